@@ -267,7 +267,8 @@ void SellState::btnOkClick(Action *)
 				}
 
 				// Remove items from craft
-				for (std::map<std::string, int>::iterator it = craft->getItems()->getContents()->begin(); it != craft->getItems()->getContents()->end(); ++it)
+				std::map<std::string, int> contents = craft->getItems()->getContents();
+				for (std::map<std::string, int>::iterator it = contents.begin(); it != contents.end(); ++it)
 				{
 					_base->getItems()->addItem(it->first, it->second);
 				}
@@ -35,6 +35,7 @@
 #include "../Engine/Game.h"
 #include "../Ruleset/Armor.h"
 #include "../Resource/ResourcePack.h"
+#include "../Ruleset/RulesetCache.h"
 
 namespace OpenXcom
 {
@@ -43,6 +44,15 @@ namespace OpenXcom
 std::vector<Position> AggroBAIState::_randomTileSearch;
 int AggroBAIState::_randomTileSearchAge = 0xBAD; // data not good yet
 
+/// Shuffles with a substream of the game's own RNG, so replays shuffle the same way
+/// without the shuffle using up numbers the rest of the battle would have drawn.
+struct ShuffleRandom
+{
+	RNG::State state;
+	ShuffleRandom(Uint32 id) : state(RNG::split(id)) {}
+	int operator()(int n) { return RNG::generate(state, 0, n - 1); }
+};
+
 /**
  * Sets up a BattleAIState.
  * @param game pointer to the game.
@@ -66,7 +76,8 @@ AggroBAIState::AggroBAIState(SavedBattleGame *game, BattleUnit *unit) : BattleAI
     if (_randomTileSearchAge > 42) // shuffle the search pattern after an arbitrary number of uses
     {
 
-        std::random_shuffle(_randomTileSearch.begin(), _randomTileSearch.end());
+        ShuffleRandom random(unit->getId());
+        std::random_shuffle(_randomTileSearch.begin(), _randomTileSearch.end(), random);
         _randomTileSearchAge = 0;
     }
 	_coverAction = new BattleAction();
@@ -145,6 +156,36 @@ void AggroBAIState::save(YAML::Emitter &out) const
 	out << YAML::EndMap;
 }
 
+/**
+ * Loads the AI state from a record in a binary save.
+ * @param in Record reader.
+ */
+void AggroBAIState::loadBinary(CacheReader &in)
+{
+	int targetID, lastKnownID;
+	in >> targetID >> lastKnownID;
+	for (std::vector<BattleUnit*>::iterator j = _game->getUnits()->begin(); j != _game->getUnits()->end(); ++j)
+	{
+		if (targetID != -1 && (*j)->getId() == targetID)
+			_aggroTarget = (*j);
+		if (lastKnownID != -1 && (*j)->getId() == lastKnownID)
+			_lastKnownTarget = (*j);
+	}
+	in >> _lastKnownPosition.x >> _lastKnownPosition.y >> _lastKnownPosition.z >> _timesNotSeen >> _charge;
+}
+
+/**
+ * Saves the AI state to a record in a binary save.
+ * @param out Record writer.
+ */
+void AggroBAIState::saveBinary(CacheWriter &out) const
+{
+	out << std::string("AGGRO");
+	out << (_aggroTarget ? _aggroTarget->getId() : -1);
+	out << (_lastKnownTarget ? _lastKnownTarget->getId() : -1);
+	out << _lastKnownPosition.x << _lastKnownPosition.y << _lastKnownPosition.z << _timesNotSeen << _charge;
+}
+
 /**
  * Enters the current AI state.
  */
@@ -652,14 +693,15 @@ void AggroBAIState::takeCoverAction(BattleAction *action)
 
 	std::vector<int> reachable = _game->getPathfinding()->findReachable(_unit, tu);
 
+	Position searchOrigin = _unit->getPosition() + runOffset; // start looking in a direction away from the enemy
+	if (!_game->getTile(searchOrigin))
+	{
+		searchOrigin = _unit->getPosition(); // cornered at the edge of the map perhaps? 
+	}
+
 	while (tries < 150 && !coverFound)
 	{
-		action->target = _unit->getPosition() + runOffset; // start looking in a direction away from the enemy
-					
-		if (!_game->getTile(action->target))
-		{
-			action->target = _unit->getPosition(); // cornered at the edge of the map perhaps? 
-		}
+		action->target = searchOrigin;
 		
 		if (tries == -1)
 		{
@@ -686,6 +728,10 @@ void AggroBAIState::takeCoverAction(BattleAction *action)
 					score += currentTilePreference;
 				}
 			}
+			else if ((tile = _game->getTile(action->target)) && tile->soldiersVisible == Tile::NOT_CALCULATED)
+			{
+				surveyCoverTiles(searchOrigin, tries, civ ? 10 : 1, reachable);
+			}
 			//score = _game->getTileEngine()->visible(_aggroTarget, _game->getTile(action->target)) ? 0 : 100;
 			score = BASE_SYSTEMATIC_SUCCESS; // no need for visible here, the TileEngine code will take care of it
 		}
@@ -728,7 +774,7 @@ void AggroBAIState::takeCoverAction(BattleAction *action)
 		{
 			if (std::find(reachable.begin(), reachable.end(), _game->getTileIndex(tile->getPosition()))  == reachable.end()) continue; // just ignore unreachable tiles
 
-			_game->getTileEngine()->surveyXComThreatToTile(tile, action->target, _unit);
+			_game->getTileEngine()->surveyXComThreatToTile(tile, _unit);
 						
 			if (tile->soldiersVisible == Tile::NOT_CALCULATED) continue; // you can't go there.
 						
@@ -811,6 +857,32 @@ void AggroBAIState::takeCoverAction(BattleAction *action)
 	}
 }
 
+/**
+ * Surveys the threat to the next tiles of the systematic cover search all
+ * at once, so the work can be spread over several threads. The search
+ * then finds them already surveyed, and comes to the same conclusions.
+ * @param origin Where the search pattern is centered.
+ * @param first Index of the first search pattern entry to survey.
+ * @param step How many entries the search moves on by each try.
+ * @param reachable Indices of the tiles the unit can reach.
+ */
+void AggroBAIState::surveyCoverTiles(const Position &origin, int first, int step, const std::vector<int> &reachable)
+{
+	const size_t BATCH_SIZE = 32;
+	std::vector<Tile*> tiles;
+	for (int i = first; i < 121 && tiles.size() < BATCH_SIZE; i += step)
+	{
+		Position target = origin + _randomTileSearch[i];
+		if (target == _unit->getPosition()) continue; // this one gets moved randomly instead
+		Tile *tile = _game->getTile(target);
+		if (tile && tile->soldiersVisible == Tile::NOT_CALCULATED && std::find(reachable.begin(), reachable.end(), _game->getTileIndex(target)) != reachable.end())
+		{
+			tiles.push_back(tile);
+		}
+	}
+	_game->getTileEngine()->surveyXComThreatToTiles(tiles, _unit);
+}
+
 /*
  * if we currently see no target, we either can move to it's last seen position or lose aggro
  */
@@ -53,6 +53,10 @@ public:
 	void load(const YAML::Node& node);
 	/// Saves the AI state to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the AI state from a binary save record.
+	void loadBinary(CacheReader &in);
+	/// Saves the AI state to a binary save record.
+	void saveBinary(CacheWriter &out) const;
 	/// Enters the state.
 	void enter();
 	/// Exits the state.
@@ -79,6 +83,8 @@ public:
 	void grenadeAction(BattleAction *action);
 	/// attempt to find cover, and move toward it.
 	void takeCoverAction(BattleAction *action);
+	/// survey the threat to the next tiles the cover search looks at.
+	void surveyCoverTiles(const Position &origin, int first, int step, const std::vector<int> &reachable);
 	/// attempt to track down an enemy we have lost sight of.
 	void stalkingAction(BattleAction *action);
 	/// should we take cover or not?
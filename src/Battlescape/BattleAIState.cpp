@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "BattleAIState.h"
+#include "../Ruleset/RulesetCache.h"
 
 namespace OpenXcom
 {
@@ -55,6 +56,26 @@ void BattleAIState::save(YAML::Emitter &) const
 {
 }
 
+/**
+ * Loads the AI state from a record in a binary save.
+ * The state name was already read by the battle save.
+ * @param in Record reader.
+ */
+void BattleAIState::loadBinary(CacheReader &)
+{
+}
+
+/**
+ * Saves the AI state to a record in a binary save,
+ * starting with the state name. States that aren't
+ * saved write an empty name.
+ * @param out Record writer.
+ */
+void BattleAIState::saveBinary(CacheWriter &out) const
+{
+	out << std::string();
+}
+
 
 /**
  * Enters the current AI state.
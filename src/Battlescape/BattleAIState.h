@@ -28,6 +28,8 @@ namespace OpenXcom
 class SavedBattleGame;
 class BattleUnit;
 class BattlescapeState;
+class CacheReader;
+class CacheWriter;
 
 /**
  * This class is used by the BattleUnit AI.
@@ -46,6 +48,10 @@ public:
 	virtual void load(const YAML::Node& node);
 	/// Saves the AI state to YAML.
 	virtual void save(YAML::Emitter& out) const;
+	/// Loads the AI state from a binary save record.
+	virtual void loadBinary(CacheReader &in);
+	/// Saves the AI state to a binary save record.
+	virtual void saveBinary(CacheWriter &out) const;
 	/// Enters the state.
 	virtual void enter();
 	/// Exits the state.
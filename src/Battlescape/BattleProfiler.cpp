@@ -0,0 +1,138 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BattleProfiler.h"
+#include <vector>
+#include "../Engine/CrossPlatform.h"
+
+namespace OpenXcom
+{
+namespace BattleProfiler
+{
+
+const char *const NAMES[PROFILE_SECTIONS] = {"FOV", "Lighting", "Pathfinding", "AI", "Explosions"};
+
+bool _enabled = false;
+double _time[PROFILE_SECTIONS] = {0};
+int _calls[PROFILE_SECTIONS] = {0};
+std::vector<Section> _stack;
+double _mark = 0.0;
+
+/**
+ * Turns the profiler on or off. Sections
+ * are only measured while it's on.
+ * @param enabled True to turn it on.
+ */
+void setEnabled(bool enabled)
+{
+	_enabled = enabled;
+	_stack.clear();
+}
+
+/**
+ * Checks if the profiler is measuring sections.
+ * @return True if it's on.
+ */
+bool isEnabled()
+{
+	return _enabled;
+}
+
+/**
+ * Starts measuring a section, pausing the section
+ * it's nested in (if any) until it's done.
+ * @param section Section to measure.
+ */
+void enter(Section section)
+{
+	double now = CrossPlatform::getMicroseconds();
+	if (!_stack.empty())
+	{
+		_time[_stack.back()] += now - _mark;
+	}
+	if (_stack.empty() || _stack.back() != section)
+	{
+		_calls[section]++;
+	}
+	_stack.push_back(section);
+	_mark = now;
+}
+
+/**
+ * Stops measuring the current section, resuming
+ * the section it was nested in (if any).
+ */
+void leave()
+{
+	if (_stack.empty())
+		return;
+	double now = CrossPlatform::getMicroseconds();
+	_time[_stack.back()] += now - _mark;
+	_stack.pop_back();
+	_mark = now;
+}
+
+/**
+ * Clears the time and calls of all the sections,
+ * keeping any sections currently being measured.
+ */
+void reset()
+{
+	for (int i = 0; i < PROFILE_SECTIONS; ++i)
+	{
+		_time[i] = 0.0;
+		_calls[i] = 0;
+	}
+	_mark = CrossPlatform::getMicroseconds();
+}
+
+/**
+ * Returns the total time spent in a section
+ * since the last reset, not counting other
+ * sections nested inside it.
+ * @param section Section to check.
+ * @return Time in microseconds.
+ */
+double getTime(Section section)
+{
+	return _time[section];
+}
+
+/**
+ * Returns how many times a section was
+ * entered since the last reset.
+ * @param section Section to check.
+ * @return Number of calls.
+ */
+int getCalls(Section section)
+{
+	return _calls[section];
+}
+
+/**
+ * Returns the name of a section for reports.
+ * @param section Section to check.
+ * @return Name of the section.
+ */
+const char *getName(Section section)
+{
+	return NAMES[section];
+}
+
+}
+}
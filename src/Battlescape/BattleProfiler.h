@@ -0,0 +1,69 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_BATTLEPROFILER_H
+#define OPENXCOM_BATTLEPROFILER_H
+
+namespace OpenXcom
+{
+
+/**
+ * Measures the time spent in the expensive parts of the battlescape
+ * engine, for the battle simulation to report on. Time spent in a
+ * section nested inside another only counts towards the inner one,
+ * so the sections add up to the total. Does nothing unless enabled.
+ */
+namespace BattleProfiler
+{
+	/// Parts of the engine being measured.
+	enum Section { PROFILE_FOV, PROFILE_LIGHTING, PROFILE_PATHFINDING, PROFILE_AI, PROFILE_EXPLOSIONS, PROFILE_SECTIONS };
+	/// Turns the profiler on or off.
+	void setEnabled(bool enabled);
+	/// Checks if the profiler is on.
+	bool isEnabled();
+	/// Starts measuring a section.
+	void enter(Section section);
+	/// Stops measuring the current section.
+	void leave();
+	/// Clears all the measurements.
+	void reset();
+	/// Gets the time spent in a section.
+	double getTime(Section section);
+	/// Gets the number of times a section was entered.
+	int getCalls(Section section);
+	/// Gets the name of a section.
+	const char *getName(Section section);
+
+	/**
+	 * Measures a section for as long as it's in scope.
+	 */
+	class Scope
+	{
+	private:
+		bool _active;
+	public:
+		/// Starts measuring a section.
+		Scope(Section section) : _active(isEnabled()) { if (_active) enter(section); }
+		/// Stops measuring the section.
+		~Scope() { if (_active) leave(); }
+	};
+}
+
+}
+
+#endif
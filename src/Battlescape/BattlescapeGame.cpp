@@ -21,6 +21,7 @@
 #include <sstream>
 #include <typeinfo>
 #include "BattlescapeGame.h"
+#include "BattleProfiler.h"
 #include "BattlescapeState.h"
 #include "../Engine/Timer.h"
 
@@ -89,7 +90,7 @@ bool BattlescapeGame::_debugPlay = false;
  * @param save Pointer to the save game.
  * @param parentState Pointer to the parent battlescape state.
  */
-BattlescapeGame::BattlescapeGame(SavedBattleGame *save, BattlescapeState *parentState) : _save(save), _parentState(parentState), _playedAggroSound(false), _endTurnRequested(false), _kneelReserved(false)
+BattlescapeGame::BattlescapeGame(SavedBattleGame *save, BattlescapeState *parentState) : _save(save), _parentState(parentState), _playedAggroSound(false), _endTurnRequested(false), _kneelReserved(false), _headless(false)
 {
 	_tuReserved = BA_NONE;
 	_playerTUReserved = BA_NONE;
@@ -97,6 +98,8 @@ BattlescapeGame::BattlescapeGame(SavedBattleGame *save, BattlescapeState *parent
 	_playerPanicHandled = true;
 	_AIActionCounter = 0;
 	_currentAction.actor = 0;
+	// the battle draws its own random numbers, leaving the geoscape sequence alone
+	RNG::setStream(RNG::STREAM_BATTLESCAPE);
 
 	checkForCasualties(0, 0, true);
 	cancelCurrentAction();
@@ -110,6 +113,7 @@ BattlescapeGame::BattlescapeGame(SavedBattleGame *save, BattlescapeState *parent
  */
 BattlescapeGame::~BattlescapeGame()
 {
+	RNG::setStream(RNG::STREAM_GEOSCAPE);
 }
 
 /**
@@ -120,8 +124,8 @@ void BattlescapeGame::think()
 	// nothing is happening - see if we need some alien AI or units panicking or what have you
 	if (_states.empty())
 	{
-		// it's a non player side (ALIENS or CIVILIANS)
-		if (_save->getSide() != FACTION_PLAYER)
+		// it's a non player side (ALIENS or CIVILIANS), or nobody is playing
+		if (_save->getSide() != FACTION_PLAYER || _headless)
 		{
 			if (!_debugPlay)
 			{
@@ -179,6 +183,7 @@ void BattlescapeGame::init()
  */
 void BattlescapeGame::handleAI(BattleUnit *unit)
 {
+	BattleProfiler::Scope profile(BattleProfiler::PROFILE_AI);
 	std::wstringstream ss;
 	
 	_tuReserved = BA_NONE;
@@ -494,7 +499,10 @@ void BattlescapeGame::endTurn()
 
 	if (_save->isObjectiveDestroyed())
 	{
-		_parentState->finishBattle(false,liveSoldiers);
+		if (!_headless)
+		{
+			_parentState->finishBattle(false,liveSoldiers);
+		}
 		return;
 	}
 
@@ -517,7 +525,7 @@ void BattlescapeGame::endTurn()
         resetSituationForAI();
     }
 
-	if (_save->getSide() != FACTION_NEUTRAL)
+	if (_save->getSide() != FACTION_NEUTRAL && !_headless)
 	{
 		_parentState->getGame()->pushState(new NextTurnState(_parentState->getGame(), _save, _parentState));
 	}
@@ -816,7 +824,10 @@ void BattlescapeGame::handleState()
 		{
 			_states.front()->think();
 		}
-		getMap()->draw(); // redraw map
+		if (!_headless)
+		{
+			getMap()->draw(); // redraw map
+		}
 	}
 }
 
@@ -1132,12 +1143,12 @@ bool BattlescapeGame::handlePanickingUnit(BattleUnit *unit)
 	case STATUS_PANICKING: // 1/2 chance to freeze and 1/2 chance try to flee
 		if (flee <= 50)
 		{
-			BattleItem *item = unit->getItem("STR_RIGHT_HAND");
+			BattleItem *item = unit->getItem(BattleUnit::getRightHandSlot());
 			if (item)
 			{
 				dropItem(unit->getPosition(), item, false, true);
 			}
-			item = unit->getItem("STR_LEFT_HAND");
+			item = unit->getItem(BattleUnit::getLeftHandSlot());
 			if (item)
 			{
 				dropItem(unit->getPosition(), item, false, true);
@@ -1535,7 +1546,7 @@ void BattlescapeGame::dropItem(const Position &position, BattleItem *item, bool
 
 	if (item->getRules()->getBattleType() == BT_FLARE)
 	{
-		getTileEngine()->calculateTerrainLighting();
+		getTileEngine()->calculateTerrainLighting(p.x, p.y, p.x, p.y);
 		getTileEngine()->calculateFOV(position);
 	}
 
@@ -1659,25 +1670,8 @@ const Ruleset *BattlescapeGame::getRuleset() const
  */
 void BattlescapeGame::resetSituationForAI()
 {
-    int w = _save->getMapSizeX();
-    int h = _save->getMapSizeZ();
-    int l = _save->getMapSizeY();
-
-    Tile **tiles = _save->getTiles();
-
-    // Log(LOG_INFO) << w*h*l << " tiles!";
-
-	if (_save->getTraceSetting())
-	{
-		for (int i = 0; i < w * l * h; ++i) if (tiles[i]->soldiersVisible != -1) { tiles[i]->setMarkerColor(0); } // clear old tile markers
-	}
-
-    for (int i = 0; i < w * l * h; ++i)
-    {
-		tiles[i]->soldiersVisible = Tile::NOT_CALCULATED;    // -1 for "not calculated"; actual calculations will take place as needed
-		tiles[i]->closestSoldierDSqr = Tile::NOT_CALCULATED; // for most of the tiles most of the time, this data is not needed
-    }
-
+	// only the tiles actually surveyed need forgetting, the rest are still "not calculated"
+	_save->getTileEngine()->resetThreatMap(_save->getTraceSetting());
 }
 
 
@@ -1918,9 +1912,9 @@ bool BattlescapeGame::takeItem(BattleItem* item, BattleAction *action)
 	{
 	case BT_AMMO:
 		// find equipped weapons that can be loaded with this ammo
-		if (action->actor->getItem("STR_RIGHT_HAND") && action->actor->getItem("STR_RIGHT_HAND")->getAmmoItem() == 0)
+		if (action->actor->getItem(BattleUnit::getRightHandSlot()) && action->actor->getItem(BattleUnit::getRightHandSlot())->getAmmoItem() == 0)
 		{
-			if (action->actor->getItem("STR_RIGHT_HAND")->setAmmoItem(item) == 0)
+			if (action->actor->getItem(BattleUnit::getRightHandSlot())->setAmmoItem(item) == 0)
 			{
 				placed = true;
 			}
@@ -1956,7 +1950,7 @@ bool BattlescapeGame::takeItem(BattleItem* item, BattleAction *action)
 		break;
 	case BT_FIREARM:
 	case BT_MELEE:
-		if (!action->actor->getItem("STR_RIGHT_HAND"))
+		if (!action->actor->getItem(BattleUnit::getRightHandSlot()))
 		{
 			item->moveToOwner(action->actor);
 			item->setSlot(rules->getInventory("STR_RIGHT_HAND"));
@@ -1973,7 +1967,7 @@ bool BattlescapeGame::takeItem(BattleItem* item, BattleAction *action)
 		}
 		break;
 	case BT_MINDPROBE:
-		if (!action->actor->getItem("STR_LEFT_HAND"))
+		if (!action->actor->getItem(BattleUnit::getLeftHandSlot()))
 		{
 			item->moveToOwner(action->actor);
 			item->setSlot(rules->getInventory("STR_LEFT_HAND"));
@@ -2046,4 +2040,17 @@ bool BattlescapeGame::getKneelReserved()
 	}
 	return false;
 }
+
+/**
+ * Lets the AI play every side, including the player's,
+ * for simulating battles with nobody watching. The battle
+ * is left to the caller to finish, and to dismiss any
+ * messages that pop up along the way.
+ * @param headless True to let the AI play.
+ */
+void BattlescapeGame::setHeadless(bool headless)
+{
+	_headless = headless;
+}
+
 }
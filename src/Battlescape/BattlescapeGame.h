@@ -84,7 +84,7 @@ private:
 	bool noActionsPending(BattleUnit *bu);
 	std::vector<InfoboxOKState*> _infoboxQueue;
 	void showInfoBoxQueue();
-	bool _playedAggroSound, _endTurnRequested, _kneelReserved;
+	bool _playedAggroSound, _endTurnRequested, _kneelReserved, _headless;
 public:
 	/// Creates the BattlescapeGame state.
 	BattlescapeGame(SavedBattleGame *save, BattlescapeState *parentState);
@@ -175,6 +175,8 @@ public:
 	void setKneelReserved(bool reserved);
 	/// check the kneel reservation setting.
 	bool getKneelReserved();
+	/// let the AI play every side.
+	void setHeadless(bool headless);
 
 };
 
@@ -17,7 +17,6 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <assert.h>
-#include <fstream>
 #include <sstream>
 #include "BattlescapeGenerator.h"
 #include "TileEngine.h"
@@ -53,6 +52,7 @@
 #include "../Engine/Game.h"
 #include "../Engine/Language.h"
 #include "../Engine/CrossPlatform.h"
+#include "../Engine/DataBuffer.h"
 #include "../Savegame/Vehicle.h"
 #include "../Savegame/TerrorSite.h"
 #include "../Savegame/AlienBase.h"
@@ -349,7 +349,8 @@ void BattlescapeGenerator::run()
 		if (_craft != 0)
 		{
 			// add items that are in the craft
-			for (std::map<std::string, int>::iterator i = _craft->getItems()->getContents()->begin(); i != _craft->getItems()->getContents()->end(); ++i)
+			std::map<std::string, int> contents = _craft->getItems()->getContents();
+			for (std::map<std::string, int>::iterator i = contents.begin(); i != contents.end(); ++i)
 			{
 				for (int count=0; count < i->second; count++)
 				{
@@ -361,7 +362,8 @@ void BattlescapeGenerator::run()
 		else
 		{
 			// add items that are in the base
-			for (std::map<std::string, int>::iterator i = _base->getItems()->getContents()->begin(); i != _base->getItems()->getContents()->end();)
+			std::map<std::string, int> contents = _base->getItems()->getContents();
+			for (std::map<std::string, int>::iterator i = contents.begin(); i != contents.end(); ++i)
 			{
 				// only put items in the battlescape that make sense (when the item got a sprite, it's probably ok)
 				RuleItem *rule = _game->getRuleset()->getItem(i->first);
@@ -372,13 +374,7 @@ void BattlescapeGenerator::run()
 						_craftInventoryTile->addItem(new BattleItem(_game->getRuleset()->getItem(i->first), _save->getCurrentItemId()),
 							_game->getRuleset()->getInventory("STR_GROUND"));
 					}
-					std::map<std::string, int>::iterator tmp = i;
-					++i;
-					_base->getItems()->removeItem(tmp->first, tmp->second);
-				}
-				else
-				{
-					++i;
+					_base->getItems()->removeItem(i->first, i->second);
 				}
 			}
 			// add items from crafts in base
@@ -386,7 +382,8 @@ void BattlescapeGenerator::run()
 			{
 				if ((*c)->getStatus() == "STR_OUT")
 					continue;
-				for (std::map<std::string, int>::iterator i = (*c)->getItems()->getContents()->begin(); i != (*c)->getItems()->getContents()->end(); ++i)
+				std::map<std::string, int> craftContents = (*c)->getItems()->getContents();
+				for (std::map<std::string, int>::iterator i = craftContents.begin(); i != craftContents.end(); ++i)
 				{
 					for (int count=0; count < i->second; count++)
 					{
@@ -1277,7 +1274,7 @@ void BattlescapeGenerator::generateMap()
 
 	for (std::vector<MapDataSet*>::iterator i = _terrain->getMapDataSets()->begin(); i != _terrain->getMapDataSets()->end(); ++i)
 	{
-		(*i)->loadData();
+		_res->acquireTerrain(*i);
 		if (_game->getRuleset()->getMCDPatch((*i)->getName()))
 		{
 			_game->getRuleset()->getMCDPatch((*i)->getName())->modifyData(*i);
@@ -1419,7 +1416,7 @@ void BattlescapeGenerator::generateMap()
 	{
 		for (std::vector<MapDataSet*>::iterator i = _ufo->getRules()->getBattlescapeTerrainData()->getMapDataSets()->begin(); i != _ufo->getRules()->getBattlescapeTerrainData()->getMapDataSets()->end(); ++i)
 		{
-			(*i)->loadData();
+			_res->acquireTerrain(*i);
 			if (_game->getRuleset()->getMCDPatch((*i)->getName()))
 			{
 				_game->getRuleset()->getMCDPatch((*i)->getName())->modifyData(*i);
@@ -1442,7 +1439,7 @@ void BattlescapeGenerator::generateMap()
 	{
 		for (std::vector<MapDataSet*>::iterator i = _craft->getRules()->getBattlescapeTerrainData()->getMapDataSets()->begin(); i != _craft->getRules()->getBattlescapeTerrainData()->getMapDataSets()->end(); ++i)
 		{
-			(*i)->loadData();
+			_res->acquireTerrain(*i);
 			if (_game->getRuleset()->getMCDPatch((*i)->getName()))
 			{
 				_game->getRuleset()->getMCDPatch((*i)->getName())->modifyData(*i);
@@ -1533,14 +1530,13 @@ int BattlescapeGenerator::loadMAP(MapBlock *mapblock, int xoff, int yoff, RuleTe
 	int sizex, sizey, sizez;
 	int x = xoff, y = yoff, z = 0;
 	char size[3];
-	unsigned char value[4];
 	std::stringstream filename;
 	filename << "MAPS/" << mapblock->getName() << ".MAP";
 	int terrainObjectID;
 
 	// Load file
-	std::ifstream mapFile (CrossPlatform::getDataFile(filename.str()).c_str(), std::ios::in| std::ios::binary);
-	if (!mapFile)
+	DataBuffer mapFile;
+	if (!mapFile.open(CrossPlatform::getDataFile(filename.str())))
 	{
 		throw Exception(filename.str() + " not found");
 	}
@@ -1574,11 +1570,13 @@ int BattlescapeGenerator::loadMAP(MapBlock *mapblock, int xoff, int yoff, RuleTe
 		throw Exception("Something is wrong in your map definitions");
 	}
 
-	while (mapFile.read((char*)&value, sizeof(value)))
+	// decode the tiles straight from the file contents
+	const Uint8 *value = mapFile.getData() + mapFile.tell(), *end = mapFile.getData() + mapFile.getSize();
+	for (; end - value >= 4; value += 4)
 	{
 		for (int part = 0; part < 4; part++)
 		{
-			terrainObjectID = (int)((unsigned char)value[part]);
+			terrainObjectID = (int)value[part];
 			if (terrainObjectID>0)
 			{
 				int mapDataSetID = mapDataSetOffset;
@@ -1609,13 +1607,6 @@ int BattlescapeGenerator::loadMAP(MapBlock *mapblock, int xoff, int yoff, RuleTe
 		}
 	}
 
-	if (!mapFile.eof())
-	{
-		throw Exception("Invalid MAP file");
-	}
-
-	mapFile.close();
-
 	return sizez;
 }
 
@@ -1635,8 +1626,8 @@ void BattlescapeGenerator::loadRMP(MapBlock *mapblock, int xoff, int yoff, int s
 	filename << "ROUTES/" << mapblock->getName() << ".RMP";
 
 	// Load file
-	std::ifstream mapFile (CrossPlatform::getDataFile(filename.str()).c_str(), std::ios::in| std::ios::binary);
-	if (!mapFile)
+	DataBuffer mapFile;
+	if (!mapFile.open(CrossPlatform::getDataFile(filename.str())))
 	{
 		throw Exception(filename.str() + " not found");
 	}
@@ -1661,13 +1652,6 @@ void BattlescapeGenerator::loadRMP(MapBlock *mapblock, int xoff, int yoff, int s
 		}
 		id++;
 	}
-
-	if (!mapFile.eof())
-	{
-		throw Exception("Invalid RMP file");
-	}
-
-	mapFile.close();
 }
 
 /**
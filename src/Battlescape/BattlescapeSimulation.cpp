@@ -0,0 +1,472 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BattlescapeSimulation.h"
+#include <iomanip>
+#include <sstream>
+#include "BattlescapeState.h"
+#include "BattlescapeGame.h"
+#include "BattlescapeGenerator.h"
+#include "TileEngine.h"
+#include "Pathfinding.h"
+#include "Position.h"
+#include "SightCache.h"
+#include "../Engine/Game.h"
+#include "../Engine/Exception.h"
+#include "../Engine/Logger.h"
+#include "../Engine/Options.h"
+#include "../Engine/RNG.h"
+#include "../Engine/CrossPlatform.h"
+#include "../Ruleset/Ruleset.h"
+#include "../Ruleset/RuleTerrain.h"
+#include "../Ruleset/MapData.h"
+#include "../Savegame/SavedGame.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/Tile.h"
+#include "../Savegame/TileStore.h"
+#include "../Savegame/BattleUnit.h"
+#include "../Savegame/Base.h"
+#include "../Savegame/Craft.h"
+#include "../Savegame/Ufo.h"
+#include "../Savegame/TerrorSite.h"
+#include "../Savegame/AlienBase.h"
+
+namespace OpenXcom
+{
+
+/// Most steps a turn can take before the AI is considered stuck.
+const int MAX_TURN_STEPS = 1000000;
+/// Times each full map sweep is repeated to time it.
+const int SWEEP_REPEATS = 100;
+/// Most tiles per unit the pathfinding benchmark looks for a path to.
+const int PATH_DESTINATIONS = 100;
+
+/**
+ * Creates a simulation for a game that
+ * has its resources and ruleset loaded.
+ * @param game Pointer to the core game.
+ */
+BattlescapeSimulation::BattlescapeSimulation(Game *game) : _game(game), _battlescape(0), _sightHits(0), _sightMisses(0)
+{
+	for (int i = 0; i < BattleProfiler::PROFILE_SECTIONS; ++i)
+	{
+		_time[i] = 0.0;
+		_calls[i] = 0;
+	}
+}
+
+/**
+ * Takes the battlescape and anything still
+ * on top of it off the game.
+ */
+BattlescapeSimulation::~BattlescapeSimulation()
+{
+	BattleProfiler::setEnabled(false);
+	if (_battlescape != 0)
+	{
+		while (!_game->isState(_battlescape))
+		{
+			_game->popState();
+		}
+		_game->popState();
+	}
+}
+
+/**
+ * Loads a battle from a saved game in the User Folder or,
+ * if there's no save by that name, generates a new battle
+ * for that mission type. The RNG is reset to the given seed
+ * so the results don't depend on the state stored in the save.
+ * @param battle Name of the save without extension, or mission type.
+ * @param seed RNG seed.
+ */
+void BattlescapeSimulation::load(const std::string &battle, int seed)
+{
+	if (CrossPlatform::fileExists(Options::getUserFolder() + battle + ".sav"))
+	{
+		SavedGame *save = new SavedGame();
+		try
+		{
+			save->load(battle, _game->getRuleset());
+		}
+		catch (...)
+		{
+			delete save;
+			throw;
+		}
+		_game->setSavedGame(save);
+		if (save->getSavedBattle() == 0)
+		{
+			throw Exception(battle + " is not saved in the middle of a battle");
+		}
+		save->getSavedBattle()->loadMapResources(_game);
+		RNG::seed(seed);
+	}
+	else
+	{
+		RNG::seed(seed);
+		generate(battle);
+	}
+	_battlescape = new BattlescapeState(_game);
+	_game->pushState(_battlescape);
+	_game->getSavedGame()->getSavedBattle()->setBattleState(_battlescape);
+	_battlescape->getBattleGame()->setHeadless(true);
+}
+
+/**
+ * Generates a new battle like the New Battle screen does,
+ * with the starting base's craft and soldiers against
+ * the chosen alien race on the chosen terrain.
+ * @param mission Mission type, or UFO type for UFO missions.
+ */
+void BattlescapeSimulation::generate(const std::string &mission)
+{
+	Ruleset *rule = _game->getRuleset();
+	if (rule->getDeployment(mission) == 0)
+	{
+		throw Exception("No saved game or mission called " + mission);
+	}
+
+	std::string terrain = Options::getSimulateTerrain();
+	if (terrain.empty())
+	{
+		const std::vector<std::string> &terrains = rule->getTerrainList();
+		for (std::vector<std::string>::const_iterator i = terrains.begin(); i != terrains.end() && terrain.empty(); ++i)
+		{
+			if (!rule->getTerrain(*i)->getTextures()->empty())
+			{
+				terrain = *i;
+			}
+		}
+	}
+	if (rule->getTerrain(terrain) == 0 || rule->getTerrain(terrain)->getTextures()->empty())
+	{
+		throw Exception("No terrain called " + terrain);
+	}
+	std::string race = Options::getSimulateRace();
+	if (race.empty() && !rule->getAlienRacesList().empty())
+	{
+		race = rule->getAlienRacesList().front();
+	}
+	if (rule->getAlienRace(race) == 0)
+	{
+		throw Exception("No alien race called " + race);
+	}
+
+	SavedGame *save = rule->newSave();
+	_game->setSavedGame(save);
+	Base *base = save->getBases()->front();
+	Craft *craft = base->getCrafts()->front();
+	SavedBattleGame *battle = new SavedBattleGame();
+	save->setBattleGame(battle);
+	battle->setMissionType(mission);
+	BattlescapeGenerator bgen = BattlescapeGenerator(_game);
+	bgen.setWorldTexture(rule->getTerrain(terrain)->getTextures()->at(0));
+
+	if (mission == "STR_TERROR_MISSION")
+	{
+		TerrorSite *t = new TerrorSite();
+		t->setId(1);
+		save->getTerrorSites()->push_back(t);
+		craft->setDestination(t);
+		bgen.setTerrorSite(t);
+		bgen.setCraft(craft);
+	}
+	else if (mission == "STR_BASE_DEFENSE")
+	{
+		bgen.setBase(base);
+	}
+	else if (mission == "STR_ALIEN_BASE_ASSAULT")
+	{
+		AlienBase *b = new AlienBase();
+		b->setId(1);
+		save->getAlienBases()->push_back(b);
+		craft->setDestination(b);
+		bgen.setAlienBase(b);
+		bgen.setCraft(craft);
+	}
+	else if (mission == "STR_MARS_CYDONIA_LANDING" || mission == "STR_MARS_THE_FINAL_ASSAULT")
+	{
+		bgen.setCraft(craft);
+	}
+	else if (rule->getUfo(mission) != 0)
+	{
+		Ufo *u = new Ufo(rule->getUfo(mission));
+		u->setId(1);
+		save->getUfos()->push_back(u);
+		craft->setDestination(u);
+		bgen.setUfo(u);
+		bgen.setCraft(craft);
+		// either ground assault or ufo crash
+		if (RNG::generate(0, 1) == 1)
+			battle->setMissionType("STR_UFO_GROUND_ASSAULT");
+		else
+			battle->setMissionType("STR_UFO_CRASH_RECOVERY");
+	}
+	else
+	{
+		bgen.setCraft(craft);
+	}
+	craft->setSpeed(0);
+	bgen.setWorldShade(0);
+	bgen.setAlienRace(race);
+	bgen.setAlienItemlevel(0);
+	bgen.run();
+	Log(LOG_INFO) << "Generated " << battle->getMissionType() << " against " << race << " on " << terrain << ".";
+}
+
+/**
+ * Times the sweeps that go over every tile of the map in
+ * order: sun shading, terrain lighting, unit lighting and
+ * a pass over the tile fields the new turn looks at. These
+ * are the ones the tile layout matters most to. Each sweep
+ * is repeated and leaves the map as it found it.
+ */
+void BattlescapeSimulation::benchmarkSweeps()
+{
+	SavedBattleGame *battle = _game->getSavedGame()->getSavedBattle();
+	TileEngine *tileEngine = battle->getTileEngine();
+	const char *names[] = {"Sun shading", "Terrain lighting", "Unit lighting", "Tile scan"};
+	double time[4] = {0.0, 0.0, 0.0, 0.0};
+	int busy = 0;
+	for (int i = 0; i < SWEEP_REPEATS; ++i)
+	{
+		double mark = CrossPlatform::getMicroseconds(), now;
+		tileEngine->calculateSunShading();
+		now = CrossPlatform::getMicroseconds();
+		time[0] += now - mark;
+		mark = now;
+		tileEngine->calculateTerrainLighting();
+		now = CrossPlatform::getMicroseconds();
+		time[1] += now - mark;
+		mark = now;
+		tileEngine->calculateUnitLighting();
+		now = CrossPlatform::getMicroseconds();
+		time[2] += now - mark;
+		mark = now;
+		busy = 0;
+		TileStore *store = battle->getTileStore();
+		const int *fire = store->getFire(), *smoke = store->getSmoke(), *light = store->getLight();
+		MapData **objects = store->getObjects();
+		const bool *discovered = store->getDiscovered();
+		for (int t = 0; t < battle->getMapSizeXYZ(); ++t)
+		{
+			const int *tileLight = light + t * TileStore::LIGHTLAYERS;
+			if (fire[t] > 0 || smoke[t] > 0
+				|| (objects[t * TileStore::PARTS + MapData::O_OBJECT] != 0 && discovered[t * TileStore::DISCOVERY_PARTS + 2])
+				|| tileLight[0] > 0 || tileLight[1] > 0 || tileLight[2] > 0)
+			{
+				++busy;
+			}
+		}
+		time[3] += CrossPlatform::getMicroseconds() - mark;
+	}
+	Log(LOG_INFO) << "Map sweeps over " << battle->getMapSizeXYZ() << " tiles (" << busy << " busy), " << SWEEP_REPEATS << " times each:";
+	for (int i = 0; i < 4; ++i)
+	{
+		std::ostringstream ss;
+		ss << std::fixed << std::setprecision(1);
+		ss << std::setw(16) << names[i] << ": " << std::setw(8) << time[i] / SWEEP_REPEATS << "us each";
+		Log(LOG_INFO) << ss.str();
+	}
+}
+
+/**
+ * Times the pathfinding of every unit still in the battle:
+ * the search for all tiles it can reach with its time units,
+ * and a path to each of up to PATH_DESTINATIONS of those tiles.
+ * A path has to exist to every tile the reachable search
+ * found, so any that's missing is counted and warned about.
+ */
+void BattlescapeSimulation::benchmarkPathfinding()
+{
+	SavedBattleGame *battle = _game->getSavedGame()->getSavedBattle();
+	Pathfinding *pathfinding = battle->getPathfinding();
+	double reachTime = 0.0, pathTime = 0.0;
+	int units = 0, reached = 0, paths = 0, missing = 0;
+	for (std::vector<BattleUnit*>::iterator i = battle->getUnits()->begin(); i != battle->getUnits()->end(); ++i)
+	{
+		BattleUnit *unit = *i;
+		if (unit->isOut())
+			continue;
+		double mark = CrossPlatform::getMicroseconds();
+		std::vector<int> reachable = pathfinding->findReachable(unit, unit->getTimeUnits());
+		reachTime += CrossPlatform::getMicroseconds() - mark;
+		++units;
+		reached += reachable.size();
+
+		// the first tile is the one the unit stands on
+		size_t stride = reachable.size() / PATH_DESTINATIONS + 1;
+		for (size_t j = stride; j < reachable.size(); j += stride)
+		{
+			int x, y, z;
+			battle->getTileCoords(reachable[j], &x, &y, &z);
+			mark = CrossPlatform::getMicroseconds();
+			pathfinding->calculate(unit, Position(x, y, z));
+			pathTime += CrossPlatform::getMicroseconds() - mark;
+			++paths;
+			if (pathfinding->getStartDirection() == -1)
+			{
+				++missing;
+			}
+		}
+		pathfinding->abortPath();
+	}
+
+	std::ostringstream ss;
+	ss << std::fixed << std::setprecision(1);
+	ss << "Pathfinding for " << units << " units: reachable tiles " << (units > 0 ? reachTime / units : 0.0) << "us each (" << reached << " tiles), ";
+	ss << "paths " << (paths > 0 ? pathTime / paths : 0.0) << "us each (" << paths << " paths)";
+	Log(LOG_INFO) << ss.str();
+	if (missing > 0)
+	{
+		Log(LOG_WARNING) << "No path found to " << missing << " of " << paths << " reachable tiles.";
+	}
+}
+
+/**
+ * Checks if either side has been wiped out
+ * or the mission objective was destroyed.
+ * @return True if the battle is over.
+ */
+bool BattlescapeSimulation::isOver()
+{
+	int liveAliens = 0, liveSoldiers = 0;
+	_battlescape->getBattleGame()->tallyUnits(liveAliens, liveSoldiers, false);
+	return liveAliens == 0 || liveSoldiers == 0 || _game->getSavedGame()->getSavedBattle()->isObjectiveDestroyed();
+}
+
+/**
+ * Times the map sweeps and the pathfinding, then plays out
+ * the battle for a number of turns, or until it's over,
+ * running the battle states one step at a time like the
+ * battlescape timer does, and reports how long each turn took.
+ * Any message windows are dismissed as soon as they show up.
+ * @param turns Number of turns.
+ */
+void BattlescapeSimulation::run(int turns)
+{
+	SavedBattleGame *battle = _game->getSavedGame()->getSavedBattle();
+	BattlescapeGame *battleGame = _battlescape->getBattleGame();
+	Log(LOG_INFO) << "Simulating " << turns << " turns with " << Options::getInt("aiThreads") << " AI threads...";
+	_battlescape->init();
+	benchmarkSweeps();
+	benchmarkPathfinding();
+	BattleProfiler::reset();
+	BattleProfiler::setEnabled(true);
+	battle->getTileEngine()->getSightCache()->resetCounters();
+
+	int turn = battle->getTurn(), played = 0, steps = 0;
+	double start = CrossPlatform::getMicroseconds(), turnStart = start;
+	while (played < turns)
+	{
+		battleGame->think();
+		battleGame->handleState();
+		while (!_game->isState(_battlescape))
+		{
+			_game->popState();
+		}
+		++steps;
+
+		double now = CrossPlatform::getMicroseconds();
+		bool over = !battleGame->isBusy() && isOver();
+		if (battle->getTurn() != turn || over || steps == MAX_TURN_STEPS)
+		{
+			reportTurn(turn, steps, now - turnStart);
+			++played;
+			if (over)
+			{
+				Log(LOG_INFO) << "The battle is over.";
+				break;
+			}
+			if (steps == MAX_TURN_STEPS)
+			{
+				Log(LOG_WARNING) << "Turn " << turn << " is stuck, giving up.";
+				break;
+			}
+			turn = battle->getTurn();
+			steps = 0;
+			turnStart = now;
+		}
+	}
+	BattleProfiler::setEnabled(false);
+	report(played, CrossPlatform::getMicroseconds() - start);
+}
+
+/**
+ * Logs how long each section of the engine
+ * took in a turn, and adds it to the totals.
+ * @param turn Turn number.
+ * @param steps Number of steps the turn took.
+ * @param time Total time of the turn in microseconds.
+ */
+void BattlescapeSimulation::reportTurn(int turn, int steps, double time)
+{
+	std::ostringstream ss;
+	ss << std::fixed << std::setprecision(1);
+	ss << "Turn " << std::setw(3) << turn << ": " << std::setw(8) << time / 1000.0 << "ms, " << std::setw(6) << steps << " steps";
+	for (int i = 0; i < BattleProfiler::PROFILE_SECTIONS; ++i)
+	{
+		BattleProfiler::Section section = (BattleProfiler::Section)i;
+		ss << ", " << BattleProfiler::getName(section) << " " << BattleProfiler::getTime(section) / 1000.0 << "ms";
+		_time[i] += BattleProfiler::getTime(section);
+		_calls[i] += BattleProfiler::getCalls(section);
+	}
+	SightCache *sight = _game->getSavedGame()->getSavedBattle()->getTileEngine()->getSightCache();
+	ss << ", sight cache " << sight->getHits() << " hits " << sight->getMisses() << " misses";
+	_sightHits += sight->getHits();
+	_sightMisses += sight->getMisses();
+	sight->resetCounters();
+	Log(LOG_INFO) << ss.str();
+	BattleProfiler::reset();
+}
+
+/**
+ * Logs how long the simulation took in total
+ * and in each section of the engine, how well
+ * the sight cache did, and how many units
+ * are left on each side.
+ * @param turns Number of turns simulated.
+ * @param time Total time in microseconds.
+ */
+void BattlescapeSimulation::report(int turns, double time)
+{
+	std::ostringstream ss;
+	ss << std::fixed << std::setprecision(1);
+	ss << "Simulated " << turns << " turns in " << time / 1000.0 << "ms";
+	if (turns > 0)
+	{
+		ss << " (" << time / 1000.0 / turns << "ms/turn)";
+	}
+	Log(LOG_INFO) << ss.str();
+	for (int i = 0; i < BattleProfiler::PROFILE_SECTIONS; ++i)
+	{
+		std::ostringstream line;
+		line << std::fixed << std::setprecision(1);
+		line << std::setw(12) << BattleProfiler::getName((BattleProfiler::Section)i) << ": " << std::setw(8) << _calls[i] << " calls, " << std::setw(10) << _time[i] / 1000.0 << "ms total, ";
+		line << std::setw(8) << (_calls[i] > 0 ? _time[i] / _calls[i] : 0.0) << "us each, " << std::setw(5) << (time > 0.0 ? _time[i] * 100.0 / time : 0.0) << "%";
+		Log(LOG_INFO) << line.str();
+	}
+	int lookups = _sightHits + _sightMisses;
+	Log(LOG_INFO) << "Sight cache: " << _sightHits << " hits, " << _sightMisses << " misses (" << (lookups > 0 ? _sightHits * 100 / lookups : 0) << "% hits)";
+	int liveAliens = 0, liveSoldiers = 0;
+	_battlescape->getBattleGame()->tallyUnits(liveAliens, liveSoldiers, false);
+	Log(LOG_INFO) << "Units left: " << liveSoldiers << " X-Com, " << liveAliens << " aliens";
+}
+
+}
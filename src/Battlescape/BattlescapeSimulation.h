@@ -0,0 +1,71 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_BATTLESCAPESIMULATION_H
+#define OPENXCOM_BATTLESCAPESIMULATION_H
+
+#include <string>
+#include "BattleProfiler.h"
+
+namespace OpenXcom
+{
+
+class Game;
+class BattlescapeState;
+
+/**
+ * Plays out a battle with the AI in control of every side and
+ * nothing drawn on screen, as fast as the engine can go, to measure
+ * how long the expensive parts of the battlescape take each turn.
+ * The battle comes from a saved game or is generated from scratch.
+ */
+class BattlescapeSimulation
+{
+private:
+	Game *_game;
+	BattlescapeState *_battlescape;
+	double _time[BattleProfiler::PROFILE_SECTIONS];
+	int _calls[BattleProfiler::PROFILE_SECTIONS];
+	int _sightHits, _sightMisses;
+
+	/// Generates a new battle.
+	void generate(const std::string &mission);
+	/// Times the full map sweeps.
+	void benchmarkSweeps();
+	/// Times the pathfinding for every unit.
+	void benchmarkPathfinding();
+	/// Checks if the battle is over.
+	bool isOver();
+	/// Logs the timings of a turn.
+	void reportTurn(int turn, int steps, double time);
+	/// Logs the results of the simulation.
+	void report(int turns, double time);
+public:
+	/// Creates a new battle simulation.
+	BattlescapeSimulation(Game *game);
+	/// Cleans up the battle simulation.
+	~BattlescapeSimulation();
+	/// Loads or generates the battle to simulate.
+	void load(const std::string &battle, int seed);
+	/// Simulates a number of turns.
+	void run(int turns);
+};
+
+}
+
+#endif
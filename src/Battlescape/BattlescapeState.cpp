@@ -863,7 +863,7 @@ void BattlescapeState::btnLeftHandItemClick(Action *)
 		_save->getSelectedUnit()->setActiveHand("STR_LEFT_HAND");
 		_map->cacheUnits();
 		_map->draw();
-		BattleItem *leftHandItem = _save->getSelectedUnit()->getItem("STR_LEFT_HAND");
+		BattleItem *leftHandItem = _save->getSelectedUnit()->getItem(BattleUnit::getLeftHandSlot());
 		handleItemClick(leftHandItem);
 	}
 }
@@ -880,7 +880,7 @@ void BattlescapeState::btnRightHandItemClick(Action *)
 		_save->getSelectedUnit()->setActiveHand("STR_RIGHT_HAND");
 		_map->cacheUnits();
 		_map->draw();
-		BattleItem *rightHandItem = _save->getSelectedUnit()->getItem("STR_RIGHT_HAND");
+		BattleItem *rightHandItem = _save->getSelectedUnit()->getItem(BattleUnit::getRightHandSlot());
 		handleItemClick(rightHandItem);
 	}
 }
@@ -1052,7 +1052,7 @@ void BattlescapeState::updateSoldierInfo()
 	_barMorale->setMax(100);
 	_barMorale->setValue(battleUnit->getMorale());
 
-	BattleItem *leftHandItem = battleUnit->getItem("STR_LEFT_HAND");
+	BattleItem *leftHandItem = battleUnit->getItem(BattleUnit::getLeftHandSlot());
 	_btnLeftHandItem->clear();
 	_numAmmoLeft->setVisible(false);
 	if (leftHandItem)
@@ -1067,7 +1067,7 @@ void BattlescapeState::updateSoldierInfo()
 				_numAmmoLeft->setValue(0);
 		}
 	}
-	BattleItem *rightHandItem = battleUnit->getItem("STR_RIGHT_HAND");
+	BattleItem *rightHandItem = battleUnit->getItem(BattleUnit::getRightHandSlot());
 	_btnRightHandItem->clear();
 	_numAmmoRight->setVisible(false);
 	if (rightHandItem)
@@ -1315,7 +1315,7 @@ void BattlescapeState::SaveAIMap()
 			if (!t) continue;
 			if (!t->isDiscovered(2)) continue;
 			
-			if (_save->getTileEngine()->surveyXComThreatToTile(t, tilePos, unit) && t->totalExposure > expMax) expMax = t->totalExposure;
+			if (_save->getTileEngine()->surveyXComThreatToTile(t, unit) && t->totalExposure > expMax) expMax = t->totalExposure;
 		}
 	}
 	
@@ -1335,7 +1335,7 @@ void BattlescapeState::SaveAIMap()
 			r.x = x * r.w;
 			r.y = y * r.h;
 
-			if (t->getTUCost(MapData::O_FLOOR, MT_FLY) != 255 && t->getTUCost(MapData::O_OBJECT, MT_FLY) != 255 && _save->getTileEngine()->surveyXComThreatToTile(t, tilePos, unit) && t->soldiersVisible != Tile::NOT_CALCULATED)
+			if (t->getTUCost(MapData::O_FLOOR, MT_FLY) != 255 && t->getTUCost(MapData::O_OBJECT, MT_FLY) != 255 && _save->getTileEngine()->surveyXComThreatToTile(t, unit) && t->soldiersVisible != Tile::NOT_CALCULATED)
 			{
 				int e = (t->totalExposure * 255) / expMax;
 				SDL_FillRect(img, &r, SDL_MapRGB(img->format, e, 255-e, 0x20));
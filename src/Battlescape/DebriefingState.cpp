@@ -879,7 +879,7 @@ void DebriefingState::prepareDebriefing()
 
 void DebriefingState::reequipCraft(Base *base, Craft *craft, bool vehicleItemsCanBeDestroyed)
 {
-	std::map<std::string, int> craftItems = *craft->getItems()->getContents();
+	std::map<std::string, int> craftItems = craft->getItems()->getContents();
 	for (std::map<std::string, int>::iterator i = craftItems.begin(); i != craftItems.end(); ++i)
 	{
 		int qty = base->getItems()->getItem(i->first);
@@ -908,7 +908,8 @@ void DebriefingState::reequipCraft(Base *base, Craft *craft, bool vehicleItemsCa
 			delete (*i);
 	craft->getVehicles()->clear();
 	// Ok, now readd those vehicles
-	for (std::map<std::string, int>::iterator i = craftVehicles.getContents()->begin(); i != craftVehicles.getContents()->end(); ++i)
+	std::map<std::string, int> vehicleContents = craftVehicles.getContents();
+	for (std::map<std::string, int>::iterator i = vehicleContents.begin(); i != vehicleContents.end(); ++i)
 	{
 		int qty = base->getItems()->getItem(i->first);
 		RuleItem *tankRule = _game->getRuleset()->getItem(i->first);
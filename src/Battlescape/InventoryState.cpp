@@ -335,8 +335,19 @@ void InventoryState::btnOkClick(Action *)
 			if ((*i)->getFaction() == _battleGame->getSide())
 				(*i)->prepareNewTurn();
 	}
-	_battleGame->getTileEngine()->applyGravity(_battleGame->getSelectedUnit()->getTile());
-	_battleGame->getTileEngine()->calculateTerrainLighting(); // dropping/picking up flares
+	BattleUnit *unit = _battleGame->getSelectedUnit();
+	_battleGame->getTileEngine()->applyGravity(unit->getTile());
+	if (_tu)
+	{
+		// items only changed hands with the ground under the unit
+		Position pos = unit->getPosition();
+		int size = unit->getArmor()->getSize();
+		_battleGame->getTileEngine()->calculateTerrainLighting(pos.x, pos.y, pos.x + size - 1, pos.y + size - 1); // dropping/picking up flares
+	}
+	else
+	{
+		_battleGame->getTileEngine()->calculateTerrainLighting(); // dropping/picking up flares
+	}
 	_battleGame->getTileEngine()->recalculateFOV();
 }
 
@@ -0,0 +1,198 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cmath>
+#include <algorithm>
+#include "LightLayer.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/Tile.h"
+#include "../Savegame/TileStore.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates a light layer without any light sources.
+ * @param save Pointer to the battle.
+ * @param layer The tile light layer this layer controls.
+ */
+LightLayer::LightLayer(SavedBattleGame *save, int layer) : _save(save), _layer(layer), _lit(false), _minX(0), _minY(0), _maxX(-1), _maxY(-1)
+{
+	_dirty.resize(_save->getMapSizeX() * _save->getMapSizeY(), 0);
+	_light.resize(_save->getMapSizeX() * _save->getMapSizeY(), 0);
+}
+
+/**
+ * Cleans up the light layer.
+ */
+LightLayer::~LightLayer()
+{
+
+}
+
+/**
+ * Marks every map column within reach of a light source to be lit again.
+ * @param source The light source.
+ */
+void LightLayer::markDirty(const LightSource &source)
+{
+	int x1 = std::max(source.x - source.power, 0);
+	int y1 = std::max(source.y - source.power, 0);
+	int x2 = std::min(source.x + source.power, _save->getMapSizeX() - 1);
+	int y2 = std::min(source.y + source.power, _save->getMapSizeY() - 1);
+	if (x1 > x2 || y1 > y2)
+		return;
+
+	for (int y = y1; y <= y2; ++y)
+	{
+		for (int x = x1; x <= x2; ++x)
+		{
+			_dirty[y * _save->getMapSizeX() + x] = 1;
+		}
+	}
+	_minX = std::min(_minX, x1);
+	_minY = std::min(_minY, y1);
+	_maxX = std::max(_maxX, x2);
+	_maxY = std::max(_maxY, y2);
+}
+
+/**
+ * Adds the light of a source to the dirty area. A tile keeps the brightest light that reaches it.
+ * @param source The light source.
+ */
+void LightLayer::addLight(const LightSource &source)
+{
+	int x1 = std::max(source.x - source.power, _minX);
+	int y1 = std::max(source.y - source.power, _minY);
+	int x2 = std::min(source.x + source.power, _maxX);
+	int y2 = std::min(source.y + source.power, _maxY);
+
+	for (int y = y1; y <= y2; ++y)
+	{
+		for (int x = x1; x <= x2; ++x)
+		{
+			int dx = x - source.x;
+			int dy = y - source.y;
+			int light = source.power - int(floor(sqrt(float(dx*dx + dy*dy)) + 0.5));
+			int index = y * _save->getMapSizeX() + x;
+			if (_light[index] < light)
+				_light[index] = light;
+		}
+	}
+}
+
+/**
+ * Replaces the light sources of this layer. Sources are matched by their key,
+ * and any source that appeared, disappeared, moved or changed power
+ * has the tiles within its old and new reach lit again from all sources.
+ * The very first update lights the whole layer.
+ * @param sources The light sources, by a key that identifies them between updates.
+ */
+void LightLayer::update(const std::map<int, LightSource> &sources)
+{
+	if (!_lit)
+	{
+		_minX = 0;
+		_minY = 0;
+		_maxX = _save->getMapSizeX() - 1;
+		_maxY = _save->getMapSizeY() - 1;
+		std::fill(_dirty.begin(), _dirty.end(), 1);
+		_lit = true;
+	}
+	else
+	{
+		_minX = _save->getMapSizeX();
+		_minY = _save->getMapSizeY();
+		_maxX = -1;
+		_maxY = -1;
+		std::map<int, LightSource>::const_iterator i = _sources.begin();
+		std::map<int, LightSource>::const_iterator j = sources.begin();
+		while (i != _sources.end() || j != sources.end())
+		{
+			if (j == sources.end() || (i != _sources.end() && i->first < j->first))
+			{
+				// removed
+				markDirty(i->second);
+				++i;
+			}
+			else if (i == _sources.end() || j->first < i->first)
+			{
+				// added
+				markDirty(j->second);
+				++j;
+			}
+			else
+			{
+				if (i->second != j->second)
+				{
+					markDirty(i->second);
+					markDirty(j->second);
+				}
+				++i;
+				++j;
+			}
+		}
+	}
+	_sources = sources;
+
+	if (_maxX < _minX || _maxY < _minY)
+		return;
+
+	for (int y = _minY; y <= _maxY; ++y)
+	{
+		for (int x = _minX; x <= _maxX; ++x)
+		{
+			_light[y * _save->getMapSizeX() + x] = 0;
+		}
+	}
+	for (std::map<int, LightSource>::const_iterator i = _sources.begin(); i != _sources.end(); ++i)
+	{
+		addLight(i->second);
+	}
+
+	// light does not care about levels, every tile in the column gets the same
+	int *light = _save->getTileStore()->getLight();
+	int *lastLight = _save->getTileStore()->getLastLight();
+	for (int y = _minY; y <= _maxY; ++y)
+	{
+		for (int x = _minX; x <= _maxX; ++x)
+		{
+			int index = y * _save->getMapSizeX() + x;
+			if (!_dirty[index])
+				continue;
+			_dirty[index] = 0;
+			for (int z = 0; z < _save->getMapSizeZ(); ++z)
+			{
+				int t = _save->getTileIndex(Position(x, y, z)) * TileStore::LIGHTLAYERS + _layer;
+				light[t] = _light[index];
+				lastLight[t] = 0;
+			}
+		}
+	}
+}
+
+/**
+ * Gets the number of light sources on this layer.
+ * @return Number of light sources.
+ */
+size_t LightLayer::getSourceCount() const
+{
+	return _sources.size();
+}
+
+}
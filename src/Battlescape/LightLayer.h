@@ -0,0 +1,77 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_LIGHTLAYER_H
+#define OPENXCOM_LIGHTLAYER_H
+
+#include <map>
+#include <vector>
+#include <SDL_types.h>
+
+namespace OpenXcom
+{
+
+class SavedBattleGame;
+
+/**
+ * A point light on the battlescape: lights a square around a map column,
+ * losing one level of power per tile of distance, on every level of the map.
+ */
+struct LightSource
+{
+	int x, y;
+	int power;
+	LightSource() : x(0), y(0), power(0) {}
+	LightSource(int x_, int y_, int power_) : x(x_), y(y_), power(power_) {}
+	bool operator==(const LightSource &other) const { return x == other.x && y == other.y && power == other.power; }
+	bool operator!=(const LightSource &other) const { return !(*this == other); }
+};
+
+/**
+ * Keeps track of the light sources of one lighting layer of the battlescape.
+ * When the sources change, only the tiles in reach of the sources that were added,
+ * moved, changed or removed are lit again. The rest of the layer is left alone.
+ */
+class LightLayer
+{
+private:
+	SavedBattleGame *_save;
+	int _layer;
+	bool _lit;
+	std::map<int, LightSource> _sources;
+	std::vector<Uint8> _dirty;
+	std::vector<int> _light;
+	int _minX, _minY, _maxX, _maxY;
+	/// Marks the reach of a light source to be lit again.
+	void markDirty(const LightSource &source);
+	/// Adds the light of a source to the dirty area.
+	void addLight(const LightSource &source);
+public:
+	/// Creates a light layer.
+	LightLayer(SavedBattleGame *save, int layer);
+	/// Cleans up the light layer.
+	~LightLayer();
+	/// Replaces the light sources, relighting what changed.
+	void update(const std::map<int, LightSource> &sources);
+	/// Gets the number of light sources.
+	size_t getSourceCount() const;
+};
+
+}
+
+#endif
@@ -1078,8 +1078,8 @@ void Map::cacheUnit(BattleUnit *unit)
 			}
 			unitSprite->setBattleUnit(unit, i);
 
-			BattleItem *rhandItem = unit->getItem("STR_RIGHT_HAND");
-			BattleItem *lhandItem = unit->getItem("STR_LEFT_HAND");
+			BattleItem *rhandItem = unit->getItem(BattleUnit::getRightHandSlot());
+			BattleItem *lhandItem = unit->getItem(BattleUnit::getLeftHandSlot());
 			if (rhandItem)
 			{
 				unitSprite->setBattleItem(rhandItem);
@@ -17,7 +17,9 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <list>
+#include <algorithm>
 #include "Pathfinding.h"
+#include "BattleProfiler.h"
 #include "PathfindingNode.h"
 #include "PathfindingOpenSet.h"
 #include "../Savegame/SavedBattleGame.h"
@@ -39,7 +41,7 @@ namespace OpenXcom
  * Sets up a Pathfinding.
  * @param save pointer to SavedBattleGame object.
  */
-Pathfinding::Pathfinding(SavedBattleGame *save) : _save(save), _nodes(), _unit(0), _pathPreviewed(false)
+Pathfinding::Pathfinding(SavedBattleGame *save) : _save(save), _nodes(), _search(0), _stepCache(0), _unit(0), _pathPreviewed(false)
 {
 	_size = _save->getMapSizeXYZ();
 	// Initialize one node per tile
@@ -68,7 +70,245 @@ Pathfinding::~Pathfinding()
  */
 PathfindingNode *Pathfinding::getNode(const Position& pos)
 {
-	return &_nodes[_save->getTileIndex(pos)];
+	PathfindingNode *node = &_nodes[_save->getTileIndex(pos)];
+	// nodes left over from an older search are reset the first time they are looked at
+	if (node->getSearch() != _search)
+	{
+		node->reset(_search);
+	}
+	return node;
+}
+
+/**
+ * Starts a new search. Instead of resetting every node on the map,
+ * the search counter is increased so old nodes are recognised by getNode().
+ */
+void Pathfinding::newSearch()
+{
+	++_search;
+	if (_search < 0)
+	{
+		// wrapped around, old nodes could look current again
+		_search = 1;
+		for (std::vector<PathfindingNode>::iterator it = _nodes.begin(); it != _nodes.end(); ++it)
+		{
+			it->reset(0);
+		}
+	}
+	_openSet.clear();
+}
+
+/**
+ * Makes sure the cached step costs can be used by a unit about to search for a path.
+ * Step costs only depend on the unit moving through how it moves, how big it is and
+ * which side it's on, so every kind of mover has its own cache, shared by all the
+ * units of that kind. Switching to another unit of the same kind only drops the costs
+ * around the old and new unit and target, as those are the only units treated
+ * differently from everyone else. Units that moved, died, knelt, changed sides or
+ * became visible since the cache was last used drop the costs around their old and
+ * new positions, and changes to the terrain drop the costs of every cache.
+ * @param unit The unit moving.
+ * @param target The target unit.
+ * @param missile Is this a guided missile?
+ */
+void Pathfinding::prepareStepCosts(BattleUnit *unit, BattleUnit *target, bool missile)
+{
+	int key = unit->getFaction();
+	key = key * 4 + unit->getArmor()->getSize();
+	key = key * 4 + unit->getArmor()->getMovementType();
+	key = key * 4 + _movementType;
+	key = key * 2 + (missile ? 1 : 0);
+	std::map<int, StepCostCache>::iterator i = _stepCaches.find(key);
+	if (i == _stepCaches.end())
+	{
+		StepCostCache cache;
+		cache.costs.resize(_size * 10);
+		cache.stamps.resize(_size, 0);
+		cache.generation = 1;
+		cache.unit = 0;
+		cache.target = 0;
+		i = _stepCaches.insert(std::make_pair(key, cache)).first;
+	}
+	StepCostCache &cache = i->second;
+	_stepCache = &cache;
+
+	std::vector<BattleUnit*> *units = _save->getUnits();
+	if (units->size() != cache.unitStates.size())
+	{
+		cache.unitStates.resize(units->size());
+		for (size_t j = 0; j < units->size(); ++j)
+		{
+			cache.unitStates[j].unit = 0;
+		}
+		invalidateStepCosts(cache);
+	}
+	// the old unit and target go by where the cache last saw them
+	if (unit != cache.unit || target != cache.target)
+	{
+		invalidateStepCosts(cache, cache.unit);
+		invalidateStepCosts(cache, cache.target);
+	}
+	for (size_t j = 0; j < units->size(); ++j)
+	{
+		BattleUnit *bu = units->at(j);
+		UnitState &state = cache.unitStates[j];
+		if (state.unit != bu || state.pos != bu->getPosition() || state.height != bu->getHeight() + bu->getFloatHeight()
+			|| state.faction != bu->getFaction() || state.out != bu->isOut() || state.visible != bu->getVisible())
+		{
+			if (state.unit)
+			{
+				invalidateStepCosts(cache, state.pos, state.size);
+			}
+			state.unit = bu;
+			state.pos = bu->getPosition();
+			state.size = bu->getArmor()->getSize();
+			state.height = bu->getHeight() + bu->getFloatHeight();
+			state.faction = bu->getFaction();
+			state.out = bu->isOut();
+			state.visible = bu->getVisible();
+			invalidateStepCosts(cache, state.pos, state.size);
+		}
+	}
+	if (unit != cache.unit || target != cache.target)
+	{
+		invalidateStepCosts(cache, unit);
+		invalidateStepCosts(cache, target);
+		cache.unit = unit;
+		cache.target = target;
+	}
+}
+
+/**
+ * Gets the TU cost of one step, like getTUCost, but every step is only worked out
+ * once until something on the map around it changes.
+ * @param startPosition The position to start from.
+ * @param direction The direction we are facing.
+ * @param endPosition The position we want to reach.
+ * @param unit The unit moving.
+ * @param target The target unit.
+ * @param missile Is this a guided missile?
+ * @return TU cost or 255 if movement impossible
+ */
+int Pathfinding::getStepCost(const Position &startPosition, int direction, Position *endPosition, BattleUnit *unit, BattleUnit *target, bool missile)
+{
+	// strafing costs depend on the facing of the unit, don't bother caching those
+	if (_save->getStrafeSetting() && _strafeMove)
+	{
+		return getTUCost(startPosition, direction, endPosition, unit, target, missile);
+	}
+
+	int index = _save->getTileIndex(startPosition);
+	if (_stepCache->stamps[index] != _stepCache->generation)
+	{
+		for (int i = 0; i < 10; ++i)
+		{
+			_stepCache->costs[index * 10 + i].cost = -1;
+		}
+		_stepCache->stamps[index] = _stepCache->generation;
+	}
+	StepCost &step = _stepCache->costs[index * 10 + direction];
+	if (step.cost == -1)
+	{
+		int cost = getTUCost(startPosition, direction, endPosition, unit, target, missile);
+		step.cost = cost;
+		step.dx = endPosition->x - startPosition.x;
+		step.dy = endPosition->y - startPosition.y;
+		step.dz = endPosition->z - startPosition.z;
+		return cost;
+	}
+	*endPosition = startPosition + Position(step.dx, step.dy, step.dz);
+	return step.cost;
+}
+
+/**
+ * Forgets the cached step costs of one cache that could have been affected by a change
+ * to some tiles. A step looks at the tiles up to two tiles around its start, one level up,
+ * and down to the floor below its destination.
+ * @param cache The step cost cache.
+ * @param pos Position of the tile that changed.
+ * @param size Size of the changed area, for large units, or 0 for none.
+ */
+void Pathfinding::invalidateStepCosts(StepCostCache &cache, const Position &pos, int size)
+{
+	if (size <= 0)
+		return;
+	int x1 = std::max(pos.x - 2, 0);
+	int y1 = std::max(pos.y - 2, 0);
+	int z1 = std::max(pos.z - 1, 0);
+	int x2 = std::min(pos.x + size + 1, _save->getMapSizeX() - 1);
+	int y2 = std::min(pos.y + size + 1, _save->getMapSizeY() - 1);
+	for (int z = z1; z < _save->getMapSizeZ(); ++z)
+	{
+		for (int y = y1; y <= y2; ++y)
+		{
+			for (int x = x1; x <= x2; ++x)
+			{
+				cache.stamps[_save->getTileIndex(Position(x, y, z))] = 0;
+			}
+		}
+	}
+}
+
+/**
+ * Forgets all the cached step costs of one cache.
+ * @param cache The step cost cache.
+ */
+void Pathfinding::invalidateStepCosts(StepCostCache &cache)
+{
+	++cache.generation;
+	if (cache.generation == 0)
+	{
+		// wrapped around, old stamps could look current again
+		std::fill(cache.stamps.begin(), cache.stamps.end(), 0);
+		cache.generation = 1;
+	}
+}
+
+/**
+ * Forgets the cached step costs of one cache around a unit,
+ * at the position the cache last saw it.
+ * @param cache The step cost cache.
+ * @param unit The unit, or 0 for none.
+ */
+void Pathfinding::invalidateStepCosts(StepCostCache &cache, BattleUnit *unit)
+{
+	if (unit == 0)
+		return;
+	for (std::vector<UnitState>::iterator i = cache.unitStates.begin(); i != cache.unitStates.end(); ++i)
+	{
+		if (i->unit == unit)
+		{
+			invalidateStepCosts(cache, i->pos, i->size);
+			return;
+		}
+	}
+	invalidateStepCosts(cache, unit->getPosition(), unit->getArmor()->getSize());
+}
+
+/**
+ * Forgets the cached step costs that could have been affected by a change to some tiles,
+ * like a door opening, a fire starting or a unit arriving or leaving.
+ * @param pos Position of the tile that changed.
+ * @param size Size of the changed area, for large units.
+ */
+void Pathfinding::invalidateStepCosts(const Position &pos, int size)
+{
+	for (std::map<int, StepCostCache>::iterator i = _stepCaches.begin(); i != _stepCaches.end(); ++i)
+	{
+		invalidateStepCosts(i->second, pos, size);
+	}
+}
+
+/**
+ * Forgets all cached step costs, for when too much of the map changed to keep track,
+ * like after an explosion or at the start of a new turn.
+ */
+void Pathfinding::invalidateStepCosts()
+{
+	for (std::map<int, StepCostCache>::iterator i = _stepCaches.begin(); i != _stepCaches.end(); ++i)
+	{
+		invalidateStepCosts(i->second);
+	}
 }
 
 /**
@@ -81,6 +321,7 @@ PathfindingNode *Pathfinding::getNode(const Position& pos)
 
 void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleUnit *target, int maxTUCost)
 {
+	BattleProfiler::Scope profile(BattleProfiler::PROFILE_PATHFINDING);
 	_totalTUCost = 0;
 	_path.clear();
 	// i'm DONE with these out of bounds errors.
@@ -179,16 +420,15 @@ void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleUnit *
  */
 bool Pathfinding::aStarPath(const Position &startPosition, const Position &endPosition, BattleUnit *target, bool sneak, int maxTUCost)
 {
-	// reset every node, so we have to check them all
-	for (std::vector<PathfindingNode>::iterator it = _nodes.begin(); it != _nodes.end(); ++it)
-		it->reset();
+	newSearch();
+	bool missile = (target && maxTUCost == 10000);
+	prepareStepCosts(_unit, target, missile);
 
 	// start position is the first one in our "open" list
 	PathfindingNode *start = getNode(startPosition);
 	start->connect(0, 0, 0, endPosition);
-	PathfindingOpenSet openList;
+	PathfindingOpenSet &openList = _openSet;
 	openList.push(start);
-	bool missile = (target && maxTUCost == 10000);
 	// if the open list is empty, we've reached the end
 	while(!openList.empty())
 	{
@@ -211,7 +451,7 @@ bool Pathfinding::aStarPath(const Position &startPosition, const Position &endPo
 		for (int direction = 0; direction < 10; direction++)
 		{
 			Position nextPos;
-			int tuCost = getTUCost(currentPos, direction, &nextPos, _unit, target, missile);
+			int tuCost = getStepCost(currentPos, direction, &nextPos, _unit, target, missile);
 			if (tuCost >= 255) // Skip unreachable / blocked
 				continue;
 			if (sneak && _save->getTile(nextPos)->getVisible()) tuCost *= 2; // avoid being seen
@@ -1043,15 +1283,15 @@ bool Pathfinding::bresenhamPath(const Position& origin, const Position& target,
  */
 std::vector<int> Pathfinding::findReachable(BattleUnit *unit, int tuMax)
 {
+	BattleProfiler::Scope profile(BattleProfiler::PROFILE_PATHFINDING);
 	const Position &start = unit->getPosition();
 
-	for (std::vector<PathfindingNode>::iterator it = _nodes.begin(); it != _nodes.end(); ++it)
-	{
-		it->reset();
-	}
+	newSearch();
+	prepareStepCosts(unit, 0, false);
+
 	PathfindingNode *startNode = getNode(start);
 	startNode->connect(0, 0, 0);
-	PathfindingOpenSet unvisited;
+	PathfindingOpenSet &unvisited = _openSet;
 	unvisited.push(startNode);
 	std::vector<PathfindingNode*> reachable;
 	while (!unvisited.empty())
@@ -1063,7 +1303,7 @@ std::vector<int> Pathfinding::findReachable(BattleUnit *unit, int tuMax)
 		for (int direction = 0; direction < 10; direction++)
 		{
 			Position nextPos;
-			int tuCost = getTUCost(currentPos, direction, &nextPos, unit, 0, false);
+			int tuCost = getStepCost(currentPos, direction, &nextPos, unit, 0, false);
 			if (tuCost == 255) // Skip unreachable / blocked
 				continue;
 			if (currentNode->getTUCost(false) + tuCost > tuMax) // Run out of TUs
@@ -20,8 +20,11 @@
 #define OPENXCOM_PATHFINDING_H
 
 #include <vector>
+#include <map>
+#include <SDL_types.h>
 #include "Position.h"
 #include "../Ruleset/MapData.h"
+#include "PathfindingOpenSet.h"
 
 namespace OpenXcom
 {
@@ -41,6 +44,45 @@ private:
 	SavedBattleGame *_save;
 	std::vector<PathfindingNode> _nodes;
 	int _size;
+	int _search;
+	PathfindingOpenSet _openSet;
+	/// Cached result of getTUCost for one direction from one tile.
+	struct StepCost
+	{
+		Sint16 cost;
+		Sint8 dx, dy, dz;
+	};
+	/// What a unit standing on the map looked like when the step costs were cached.
+	struct UnitState
+	{
+		BattleUnit *unit;
+		Position pos;
+		int size, height, faction;
+		bool out, visible;
+	};
+	/// Cached step costs shared by every unit that moves the same way.
+	struct StepCostCache
+	{
+		std::vector<StepCost> costs;
+		std::vector<Uint32> stamps;
+		Uint32 generation;
+		std::vector<UnitState> unitStates;
+		BattleUnit *unit, *target;
+	};
+	std::map<int, StepCostCache> _stepCaches;
+	StepCostCache *_stepCache;
+	/// Starts a new search, which invalidates the state of every node.
+	void newSearch();
+	/// Forgets all the cached step costs of one cache.
+	void invalidateStepCosts(StepCostCache &cache);
+	/// Forgets the cached step costs of one cache around a tile.
+	void invalidateStepCosts(StepCostCache &cache, const Position &pos, int size);
+	/// Forgets the cached step costs of one cache around a unit.
+	void invalidateStepCosts(StepCostCache &cache, BattleUnit *unit);
+	/// Makes sure the cached step costs are valid for the unit about to search.
+	void prepareStepCosts(BattleUnit *unit, BattleUnit *target, bool missile);
+	/// Gets the TU cost of one step, from the cache if possible.
+	int getStepCost(const Position &startPosition, int direction, Position *endPosition, BattleUnit *unit, BattleUnit *target, bool missile);
 	std::vector<int> _path;
 	MovementType _movementType;
 	/// Gets the node at certain position.
@@ -81,6 +123,10 @@ public:
 	int dequeuePath();
 	/// Get's the TU cost to move from 1 tile to the other.
 	int getTUCost(const Position &startPosition, const int direction, Position *endPosition, BattleUnit *unit, BattleUnit *target, bool missile);
+	/// Forgets the cached step costs around a tile that changed.
+	void invalidateStepCosts(const Position &pos, int size = 1);
+	/// Forgets all cached step costs.
+	void invalidateStepCosts();
 	/// Abort the current path.
 	void abortPath();
 	bool getStrafeMove() const;
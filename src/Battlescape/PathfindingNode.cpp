@@ -27,7 +27,7 @@ namespace OpenXcom
  * Sets up a PathfindingNode.
  * @param pos Position.
  */
-PathfindingNode::PathfindingNode(Position pos) : _pos(pos), _openentry(0)
+PathfindingNode::PathfindingNode(Position pos) : _pos(pos), _search(0), _checked(false), _open(false), _openKey(0)
 {
 
 }
@@ -50,11 +50,13 @@ const Position &PathfindingNode::getPosition() const
 }
 /**
  * Reset node.
+ * @param search The search the node is now part of.
  */
-void PathfindingNode::reset()
+void PathfindingNode::reset(int search)
 {
+	_search = search;
 	_checked = false;
-	_openentry = 0;
+	_open = false;
 }
 
 /**
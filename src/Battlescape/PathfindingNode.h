@@ -25,7 +25,6 @@ namespace OpenXcom
 {
 
 class PathfindingOpenSet;
-struct OpenSetEntry;
 
 /**
  * A class that holds pathfinding info for a certain node on the map.
@@ -34,14 +33,16 @@ class PathfindingNode
 {
 private:
 	Position _pos;
+	int _search;
 	bool _checked;
 	int _tuCost;
 	PathfindingNode* _prevNode;
 	int _prevDir;
 	/// Approximate cost to reach goal position.
 	int _tuGuess;
-	// Invasive field needed by PathfindingOpenSet
-	OpenSetEntry *_openentry;
+	// Invasive fields needed by PathfindingOpenSet
+	bool _open;
+	int _openKey;
 	friend class PathfindingOpenSet;
 public:
 	/// Creates a new PathfindingNode class
@@ -50,8 +51,10 @@ public:
 	~PathfindingNode();
 	/// Get the node position
 	const Position &getPosition() const;
-	/// Reset node.
-	void reset();
+	/// Reset node for a new search.
+	void reset(int search);
+	/// Get the search this node was last reset for.
+	int getSearch() const { return _search; }
 	/// is checked?
 	bool isChecked() const;
 	/// Mark as checked
@@ -65,7 +68,7 @@ public:
 	/// get previous walking direction
 	int getPrevDir() const;
 	/// Is this node already in a PathfindingOpenSet?
-	bool inOpenSet() const { return (_openentry != 0); }
+	bool inOpenSet() const { return _open; }
 	/// Get approximate cost to reach target position.
 	int getTUGuess() const { return _tuGuess; }
 	/// Connect to previous node along the path.
@@ -24,27 +24,33 @@ namespace OpenXcom
 {
 
 /**
- * Cleans up all the entries still in set.
+ * Creates an empty set.
+ */
+PathfindingOpenSet::PathfindingOpenSet() : _min(0), _max(0), _size(0)
+{
+
+}
+
+/**
+ * Cleans up the set.
  */
 PathfindingOpenSet::~PathfindingOpenSet()
 {
-	while (!_queue.empty())
-	{
-		delete _queue.top();
-		_queue.pop();
-	}
+
 }
 
 /**
- * Keep removing all discarded entries that have come to the top of the queue.
+ * Empties all the buckets used by the last search, keeping their memory around.
  */
-void PathfindingOpenSet::removeDiscarded()
+void PathfindingOpenSet::clear()
 {
-	while (!_queue.empty() && !_queue.top()->_node)
+	for (size_t i = 0; i < _buckets.size() && i <= _max; ++i)
 	{
-		delete _queue.top();
-		_queue.pop();
+		_buckets[i].clear();
 	}
+	_min = 0;
+	_max = 0;
+	_size = 0;
 }
 
 /**
@@ -55,14 +61,22 @@ void PathfindingOpenSet::removeDiscarded()
 PathfindingNode *PathfindingOpenSet::pop()
 {
 	assert(!empty());
-	PathfindingNode *nd = _queue.top()->_node;
-	delete _queue.top();
-	_queue.pop();
-	nd->_openentry = 0;
-
-	// Discarded entries might be visible now.
-	removeDiscarded();
-	return nd;
+	while (true)
+	{
+		while (_buckets[_min].empty())
+		{
+			++_min;
+		}
+		PathfindingNode *nd = _buckets[_min].back();
+		_buckets[_min].pop_back();
+		// nodes pushed again with a better cost leave their old entry behind, skip those
+		if (nd->_open && nd->_openKey == (int)_min)
+		{
+			nd->_open = false;
+			--_size;
+			return nd;
+		}
+	}
 }
 
 /**
@@ -73,14 +87,27 @@ PathfindingNode *PathfindingOpenSet::pop()
  */
 void PathfindingOpenSet::push(PathfindingNode *node)
 {
-	OpenSetEntry *entry = new OpenSetEntry;
-	entry->_node = node;
-	entry->_cost = node->getTUCost(false) + node->getTUGuess();
-	if (node->_openentry)
-		node->_openentry->_node = 0;
-	node->_openentry = entry;
-	_queue.push(entry);
+	size_t key = node->getTUCost(false) + node->getTUGuess();
+	if (key >= _buckets.size())
+	{
+		_buckets.resize(key + 1);
+	}
+	_buckets[key].push_back(node);
+	if (!node->_open)
+	{
+		++_size;
+	}
+	node->_open = true;
+	node->_openKey = key;
+	// the guess is not always consistent, so a key can be lower than the last one popped
+	if (key < _min || _size == 1)
+	{
+		_min = key;
+	}
+	if (key > _max)
+	{
+		_max = key;
+	}
 }
 
-
 }
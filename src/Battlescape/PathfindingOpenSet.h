@@ -19,57 +19,38 @@
 #ifndef OPENXCOM_PATHFINDINGOPENSET_H
 #define OPENXCOM_PATHFINDINGOPENSET_H
 
-#include <queue>
+#include <cstddef>
+#include <vector>
 
 namespace OpenXcom
 {
 
 class PathfindingNode;
 
-struct OpenSetEntry
-{
-	int _cost;
-	PathfindingNode *_node;
-};
-
-/**
- * Helper class to compare entries through pointers.
- */
-class EntryCompare
-{
-public:
- 	/**
-	 * Compare entries @a *a and @a *b.
-         * @param a Pointer to first entry.
-         * @param b Pointer to second entry.
-	 * @return true If entry @a *b must come before @a *a.
-	 */
-	bool operator()(OpenSetEntry *a, OpenSetEntry *b) const
-	{
-		return b->_cost < a->_cost;
-	}
-};
-
 /**
  * A class that holds references to the nodes to be examined in pathfinding.
+ * TU costs are small integers, so the nodes are kept in one bucket per cost
+ * instead of a heap. Buckets keep their memory between searches.
  */
 class PathfindingOpenSet
 {
 public:
-	/// Cleanup the set and free allocated memory.
+	/// Create an empty set.
+	PathfindingOpenSet();
+	/// Cleanup the set.
 	~PathfindingOpenSet();
+	/// Empty the set for a new search.
+	void clear();
 	/// Get the next node to check.
 	PathfindingNode *pop();
 	/// Add a node in the set.
 	void push(PathfindingNode *node);
 	/// Is the set empty?
-	bool empty() const { return _queue.empty(); }
+	bool empty() const { return _size == 0; }
 
 private:
-	std::priority_queue<OpenSetEntry*, std::vector<OpenSetEntry*>, EntryCompare> _queue;
-
-	/// Remove reachable discarded entries.
-	void removeDiscarded();
+	std::vector<std::vector<PathfindingNode*> > _buckets;
+	size_t _min, _max, _size;
 };
 
 }
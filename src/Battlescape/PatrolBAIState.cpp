@@ -30,6 +30,7 @@
 #include "../Engine/Options.h"
 #include "../Ruleset/Armor.h"
 #include "../Savegame/Tile.h"
+#include "../Ruleset/RulesetCache.h"
 
 namespace OpenXcom
 {
@@ -96,6 +97,35 @@ void PatrolBAIState::save(YAML::Emitter &out) const
 	out << YAML::EndMap;
 }
 
+/**
+ * Loads the AI state from a record in a binary save.
+ * @param in Record reader.
+ */
+void PatrolBAIState::loadBinary(CacheReader &in)
+{
+	int fromnodeID, tonodeID;
+	in >> fromnodeID >> tonodeID;
+	if (fromnodeID != -1)
+	{
+		_fromNode = _game->getNodes()->at(fromnodeID);
+	}
+	if (tonodeID != -1)
+	{
+		_toNode = _game->getNodes()->at(tonodeID);
+	}
+}
+
+/**
+ * Saves the AI state to a record in a binary save.
+ * @param out Record writer.
+ */
+void PatrolBAIState::saveBinary(CacheWriter &out) const
+{
+	out << std::string("PATROL");
+	out << (_fromNode ? _fromNode->getID() : -1);
+	out << (_toNode ? _toNode->getID() : -1);
+}
+
 /**
  * Enters the current AI state.
  */
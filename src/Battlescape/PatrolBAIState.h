@@ -47,6 +47,10 @@ public:
 	void load(const YAML::Node& node);
 	/// Saves the AI state to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the AI state from a binary save record.
+	void loadBinary(CacheReader &in);
+	/// Saves the AI state to a binary save record.
+	void saveBinary(CacheWriter &out) const;
 	/// Enters the state.
 	void enter();
 	/// Exits the state.
@@ -84,7 +84,7 @@ int Projectile::calculateTrajectory(double accuracy)
 	{
 		offset = 16;
 	}
-	else if(_action.weapon == _action.weapon->getOwner()->getItem("STR_LEFT_HAND") && !_action.weapon->getRules()->isTwoHanded())
+	else if(_action.weapon == _action.weapon->getOwner()->getItem(BattleUnit::getLeftHandSlot()) && !_action.weapon->getRules()->isTwoHanded())
 	{
 		offset = 8;
 	}
@@ -0,0 +1,252 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "SightCache.h"
+#include <algorithm>
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/BattleUnit.h"
+#include "../Savegame/Tile.h"
+#include "../Ruleset/Armor.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates a sight cache with no lines in it.
+ * @param save Pointer to the battle.
+ */
+SightCache::SightCache(SavedBattleGame *save) : _save(save), _tileChanges(Tile::getSightChanges()), _hits(0), _misses(0)
+{
+}
+
+/**
+ *
+ */
+SightCache::~SightCache()
+{
+}
+
+/**
+ * Compares the tiles and units to how they were when last
+ * checked, and forgets the lines that might not be the same
+ * anymore: all of them if a tile has changed, or the ones
+ * around any unit that has moved, changed height or gone down.
+ */
+void SightCache::checkChanges()
+{
+	if (_tileChanges != Tile::getSightChanges())
+	{
+		_lines.clear();
+		_tileChanges = Tile::getSightChanges();
+	}
+	std::vector<BattleUnit*> *units = _save->getUnits();
+	for (size_t i = 0; i < units->size(); ++i)
+	{
+		UnitState state;
+		state.unit = units->at(i);
+		state.tile = state.unit->getTile();
+		state.pos = state.unit->getPosition();
+		state.height = state.unit->getHeight();
+		state.floatHeight = state.unit->getFloatHeight();
+		state.out = state.unit->isOut();
+		if (i >= _units.size())
+		{
+			_units.push_back(state);
+			forget(state);
+		}
+		else
+		{
+			UnitState &old = _units[i];
+			if (old.unit != state.unit || old.tile != state.tile || old.pos != state.pos || old.height != state.height || old.floatHeight != state.floatHeight || old.out != state.out)
+			{
+				forget(old);
+				forget(state);
+				old = state;
+			}
+		}
+	}
+}
+
+/**
+ * Forgets all the lines that pass close enough to
+ * a unit for it to block them, or be one of their ends.
+ * @param state Where the unit is or was.
+ */
+void SightCache::forget(const UnitState &state)
+{
+	int size = state.unit->getArmor()->getSize();
+	const Position &pos = state.pos;
+	for (std::map<std::pair<int, int>, Line>::iterator i = _lines.begin(); i != _lines.end();)
+	{
+		const Line &line = i->second;
+		// the unit's head may stick up into the tile above
+		if (pos.x + size - 1 >= line.min.x && pos.x <= line.max.x &&
+			pos.y + size - 1 >= line.min.y && pos.y <= line.max.y &&
+			pos.z + 1 >= line.min.z && pos.z <= line.max.z)
+		{
+			_lines.erase(i++);
+		}
+		else
+		{
+			++i;
+		}
+	}
+}
+
+/**
+ * Finds what's known about the line from a unit's eyes to
+ * the unit on a tile, as long as neither has changed since.
+ * @param viewer The unit looking.
+ * @param origin The viewer's eye voxel.
+ * @param tile The tile with the unit being looked at.
+ * @param create Whether to start a new line if there's none.
+ * @return Pointer to the line, or 0 if there's none.
+ */
+SightCache::Line *SightCache::find(BattleUnit *viewer, const Position &origin, Tile *tile, bool create)
+{
+	checkChanges();
+	std::pair<int, int> key(viewer->getId(), tile->getUnit()->getId());
+	std::map<std::pair<int, int>, Line>::iterator i = _lines.find(key);
+	if (i != _lines.end() && i->second.origin == origin && i->second.target == tile->getPosition())
+	{
+		return &i->second;
+	}
+	if (!create)
+	{
+		return 0;
+	}
+
+	Line &line = _lines[key];
+	Position eye(origin.x / 16, origin.y / 16, origin.z / 24);
+	const Position &target = tile->getPosition();
+	line.origin = origin;
+	line.target = target;
+	// the rays stay between the two tiles, give or take the width of a unit
+	line.min = Position(std::min(eye.x, target.x) - 1, std::min(eye.y, target.y) - 1, std::min(eye.z, target.z) - 1);
+	line.max = Position(std::max(eye.x, target.x) + 1, std::max(eye.y, target.y) + 1, std::max(eye.z, target.z) + 1);
+	line.targetable = false;
+	line.targetableKnown = false;
+	line.seen = false;
+	line.seenKnown = false;
+	return &line;
+}
+
+/**
+ * Looks up if a unit can target the unit on a tile from its eyes,
+ * as worked out by TileEngine::canTargetUnit.
+ * @param viewer The unit looking.
+ * @param origin The viewer's eye voxel.
+ * @param tile The tile with the unit being looked at.
+ * @param targetable Returns if the unit can be targeted.
+ * @param scanVoxel Returns the voxel it can be targeted at.
+ * @return True if it's known, false if it has to be traced.
+ */
+bool SightCache::getTargetable(BattleUnit *viewer, const Position &origin, Tile *tile, bool *targetable, Position *scanVoxel)
+{
+	Line *line = find(viewer, origin, tile, false);
+	if (line == 0 || !line->targetableKnown)
+	{
+		++_misses;
+		return false;
+	}
+	++_hits;
+	*targetable = line->targetable;
+	*scanVoxel = line->scanVoxel;
+	return true;
+}
+
+/**
+ * Remembers if a unit can target the unit on a tile from its eyes.
+ * @param viewer The unit looking.
+ * @param origin The viewer's eye voxel.
+ * @param tile The tile with the unit being looked at.
+ * @param targetable If the unit can be targeted.
+ * @param scanVoxel The voxel it can be targeted at.
+ */
+void SightCache::setTargetable(BattleUnit *viewer, const Position &origin, Tile *tile, bool targetable, const Position &scanVoxel)
+{
+	Line *line = find(viewer, origin, tile, true);
+	line->targetable = targetable;
+	line->targetableKnown = true;
+	line->scanVoxel = scanVoxel;
+}
+
+/**
+ * Looks up if a unit can see the unit on a tile through
+ * any smoke in the way, as worked out by TileEngine::visible.
+ * @param viewer The unit looking.
+ * @param origin The viewer's eye voxel.
+ * @param tile The tile with the unit being looked at.
+ * @param seen Returns if the unit is seen.
+ * @return True if it's known, false if it has to be traced.
+ */
+bool SightCache::getSeen(BattleUnit *viewer, const Position &origin, Tile *tile, bool *seen)
+{
+	Line *line = find(viewer, origin, tile, false);
+	if (line == 0 || !line->seenKnown)
+	{
+		++_misses;
+		return false;
+	}
+	++_hits;
+	*seen = line->seen;
+	return true;
+}
+
+/**
+ * Remembers if a unit can see the unit on a tile.
+ * @param viewer The unit looking.
+ * @param origin The viewer's eye voxel.
+ * @param tile The tile with the unit being looked at.
+ * @param seen If the unit is seen.
+ */
+void SightCache::setSeen(BattleUnit *viewer, const Position &origin, Tile *tile, bool seen)
+{
+	Line *line = find(viewer, origin, tile, true);
+	line->seen = seen;
+	line->seenKnown = true;
+}
+
+/**
+ * Returns how many lookups found the line already known.
+ * @return Number of hits.
+ */
+int SightCache::getHits() const
+{
+	return _hits;
+}
+
+/**
+ * Returns how many lookups had to trace the line.
+ * @return Number of misses.
+ */
+int SightCache::getMisses() const
+{
+	return _misses;
+}
+
+/**
+ * Starts counting hits and misses from zero.
+ */
+void SightCache::resetCounters()
+{
+	_hits = 0;
+	_misses = 0;
+}
+
+}
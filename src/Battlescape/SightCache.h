@@ -0,0 +1,95 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_SIGHTCACHE_H
+#define OPENXCOM_SIGHTCACHE_H
+
+#include <map>
+#include <vector>
+#include <utility>
+#include "Position.h"
+
+namespace OpenXcom
+{
+
+class SavedBattleGame;
+class BattleUnit;
+class Tile;
+
+/**
+ * Remembers the lines of sight traced from each unit's eyes to each
+ * other unit, so the same voxel rays aren't traced again and again
+ * while nothing has changed between them. A line is forgotten when
+ * either unit moves, or any unit moves, kneels or goes down anywhere
+ * around the line, and all of them when any tile changes shape or
+ * its smoke or fire changes.
+ */
+class SightCache
+{
+private:
+	/// What's known about the line between two units.
+	struct Line
+	{
+		Position origin, target, min, max;
+		bool targetable, targetableKnown, seen, seenKnown;
+		Position scanVoxel;
+	};
+	/// What a unit was like when last checked.
+	struct UnitState
+	{
+		BattleUnit *unit;
+		Tile *tile;
+		Position pos;
+		int height, floatHeight;
+		bool out;
+	};
+	SavedBattleGame *_save;
+	std::map<std::pair<int, int>, Line> _lines;
+	std::vector<UnitState> _units;
+	unsigned int _tileChanges;
+	int _hits, _misses;
+	/// Forgets the lines that anything has changed for.
+	void checkChanges();
+	/// Forgets the lines passing near a unit.
+	void forget(const UnitState &state);
+	/// Finds the line from a unit's eyes to a tile.
+	Line *find(BattleUnit *viewer, const Position &origin, Tile *tile, bool create);
+public:
+	/// Creates an empty sight cache.
+	SightCache(SavedBattleGame *save);
+	/// Cleans up the sight cache.
+	~SightCache();
+	/// Looks up if a unit can target the unit on a tile.
+	bool getTargetable(BattleUnit *viewer, const Position &origin, Tile *tile, bool *targetable, Position *scanVoxel);
+	/// Remembers if a unit can target the unit on a tile.
+	void setTargetable(BattleUnit *viewer, const Position &origin, Tile *tile, bool targetable, const Position &scanVoxel);
+	/// Looks up if a unit can see the unit on a tile.
+	bool getSeen(BattleUnit *viewer, const Position &origin, Tile *tile, bool *seen);
+	/// Remembers if a unit can see the unit on a tile.
+	void setSeen(BattleUnit *viewer, const Position &origin, Tile *tile, bool seen);
+	/// Gets the number of lines found in the cache.
+	int getHits() const;
+	/// Gets the number of lines that had to be traced.
+	int getMisses() const;
+	/// Clears the hit and miss counters.
+	void resetCounters();
+};
+
+}
+
+#endif
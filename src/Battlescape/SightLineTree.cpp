@@ -0,0 +1,260 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <map>
+#include <cstdlib>
+#include <algorithm>
+#include "SightLineTree.h"
+#include "TileEngine.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/Tile.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Builds the tree with one line towards every tile within maxDistance horizontally,
+ * on every level the map has (and one more, for eyes sticking into the level above).
+ * The lines are stepped exactly like TileEngine::calculateLine does it in tile space.
+ * @param save Pointer to the battle, used for its dimensions and tiles.
+ * @param tileEngine Pointer to the tile engine, used for the blockage checks.
+ * @param maxDistance Maximum horizontal view distance in tiles.
+ */
+SightLineTree::SightLineTree(SavedBattleGame *save, TileEngine *tileEngine, int maxDistance) : _maxDistance(maxDistance), _maxHeight(save->getMapSizeZ()), _width(maxDistance * 2 + 1), _sweep(0), _save(save), _tileEngine(tileEngine)
+{
+	_lookup.resize(_width * _width * (_maxHeight * 2 + 1), -1);
+
+	Node root;
+	root.x = root.y = root.z = 0;
+	root.parent = -1;
+	_nodes.push_back(root);
+
+	// child nodes indexed by parent and packed offset, only needed while building
+	std::map<std::pair<int, int>, int> children;
+
+	for (int dz = -_maxHeight; dz <= _maxHeight; ++dz)
+	{
+		for (int dy = -_maxDistance; dy <= _maxDistance; ++dy)
+		{
+			for (int dx = -_maxDistance; dx <= _maxDistance; ++dx)
+			{
+				if (dx*dx + dy*dy > _maxDistance*_maxDistance)
+					continue;
+
+				int x0 = 0, y0 = 0, z0 = 0;
+				int x1 = dx, y1 = dy, z1 = dz;
+				bool swap_xy = std::abs(y1 - y0) > std::abs(x1 - x0);
+				if (swap_xy)
+				{
+					std::swap(x0, y0);
+					std::swap(x1, y1);
+				}
+				bool swap_xz = std::abs(z1 - z0) > std::abs(x1 - x0);
+				if (swap_xz)
+				{
+					std::swap(x0, z0);
+					std::swap(x1, z1);
+				}
+				int delta_x = std::abs(x1 - x0);
+				int delta_y = std::abs(y1 - y0);
+				int delta_z = std::abs(z1 - z0);
+				int drift_xy = (delta_x / 2);
+				int drift_xz = (delta_x / 2);
+				int step_x = (x0 > x1) ? -1 : 1;
+				int step_y = (y0 > y1) ? -1 : 1;
+				int step_z = (z0 > z1) ? -1 : 1;
+				int y = y0, z = z0;
+				int current = 0;
+
+				for (int x = x0; x != (x1 + step_x); x += step_x)
+				{
+					int cx = x, cy = y, cz = z;
+					if (swap_xz) std::swap(cx, cz);
+					if (swap_xy) std::swap(cx, cy);
+
+					// the first point of every line is the eye itself, which is the root
+					if (cx != 0 || cy != 0 || cz != 0)
+					{
+						int key = ((cz + 128) << 16) | ((cy + 128) << 8) | (cx + 128);
+						std::map<std::pair<int, int>, int>::iterator i = children.find(std::make_pair(current, key));
+						if (i == children.end())
+						{
+							Node node;
+							node.x = cx;
+							node.y = cy;
+							node.z = cz;
+							node.parent = current;
+							_nodes.push_back(node);
+							children[std::make_pair(current, key)] = _nodes.size() - 1;
+							current = _nodes.size() - 1;
+						}
+						else
+						{
+							current = i->second;
+						}
+					}
+
+					drift_xy = drift_xy - delta_y;
+					drift_xz = drift_xz - delta_z;
+					if (drift_xy < 0)
+					{
+						y = y + step_y;
+						drift_xy = drift_xy + delta_x;
+					}
+					if (drift_xz < 0)
+					{
+						z = z + step_z;
+						drift_xz = drift_xz + delta_x;
+					}
+				}
+
+				_lookup[((dz + _maxHeight) * _width + (dy + _maxDistance)) * _width + (dx + _maxDistance)] = current;
+			}
+		}
+	}
+
+	_stamp.resize(_nodes.size(), 0);
+	_state.resize(_nodes.size(), NODE_UNKNOWN);
+}
+
+/**
+ * Cleans up the sight line tree.
+ */
+SightLineTree::~SightLineTree()
+{
+
+}
+
+/**
+ * Gets the node where the line towards a relative offset ends.
+ * @param offset Offset of the target tile from the eye.
+ * @return Node index, or -1 if the offset is out of range.
+ */
+int SightLineTree::getNode(const Position &offset) const
+{
+	if (offset.x < -_maxDistance || offset.x > _maxDistance
+		|| offset.y < -_maxDistance || offset.y > _maxDistance
+		|| offset.z < -_maxHeight || offset.z > _maxHeight)
+		return -1;
+	return _lookup[((offset.z + _maxHeight) * _width + (offset.y + _maxDistance)) * _width + (offset.x + _maxDistance)];
+}
+
+/**
+ * Starts a new sweep from an eye, forgetting everything known about the previous one.
+ * @param origin Position of the eye in tile space.
+ * @param seen Vector the eye tile gets added to, as it is the first point of every line.
+ */
+void SightLineTree::beginSweep(const Position &origin, std::vector<Position> *seen)
+{
+	_origin = origin;
+	++_sweep;
+	if (_sweep == 0)
+	{
+		// wrapped around, old stamps could look current again
+		std::fill(_stamp.begin(), _stamp.end(), 0);
+		_sweep = 1;
+	}
+	_stamp[0] = _sweep;
+	_state[0] = NODE_OPEN;
+	if (_save->getTile(origin))
+	{
+		seen->push_back(origin);
+	}
+}
+
+/**
+ * Evaluates the step from a node's parent into the node, the same way calculateLine does:
+ * a line stops in front of anything blocking more than 127, or stops on a big wall, which
+ * is still seen.
+ * @param node Node index, its parent must have been evaluated already in this sweep.
+ * @return The state of the node.
+ */
+Uint8 SightLineTree::evaluate(int node)
+{
+	int parent = _nodes[node].parent;
+	if (_state[parent] != NODE_OPEN)
+	{
+		return NODE_BLOCKED;
+	}
+	Tile *last = _save->getTile(_origin + Position(_nodes[parent].x, _nodes[parent].y, _nodes[parent].z));
+	Tile *current = _save->getTile(_origin + Position(_nodes[node].x, _nodes[node].y, _nodes[node].z));
+	if (current == 0)
+	{
+		return NODE_BLOCKED;
+	}
+	int vertical = _tileEngine->verticalBlockage(last, current, DT_NONE);
+	int result = _tileEngine->horizontalBlockage(last, current, DT_NONE);
+	if (result == -1)
+	{
+		if (vertical <= 127)
+		{
+			return NODE_WALL; // we hit a big wall
+		}
+		result = 0;
+	}
+	result += vertical;
+	return result > 127 ? NODE_BLOCKED : NODE_OPEN;
+}
+
+/**
+ * Traces the sight line from the current eye towards a tile.
+ * Every part of the line that was already traced in this sweep is not looked at again.
+ * @param target Position of the target tile.
+ * @param seen Vector the tiles seen for the first time in this sweep get added to.
+ * @return False if the target is too far away to be covered by the tree.
+ */
+bool SightLineTree::trace(const Position &target, std::vector<Position> *seen)
+{
+	int node = getNode(target - _origin);
+	if (node == -1)
+	{
+		return false;
+	}
+
+	// climb up to the first node we already know about
+	_stack.clear();
+	while (_stamp[node] != _sweep)
+	{
+		_stack.push_back(node);
+		node = _nodes[node].parent;
+	}
+
+	// and walk back down, evaluating every new step
+	for (std::vector<int>::reverse_iterator i = _stack.rbegin(); i != _stack.rend(); ++i)
+	{
+		Uint8 state = evaluate(*i);
+		_stamp[*i] = _sweep;
+		_state[*i] = state;
+		if (state == NODE_OPEN || state == NODE_WALL)
+		{
+			seen->push_back(_origin + Position(_nodes[*i].x, _nodes[*i].y, _nodes[*i].z));
+		}
+	}
+	return true;
+}
+
+/**
+ * Gets the amount of nodes in the tree.
+ * @return Number of nodes.
+ */
+size_t SightLineTree::size() const
+{
+	return _nodes.size();
+}
+
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_SIGHTLINETREE_H
+#define OPENXCOM_SIGHTLINETREE_H
+
+#include <vector>
+#include <SDL_types.h>
+#include "Position.h"
+
+namespace OpenXcom
+{
+
+class SavedBattleGame;
+class TileEngine;
+
+/**
+ * A prefix tree of every tile-space sight line a unit can cast.
+ * The bresenham line from an eye to a tile only depends on their relative offset,
+ * so all the lines are precomputed once and merged where they share the same start.
+ * A sweep then evaluates every branch of the tree at most once, instead of
+ * tracing every line from scratch.
+ */
+class SightLineTree
+{
+private:
+	/// Visibility states of a node during a sweep.
+	enum NodeState { NODE_UNKNOWN = 0, NODE_OPEN, NODE_WALL, NODE_BLOCKED };
+	struct Node
+	{
+		Sint8 x, y, z;
+		int parent;
+	};
+	int _maxDistance, _maxHeight, _width;
+	std::vector<Node> _nodes;
+	std::vector<int> _lookup;
+	std::vector<Uint32> _stamp;
+	std::vector<Uint8> _state;
+	std::vector<int> _stack;
+	Uint32 _sweep;
+	Position _origin;
+	SavedBattleGame *_save;
+	TileEngine *_tileEngine;
+	/// Gets the node index of the line towards a relative offset.
+	int getNode(const Position &offset) const;
+	/// Evaluates the transition into a node whose parent is already known.
+	Uint8 evaluate(int node);
+public:
+	/// Builds the tree of sight lines.
+	SightLineTree(SavedBattleGame *save, TileEngine *tileEngine, int maxDistance);
+	/// Cleans up the tree.
+	~SightLineTree();
+	/// Starts a new sweep from an eye position.
+	void beginSweep(const Position &origin, std::vector<Position> *seen);
+	/// Traces the line towards a tile, collecting the tiles newly seen on the way.
+	bool trace(const Position &target, std::vector<Position> *seen);
+	/// Gets the amount of nodes in the tree.
+	size_t size() const;
+};
+
+}
+
+#endif
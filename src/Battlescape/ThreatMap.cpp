@@ -0,0 +1,509 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ThreatMap.h"
+#include <cmath>
+#include <cstdlib>
+#include <climits>
+#include <algorithm>
+#include "TileEngine.h"
+#include "Pathfinding.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/BattleUnit.h"
+#include "../Savegame/Tile.h"
+#include "../Ruleset/Armor.h"
+#include "../Ruleset/MapData.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates a threat map with no tiles surveyed yet.
+ * @param save Pointer to the battle.
+ * @param engine Pointer to the tile engine, to trace the terrain with.
+ * @param voxelData Voxel shapes (LOFTEMPS).
+ */
+ThreatMap::ThreatMap(SavedBattleGame *save, TileEngine *engine, const std::vector<Uint16> *voxelData) : _save(save), _engine(engine), _voxelData(voxelData), _batchUnit(0), _batchNext(0), _batchDone(0), _quit(false)
+{
+	_mutex = SDL_CreateMutex();
+	_wake = SDL_CreateCond();
+	_finished = SDL_CreateCond();
+}
+
+/**
+ * Stops the worker threads.
+ */
+ThreatMap::~ThreatMap()
+{
+	setWorkers(0);
+	SDL_DestroyCond(_finished);
+	SDL_DestroyCond(_wake);
+	SDL_DestroyMutex(_mutex);
+}
+
+/**
+ * Forgets the threat worked out for every tile surveyed,
+ * so it's surveyed again the next time it's asked for.
+ * @param clearMarkers Also clear the AI debug markers on the tiles.
+ */
+void ThreatMap::clear(bool clearMarkers)
+{
+	for (std::vector<Tile*>::iterator i = _surveyed.begin(); i != _surveyed.end(); ++i)
+	{
+		if (clearMarkers)
+		{
+			(*i)->setMarkerColor(0);
+		}
+		(*i)->soldiersVisible = Tile::NOT_CALCULATED;
+		(*i)->closestSoldierDSqr = Tile::NOT_CALCULATED;
+	}
+	_surveyed.clear();
+}
+
+/**
+ * Compares the soldiers and their eyes to the ones the tiles
+ * were surveyed with, and if anyone has moved, knelt, turned up
+ * or gone down since, forgets all the tiles surveyed.
+ */
+void ThreatMap::checkSoldiers()
+{
+	std::vector<BattleUnit*> soldiers;
+	std::vector<Position> eyes;
+	for (std::vector<BattleUnit*>::const_iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+	{
+		if ((*i)->getFaction() == FACTION_PLAYER && !(*i)->isOut())
+		{
+			soldiers.push_back(*i);
+			eyes.push_back(_engine->getSightOriginVoxel(*i));
+		}
+	}
+	if (soldiers != _soldiers || eyes != _eyes)
+	{
+		clear();
+		_soldiers.swap(soldiers);
+		_eyes.swap(eyes);
+	}
+}
+
+/**
+ * Checks if a unit could be placed at a position, same as
+ * SavedBattleGame::setUnitPosition, with any unit in the way
+ * (even the unit itself) counting as blocking it.
+ * @param unit Pointer to the unit.
+ * @param pos Position of the unit.
+ * @return True if there's room for the unit.
+ */
+bool ThreatMap::canStand(BattleUnit *unit, const Position &pos) const
+{
+	int size = unit->getArmor()->getSize() - 1;
+	for (int x = size; x >= 0; x--)
+	{
+		for (int y = size; y >= 0; y--)
+		{
+			Tile *t = _save->getTile(pos + Position(x,y,0));
+			if (t == 0 || t->getUnit() != 0 || t->getTUCost(MapData::O_OBJECT, unit->getArmor()->getMovementType()) == 255)
+			{
+				return false;
+			}
+		}
+	}
+	if (size > 0 && _save->getPathfinding()->isBlocked(_save->getTile(pos), _save->getTile(pos + Position(1,1,0)), 3, 0))
+	{
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Checks if a voxel is inside the stand-in unit, same as
+ * TileEngine::voxelCheck does for a unit actually standing there.
+ * @param standIn The stand-in unit.
+ * @param voxel The voxel to check.
+ * @return True if the stand-in unit is hit.
+ */
+bool ThreatMap::hitsStandIn(const StandIn &standIn, const Position &voxel) const
+{
+	int size = standIn.unit->getArmor()->getSize();
+	Position pos(voxel.x/16, voxel.y/16, voxel.z/24);
+	Tile *tile = _save->getTile(pos);
+	bool inside = (pos.x >= standIn.pos.x && pos.x < standIn.pos.x + size && pos.y >= standIn.pos.y && pos.y < standIn.pos.y + size);
+	if (pos.z != standIn.pos.z)
+	{
+		// the unit's head may stick up into the tile above
+		if (!inside || pos.z != standIn.pos.z + 1 || tile->getUnit() != 0 || !tile->hasNoFloor(0))
+		{
+			return false;
+		}
+		--pos.z;
+		tile = _save->getTile(pos);
+	}
+	else if (!inside)
+	{
+		return false;
+	}
+
+	int tz = standIn.pos.z*24 + standIn.unit->getFloatHeight() - tile->getTerrainLevel();
+	if (voxel.z <= tz || voxel.z > tz + standIn.unit->getHeight())
+	{
+		return false;
+	}
+	int part = 0;
+	if (size > 1)
+	{
+		part = pos.x - standIn.pos.x + (pos.y - standIn.pos.y)*2;
+	}
+	int idx = (standIn.unit->getLoftemps(part) * 16) + voxel.y%16;
+	return (_voxelData->at(idx) & (1 << (voxel.x%16))) != 0;
+}
+
+/**
+ * Traces a line of fire through the same voxels as
+ * TileEngine::calculateLine, with the stand-in unit
+ * being the only unit that can be hit.
+ * @param standIn The stand-in unit.
+ * @param origin Origin voxel.
+ * @param target Target voxel.
+ * @param impact Returns the voxel the stand-in unit was hit at.
+ * @return True if the stand-in unit was hit before anything else.
+ */
+bool ThreatMap::traceToStandIn(const StandIn &standIn, const Position &origin, const Position &target, Position *impact) const
+{
+	int x0 = origin.x, x1 = target.x;
+	int y0 = origin.y, y1 = target.y;
+	int z0 = origin.z, z1 = target.z;
+
+	bool swap_xy = abs(y1 - y0) > abs(x1 - x0);
+	if (swap_xy)
+	{
+		std::swap(x0, y0);
+		std::swap(x1, y1);
+	}
+	bool swap_xz = abs(z1 - z0) > abs(x1 - x0);
+	if (swap_xz)
+	{
+		std::swap(x0, z0);
+		std::swap(x1, z1);
+	}
+
+	int delta_x = abs(x1 - x0);
+	int delta_y = abs(y1 - y0);
+	int delta_z = abs(z1 - z0);
+	int drift_xy = delta_x / 2;
+	int drift_xz = delta_x / 2;
+	int step_x = (x0 > x1) ? -1 : 1;
+	int step_y = (y0 > y1) ? -1 : 1;
+	int step_z = (z0 > z1) ? -1 : 1;
+
+	int y = y0, z = z0;
+	for (int x = x0; x != (x1+step_x); x += step_x)
+	{
+		// every step checks the voxel itself, then the diagonal intermediate voxels
+		for (int check = 0; check < 3; ++check)
+		{
+			if (check == 1)
+			{
+				drift_xy = drift_xy - delta_y;
+				drift_xz = drift_xz - delta_z;
+				if (drift_xy >= 0)
+					continue;
+				y = y + step_y;
+				drift_xy = drift_xy + delta_x;
+			}
+			else if (check == 2)
+			{
+				if (drift_xz >= 0)
+					continue;
+				z = z + step_z;
+				drift_xz = drift_xz + delta_x;
+			}
+			int cx = x, cy = y, cz = z;
+			if (swap_xz) std::swap(cx, cz);
+			if (swap_xy) std::swap(cx, cy);
+			Position voxel(cx, cy, cz);
+			if (_engine->voxelCheck(voxel, 0, true) != -1)
+			{
+				return false;
+			}
+			if (hitsStandIn(standIn, voxel))
+			{
+				*impact = voxel;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/**
+ * Works out how much of the stand-in unit a soldier can see,
+ * same as TileEngine::checkVoxelExposure.
+ * @param standIn The stand-in unit.
+ * @param eye The soldier's eye voxel.
+ * @param tile The tile the stand-in unit is on.
+ * @return Degree of exposure (as percent).
+ */
+int ThreatMap::getExposure(const StandIn &standIn, const Position &eye, Tile *tile) const
+{
+	Position targetVoxel = Position((tile->getPosition().x * 16) + 7, (tile->getPosition().y * 16) + 8, tile->getPosition().z * 24);
+	int targetMinHeight = targetVoxel.z - tile->getTerrainLevel() + standIn.unit->getFloatHeight();
+	int heightRange = standIn.unit->getHeight();
+	int targetMaxHeight = targetMinHeight + heightRange;
+
+	int unitRadius = standIn.unit->getLoftemps();
+	if (standIn.unit->getArmor()->getSize() > 1)
+	{
+		unitRadius = 3;
+	}
+	Position relPos = targetVoxel - eye;
+	float normal = unitRadius/sqrt((float)(relPos.x*relPos.x + relPos.y*relPos.y));
+	int relX = floor(((float)relPos.y)*normal+0.5);
+	int relY = floor(((float)-relPos.x)*normal+0.5);
+	int sliceTargets[4] = {0,0, relX,relY};
+
+	int total = 0;
+	int visible = 0;
+	Position scanVoxel, impact;
+	for (int i = heightRange; i >= 0; i -= 2)
+	{
+		++total;
+		scanVoxel.z = targetMinHeight + i;
+		for (int j = 0; j < 2; ++j)
+		{
+			scanVoxel.x = targetVoxel.x + sliceTargets[j*2];
+			scanVoxel.y = targetVoxel.y + sliceTargets[j*2+1];
+			//voxel of hit must be inside of scanned box
+			if (traceToStandIn(standIn, eye, scanVoxel, &impact) &&
+				impact.x/16 == scanVoxel.x/16 &&
+				impact.y/16 == scanVoxel.y/16 &&
+				impact.z >= targetMinHeight &&
+				impact.z <= targetMaxHeight)
+			{
+				++visible;
+			}
+		}
+	}
+	return (visible*100)/total;
+}
+
+/**
+ * Finds all the soldiers that would see a unit standing on a tile,
+ * and how well, and stores it in the tile for the AI. Only reads
+ * the map, so several tiles can be surveyed at the same time.
+ * @param tile The tile to check, with room for the unit.
+ * @param unit The unit that would be standing there.
+ */
+void ThreatMap::surveyTile(Tile *tile, BattleUnit *unit) const
+{
+	StandIn standIn;
+	standIn.unit = unit;
+	standIn.pos = tile->getPosition();
+	const Position &pos = standIn.pos;
+
+	int soldiersVisible = 0; // we're actually not updating the other three tiles of a 2x2 unit because the AI code is going to ignore them anyway for now
+	int closestSoldierDSqr = INT_MAX;
+	int closestAlienDSqr = INT_MAX;
+	int totalExposure = 0;
+	int dsqrTotal = 0;
+	Position closestSoldierPos;
+
+	const int maxDSqr = TileEngine::MAX_VIEW_DISTANCE * TileEngine::MAX_VIEW_DISTANCE;
+	for (size_t i = 0; i < _soldiers.size(); ++i)
+	{
+		int dsqr = _engine->distanceSq(pos, _soldiers[i]->getPosition());
+		if (dsqr < 1) dsqr = 1; // sanity buffer against dividing by 0
+		if (dsqr > maxDSqr) continue; // can't even see that far, yo
+
+		int exposure = getExposure(standIn, _eyes[i], tile);
+		if (exposure)
+		{
+			++soldiersVisible;
+			totalExposure += exposure;
+			if (dsqr < closestSoldierDSqr)
+			{
+				closestSoldierDSqr = dsqr;
+				closestSoldierPos = _soldiers[i]->getPosition();
+			}
+			dsqrTotal += dsqr;
+		}
+	}
+	for (std::vector<BattleUnit*>::const_iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+	{
+		if ((*i)->getFaction() != FACTION_HOSTILE || (*i)->isOut()) continue;
+		int dsqr = _engine->distanceSq(pos, (*i)->getPosition());
+		if (dsqr < 1) dsqr = 1;
+		if (dsqr <= maxDSqr && dsqr < closestAlienDSqr) closestAlienDSqr = dsqr;
+	}
+
+	if (soldiersVisible == 0)
+	{
+		closestSoldierDSqr = -1;
+		closestSoldierPos = Position(INT_MAX, INT_MAX, INT_MAX);
+	}
+	tile->closestSoldierDSqr = closestSoldierDSqr;
+	tile->closestSoldierPos = closestSoldierPos;
+	tile->meanSoldierDSqr = soldiersVisible ? (dsqrTotal / soldiersVisible) : 0;
+	tile->closestAlienDSqr = closestAlienDSqr;
+	tile->totalExposure = totalExposure;
+	tile->soldiersVisible = soldiersVisible;
+}
+
+/**
+ * Keeps surveying the next tile of the batch until
+ * there's none left. Has to be called with the mutex
+ * locked, and returns with it locked.
+ */
+void ThreatMap::work()
+{
+	while (_batchNext < _batch.size())
+	{
+		Tile *tile = _batch[_batchNext++];
+		SDL_mutexV(_mutex);
+		surveyTile(tile, _batchUnit);
+		SDL_mutexP(_mutex);
+		if (++_batchDone == _batch.size())
+		{
+			SDL_CondSignal(_finished);
+		}
+	}
+}
+
+/**
+ * Helps survey every batch handed out,
+ * until the threat map is deleted.
+ * @param data Pointer to the threat map.
+ * @return Always 0.
+ */
+int ThreatMap::worker(void *data)
+{
+	ThreatMap *map = (ThreatMap*)data;
+	SDL_mutexP(map->_mutex);
+	while (!map->_quit)
+	{
+		map->work();
+		SDL_CondWait(map->_wake, map->_mutex);
+	}
+	SDL_mutexV(map->_mutex);
+	return 0;
+}
+
+/**
+ * Starts or stops worker threads until there's a certain number of them.
+ * Stopping any stops them all, and the rest are started again.
+ * @param workers Number of worker threads.
+ */
+void ThreatMap::setWorkers(int workers)
+{
+	if ((int)_workers.size() > workers)
+	{
+		SDL_mutexP(_mutex);
+		_quit = true;
+		SDL_CondBroadcast(_wake);
+		SDL_mutexV(_mutex);
+		for (std::vector<SDL_Thread*>::iterator i = _workers.begin(); i != _workers.end(); ++i)
+		{
+			SDL_WaitThread(*i, 0);
+		}
+		_workers.clear();
+		_quit = false;
+	}
+	while ((int)_workers.size() < workers)
+	{
+		SDL_Thread *thread = SDL_CreateThread(worker, this);
+		if (thread == 0)
+		{
+			break;
+		}
+		_workers.push_back(thread);
+	}
+}
+
+/**
+ * Surveys the threat to a unit standing on a tile,
+ * unless it's already known from earlier this turn.
+ * @param tile The tile to check.
+ * @param unit The unit that would be standing there.
+ * @return False if the unit couldn't possibly be placed at the tile, true otherwise.
+ */
+bool ThreatMap::survey(Tile *tile, BattleUnit *unit)
+{
+	checkSoldiers();
+	if (tile->soldiersVisible != Tile::NOT_CALCULATED) return true; // already calculated this turn
+
+	if (!canStand(unit, tile->getPosition()))
+	{
+		return false;
+	}
+	surveyTile(tile, unit);
+	_surveyed.push_back(tile);
+	return true;
+}
+
+/**
+ * Surveys the threat to a unit standing on each of several tiles,
+ * skipping the ones already known or with no room for the unit.
+ * The rays are traced on worker threads, the tile engine has
+ * to have the terrain voxels of the whole map ready beforehand.
+ * @param tiles The tiles to check.
+ * @param unit The unit that would be standing there.
+ * @param threads Number of threads to use, including this one.
+ */
+void ThreatMap::survey(const std::vector<Tile*> &tiles, BattleUnit *unit, int threads)
+{
+	checkSoldiers();
+	std::vector<Tile*> batch;
+	for (std::vector<Tile*>::const_iterator i = tiles.begin(); i != tiles.end(); ++i)
+	{
+		if ((*i)->soldiersVisible == Tile::NOT_CALCULATED && std::find(batch.begin(), batch.end(), *i) == batch.end() && canStand(unit, (*i)->getPosition()))
+		{
+			batch.push_back(*i);
+		}
+	}
+	if (batch.empty())
+	{
+		return;
+	}
+	if (threads <= 1 || batch.size() == 1)
+	{
+		for (std::vector<Tile*>::iterator i = batch.begin(); i != batch.end(); ++i)
+		{
+			surveyTile(*i, unit);
+		}
+		_surveyed.insert(_surveyed.end(), batch.begin(), batch.end());
+		return;
+	}
+
+	setWorkers(threads - 1);
+	SDL_mutexP(_mutex);
+	_batch.swap(batch);
+	_batchUnit = unit;
+	_batchNext = 0;
+	_batchDone = 0;
+	SDL_CondBroadcast(_wake);
+	work();
+	while (_batchDone < _batch.size())
+	{
+		SDL_CondWait(_finished, _mutex);
+	}
+	_batch.swap(batch);
+	_batch.clear();
+	SDL_mutexV(_mutex);
+
+	_surveyed.insert(_surveyed.end(), batch.begin(), batch.end());
+}
+
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_THREATMAP_H
+#define OPENXCOM_THREATMAP_H
+
+#include <vector>
+#include <SDL.h>
+#include <SDL_thread.h>
+#include "Position.h"
+
+namespace OpenXcom
+{
+
+class SavedBattleGame;
+class TileEngine;
+class BattleUnit;
+class Tile;
+
+/**
+ * How exposed the tiles of the map are to the soldiers, as seen by
+ * the AI, kept in the scratch fields of the tiles and shared by all
+ * the aliens for the whole turn. Each tile is surveyed the first time
+ * it's asked for, tracing rays against a stand-in for the unit instead
+ * of actually moving one there, and the tiles surveyed so far are
+ * forgotten again as soon as any soldier moves, turns up or goes down.
+ * Surveying only reads the map, so a batch of tiles can be spread
+ * over several threads with the same results as one at a time.
+ * The worker threads are started with the first batch and wait
+ * for the next one until the threat map is deleted.
+ */
+class ThreatMap
+{
+private:
+	SavedBattleGame *_save;
+	TileEngine *_engine;
+	const std::vector<Uint16> *_voxelData;
+	std::vector<BattleUnit*> _soldiers;
+	std::vector<Position> _eyes;
+	std::vector<Tile*> _surveyed;
+	/// A unit pretending to stand on the tile being surveyed.
+	struct StandIn
+	{
+		BattleUnit *unit;
+		Position pos;
+	};
+	/// The batch of tiles shared out to the worker threads.
+	BattleUnit *_batchUnit;
+	std::vector<Tile*> _batch;
+	size_t _batchNext, _batchDone;
+	std::vector<SDL_Thread*> _workers;
+	SDL_mutex *_mutex;
+	SDL_cond *_wake, *_finished;
+	bool _quit;
+	/// Forgets the tiles surveyed if the soldiers have changed.
+	void checkSoldiers();
+	/// Checks if a unit could stand at a position.
+	bool canStand(BattleUnit *unit, const Position &pos) const;
+	/// Checks if a voxel is inside the stand-in unit.
+	bool hitsStandIn(const StandIn &standIn, const Position &voxel) const;
+	/// Traces a line of fire up to the stand-in unit.
+	bool traceToStandIn(const StandIn &standIn, const Position &origin, const Position &target, Position *impact) const;
+	/// Gets how exposed the stand-in unit is to a soldier.
+	int getExposure(const StandIn &standIn, const Position &eye, Tile *tile) const;
+	/// Surveys a tile the unit has room to stand on.
+	void surveyTile(Tile *tile, BattleUnit *unit) const;
+	/// Surveys tiles of the batch until there's none left.
+	void work();
+	/// Waits for batches to survey until the threat map is deleted.
+	static int worker(void *data);
+	/// Starts or stops worker threads to have a certain number.
+	void setWorkers(int workers);
+public:
+	/// Creates an empty threat map.
+	ThreatMap(SavedBattleGame *save, TileEngine *engine, const std::vector<Uint16> *voxelData);
+	/// Cleans up the threat map.
+	~ThreatMap();
+	/// Forgets all the tiles surveyed.
+	void clear(bool clearMarkers = false);
+	/// Surveys the threat to a unit standing on a tile.
+	bool survey(Tile *tile, BattleUnit *unit);
+	/// Surveys the threat to a unit standing on each of several tiles.
+	void survey(const std::vector<Tile*> &tiles, BattleUnit *unit, int threads);
+};
+
+}
+
+#endif
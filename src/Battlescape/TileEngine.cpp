@@ -21,8 +21,12 @@
 #include <cmath>
 #include <climits>
 #include <set>
+#include <map>
+#include <algorithm>
 #include <functional>
+#include <sstream>
 #include "TileEngine.h"
+#include "BattleProfiler.h"
 #include <SDL.h>
 #include "BattleAIState.h"
 #include "AggroBAIState.h"
@@ -32,6 +36,7 @@
 #include "../Savegame/SavedBattleGame.h"
 #include "ExplosionBState.h"
 #include "../Savegame/Tile.h"
+#include "../Savegame/TileStore.h"
 #include "../Savegame/BattleUnit.h"
 #include "../Savegame/Soldier.h"
 #include "../Engine/RNG.h"
@@ -44,9 +49,15 @@
 #include "../Ruleset/Ruleset.h"
 #include "../Resource/ResourcePack.h"
 #include "Pathfinding.h"
+#include "SightLineTree.h"
+#include "LightLayer.h"
+#include "VoxelGrid.h"
+#include "ThreatMap.h"
+#include "SightCache.h"
 #include "../Engine/Options.h"
 #include "ProjectileFlyBState.h"
 #include "../Engine/Logger.h"
+#include "../Engine/Exception.h"
 #include "../aresame.h"
 
 namespace OpenXcom
@@ -54,11 +65,38 @@ namespace OpenXcom
 
 const int TileEngine::heightFromCenter[11] = {0,-2,+2,-4,+4,-6,+6,-8,+8,-12,+12};
 
+/**
+ * The directions explode() casts its rays in: every 3 degrees around
+ * and every 5 degrees up and down, worked out once with the same
+ * sums the rays used to do themselves.
+ */
+struct ExplosionRays
+{
+	static const int AROUND = 121, UPDOWN = 37;
+	double sinTe[AROUND], cosTe[AROUND], sinFi[UPDOWN], cosFi[UPDOWN];
+	ExplosionRays()
+	{
+		for (int i = 0; i < AROUND; ++i)
+		{
+			int te = i * 3;
+			cosTe[i] = cos(te * M_PI / 180.0);
+			sinTe[i] = sin(te * M_PI / 180.0);
+		}
+		for (int i = 0; i < UPDOWN; ++i)
+		{
+			int fi = -90 + i * 5;
+			sinFi[i] = sin(fi * M_PI / 180.0);
+			cosFi[i] = cos(fi * M_PI / 180.0);
+		}
+	}
+};
+static const ExplosionRays explosionRays;
+
 /**
  * Sets up a TileEngine.
  * @param save pointer to SavedBattleGame object.
  */
-TileEngine::TileEngine(SavedBattleGame *save, std::vector<Uint16> *voxelData) : _save(save), _voxelData(voxelData), _personalLighting(true)
+TileEngine::TileEngine(SavedBattleGame *save, std::vector<Uint16> *voxelData) : _save(save), _voxelData(voxelData), _personalLighting(true), _sightLines(0), _checkFOV(Options::getBool("battleCheckFOV")), _terrainLight(0), _unitLight(0), _voxelGrid(0), _threatMap(0), _sightCache(0)
 {
 }
 
@@ -67,7 +105,48 @@ TileEngine::TileEngine(SavedBattleGame *save, std::vector<Uint16> *voxelData) :
  */
 TileEngine::~TileEngine()
 {
+	delete _sightLines;
+	delete _terrainLight;
+	delete _unitLight;
+	delete _voxelGrid;
+	delete _threatMap;
+	delete _sightCache;
+}
 
+/**
+ * Forgets everything cached about the map tiles. Needs to be called
+ * when the tiles are replaced, eg. on the next stage of a mission.
+ */
+void TileEngine::resetMapCache()
+{
+	delete _sightLines;
+	_sightLines = 0;
+	delete _terrainLight;
+	_terrainLight = 0;
+	delete _unitLight;
+	_unitLight = 0;
+	delete _voxelGrid;
+	_voxelGrid = 0;
+	delete _threatMap;
+	_threatMap = 0;
+	delete _sightCache;
+	_sightCache = 0;
+	_terrainSources.clear();
+	_explosionHits.clear();
+}
+
+/**
+ * Gets the cache of lines of sight between units,
+ * creating it the first time it's needed.
+ * @return Pointer to the sight cache.
+ */
+SightCache *TileEngine::getSightCache()
+{
+	if (_sightCache == 0)
+	{
+		_sightCache = new SightCache(_save);
+	}
+	return _sightCache;
 }
 
 
@@ -76,12 +155,61 @@ TileEngine::~TileEngine()
   */
 void TileEngine::calculateSunShading()
 {
+	BattleProfiler::Scope profile(BattleProfiler::PROFILE_LIGHTING);
 	const int layer = 0; // Ambient lighting layer.
+	TileStore *store = _save->getTileStore();
+	int *light = store->getLight();
+	int *lastLight = store->getLastLight();
 
 	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
 	{
-		_save->getTiles()[i]->resetLight(layer);
-		calculateSunShading(_save->getTiles()[i]);
+		light[i * TileStore::LIGHTLAYERS + layer] = 0;
+		lastLight[i * TileStore::LIGHTLAYERS + layer] = 0;
+	}
+	// roofs only drop shade by day, otherwise every tile gets the same light
+	if (_save->getGlobalShade() <= 4)
+	{
+		for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
+		{
+			calculateSunShading(_save->getTiles()[i]);
+		}
+	}
+	else
+	{
+		int power = std::max(0, 15 - _save->getGlobalShade());
+		for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
+		{
+			light[i * TileStore::LIGHTLAYERS + layer] = power;
+		}
+	}
+}
+
+/**
+  * Calculate sun shading for the map columns within an area. The whole height
+  * of the map is shaded, since a roof shades everything beneath it.
+  * @param minX, minY The north west corner of the area.
+  * @param maxX, maxY The south east corner of the area.
+  */
+void TileEngine::calculateSunShading(int minX, int minY, int maxX, int maxY)
+{
+	BattleProfiler::Scope profile(BattleProfiler::PROFILE_LIGHTING);
+	const int layer = 0; // Ambient lighting layer.
+
+	minX = std::max(minX, 0);
+	minY = std::max(minY, 0);
+	maxX = std::min(maxX, _save->getMapSizeX() - 1);
+	maxY = std::min(maxY, _save->getMapSizeY() - 1);
+	for (int z = 0; z < _save->getMapSizeZ(); ++z)
+	{
+		for (int y = minY; y <= maxY; ++y)
+		{
+			for (int x = minX; x <= maxX; ++x)
+			{
+				Tile *tile = _save->getTile(Position(x, y, z));
+				tile->resetLight(layer);
+				calculateSunShading(tile);
+			}
+		}
 	}
 }
 
@@ -108,113 +236,153 @@ void TileEngine::calculateSunShading(Tile *tile)
 }
 
 /**
-  * Recalculate lighting for the terrain: objects,items,fire.
+  * Get the light a tile gives off from its objects, items and fire.
+  * @param index The tile index.
+  * @return Light power, or 0 for none.
   */
-void TileEngine::calculateTerrainLighting()
+int TileEngine::getTerrainLight(int index) const
 {
-	const int layer = 1; // Static lighting layer.
 	const int fireLightPower = 15; // amount of light a fire generates
+	TileStore *store = _save->getTileStore();
+	MapData **objects = store->getObjects() + index * TileStore::PARTS;
+	std::vector<BattleItem*> *inventory = store->getInventories() + index;
+	int power = 0;
 
-	// reset all light to 0 first
-	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
+	// only floors and objects can light up
+	if (objects[MapData::O_FLOOR]
+		&& objects[MapData::O_FLOOR]->getLightSource())
+	{
+		power = std::max(power, objects[MapData::O_FLOOR]->getLightSource());
+	}
+	if (objects[MapData::O_OBJECT]
+		&& objects[MapData::O_OBJECT]->getLightSource())
 	{
-		_save->getTiles()[i]->resetLight(layer);
+		power = std::max(power, objects[MapData::O_OBJECT]->getLightSource());
 	}
 
-	// add lighting of terrain
-	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
+	// fires
+	if (store->getFire()[index])
 	{
-		// only floors and objects can light up
-		if (_save->getTiles()[i]->getMapData(MapData::O_FLOOR)
-			&& _save->getTiles()[i]->getMapData(MapData::O_FLOOR)->getLightSource())
-		{
-			addLight(_save->getTiles()[i]->getPosition(), _save->getTiles()[i]->getMapData(MapData::O_FLOOR)->getLightSource(), layer);
-		}
-		if (_save->getTiles()[i]->getMapData(MapData::O_OBJECT)
-			&& _save->getTiles()[i]->getMapData(MapData::O_OBJECT)->getLightSource())
+		power = std::max(power, fireLightPower);
+	}
+
+	for (std::vector<BattleItem*>::iterator it = inventory->begin(); it != inventory->end(); ++it)
+	{
+		if ((*it)->getRules()->getBattleType() == BT_FLARE)
 		{
-			addLight(_save->getTiles()[i]->getPosition(), _save->getTiles()[i]->getMapData(MapData::O_OBJECT)->getLightSource(), layer);
+			power = std::max(power, (*it)->getRules()->getPower());
 		}
+	}
+	return power;
+}
+
+/**
+  * Recalculate lighting for the terrain: objects,items,fire.
+  * Only the tiles in reach of a light source that changed since the last call are lit again.
+  */
+void TileEngine::calculateTerrainLighting()
+{
+	BattleProfiler::Scope profile(BattleProfiler::PROFILE_LIGHTING);
+	const int layer = 1; // Static lighting layer.
 
-		// fires
-		if (_save->getTiles()[i]->getFire())
+	// collect the brightest light source of every tile
+	_terrainSources.clear();
+	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
+	{
+		int power = getTerrainLight(i);
+		if (power > 0)
 		{
-			addLight(_save->getTiles()[i]->getPosition(), fireLightPower, layer);
+			int x, y, z;
+			_save->getTileCoords(i, &x, &y, &z);
+			_terrainSources[i] = LightSource(x, y, power);
 		}
+	}
+
+	if (_terrainLight == 0)
+	{
+		_terrainLight = new LightLayer(_save, layer);
+	}
+	_terrainLight->update(_terrainSources);
+}
+
+/**
+  * Recalculate lighting for the terrain, after only the map columns
+  * within an area have changed. The light sources everywhere else are
+  * taken to be the same as the last time the terrain was lit.
+  * @param minX, minY The north west corner of the area.
+  * @param maxX, maxY The south east corner of the area.
+  */
+void TileEngine::calculateTerrainLighting(int minX, int minY, int maxX, int maxY)
+{
+	if (_terrainLight == 0)
+	{
+		calculateTerrainLighting();
+		return;
+	}
+	BattleProfiler::Scope profile(BattleProfiler::PROFILE_LIGHTING);
 
-		for (std::vector<BattleItem*>::iterator it = _save->getTiles()[i]->getInventory()->begin(); it != _save->getTiles()[i]->getInventory()->end(); ++it)
+	minX = std::max(minX, 0);
+	minY = std::max(minY, 0);
+	maxX = std::min(maxX, _save->getMapSizeX() - 1);
+	maxY = std::min(maxY, _save->getMapSizeY() - 1);
+	for (int z = 0; z < _save->getMapSizeZ(); ++z)
+	{
+		for (int y = minY; y <= maxY; ++y)
 		{
-			if ((*it)->getRules()->getBattleType() == BT_FLARE)
+			for (int x = minX; x <= maxX; ++x)
 			{
-				addLight(_save->getTiles()[i]->getPosition(), (*it)->getRules()->getPower(), layer);
+				int i = _save->getTileIndex(Position(x, y, z));
+				int power = getTerrainLight(i);
+				if (power > 0)
+				{
+					_terrainSources[i] = LightSource(x, y, power);
+				}
+				else
+				{
+					_terrainSources.erase(i);
+				}
 			}
 		}
-
 	}
-
+	_terrainLight->update(_terrainSources);
 }
 
 /**
   * Recalculate lighting for the units.
+  * Only the tiles in reach of a unit whose light moved or changed since the last call are lit again.
   */
 void TileEngine::calculateUnitLighting()
 {
+	BattleProfiler::Scope profile(BattleProfiler::PROFILE_LIGHTING);
 	const int layer = 2; // Dynamic lighting layer.
 	const int personalLightPower = 15; // amount of light a unit generates
 	const int fireLightPower = 15; // amount of light a fire generates
 
-	// reset all light to 0 first
-	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
-	{
-		_save->getTiles()[i]->resetLight(layer);
-	}
-
+	std::map<int, LightSource> sources;
 	for (std::vector<BattleUnit*>::iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
 	{
+		int power = 0;
 		// add lighting of soldiers
 		if (_personalLighting && (*i)->getFaction() == FACTION_PLAYER && !(*i)->isOut())
 		{
-			addLight((*i)->getPosition(), personalLightPower, layer);
+			power = std::max(power, personalLightPower);
 		}
 		// add lighting of units on fire
 		if ((*i)->getFire())
 		{
-			addLight((*i)->getPosition(), fireLightPower, layer);
+			power = std::max(power, fireLightPower);
+		}
+		if (power > 0)
+		{
+			sources[(*i)->getId()] = LightSource((*i)->getPosition().x, (*i)->getPosition().y, power);
 		}
 	}
-}
 
-/**
- * Adds circular light pattern starting from center and losing power with distance travelled.
- * @param center
- * @param power
- * @param layer Light is seperated in 3 layers: Ambient, Static and Dynamic.
- */
-void TileEngine::addLight(const Position &center, int power, int layer)
-{
-	// only loop through the positive quadrant.
-	for (int x = 0; x <= power; ++x)
+	if (_unitLight == 0)
 	{
-		for (int y = 0; y <= power; ++y)
-		{
-			for (int z = 0; z < _save->getMapSizeZ(); z++)
-			{
-				int distance = int(floor(sqrt(float(x*x + y*y)) + 0.5));
-
-				if (_save->getTile(Position(center.x + x,center.y + y, z)))
-					_save->getTile(Position(center.x + x,center.y + y, z))->addLight(power - distance, layer);
-
-				if (_save->getTile(Position(center.x - x,center.y - y, z)))
-					_save->getTile(Position(center.x - x,center.y - y, z))->addLight(power - distance, layer);
-
-				if (_save->getTile(Position(center.x - x,center.y + y, z)))
-					_save->getTile(Position(center.x - x,center.y + y, z))->addLight(power - distance, layer);
-
-				if (_save->getTile(Position(center.x + x,center.y - y, z)))
-					_save->getTile(Position(center.x + x,center.y - y, z))->addLight(power - distance, layer);
-			}
-		}
+		_unitLight = new LightLayer(_save, layer);
 	}
+	_unitLight->update(sources);
 }
 
 /**
@@ -224,12 +392,13 @@ void TileEngine::addLight(const Position &center, int power, int layer)
  */
 bool TileEngine::calculateFOV(BattleUnit *unit)
 {
+	BattleProfiler::Scope profile(BattleProfiler::PROFILE_FOV);
 	size_t oldNumVisibleUnits = unit->getUnitsSpottedThisTurn().size();
 	Position center = unit->getPosition();
 	Position test;
 	int direction;
 	bool swap;
-	std::vector<Position> _trajectory;
+	std::vector<Position> targets;
 	if (_save->getStrafeSetting() && (unit->getTurretType() > -1)) {
 		direction = unit->getTurretDirection();
 	}
@@ -301,34 +470,7 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 
 						if (unit->getFaction() == FACTION_PLAYER)
 						{
-							// this sets tiles to discovered if they are in LOS - tile visibility is not calculated in voxelspace but in tilespace
-							// large units have "4 pair of eyes"
-							int size = unit->getArmor()->getSize();
-							for (int xo = 0; xo < size; xo++)
-							{
-								for (int yo = 0; yo < size; yo++)
-								{
-									Position poso = pos + Position(xo,yo,0);
-									_trajectory.clear();
-									int tst = calculateLine(poso, test, true, &_trajectory, unit, false);
-									unsigned int tsize = _trajectory.size();
-									if (tst>127) --tsize; //last tile is blocked thus must be cropped
-									for (unsigned int i = 0; i < tsize; i++)
-									{
-										Position posi = _trajectory.at(i); 
-										//mark every tile of line as visible (as in original)
-										//this is needed because of bresenham narrow stroke. 
-										_save->getTile(posi)->setVisible(+1);
-										_save->getTile(posi)->setDiscovered(true, 2);
-										// walls to the east or south of a visible tile, we see that too
-										Tile* t = _save->getTile(Position(posi.x + 1, posi.y, posi.z));
-										if (t) t->setDiscovered(true, 0);
-										t = _save->getTile(Position(posi.x, posi.y + 1, posi.z));
-										if (t) t->setDiscovered(true, 1);
-									}
-
-								}
-							}
+							targets.push_back(test);
 						}
 					}
 				}
@@ -336,6 +478,58 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 		}
 	}
 
+	if (unit->getFaction() == FACTION_PLAYER)
+	{
+		// this sets tiles to discovered if they are in LOS - tile visibility is not calculated in voxelspace but in tilespace
+		// every tile on a line towards a tile in the view cone is seen, up to what blocks it,
+		// the lines are swept through the sight line tree so the steps they share are only checked once
+		if (_sightLines == 0)
+		{
+			_sightLines = new SightLineTree(_save, this, MAX_VIEW_DISTANCE);
+		}
+		std::vector<Position> seen;
+		// large units have "4 pair of eyes"
+		int size = unit->getArmor()->getSize();
+		for (int xo = 0; xo < size; xo++)
+		{
+			for (int yo = 0; yo < size; yo++)
+			{
+				Position poso = pos + Position(xo,yo,0);
+				std::vector<Position> missed;
+				_sightLines->beginSweep(poso, &seen);
+				for (std::vector<Position>::const_iterator i = targets.begin(); i != targets.end(); ++i)
+				{
+					if (!_sightLines->trace(*i, &seen))
+					{
+						missed.push_back(*i);
+					}
+				}
+				if (!missed.empty())
+				{
+					traceFOVLines(unit, poso, missed, &seen);
+				}
+				if (_checkFOV)
+				{
+					checkFOVSweep(unit, poso, targets);
+				}
+			}
+		}
+
+		for (std::vector<Position>::const_iterator i = seen.begin(); i != seen.end(); ++i)
+		{
+			Position posi = *i;
+			//mark every tile of line as visible (as in original)
+			//this is needed because of bresenham narrow stroke.
+			_save->getTile(posi)->setVisible(+1);
+			_save->getTile(posi)->setDiscovered(true, 2);
+			// walls to the east or south of a visible tile, we see that too
+			Tile* t = _save->getTile(Position(posi.x + 1, posi.y, posi.z));
+			if (t) t->setDiscovered(true, 0);
+			t = _save->getTile(Position(posi.x, posi.y + 1, posi.z));
+			if (t) t->setDiscovered(true, 1);
+		}
+	}
+
 	// we only react when there are at least the same amount of visible units as before AND the checksum is different
 	// this way we stop if there are the same amount of visible units, but a different unit is seen
 	// or we stop if there are more visible units seen
@@ -361,160 +555,123 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 
 }
 
-
-
 /**
- * @brief Find all the soldiers that would see queryingUnit at tile (aka tilePos) and collect some statistics for AI.
- * @param tile the tile to check
- * @param tilePos the position of the tile to check, redundantly
- * @param queryingUnit the unit to temporarily place at tilePos for calculations
- * @return false if the unit couldn't possibly be placed at tile (i.e., something's blocking it), true otherwise
+ * Checks that sweeping the lines from an eye through the sight line tree
+ * sees exactly the same tiles as tracing every line on its own.
+ * @param unit The unit looking.
+ * @param eye Position of the eye.
+ * @param targets Tiles the lines go to.
+ * @throws Exception if they see different tiles.
  */
-bool TileEngine::surveyXComThreatToTile(Tile *tile, Position &tilePos, BattleUnit *queryingUnit)
+void TileEngine::checkFOVSweep(BattleUnit *unit, const Position &eye, const std::vector<Position> &targets)
 {
-	if (tile->soldiersVisible != -1) return true; // already calculated this turn
-
-	BattleUnit hypotheticalUnit(*queryingUnit); // this is why I needed a copy constructor for BattleUnit
-	// I tried repeatedly to just move queryingUnit without making a copy of it but that caused mysterious crashes in loftemps calculations for 2x2 units. :<
-	
-	if (!_save->setUnitPosition(&hypotheticalUnit, tilePos, true)) 
-	{
-		return false;
-	}
-	
-	std::map<int, BattleUnit*> originalTileUnits;
-	std::vector<Position> toBackUp;
-	
-	toBackUp.push_back(hypotheticalUnit.getPosition());
-	toBackUp.push_back(hypotheticalUnit.getTile()->getPosition()); // no such thing as too many backups??? .__.
-	toBackUp.push_back(hypotheticalUnit.getLastPosition());
-	toBackUp.push_back(tilePos);
-	
-	// back up the BattleUnit pointers from the live tile data
-	for (std::vector<Position>::iterator which = toBackUp.begin(); which != toBackUp.end(); ++which)
+	std::vector<Position> swept, traced;
+	_sightLines->beginSweep(eye, &swept);
+	for (std::vector<Position>::const_iterator i = targets.begin(); i != targets.end(); ++i)
 	{
-		for (int x = hypotheticalUnit.getArmor()->getSize()-1; x >= 0; x--)
+		if (!_sightLines->trace(*i, &swept))
 		{
-			for (int y = hypotheticalUnit.getArmor()->getSize()-1; y >= 0; y--)
-			{
-				Position pos = *which;
-				pos.x += x;
-				pos.y += y;
-				
-				Tile *tileToSave = _save->getTile(pos);
-				if (!tileToSave) continue; // out of map bounds?
-				
-				int index = _save->getTileIndex(pos);				
-				originalTileUnits[index] = tileToSave->getUnit();
-			}
+			traced.push_back(*i);
 		}
 	}
+	traceFOVLines(unit, eye, traced, &swept);
+	traced.clear();
+	traceFOVLines(unit, eye, targets, &traced);
+	std::set<int> sweptSet, tracedSet;
+	for (std::vector<Position>::const_iterator i = swept.begin(); i != swept.end(); ++i)
+		sweptSet.insert(_save->getTileIndex(*i));
+	for (std::vector<Position>::const_iterator i = traced.begin(); i != traced.end(); ++i)
+		tracedSet.insert(_save->getTileIndex(*i));
+	if (sweptSet != tracedSet)
+	{
+		std::ostringstream ss;
+		ss << "Field of view sweep of unit #" << unit->getId() << " sees " << sweptSet.size() << " tiles, sight lines see " << tracedSet.size() << ".";
+		throw Exception(ss.str());
+	}
+}
 
-
-#if 0
-	// this block of code would make sure that the unit in question wouldn't occlude its own LOS checks
-	// since the LOS checks happen from soldiers to the hypothetical unit, this is possible, I think
-	// however, this code also causes the game to crash in other parts of the code for mysterious reasons
-	for (int x = hypotheticalUnit.getArmor()->getSize()-1; x >= 0; x--)
+/**
+ * Traces a tile-space line from an eye to each of the targets, and collects every tile
+ * on them up to whatever blocks the line.
+ * This is how the field of view was calculated before the sight line tree,
+ * it's still used for eyes the tree doesn't cover.
+ * @param unit The unit looking.
+ * @param eye Position of the eye.
+ * @param targets Tiles to trace lines to.
+ * @param seen Vector the tiles on the lines get added to.
+ */
+void TileEngine::traceFOVLines(BattleUnit *unit, const Position &eye, const std::vector<Position> &targets, std::vector<Position> *seen)
+{
+	std::vector<Position> _trajectory;
+	for (std::vector<Position>::const_iterator i = targets.begin(); i != targets.end(); ++i)
 	{
-		for (int y = hypotheticalUnit.getArmor()->getSize()-1; y >= 0; y--)
+		_trajectory.clear();
+		int tst = calculateLine(eye, *i, true, &_trajectory, unit, false);
+		unsigned int tsize = _trajectory.size();
+		if (tst>127) --tsize; //last tile is blocked thus must be cropped
+		for (unsigned int j = 0; j < tsize; j++)
 		{
-			Position pos = hypotheticalUnit.getPosition();
-			pos.x += x;
-			pos.y += y;
-
-			Tile *zeroMe = _save->getTile(pos);
-			assert (!zeroMe || zeroMe->getUnit() == queryingUnit);
-			if (zeroMe) zeroMe->setUnit(0);
+			if (_save->getTile(_trajectory.at(j)))
+			{
+				seen->push_back(_trajectory.at(j));
+			}
 		}
 	}
-#endif
+}
 
-#ifdef _DEBUG
-	// sanity-check the tile data...
-	int count = 0;
-	for (int i = 0; i < _save->getMapSizeX() * _save->getMapSizeY() * _save->getMapSizeZ(); ++i)
+/**
+ * @brief Find all the soldiers that would see queryingUnit at tile and collect some statistics for AI.
+ * The results are kept in the tile and shared by all the aliens until a soldier moves or the turn ends.
+ * @param tile the tile to check
+ * @param queryingUnit the unit that would be standing at tile
+ * @return false if the unit couldn't possibly be placed at tile (i.e., something's blocking it), true otherwise
+ */
+bool TileEngine::surveyXComThreatToTile(Tile *tile, BattleUnit *queryingUnit)
+{
+	if (_threatMap == 0)
 	{
-		if (_save->getTiles()[i]->getUnit() == queryingUnit)
-		{
-			++count;
-		}
+		_threatMap = new ThreatMap(_save, this, _voxelData);
 	}
-	if (count != queryingUnit->getArmor()->getSize()*queryingUnit->getArmor()->getSize())
+	return _threatMap->survey(tile, queryingUnit);
+}
+
+/**
+ * Surveys the threat to queryingUnit at each of several tiles in one go,
+ * spreading the work over the number of threads set in the options.
+ * The results are the same as surveying each tile on its own.
+ * @param tiles the tiles to check
+ * @param queryingUnit the unit that would be standing there
+ */
+void TileEngine::surveyXComThreatToTiles(const std::vector<Tile*> &tiles, BattleUnit *queryingUnit)
+{
+	if (_threatMap == 0)
 	{
-		Log(LOG_ERROR) << count << " tiles are occupied by " << queryingUnit->getType() << " #" << queryingUnit->getId() << " and that is messed up.";
+		_threatMap = new ThreatMap(_save, this, _voxelData);
 	}
-#endif
-	
-	_save->setUnitPosition(&hypotheticalUnit, tilePos); // updates the unit and the tiles
-	//_save->setUnitPosition(&hypotheticalUnit, tilePos); // reset its lastPosition too
-
-		
-	tile->soldiersVisible = 0; // we're actually not updating the other three tiles of a 2x2 unit because the AI code is going to ignore them anyway for now
-	tile->closestSoldierDSqr = INT_MAX;
-	tile->closestAlienDSqr = INT_MAX;
-	tile->meanSoldierDSqr = INT_MAX;
-	tile->totalExposure = 0;
-	
-	int dsqrTotal = 0;
-	
-	//Position targetVoxel = getSightOriginVoxel(&hypotheticalUnit); // relevant if trying to use calculateLine() which doesn't seem to cooperate anyway!
-	Position targetVoxel(0,0,0);
-	
-	for (std::vector<BattleUnit*>::const_iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+	int threads = Options::getInt("aiThreads");
+	if (threads > 1)
 	{
-		if ((*i)->isOut()) continue;
-		
-		int dsqr = distanceSq(tilePos, (*i)->getPosition());
-		if (dsqr < 1) dsqr = 1; // sanity buffer against dividing by 0
-
-		if (dsqr > (MAX_VIEW_DISTANCE * MAX_VIEW_DISTANCE)) continue; // can't even see that far, yo
-		
-		Position originVoxel = getSightOriginVoxel(*i);
-
-		// these three things don't seem to work, probably because I don't know how to call them properly:
-		//if ((*i)->getFaction() == FACTION_PLAYER && visible(*i, tile))
-		//if ((*i)->getFaction() == FACTION_PLAYER && canTargetTile(&originVoxel, tile, MapData::O_FLOOR, &targetVoxel, *i)) 
-		//if ((*i)->getFaction() == FACTION_PLAYER && calculateLine(originVoxel, targetVoxel, false, 0, *i, false) == 4)
-
-		// this works OK but we don't need to try all those rays for this tactical assessment
-		//if ((*i)->getFaction() == FACTION_PLAYER && canTargetUnit(&originVoxel, tile, &targetVoxel, *i))		
-		// this should be the best, a routine that gives us the degree of exposure while economizing raytraces:
-		int exposure;
-		if ((*i)->getFaction() == FACTION_PLAYER && (exposure = checkVoxelExposure(&originVoxel, tile, *i, &hypotheticalUnit)))
+		// the workers may only read the voxel grid, so it has to be up to date first
+		if (_voxelGrid == 0)
 		{
-			++tile->soldiersVisible;
-			tile->totalExposure += exposure;
-
-			if (dsqr < tile->closestSoldierDSqr)
-			{
-				tile->closestSoldierDSqr = dsqr;
-				tile->closestSoldierPos = (*i)->getPosition();
-			}
-			
-			dsqrTotal += dsqr;
+			_voxelGrid = new VoxelGrid(_save, _voxelData);
 		}
-
-		if ((*i)->getFaction() == FACTION_HOSTILE && dsqr < tile->closestAlienDSqr) tile->closestAlienDSqr = dsqr;
+		_voxelGrid->update();
 	}
-	
-	tile->meanSoldierDSqr = tile->soldiersVisible ? (dsqrTotal / tile->soldiersVisible) : 0;
-	
-	//if (tile->_soldiersVisible == 0 && tile->getVisible()) { Log(LOG_WARNING) << "Visible tile returned !canTargetTile() for all soldiers."; }
+	_threatMap->survey(tiles, queryingUnit, threads);
+}
 
-	// restore tile data
-	for (std::map<int,BattleUnit*>::iterator i = originalTileUnits.begin(); i != originalTileUnits.end(); ++i)
-	{
-		_save->getTiles()[i->first]->setUnit(i->second);
-	}
-	
-	if (tile->soldiersVisible == 0)
+/**
+ * Forgets the threat to all the tiles surveyed for the AI,
+ * so they're surveyed again when next needed.
+ * @param clearMarkers Also clear the AI debug markers on those tiles.
+ */
+void TileEngine::resetThreatMap(bool clearMarkers)
+{
+	if (_threatMap != 0)
 	{
-		tile->closestSoldierDSqr = -1; 
-		tile->closestSoldierPos = Position(INT_MAX, INT_MAX, INT_MAX);
+		_threatMap->clear(clearMarkers);
 	}
-	
-	return true;
 }
 
 /**
@@ -576,11 +733,15 @@ bool TileEngine::visible(BattleUnit *currentUnit, Tile *tile)
 	Position originVoxel = getSightOriginVoxel(currentUnit);
 
 	bool unitSeen = false;
+	if (getSightCache()->getSeen(currentUnit, originVoxel, tile, &unitSeen))
+	{
+		return unitSeen;
+	}
 	// for large units origin voxel is in the middle
 
 	Position scanVoxel;
 	std::vector<Position> _trajectory;
-	unitSeen = canTargetUnit(&originVoxel, tile, &scanVoxel, currentUnit);
+	unitSeen = canTargetUnitFromEyes(currentUnit, originVoxel, tile, &scanVoxel);
 
 	if (unitSeen)
 	{
@@ -610,6 +771,7 @@ bool TileEngine::visible(BattleUnit *currentUnit, Tile *tile)
 			}
 		}
 	}
+	_sightCache->setSeen(currentUnit, originVoxel, tile, unitSeen);
 	return unitSeen;
 }
 
@@ -693,6 +855,32 @@ int TileEngine::checkVoxelExposure(Position *originVoxel, Tile *tile, BattleUnit
 }
 
 
+/**
+ * Check for an another unit is available for targeting from a unit's eyes,
+ * looking it up in the sight cache before tracing any rays.
+ * @param unit the unit looking
+ * @param eye the unit's eye voxel
+ * @param tile the tile to check for
+ * @param scanVoxel is returned coordinate of hit
+ * @return true/false
+ */
+bool TileEngine::canTargetUnitFromEyes(BattleUnit *unit, const Position &eye, Tile *tile, Position *scanVoxel)
+{
+	if (!tile->getUnit() || tile->getUnit() == unit)
+	{
+		return false;
+	}
+	bool targetable;
+	if (getSightCache()->getTargetable(unit, eye, tile, &targetable, scanVoxel))
+	{
+		return targetable;
+	}
+	Position origin = eye;
+	targetable = canTargetUnit(&origin, tile, scanVoxel, unit);
+	_sightCache->setTargetable(unit, eye, tile, targetable, *scanVoxel);
+	return targetable;
+}
+
 /**
  * Check for an another unit is available for targeting and what particular voxel
  * @param originVoxel voxel of trace origin (eye or gun's barrel)
@@ -914,6 +1102,7 @@ bool TileEngine::canTargetTile(Position *originVoxel, Tile *tile, int part, Posi
  */
 void TileEngine::calculateFOV(const Position &position)
 {
+	BattleProfiler::Scope profile(BattleProfiler::PROFILE_FOV);
 	for (std::vector<BattleUnit*>::iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
 	{
 		if (distance(position, (*i)->getPosition()) < MAX_VIEW_DISTANCE)
@@ -1059,7 +1248,7 @@ bool TileEngine::canMakeSnap(BattleUnit *unit, BattleUnit *target)
 	{
 		Position origin = getSightOriginVoxel(unit);
 		Position scanVoxel;
-		if (canTargetUnit(&origin, target->getTile(), &scanVoxel, unit))
+		if (canTargetUnitFromEyes(unit, origin, target->getTile(), &scanVoxel))
 		{
 			return true;
 		}
@@ -1198,8 +1387,10 @@ BattleUnit *TileEngine::hit(const Position &center, int power, ItemDamageType ty
 		}
 	}
 	applyGravity(tile);
-	calculateSunShading(); // roofs could have been destroyed
-	calculateTerrainLighting(); // fires could have been started
+	Position pos = tile->getPosition();
+	calculateSunShading(pos.x - 1, pos.y - 1, pos.x + 1, pos.y + 1); // roofs could have been destroyed
+	calculateTerrainLighting(pos.x - 1, pos.y - 1, pos.x + 1, pos.y + 1); // fires could have been started
+	_save->getPathfinding()->invalidateStepCosts(); // and terrain destroyed
 	calculateFOV(center / Position(16,16,24));
 	return bu;
 }
@@ -1216,12 +1407,15 @@ BattleUnit *TileEngine::hit(const Position &center, int power, ItemDamageType ty
  */
 void TileEngine::explode(const Position &center, int power, ItemDamageType type, int maxRadius, BattleUnit *unit)
 {
+	BattleProfiler::Scope profile(BattleProfiler::PROFILE_EXPLOSIONS);
 	double centerZ = (int)(center.z / 24) + 0.5;
 	double centerX = (int)(center.x / 16) + 0.5;
 	double centerY = (int)(center.y / 16) + 0.5;
 	int power_;
-	std::set<Tile*> tilesAffected;
-	std::pair<std::set<Tile*>::iterator,bool> ret;
+	// tiles already hit, listed by index and marked on the map
+	std::vector<int> tilesAffected;
+	_explosionHits.resize(_save->getMapSizeXYZ(), 0);
+	Position hitMin(INT_MAX, INT_MAX, INT_MAX), hitMax(INT_MIN, INT_MIN, INT_MIN);
 
 	if (type == DT_IN)
 	{
@@ -1244,19 +1438,18 @@ void TileEngine::explode(const Position &center, int power, ItemDamageType type,
 		vertdec = 5;
 	}
 
-
-	for (int fi = -90; fi <= 90; fi += 5)
-//	for (int fi = 0; fi <= 0; fi += 10)
+	Tile *centerTile = _save->getTile(Position(centerX, centerY, centerZ));
+	for (int f = 0; f < ExplosionRays::UPDOWN; ++f)
 	{
 		// raytrace every 3 degrees makes sure we cover all tiles in a circle.
-		for (int te = 0; te <= 360; te += 3)
+		for (int t = 0; t < ExplosionRays::AROUND; ++t)
 		{
-			double cos_te = cos(te * M_PI / 180.0);
-			double sin_te = sin(te * M_PI / 180.0);
-			double sin_fi = sin(fi * M_PI / 180.0);
-			double cos_fi = cos(fi * M_PI / 180.0);
+			double cos_te = explosionRays.cosTe[t];
+			double sin_te = explosionRays.sinTe[t];
+			double sin_fi = explosionRays.sinFi[f];
+			double cos_fi = explosionRays.cosFi[f];
 
-			Tile *origin = _save->getTile(Position(centerX, centerY, centerZ));
+			Tile *origin = centerTile;
 			double l = 0;
 			double vx, vy, vz;
 			int tileX, tileY, tileZ;
@@ -1298,9 +1491,13 @@ void TileEngine::explode(const Position &center, int power, ItemDamageType type,
 						dest->setExplosive(power_);
 					}
 
-					ret = tilesAffected.insert(dest); // check if we had this tile already
-					if (ret.second)
+					int index = _save->getTileIndex(dest->getPosition());
+					if (!_explosionHits[index]) // check if we had this tile already
 					{
+						_explosionHits[index] = 1;
+						tilesAffected.push_back(index);
+						hitMin = Position(std::min(hitMin.x, tileX), std::min(hitMin.y, tileY), std::min(hitMin.z, tileZ));
+						hitMax = Position(std::max(hitMax.x, tileX), std::max(hitMax.y, tileY), std::max(hitMax.z, tileZ));
 						if (type == DT_STUN)
 						{
 							// power 50 - 150%
@@ -1389,23 +1586,37 @@ void TileEngine::explode(const Position &center, int power, ItemDamageType type,
 			}
 		}
 	}
+	// map order, same as the tile pointers, since the tiles are in one block
+	std::sort(tilesAffected.begin(), tilesAffected.end());
+	for (std::vector<int>::iterator i = tilesAffected.begin(); i != tilesAffected.end(); ++i)
+	{
+		_explosionHits[*i] = 0;
+	}
+
 	// now detonate the tiles affected with HE
 
 	if (type == DT_HE)
 	{
-		for (std::set<Tile*>::iterator i = tilesAffected.begin(); i != tilesAffected.end(); ++i)
+		for (std::vector<int>::iterator i = tilesAffected.begin(); i != tilesAffected.end(); ++i)
 		{
-			if (detonate(*i))
+			Tile *tile = _save->getTiles()[*i];
+			if (detonate(tile))
 				_save->setObjectiveDestroyed(true);
-			applyGravity(*i);
-			Tile *j = _save->getTile((*i)->getPosition() + Position(0,0,1));
+			applyGravity(tile);
+			Tile *j = _save->getTile(tile->getPosition() + Position(0,0,1));
 			if (j)
 				applyGravity(j);
 		}
 	}
 
-	calculateSunShading(); // roofs could have been destroyed
-	calculateTerrainLighting(); // fires could have been started
+	if (tilesAffected.empty())
+	{
+		hitMin = hitMax = Position((int)centerX, (int)centerY, (int)centerZ);
+	}
+	// detonating also breaks the walls and ceilings on the far sides of the tiles
+	calculateSunShading(hitMin.x - 1, hitMin.y - 1, hitMax.x + 1, hitMax.y + 1); // roofs could have been destroyed
+	calculateTerrainLighting(hitMin.x - 1, hitMin.y - 1, hitMax.x + 1, hitMax.y + 1); // fires could have been started
+	_save->getPathfinding()->invalidateStepCosts(); // and terrain destroyed
 	calculateFOV(center / Position(16,16,24));
 }
 
@@ -1912,6 +2123,7 @@ int TileEngine::unitOpensDoor(BattleUnit *unit, bool rClick, int dir)
 					door = tile->openDoor(i->second, unit, _save->getDebugMode());
 					if (door != -1)
 					{
+						_save->getPathfinding()->invalidateStepCosts(tile->getPosition());
 						part = i->second;
 						if (door == 1)
 						{
@@ -1972,6 +2184,7 @@ void TileEngine::checkAdjacentDoors(Position pos, int part)
 		if (tile && tile->getMapData(part) && tile->getMapData(part)->isUFODoor())
 		{
 			tile->openDoor(part);
+			_save->getPathfinding()->invalidateStepCosts(tile->getPosition());
 		}
 		else break;
 	}
@@ -1982,6 +2195,7 @@ void TileEngine::checkAdjacentDoors(Position pos, int part)
 		if (tile && tile->getMapData(part) && tile->getMapData(part)->isUFODoor())
 		{
 			tile->openDoor(part);
+			_save->getPathfinding()->invalidateStepCosts(tile->getPosition());
 		}
 		else break;
 	}
@@ -2012,6 +2226,10 @@ int TileEngine::closeUfoDoors()
 		}
 		doorsclosed += _save->getTiles()[i]->closeUfoDoor();
 	}
+	if (doorsclosed)
+	{
+		_save->getPathfinding()->invalidateStepCosts();
+	}
 
 	return doorsclosed;
 }
@@ -2310,19 +2528,27 @@ int TileEngine::voxelCheck(const Position& voxel, BattleUnit *excludeUnit, bool
 	}
 
 	// first we check terrain voxel data, not to allow 2x2 units stick through walls
-	for (int i=0; i< 4; ++i)
+	if (_voxelGrid == 0)
 	{
-		MapData *mp = tile->getMapData(i);
-		if (tile->isUfoDoorOpen(i))
-			continue;
-		if (mp != 0)
+		_voxelGrid = new VoxelGrid(_save, _voxelData);
+	}
+	// the grid tells if any object is hit, then find out which
+	if (_voxelGrid->hasTerrain(tile, voxel))
+	{
+		for (int i=0; i< 4; ++i)
 		{
-			int x = 15 - voxel.x%16;
-			int y = voxel.y%16;
-			int idx = (mp->getLoftID((voxel.z%24)/2)*16) + y;
-			if (_voxelData->at(idx) & (1 << x))
+			MapData *mp = tile->getMapData(i);
+			if (tile->isUfoDoorOpen(i))
+				continue;
+			if (mp != 0)
 			{
-				return i;
+				int x = 15 - voxel.x%16;
+				int y = voxel.y%16;
+				int idx = (mp->getLoftID((voxel.z%24)/2)*16) + y;
+				if (_voxelData->at(idx) & (1 << x))
+				{
+					return i;
+				}
 			}
 		}
 	}
@@ -2696,6 +2922,7 @@ bool TileEngine::validateThrow(BattleAction *action)
  */
 void TileEngine::recalculateFOV()
 {
+	BattleProfiler::Scope profile(BattleProfiler::PROFILE_FOV);
 	for (std::vector<BattleUnit*>::iterator bu = _save->getUnits()->begin(); bu != _save->getUnits()->end(); ++bu)
 	{
 		if ((*bu)->getTile() != 0)
@@ -20,7 +20,9 @@
 #define OPENXCOM_TILEENGINE_H
 
 #include <vector>
+#include <map>
 #include "Position.h"
+#include "LightLayer.h"
 #include "../Ruleset/MapData.h"
 #include <SDL.h>
 #include "BattlescapeGame.h"
@@ -33,6 +35,10 @@ class SavedBattleGame;
 class BattleUnit;
 class BattleItem;
 class Tile;
+class SightLineTree;
+class VoxelGrid;
+class ThreatMap;
+class SightCache;
 
 /**
  * A utility class that modifies tile properties on a battlescape map. This includes lighting, destruction, smoke, fire, fog of war.
@@ -40,23 +46,45 @@ class Tile;
  */
 class TileEngine
 {
-private:
+public:
 	static const int MAX_VIEW_DISTANCE = 20;
+private:
 	static const int MAX_VOXEL_VIEW_DISTANCE = MAX_VIEW_DISTANCE * 16;
 	static const int MAX_DARKNESS_TO_SEE_UNITS = 9;
 	SavedBattleGame *_save;
 	std::vector<Uint16> *_voxelData;
 	static const int heightFromCenter[11];
-	void addLight(const Position &center, int power, int layer);
 	int blockage(Tile *tile, const int part, ItemDamageType type, int direction = -1);
 	bool _personalLighting;
+	SightLineTree *_sightLines;
+	bool _checkFOV;
+	LightLayer *_terrainLight, *_unitLight;
+	VoxelGrid *_voxelGrid;
+	ThreatMap *_threatMap;
+	SightCache *_sightCache;
+	std::map<int, LightSource> _terrainSources;
+	std::vector<Uint8> _explosionHits;
+	/// Get the light a tile gives off by itself.
+	int getTerrainLight(int index) const;
+	/// Check if a unit can target another from its eyes, through the sight cache.
+	bool canTargetUnitFromEyes(BattleUnit *unit, const Position &eye, Tile *tile, Position *scanVoxel);
+	/// Check the sight line tree sees the same as the old way.
+	void checkFOVSweep(BattleUnit *unit, const Position &eye, const std::vector<Position> &targets);
+	/// Trace the terrain a unit sees from one eye, the old way, one line per tile.
+	void traceFOVLines(BattleUnit *unit, const Position &eye, const std::vector<Position> &targets, std::vector<Position> *seen);
 public:
 	/// Creates a new TileEngine class.
 	TileEngine(SavedBattleGame *save, std::vector<Uint16> *voxelData);
 	/// Cleans up the TileEngine.
 	~TileEngine();
+	/// Forgets everything cached about the map tiles.
+	void resetMapCache();
+	/// Gets the cache of lines of sight between units.
+	SightCache *getSightCache();
 	/// Calculate sun shading of the whole map.
 	void calculateSunShading();
+	/// Calculate sun shading of the map columns in an area.
+	void calculateSunShading(int minX, int minY, int maxX, int maxY);
 	/// Calculate sun shading of a single tile.
 	void calculateSunShading(Tile *tile);
 	/// Calculate the field of view from a units view point.
@@ -67,6 +95,8 @@ public:
 	bool checkReactionFire(BattleUnit *unit);
 	/// Recalculate lighting of the battlescape.
 	void calculateTerrainLighting();
+	/// Recalculate lighting of the battlescape after an area changed.
+	void calculateTerrainLighting(int minX, int minY, int maxX, int maxY);
 	/// Recalculate lighting of the battlescape.
 	void calculateUnitLighting();
 	/// Explosions.
@@ -83,7 +113,11 @@ public:
 	/// Calculate a parabola trajectory.
 	int calculateParabola(const Position& origin, const Position& target, bool storeTrajectory, std::vector<Position> *trajectory, BattleUnit *excludeUnit, double curvature, double accuracy);
 	/// Find all the soldiers that would see queryingUnit at tile (aka tilePos) and collect some statistics for AI.
-	bool surveyXComThreatToTile(Tile *tile, Position &tilePos, BattleUnit *hypotheticalUnit);	
+	bool surveyXComThreatToTile(Tile *tile, BattleUnit *hypotheticalUnit);
+	/// Find the soldiers that would see hypotheticalUnit at each of several tiles.
+	void surveyXComThreatToTiles(const std::vector<Tile*> &tiles, BattleUnit *hypotheticalUnit);
+	/// Forget the threat to the tiles surveyed for the AI.
+	void resetThreatMap(bool clearMarkers);
 	/// Get the origin voxel of a unit's eyesight
 	Position getSightOriginVoxel(BattleUnit *currentUnit);
 	/// Check visibility of a unit on this tile
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "VoxelGrid.h"
+#include "Position.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/Tile.h"
+#include "../Ruleset/MapData.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates a voxel grid for the whole map,
+ * with every tile to be worked out when first checked.
+ * @param save Pointer to the battle.
+ * @param voxelData Voxel shapes (LOFTEMPS).
+ */
+VoxelGrid::VoxelGrid(SavedBattleGame *save, const std::vector<Uint16> *voxelData) : _save(save), _voxelData(voxelData)
+{
+	_terrain.resize(_save->getMapSizeXYZ() * LAYERS * ROWS, 0);
+	_versions.resize(_save->getMapSizeXYZ(), 0);
+	_built.resize(_save->getMapSizeXYZ(), 0);
+}
+
+/**
+ *
+ */
+VoxelGrid::~VoxelGrid()
+{
+}
+
+/**
+ * Merges the voxel shapes of all the objects of a tile,
+ * leaving out open ufo doors, same as TileEngine::voxelCheck.
+ * @param tile Pointer to the tile.
+ * @param rows Returns the voxel rows of each layer of the tile.
+ */
+void VoxelGrid::build(Tile *tile, Uint16 *rows)
+{
+	for (int i = 0; i < LAYERS * ROWS; ++i)
+	{
+		rows[i] = 0;
+	}
+	for (int part = 0; part < 4; ++part)
+	{
+		MapData *mp = tile->getMapData(part);
+		if (mp == 0 || tile->isUfoDoorOpen(part))
+			continue;
+		for (int layer = 0; layer < LAYERS; ++layer)
+		{
+			size_t idx = mp->getLoftID(layer) * ROWS;
+			if (idx + ROWS > _voxelData->size())
+				continue;
+			for (int y = 0; y < ROWS; ++y)
+			{
+				rows[layer * ROWS + y] |= (*_voxelData)[idx + y];
+			}
+		}
+	}
+}
+
+/**
+ * Works out the terrain voxels of all the tiles that are new or have
+ * changed shape, so checking voxels doesn't change the grid anymore
+ * until a tile changes again, and can be done from several threads.
+ */
+void VoxelGrid::update()
+{
+	for (int index = 0; index < _save->getMapSizeXYZ(); ++index)
+	{
+		Tile *tile = _save->getTiles()[index];
+		if (!_built[index] || _versions[index] != tile->getShapeVersion())
+		{
+			build(tile, &_terrain[index * LAYERS * ROWS]);
+			_versions[index] = tile->getShapeVersion();
+			_built[index] = 1;
+		}
+	}
+}
+
+/**
+ * Checks if a voxel is inside any of the terrain objects of a tile.
+ * @param tile Pointer to the tile containing the voxel.
+ * @param voxel Position of the voxel on the map.
+ * @return True if the voxel is solid terrain.
+ */
+bool VoxelGrid::hasTerrain(Tile *tile, const Position &voxel)
+{
+	int index = _save->getTileIndex(tile->getPosition());
+	Uint16 *rows = &_terrain[index * LAYERS * ROWS];
+	if (!_built[index] || _versions[index] != tile->getShapeVersion())
+	{
+		build(tile, rows);
+		_versions[index] = tile->getShapeVersion();
+		_built[index] = 1;
+	}
+	return (rows[(voxel.z % 24) / 2 * ROWS + voxel.y % 16] & (1 << (15 - voxel.x % 16))) != 0;
+}
+
+}
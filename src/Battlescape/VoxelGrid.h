@@ -0,0 +1,63 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_VOXELGRID_H
+#define OPENXCOM_VOXELGRID_H
+
+#include <vector>
+#include <SDL_types.h>
+
+namespace OpenXcom
+{
+
+class SavedBattleGame;
+class Tile;
+class Position;
+
+/**
+ * The solid terrain voxels of the whole battlescape map, one bit
+ * per voxel, with all the objects of a tile merged together. Lets
+ * rays test a voxel for terrain with a single bit test, and only look
+ * at the tile objects when they actually hit something. Tiles are
+ * worked out again when their shape changes, the next time they're checked.
+ */
+class VoxelGrid
+{
+private:
+	static const int LAYERS = 12, ROWS = 16;
+	SavedBattleGame *_save;
+	const std::vector<Uint16> *_voxelData;
+	std::vector<Uint16> _terrain;
+	std::vector<unsigned int> _versions;
+	std::vector<Uint8> _built;
+	/// Works out the terrain voxels of a tile.
+	void build(Tile *tile, Uint16 *rows);
+public:
+	/// Creates an empty voxel grid.
+	VoxelGrid(SavedBattleGame *save, const std::vector<Uint16> *voxelData);
+	/// Cleans up the voxel grid.
+	~VoxelGrid();
+	/// Works out the terrain voxels of every tile that needs it.
+	void update();
+	/// Checks if a voxel is inside the terrain of a tile.
+	bool hasTerrain(Tile *tile, const Position &voxel);
+};
+
+}
+
+#endif
@@ -18,35 +18,37 @@
  */
 
 #include "CatFile.h"
+#include <cstring>
 
 namespace OpenXcom
 {
 
 /**
- * Creates a CAT file stream. A CAT file starts with an index of the
+ * Opens a CAT file. A CAT file starts with an index of the
  * offset and size of every file contained within. Each file consists
  * of a filename followed by its contents.
  * @param path Full path to CAT file.
  */
-CatFile::CatFile(const char *path) : std::ifstream(path, std::ios::in | std::ios::binary), _amount(0), _offset(0), _size(0)
+CatFile::CatFile(const char *path) : _data(), _open(false), _amount(0), _offset(0), _size(0)
 {
-	if (!this)
+	_open = _data.open(path);
+	if (!_open)
 		return;
 
 	// Get amount of files
-	read((char*)&_amount, sizeof(_amount));
+	_data.read((char*)&_amount, sizeof(_amount));
 	_amount /= 2 * sizeof(_amount);
 
 	// Get object offsets
-	seekg(0, std::ios::beg);
+	_data.seek(0);
 
 	_offset = new unsigned int[_amount];
 	_size   = new unsigned int[_amount];
 
 	for (unsigned int i = 0; i < _amount; ++i)
 	{
-		read((char*)&_offset[i], sizeof(*_offset));
-		read((char*)&_size[i],   sizeof(*_size));
+		_data.read((char*)&_offset[i], sizeof(*_offset));
+		_data.read((char*)&_size[i],   sizeof(*_size));
 	}
 }
 
@@ -57,30 +59,41 @@ CatFile::~CatFile()
 {
 	delete[] _offset;
 	delete[] _size;
+}
+
+/**
+ * Gets the contents of an object straight from the file,
+ * without copying it. Stays valid as long as the CAT file.
+ * @param i Object number to get.
+ * @return Pointer to the object, or 0 if it's outside the file.
+ */
+const Uint8 *CatFile::getObject(unsigned int i) const
+{
+	if (i >= _amount || _offset[i] >= _data.getSize())
+		return 0;
 
-	close();
+	// Skip filename
+	unsigned int start = _offset[i] + 1 + _data.getData()[_offset[i]];
+	if (start > _data.getSize() || _size[i] > _data.getSize() - start)
+		return 0;
+
+	return _data.getData() + start;
 }
 
 /**
- * Loads an object into memory.
+ * Loads a copy of an object into memory.
  * @param i Object number to load.
  * @return Pointer to the loaded object.
  */
 char *CatFile::load(unsigned int i)
 {
-	if (i >= _amount)
+	const Uint8 *data = getObject(i);
+	if (data == 0)
 		return 0;
 
-	seekg(_offset[i], std::ios::beg);
-
-	// Skip filename
-	char namesize;
-	read(&namesize, 1);
-	seekg(namesize, std::ios::cur);
-
 	// Read object
 	char *object = new char[_size[i]];
-	read(object, _size[i]);
+	memcpy(object, data, _size[i]);
 
 	return object;
 }
@@ -20,27 +20,30 @@
 #ifndef OPENXCOM_CATFILE_H
 #define OPENXCOM_CATFILE_H
 
-#include <fstream>
+#include "DataBuffer.h"
 
 namespace OpenXcom
 {
 
 /**
- * Subclass of std::ifstream to handle CAT files
+ * Handles CAT files, reading the objects
+ * straight from the file contents in memory.
  */
-class CatFile : protected std::ifstream
+class CatFile
 {
 private:
+	DataBuffer _data;
+	bool _open;
 	unsigned int _amount, *_offset, *_size;
 public:
-	/// Creates a CAT file stream.
+	/// Opens a CAT file.
 	CatFile(const char *path);
-	/// Cleans up the stream.
+	/// Cleans up the CAT file.
 	~CatFile();
-	/// Inherit operator.
+	/// Checks if the file failed to open.
 	bool operator !() const
 	{
-		return std::ifstream::operator!();
+		return !_open;
 	}
 	/// Get amount of objects.
 	int getAmount() const
@@ -52,6 +55,8 @@ public:
 	{
 		return (i < _amount) ? _size[i] : 0;
 	}
+	/// Get an object's contents.
+	const Uint8 *getObject(unsigned int i) const;
 	/// Load an object into memory.
 	char *load(unsigned int i);
 };
@@ -18,6 +18,7 @@
  */
 #include "CrossPlatform.h"
 #include <algorithm>
+#include <map>
 #include <iostream>
 #include "../dirent.h"
 #include "Logger.h"
@@ -43,6 +44,8 @@
 #include <unistd.h>
 #include <sys/param.h>
 #include <sys/types.h>
+#include <sys/time.h>
+#include <time.h>
 #include <pwd.h>
 #endif
 
@@ -268,117 +271,236 @@ std::string findConfigFolder()
 }
 
 /**
- * Takes a path and tries to find it based on the
- * system's case-sensitivity.
- * @param base Base unaltered path.
- * @param path Full path to check for casing.
- * @return Correct filename or "" if it doesn't exist.
- * @note There's no actual method for figuring out the correct
- * filename on case-sensitive systems, this is just a workaround.
+ * Data files and folders found in each of the Data folders,
+ * by their case-folded path relative to the folder.
  */
-std::string caseInsensitive(const std::string &base, const std::string &path)
+struct DataIndex
 {
-	std::string fullPath = base + path, newPath = path;
+	std::string root;
+	std::map<std::string, std::string> files, folders;
+};
+
+std::vector<DataIndex> _dataIndex;
+bool _dataIndexed = false;
 
-	// Try all various case mutations
-	// Normal unmangled
-	if (fileExists(fullPath.c_str()))
+/**
+ * Folds a path relative to a Data folder into a key of the index,
+ * so lookups don't care about case or path style.
+ * @param path Relative path.
+ * @return Uppercase path with forward slashes and no ending slash.
+ */
+std::string getIndexKey(const std::string &path)
+{
+	std::string key = path;
+	std::replace(key.begin(), key.end(), '\\', '/');
+	std::transform(key.begin(), key.end(), key.begin(), toupper);
+	while (!key.empty() && key[key.size() - 1] == '/')
 	{
-		return fullPath;
+		key.erase(key.size() - 1);
 	}
+	return key;
+}
 
-	// UPPERCASE
-	std::transform(newPath.begin(), newPath.end(), newPath.begin(), toupper);
-	fullPath = base + newPath;
-	if (fileExists(fullPath.c_str()))
+/**
+ * Adds the contents of a folder to a Data folder index,
+ * going through all its subfolders.
+ * @param index Data folder index.
+ * @param path Path of the folder relative to the Data folder.
+ * @param depth How many folders deep it is, to stop at circular links.
+ */
+void indexFolder(DataIndex &index, const std::string &path, int depth)
+{
+	DIR *dp = opendir((index.root + path).c_str());
+	if (dp == 0)
 	{
-		return fullPath;
+		return;
 	}
-
-	// lowercase
-	std::transform(newPath.begin(), newPath.end(), newPath.begin(), tolower);
-	fullPath = base + newPath;
-	if (fileExists(fullPath.c_str()))
+	std::vector<std::string> folders;
+	struct dirent *dirp;
+	while ((dirp = readdir(dp)) != 0)
 	{
-		return fullPath;
+		std::string file = dirp->d_name;
+		if (file == "." || file == "..")
+		{
+			continue;
+		}
+		std::string relative = path + file;
+		std::string key = getIndexKey(relative);
+		if (folderExists(index.root + relative))
+		{
+			// keep the first match, like the lookup used to
+			if (index.folders.find(key) == index.folders.end())
+			{
+				index.folders[key] = relative;
+			}
+			folders.push_back(relative);
+		}
+		else if (index.files.find(key) == index.files.end())
+		{
+			index.files[key] = relative;
+		}
+	}
+	closedir(dp);
+	if (depth < 16)
+	{
+		for (std::vector<std::string>::iterator i = folders.begin(); i != folders.end(); ++i)
+		{
+			indexFolder(index, *i + PATH_SEPARATOR, depth + 1);
+		}
 	}
-
-	// If we got here nothing can help us
-	return "";
 }
 
 /**
- * Takes a path and tries to find it based on the
- * system's case-sensitivity.
- * @param base Base unaltered path.
- * @param path Full path to check for casing.
- * @return Correct foldername or "" if it doesn't exist.
- * @note There's no actual method for figuring out the correct
- * foldername on case-sensitive systems, this is just a workaround.
+ * Scans all the game's Data folders for their files and folders,
+ * so looking up data files doesn't need to touch the filesystem.
+ * Needs to be called again if the Data folders or their contents change,
+ * like when mods are added.
  */
-std::string caseInsensitiveFolder(const std::string &base, const std::string &path)
+void rescanDataFolders()
 {
-	std::string fullPath = base + path, newPath = path;
+	std::vector<std::string> roots;
+	if (!Options::getDataFolder().empty())
+	{
+		roots.push_back(Options::getDataFolder());
+	}
+	for (std::vector<std::string>::iterator i = Options::getDataList()->begin(); i != Options::getDataList()->end(); ++i)
+	{
+		if (std::find(roots.begin(), roots.end(), *i) == roots.end())
+		{
+			roots.push_back(*i);
+		}
+	}
 
-	// Try all various case mutations
-	// Normal unmangled
-	if (folderExists(fullPath.c_str()))
+	_dataIndex.clear();
+	_dataIndex.resize(roots.size());
+	size_t files = 0;
+	for (size_t i = 0; i < roots.size(); ++i)
 	{
-		return fullPath;
+		_dataIndex[i].root = roots[i];
+		indexFolder(_dataIndex[i], "", 0);
+		files += _dataIndex[i].files.size();
 	}
+	_dataIndexed = true;
+	Log(LOG_INFO) << "Indexed " << files << " data files in " << roots.size() << " folders.";
+}
 
-	// UPPERCASE
-	std::transform(newPath.begin(), newPath.end(), newPath.begin(), toupper);
-	fullPath = base + newPath;
-	if (folderExists(fullPath.c_str()))
+/**
+ * Looks up a path in the Data folder indexes. The current
+ * Data folder goes first, then every other one, which becomes
+ * the current Data folder if the path is found there.
+ * @param name Path relative to the Data folders.
+ * @param folder Look for a folder instead of a file.
+ * @return Full path or "" if it doesn't exist.
+ */
+std::string findData(const std::string &name, bool folder)
+{
+	if (!_dataIndexed)
+	{
+		rescanDataFolders();
+	}
+	std::string key = getIndexKey(name);
+	const DataIndex *found = 0;
+	std::map<std::string, std::string>::const_iterator path;
+	for (std::vector<DataIndex>::const_iterator i = _dataIndex.begin(); i != _dataIndex.end() && found == 0; ++i)
+	{
+		if (i->root == Options::getDataFolder())
+		{
+			const std::map<std::string, std::string> &paths = folder ? i->folders : i->files;
+			path = paths.find(key);
+			if (path != paths.end())
+				found = &(*i);
+		}
+	}
+	for (std::vector<DataIndex>::const_iterator i = _dataIndex.begin(); i != _dataIndex.end() && found == 0; ++i)
+	{
+		const std::map<std::string, std::string> &paths = folder ? i->folders : i->files;
+		path = paths.find(key);
+		if (path != paths.end())
+		{
+			found = &(*i);
+			Options::setDataFolder(i->root);
+		}
+	}
+	if (found == 0)
 	{
-		return fullPath;
+		return "";
 	}
+	std::string full = found->root + path->second;
+	if (folder && !name.empty() && (name[name.size() - 1] == '/' || name[name.size() - 1] == '\\'))
+	{
+		full += PATH_SEPARATOR;
+	}
+	return full;
+}
 
-	// lowercase
-	std::transform(newPath.begin(), newPath.end(), newPath.begin(), tolower);
-	fullPath = base + newPath;
-	if (folderExists(fullPath.c_str()))
+/**
+ * Gets the key a data file has in the Data folder indexes,
+ * which is the same no matter which Data folder it's in.
+ * @param path Full path to the file, or path relative to the Data folders.
+ * @return Uppercase relative path with forward slashes.
+ */
+std::string getDataKey(const std::string &path)
+{
+	for (std::vector<DataIndex>::const_iterator i = _dataIndex.begin(); i != _dataIndex.end(); ++i)
 	{
-		return fullPath;
+		if (!i->root.empty() && path.compare(0, i->root.size(), i->root) == 0)
+		{
+			return getIndexKey(path.substr(i->root.size()));
+		}
 	}
+	return getIndexKey(path);
+}
 
-	// If we got here nothing can help us
-	return "";
+/**
+ * Gets every file in the game's Data folders. Files that
+ * exist in more than one folder come from the current one,
+ * or else from the first folder that has them.
+ * @return Map of index keys to full paths.
+ */
+std::map<std::string, std::string> getDataFiles()
+{
+	if (!_dataIndexed)
+	{
+		rescanDataFolders();
+	}
+	std::map<std::string, std::string> files;
+	for (std::vector<DataIndex>::const_iterator i = _dataIndex.begin(); i != _dataIndex.end(); ++i)
+	{
+		if (i->root != Options::getDataFolder())
+			continue;
+		for (std::map<std::string, std::string>::const_iterator j = i->files.begin(); j != i->files.end(); ++j)
+		{
+			files[j->first] = i->root + j->second;
+		}
+	}
+	for (std::vector<DataIndex>::const_iterator i = _dataIndex.begin(); i != _dataIndex.end(); ++i)
+	{
+		for (std::map<std::string, std::string>::const_iterator j = i->files.begin(); j != i->files.end(); ++j)
+		{
+			if (files.find(j->first) == files.end())
+			{
+				files[j->first] = i->root + j->second;
+			}
+		}
+	}
+	return files;
 }
 
 /**
  * Takes a filename and tries to find it in the game's Data folders,
  * accounting for the system's case-sensitivity and path style.
+ * The Data folders are only scanned once, see rescanDataFolders().
  * @param filename Original filename.
  * @return Correct filename or "" if it doesn't exist.
  */
 std::string getDataFile(const std::string &filename)
 {
-	// Correct folder separator
-	std::string name = filename;
-#ifdef _WIN32
-	std::replace(name.begin(), name.end(), '/', PATH_SEPARATOR);
-#endif
-
-	// Check current data path
-	std::string path = caseInsensitive(Options::getDataFolder(), name);
+	std::string path = findData(filename, false);
 	if (path != "")
 	{
 		return path;
 	}
 
-	// Check every other path
-	for (std::vector<std::string>::iterator i = Options::getDataList()->begin(); i != Options::getDataList()->end(); ++i)
-	{
-		std::string path = caseInsensitive(*i, name);
-		if (path != "")
-		{
-			Options::setDataFolder(*i);
-			return path;
-		}
-	}
-
 	// Give up
 	return filename;
 }
@@ -386,35 +508,18 @@ std::string getDataFile(const std::string &filename)
 /**
  * Takes a foldername and tries to find it in the game's Data folders,
  * accounting for the system's case-sensitivity and path style.
+ * The Data folders are only scanned once, see rescanDataFolders().
  * @param foldername Original foldername.
  * @return Correct foldername or "" if it doesn't exist.
  */
 std::string getDataFolder(const std::string &foldername)
 {
-	// Correct folder separator
-	std::string name = foldername;
-#ifdef _WIN32
-	std::replace(name.begin(), name.end(), '/', PATH_SEPARATOR);
-#endif
-
-	// Check current data path
-	std::string path = caseInsensitiveFolder(Options::getDataFolder(), name);
+	std::string path = findData(foldername, true);
 	if (path != "")
 	{
 		return path;
 	}
 
-	// Check every other path
-	for (std::vector<std::string>::iterator i = Options::getDataList()->begin(); i != Options::getDataList()->end(); ++i)
-	{
-		std::string path = caseInsensitiveFolder(*i, name);
-		if (path != "")
-		{
-			Options::setDataFolder(*i);
-			return path;
-		}
-	}
-
 	// Give up
 	return foldername;
 }
@@ -552,5 +657,63 @@ bool deleteFile(const std::string &path)
 #endif
 }
 
+/**
+ * Gets the size and last modification time of a file,
+ * to tell if it changed since it was last looked at.
+ * @param path Full path to file.
+ * @param size Returns the size in bytes.
+ * @param modified Returns the modification time in seconds since 1970.
+ * @return True if the file exists, False otherwise.
+ */
+bool getFileInfo(const std::string &path, unsigned long *size, unsigned long *modified)
+{
+#ifdef _WIN32
+	WIN32_FILE_ATTRIBUTE_DATA info;
+	if (GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &info) == 0)
+	{
+		return false;
+	}
+	ULARGE_INTEGER time;
+	time.LowPart = info.ftLastWriteTime.dwLowDateTime;
+	time.HighPart = info.ftLastWriteTime.dwHighDateTime;
+	*size = info.nFileSizeLow;
+	*modified = (unsigned long)(time.QuadPart / 10000000 - 11644473600LL);
+	return true;
+#else
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0)
+	{
+		return false;
+	}
+	*size = info.st_size;
+	*modified = info.st_mtime;
+	return true;
+#endif
+}
+
+/**
+ * Gets a timestamp from the most precise clock available,
+ * for measuring how long things take. SDL_GetTicks() only
+ * goes down to milliseconds, which is too coarse for that.
+ * @return Time in microseconds since some arbitrary point.
+ */
+double getMicroseconds()
+{
+#ifdef _WIN32
+	LARGE_INTEGER count, frequency;
+	QueryPerformanceCounter(&count);
+	QueryPerformanceFrequency(&frequency);
+	return (double)count.QuadPart * 1000000.0 / (double)frequency.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000.0 + now.tv_nsec / 1000.0;
+#else
+	struct timeval now;
+	gettimeofday(&now, 0);
+	return now.tv_sec * 1000000.0 + now.tv_usec;
+#endif
+}
+
 }
 }
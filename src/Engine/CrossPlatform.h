@@ -21,6 +21,7 @@
 
 #include <string>
 #include <vector>
+#include <map>
 
 namespace OpenXcom
 {
@@ -43,6 +44,12 @@ namespace CrossPlatform
 	std::string getDataFile(const std::string &filename);
     /// Gets the path for a data folder
 	std::string getDataFolder(const std::string &foldername);
+	/// Scans the data folders for their contents.
+	void rescanDataFolders();
+	/// Gets the index key of a data file path.
+	std::string getDataKey(const std::string &path);
+	/// Gets every file in the data folders.
+	std::map<std::string, std::string> getDataFiles();
 	/// Creates a folder.
 	bool createFolder(const std::string &path);
 	/// Terminates a path.
@@ -55,6 +62,10 @@ namespace CrossPlatform
 	bool fileExists(const std::string &path);
 	/// Deletes the specified file.
 	bool deleteFile(const std::string &path);
+	/// Gets the size and modification time of a file.
+	bool getFileInfo(const std::string &path, unsigned long *size, unsigned long *modified);
+	/// Gets a high resolution timestamp.
+	double getMicroseconds();
 }
 
 }
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "DataBuffer.h"
+#include <fstream>
+#include <cstring>
+#include "DataPack.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates a data buffer with no file.
+ */
+DataBuffer::DataBuffer() : _copy(), _data(0), _size(0), _pos(0)
+{
+}
+
+/**
+ * Frees the file contents, if they were copied.
+ */
+DataBuffer::~DataBuffer()
+{
+}
+
+/**
+ * Opens a data file, which comes from the data pack if
+ * there's one open with the file in it, or else is read
+ * whole into memory from the Data folders.
+ * @param filename Full path to the file.
+ * @return True if the file was found.
+ */
+bool DataBuffer::open(const std::string &filename)
+{
+	_copy.clear();
+	_data = 0;
+	_size = 0;
+	_pos = 0;
+	if (DataPack::find(filename, &_data, &_size))
+	{
+		return true;
+	}
+
+	std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+	file.seekg(0, std::ios::end);
+	std::streamoff size = file.tellg();
+	file.seekg(0, std::ios::beg);
+	if (size > 0)
+	{
+		_copy.resize((size_t)size);
+		file.read((char*)&_copy[0], size);
+		_data = &_copy[0];
+		_size = (size_t)file.gcount();
+	}
+	return true;
+}
+
+/**
+ * Returns the whole contents of the file.
+ * @return Pointer to the file data.
+ */
+const Uint8 *DataBuffer::getData() const
+{
+	return _data;
+}
+
+/**
+ * Returns the size of the file.
+ * @return Size in bytes.
+ */
+size_t DataBuffer::getSize() const
+{
+	return _size;
+}
+
+/**
+ * Copies data from the current position and moves past it.
+ * Like a stream, if there isn't enough data left the
+ * rest is copied and the read fails.
+ * @param buffer Buffer to copy to.
+ * @param size Number of bytes to read.
+ * @return True if all the bytes were read.
+ */
+bool DataBuffer::read(void *buffer, size_t size)
+{
+	size_t left = _size - _pos;
+	if (size > left)
+	{
+		if (left > 0)
+			memcpy(buffer, _data + _pos, left);
+		_pos = _size;
+		return false;
+	}
+	memcpy(buffer, _data + _pos, size);
+	_pos += size;
+	return true;
+}
+
+/**
+ * Moves to a certain position in the file.
+ * @param pos Offset from the start of the file.
+ */
+void DataBuffer::seek(size_t pos)
+{
+	_pos = (pos < _size) ? pos : _size;
+}
+
+/**
+ * Moves forward a certain number of bytes.
+ * @param size Number of bytes to skip.
+ */
+void DataBuffer::skip(size_t size)
+{
+	seek(_pos + size);
+}
+
+/**
+ * Returns the current position in the file.
+ * @return Offset from the start of the file.
+ */
+size_t DataBuffer::tell() const
+{
+	return _pos;
+}
+
+/**
+ * Checks if there's nothing left to read.
+ * @return True if it's at the end of the file.
+ */
+bool DataBuffer::eof() const
+{
+	return _pos >= _size;
+}
+
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_DATABUFFER_H
+#define OPENXCOM_DATABUFFER_H
+
+#include <string>
+#include <vector>
+#include <SDL_types.h>
+
+namespace OpenXcom
+{
+
+/**
+ * The whole contents of a data file in memory, pointing straight
+ * into the data pack if the file is in it, or else read in one go
+ * from the Data folders. Reads work like a binary input stream,
+ * without going through the filesystem for every value.
+ */
+class DataBuffer
+{
+private:
+	std::vector<Uint8> _copy;
+	const Uint8 *_data;
+	size_t _size, _pos;
+public:
+	/// Creates an empty data buffer.
+	DataBuffer();
+	/// Cleans up the data buffer.
+	~DataBuffer();
+	/// Opens a data file.
+	bool open(const std::string &filename);
+	/// Gets the contents of the file.
+	const Uint8 *getData() const;
+	/// Gets the size of the file.
+	size_t getSize() const;
+	/// Reads from the current position.
+	bool read(void *buffer, size_t size);
+	/// Moves to a position in the file.
+	void seek(size_t pos);
+	/// Skips over part of the file.
+	void skip(size_t size);
+	/// Gets the current position in the file.
+	size_t tell() const;
+	/// Checks if the end of the file was reached.
+	bool eof() const;
+};
+
+}
+
+#endif
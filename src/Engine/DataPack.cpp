@@ -0,0 +1,372 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "DataPack.h"
+#include <map>
+#include <vector>
+#include <fstream>
+#include <cstring>
+#include "CrossPlatform.h"
+#include "Exception.h"
+#include "Logger.h"
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace OpenXcom
+{
+namespace DataPack
+{
+
+const char MAGIC[4] = {'O', 'X', 'P', 'K'};
+const Uint32 VERSION = 2;
+const Uint32 ALIGNMENT = 16;
+
+/// File types worth packing, the rest are only read once.
+const char *const EXTENSIONS[] = {"PCK", "TAB", "DAT", "CAT", "SCR", "SPK", "BDY", "MAP", "RMP", "MCD"};
+
+struct Entry
+{
+	Uint32 offset, size, modified;
+};
+
+std::map<std::string, Entry> _entries;
+const Uint8 *_data = 0;
+size_t _dataSize = 0;
+#ifdef _WIN32
+HANDLE _file = INVALID_HANDLE_VALUE, _mapping = 0;
+#endif
+
+/**
+ * Checks if a data file is of a type that goes in the pack.
+ * @param key Data key of the file.
+ * @return True if it should be packed.
+ */
+bool isPacked(const std::string &key)
+{
+	std::string::size_type dot = key.find_last_of('.');
+	if (dot == std::string::npos)
+		return false;
+	std::string ext = key.substr(dot + 1);
+	for (size_t i = 0; i < sizeof(EXTENSIONS) / sizeof(EXTENSIONS[0]); ++i)
+	{
+		if (ext == EXTENSIONS[i])
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Writes a pack with all the binary files found in the
+ * game's Data folders, ready to be opened by a later run.
+ * @param filename Full path to the pack to create.
+ */
+void build(const std::string &filename)
+{
+	std::map<std::string, std::string> all = CrossPlatform::getDataFiles();
+	std::vector<std::pair<std::string, std::string> > files;
+	for (std::map<std::string, std::string>::const_iterator i = all.begin(); i != all.end(); ++i)
+	{
+		if (isPacked(i->first))
+		{
+			files.push_back(*i);
+		}
+	}
+
+	// read everything first so the index knows the sizes
+	std::vector<std::vector<char> > contents(files.size());
+	std::vector<Uint32> modified(files.size(), 0);
+	Uint32 indexSize = sizeof(MAGIC) + sizeof(Uint32) * 2;
+	for (size_t i = 0; i < files.size(); ++i)
+	{
+		std::ifstream file(files[i].second.c_str(), std::ios::in | std::ios::binary);
+		if (!file)
+		{
+			throw Exception(files[i].second + " not found");
+		}
+		file.seekg(0, std::ios::end);
+		std::streamoff size = file.tellg();
+		file.seekg(0, std::ios::beg);
+		contents[i].resize((size_t)size);
+		if (size > 0)
+		{
+			file.read(&contents[i][0], size);
+		}
+		unsigned long fileSize, fileModified;
+		if (CrossPlatform::getFileInfo(files[i].second, &fileSize, &fileModified))
+		{
+			modified[i] = fileModified;
+		}
+		indexSize += sizeof(Uint32) * 3 + sizeof(Uint16) + files[i].first.size();
+	}
+
+	std::ofstream pack(filename.c_str(), std::ios::out | std::ios::binary);
+	if (!pack)
+	{
+		throw Exception("Failed to create " + filename);
+	}
+	Uint32 count = files.size();
+	pack.write(MAGIC, sizeof(MAGIC));
+	pack.write((const char*)&VERSION, sizeof(VERSION));
+	pack.write((const char*)&count, sizeof(count));
+
+	Uint32 offset = indexSize;
+	for (size_t i = 0; i < files.size(); ++i)
+	{
+		offset = (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+		Uint32 size = contents[i].size();
+		Uint16 length = files[i].first.size();
+		pack.write((const char*)&offset, sizeof(offset));
+		pack.write((const char*)&size, sizeof(size));
+		pack.write((const char*)&modified[i], sizeof(modified[i]));
+		pack.write((const char*)&length, sizeof(length));
+		pack.write(files[i].first.c_str(), length);
+		offset += size;
+	}
+
+	Uint32 position = indexSize;
+	const char padding[ALIGNMENT] = {0};
+	for (size_t i = 0; i < files.size(); ++i)
+	{
+		Uint32 start = (position + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+		pack.write(padding, start - position);
+		if (!contents[i].empty())
+		{
+			pack.write(&contents[i][0], contents[i].size());
+		}
+		position = start + contents[i].size();
+	}
+
+	if (!pack)
+	{
+		throw Exception("Failed to write " + filename);
+	}
+	pack.close();
+	Log(LOG_INFO) << "Packed " << files.size() << " data files (" << position / 1024 << "KB) into " << filename;
+}
+
+/**
+ * Unmaps the pack file from memory.
+ */
+void unmapFile()
+{
+#ifdef _WIN32
+	if (_data != 0)
+		UnmapViewOfFile(_data);
+	if (_mapping != 0)
+		CloseHandle(_mapping);
+	if (_file != INVALID_HANDLE_VALUE)
+		CloseHandle(_file);
+	_mapping = 0;
+	_file = INVALID_HANDLE_VALUE;
+#else
+	if (_data != 0)
+		munmap((void*)_data, _dataSize);
+#endif
+	_data = 0;
+	_dataSize = 0;
+}
+
+/**
+ * Maps a pack file into memory.
+ * @param filename Full path to the pack.
+ * @return True if it was mapped.
+ */
+bool mapFile(const std::string &filename)
+{
+#ifdef _WIN32
+	_file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+	if (_file == INVALID_HANDLE_VALUE)
+		return false;
+	_dataSize = GetFileSize(_file, 0);
+	_mapping = CreateFileMappingA(_file, 0, PAGE_READONLY, 0, 0, 0);
+	if (_mapping != 0)
+	{
+		_data = (const Uint8*)MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+	}
+	if (_data == 0)
+	{
+		unmapFile();
+		return false;
+	}
+	return true;
+#else
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size == 0)
+	{
+		::close(fd);
+		return false;
+	}
+	void *data = mmap(0, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (data == MAP_FAILED)
+		return false;
+	_data = (const Uint8*)data;
+	_dataSize = info.st_size;
+	return true;
+#endif
+}
+
+/**
+ * Opens a pack and reads its index, closing any pack
+ * that was open before. Files in the pack are read from it
+ * from then on, instead of from the Data folders.
+ * @param filename Full path to the pack.
+ * @return True if the pack was opened, False if it's missing or invalid.
+ */
+bool open(const std::string &filename)
+{
+	close();
+	if (!mapFile(filename))
+		return false;
+
+	const Uint8 *p = _data, *end = _data + _dataSize;
+	Uint32 version, count;
+	bool valid = (size_t)(end - p) >= sizeof(MAGIC) + sizeof(Uint32) * 2 && memcmp(p, MAGIC, sizeof(MAGIC)) == 0;
+	if (valid)
+	{
+		p += sizeof(MAGIC);
+		memcpy(&version, p, sizeof(version));
+		p += sizeof(version);
+		memcpy(&count, p, sizeof(count));
+		p += sizeof(count);
+		valid = (version == VERSION);
+	}
+	for (Uint32 i = 0; valid && i < count; ++i)
+	{
+		Entry entry;
+		Uint16 length;
+		if ((size_t)(end - p) < sizeof(Uint32) * 3 + sizeof(Uint16))
+		{
+			valid = false;
+			break;
+		}
+		memcpy(&entry.offset, p, sizeof(entry.offset));
+		p += sizeof(entry.offset);
+		memcpy(&entry.size, p, sizeof(entry.size));
+		p += sizeof(entry.size);
+		memcpy(&entry.modified, p, sizeof(entry.modified));
+		p += sizeof(entry.modified);
+		memcpy(&length, p, sizeof(length));
+		p += sizeof(length);
+		if ((size_t)(end - p) < length || entry.offset > _dataSize || entry.size > _dataSize - entry.offset)
+		{
+			valid = false;
+			break;
+		}
+		_entries[std::string((const char*)p, length)] = entry;
+		p += length;
+	}
+	if (!valid)
+	{
+		Log(LOG_WARNING) << filename << " is not a valid data pack, ignoring it.";
+		close();
+		return false;
+	}
+	Log(LOG_INFO) << "Opened data pack " << filename << " with " << _entries.size() << " files.";
+	checkFiles();
+	return true;
+}
+
+/**
+ * Compares the files in the open pack against the files in
+ * the Data folders that would be used instead, and drops the
+ * ones that don't match anymore, like files edited since the
+ * pack was built or replaced by a mod, so they're read from
+ * the Data folders. Files missing from the Data folders are
+ * kept, so the pack can be used on its own.
+ */
+void checkFiles()
+{
+	if (_data == 0)
+		return;
+	std::map<std::string, std::string> files = CrossPlatform::getDataFiles();
+	int stale = 0;
+	for (std::map<std::string, Entry>::iterator i = _entries.begin(); i != _entries.end();)
+	{
+		std::map<std::string, std::string>::const_iterator file = files.find(i->first);
+		unsigned long size, modified;
+		if (file != files.end() && CrossPlatform::getFileInfo(file->second, &size, &modified)
+			&& (size != i->second.size || (Uint32)modified != i->second.modified))
+		{
+			_entries.erase(i++);
+			++stale;
+		}
+		else
+		{
+			++i;
+		}
+	}
+	if (stale > 0)
+	{
+		Log(LOG_WARNING) << stale << " files changed since the data pack was built, reading them from the Data folders instead.";
+	}
+}
+
+/**
+ * Closes the open pack, if any, so everything
+ * is read from the Data folders again.
+ */
+void close()
+{
+	_entries.clear();
+	unmapFile();
+}
+
+/**
+ * Checks if there's a pack open.
+ * @return True if a pack is open.
+ */
+bool isOpen()
+{
+	return _data != 0;
+}
+
+/**
+ * Looks up a data file in the open pack. The contents
+ * stay valid until the pack is closed, and are read-only.
+ * @param path Full path to the file, or path relative to the Data folders.
+ * @param data Returns a pointer to the contents of the file.
+ * @param size Returns the size of the file in bytes.
+ * @return True if the file is in the pack.
+ */
+bool find(const std::string &path, const Uint8 **data, size_t *size)
+{
+	if (_data == 0)
+		return false;
+	std::map<std::string, Entry>::const_iterator i = _entries.find(CrossPlatform::getDataKey(path));
+	if (i == _entries.end())
+		return false;
+	*data = _data + i->second.offset;
+	*size = i->second.size;
+	return true;
+}
+
+}
+}
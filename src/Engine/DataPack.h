@@ -0,0 +1,56 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_DATAPACK_H
+#define OPENXCOM_DATAPACK_H
+
+#include <string>
+#include <SDL_types.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Single file holding the binary data files of the game's
+ * Data folders, so they can be read straight from memory
+ * instead of opening hundreds of small files.
+ * The pack starts with an index of every file by its data key
+ * (see CrossPlatform::getDataKey), followed by their contents.
+ * It's mapped into memory while open, and anything not in it
+ * is read from the Data folders as usual, as is anything that
+ * changed in the Data folders since the pack was built.
+ */
+namespace DataPack
+{
+	/// Builds a pack out of the Data folders.
+	void build(const std::string &filename);
+	/// Opens a pack.
+	bool open(const std::string &filename);
+	/// Drops files from the open pack that don't match the Data folders.
+	void checkFiles();
+	/// Closes the open pack.
+	void close();
+	/// Checks if a pack is open.
+	bool isOpen();
+	/// Finds a file in the open pack.
+	bool find(const std::string &path, const Uint8 **data, size_t *size);
+}
+
+}
+
+#endif
@@ -358,7 +358,7 @@ Music *GMCatFile::loadMIDI(unsigned int i)
 {
 	Music *music = new Music;
 
-	unsigned char *raw = static_cast<unsigned char*> ((void*)load(i));
+	const unsigned char *raw = getObject(i);
 
 	if (!raw)
 		return music;
@@ -366,7 +366,6 @@ Music *GMCatFile::loadMIDI(unsigned int i)
 	// stream info
 	struct gmstream stream;
 	if (gmext_read_stream(&stream, getObjectSize(i), raw) == -1) {
-		delete[] raw;
 		return music;
 	}
 
@@ -375,12 +374,9 @@ Music *GMCatFile::loadMIDI(unsigned int i)
 
 	// fields in stream still point into raw
 	if (gmext_write_midi(&stream, midi) == -1) {
-		delete[] raw;
 		return music;
 	}
 
-	delete[] raw;
-
 	music->load(&midi[0], midi.size());
 
 	return music;
@@ -39,6 +39,7 @@
 #include "InteractiveSurface.h"
 #include "Options.h"
 #include "CrossPlatform.h"
+#include "DataPack.h"
 #include "../Menu/SaveState.h"
 
 namespace OpenXcom
@@ -143,9 +144,10 @@ Game::~Game()
 
 	delete _cursor;
 	delete _lang;
+	// the battle still holds on to resources and rules
+	delete _save;
 	delete _res;
 	delete _rules;
-	delete _save;
 	delete _screen;
 	delete _fpsCounter;
 
@@ -471,17 +473,72 @@ Ruleset *Game::getRuleset() const
 
 /**
  * Changes the ruleset currently in use by the game.
- * @param filename Filename of the language file.
+ * If the ruleset cache is enabled, the rules are loaded
+ * from it when it's up to date with the ruleset files,
+ * or else parsed from the files and saved to it.
+ * If the list of rulesets changed since the last time,
+ * the Data folders are scanned again for any files
+ * the new rulesets brought along.
  */
 void Game::loadRuleset()
 {
-	_rules = new Ruleset();
 	std::vector<std::string> rulesets = Options::getRulesets();
-	for (std::vector<std::string>::iterator i = rulesets.begin(); i != rulesets.end(); ++i)
+	if (!_rulesetNames.empty() && rulesets != _rulesetNames)
+	{
+		CrossPlatform::rescanDataFolders();
+		DataPack::checkFiles();
+	}
+	_rulesetNames = rulesets;
+	std::string cache = Options::getUserFolder() + "ruleset.cache";
+	std::string key;
+	Uint32 start = SDL_GetTicks();
+	_rules = 0;
+	if (Options::getBool("rulesetCache"))
+	{
+		key = Ruleset::getCacheKey(rulesets);
+		_rules = new Ruleset();
+		try
+		{
+			if (_rules->loadCache(cache, key))
+			{
+				Log(LOG_INFO) << "Ruleset loaded from cache in " << SDL_GetTicks() - start << "ms.";
+			}
+			else
+			{
+				delete _rules;
+				_rules = 0;
+			}
+		}
+		catch (Exception &e)
+		{
+			Log(LOG_WARNING) << "Ignoring ruleset cache: " << e.what();
+			delete _rules;
+			_rules = 0;
+		}
+	}
+	if (_rules == 0)
 	{
-		_rules->load(*i);
+		_rules = new Ruleset();
+		for (std::vector<std::string>::iterator i = rulesets.begin(); i != rulesets.end(); ++i)
+		{
+			_rules->load(*i);
+		}
+		Log(LOG_INFO) << "Ruleset parsed in " << SDL_GetTicks() - start << "ms.";
+		if (Options::getBool("rulesetCache"))
+		{
+			try
+			{
+				_rules->saveCache(cache, key);
+			}
+			catch (Exception &e)
+			{
+				Log(LOG_WARNING) << e.what();
+			}
+		}
 	}
 	_rules->sortLists();
+	_rules->resolveResearch();
+	_rules->indexZones();
 }
 
 /**
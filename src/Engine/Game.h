@@ -21,6 +21,7 @@
 
 #include <list>
 #include <string>
+#include <vector>
 #include <SDL.h>
 
 namespace OpenXcom
@@ -52,6 +53,7 @@ private:
 	ResourcePack *_res;
 	SavedGame *_save;
 	Ruleset *_rules;
+	std::vector<std::string> _rulesetNames;
 	bool _quit, _init;
 	FpsCounter *_fpsCounter;
 	bool _mouseActive;
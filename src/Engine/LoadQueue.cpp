@@ -0,0 +1,272 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "LoadQueue.h"
+#include "Exception.h"
+#include "Logger.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates an empty loading queue.
+ */
+LoadQueue::LoadQueue() : _next(0), _nextMain(0), _done(0)
+{
+	_mutex = SDL_CreateMutex();
+}
+
+/**
+ * Waits for any workers still running and deletes all the jobs.
+ */
+LoadQueue::~LoadQueue()
+{
+	SDL_mutexP(_mutex);
+	_next = _jobs.size();
+	SDL_mutexV(_mutex);
+	for (std::vector<SDL_Thread*>::iterator i = _threads.begin(); i != _threads.end(); ++i)
+	{
+		SDL_WaitThread(*i, 0);
+	}
+	for (std::vector<Entry>::iterator i = _jobs.begin(); i != _jobs.end(); ++i)
+	{
+		delete i->job;
+	}
+	for (std::vector<Entry>::iterator i = _mainJobs.begin(); i != _mainJobs.end(); ++i)
+	{
+		delete i->job;
+	}
+	SDL_DestroyMutex(_mutex);
+}
+
+/**
+ * Adds a job to the queue, which takes ownership of it.
+ * Jobs can only be added before the queue is started.
+ * @param job Pointer to the job.
+ * @param category Category to add the job's time to.
+ * @param mainThread Whether the job has to run on the main thread.
+ */
+void LoadQueue::add(Job *job, const std::string &category, bool mainThread)
+{
+	Entry entry;
+	entry.job = job;
+	entry.category = category;
+	if (mainThread)
+	{
+		_mainJobs.push_back(entry);
+	}
+	else
+	{
+		_jobs.push_back(entry);
+	}
+}
+
+/**
+ * Runs a job, adding its time to its category. Once a job has failed,
+ * the rest are skipped, since the loading is doomed anyway. Whatever
+ * the job throws is kept to be rethrown as an Exception by finish().
+ * @param entry The job to run.
+ */
+void LoadQueue::run(const Entry &entry)
+{
+	SDL_mutexP(_mutex);
+	bool failed = !_error.empty();
+	SDL_mutexV(_mutex);
+
+	Uint32 start = SDL_GetTicks();
+	std::string error;
+	if (!failed)
+	{
+		try
+		{
+			entry.job->run();
+		}
+		catch (std::exception &e)
+		{
+			// anything thrown on a worker thread has to reach the main thread
+			error = e.what();
+			if (error.empty())
+			{
+				error = "Unknown error";
+			}
+		}
+		catch (...)
+		{
+			error = "Unknown error";
+		}
+	}
+	Uint32 time = SDL_GetTicks() - start;
+
+	SDL_mutexP(_mutex);
+	_times[entry.category] += time;
+	if (_error.empty())
+	{
+		_error = error;
+	}
+	_done++;
+	SDL_mutexV(_mutex);
+}
+
+/**
+ * Takes the next worker job off the queue and runs it.
+ * @return False if there were no jobs left.
+ */
+bool LoadQueue::runNext()
+{
+	SDL_mutexP(_mutex);
+	size_t next = _next;
+	if (_next < _jobs.size())
+	{
+		_next++;
+	}
+	SDL_mutexV(_mutex);
+	if (next >= _jobs.size())
+	{
+		return false;
+	}
+	run(_jobs[next]);
+	return true;
+}
+
+/**
+ * Keeps running worker jobs until there's none left.
+ * @param data Pointer to the queue.
+ * @return Always 0.
+ */
+int LoadQueue::worker(void *data)
+{
+	LoadQueue *queue = (LoadQueue*)data;
+	while (queue->runNext());
+	return 0;
+}
+
+/**
+ * Starts the worker threads, which work through the queue on their own.
+ * If no threads can be created, the worker jobs are run by update() instead.
+ * @param threads Number of worker threads.
+ */
+void LoadQueue::start(int threads)
+{
+	for (int i = 0; i < threads && i < (int)_jobs.size(); ++i)
+	{
+		SDL_Thread *thread = SDL_CreateThread(worker, this);
+		if (thread)
+		{
+			_threads.push_back(thread);
+		}
+	}
+}
+
+/**
+ * Runs main thread jobs until the time budget is used up.
+ * At least one job is run every time, so the loading always moves on.
+ * @param budget Time budget in milliseconds.
+ * @return True if all the jobs are done.
+ */
+bool LoadQueue::update(Uint32 budget)
+{
+	Uint32 start = SDL_GetTicks();
+	do
+	{
+		if (_nextMain < _mainJobs.size())
+		{
+			run(_mainJobs[_nextMain++]);
+		}
+		else if (!_threads.empty() || !runNext())
+		{
+			break;
+		}
+	}
+	while (SDL_GetTicks() - start < budget);
+	return isFinished();
+}
+
+/**
+ * Gets how much of the loading is done.
+ * @return Percentage of jobs done.
+ */
+int LoadQueue::getProgress() const
+{
+	size_t total = _jobs.size() + _mainJobs.size();
+	if (total == 0)
+	{
+		return 100;
+	}
+	SDL_mutexP(_mutex);
+	int done = _done;
+	SDL_mutexV(_mutex);
+	return done * 100 / total;
+}
+
+/**
+ * Gets if all the jobs are done.
+ * @return True if there's nothing left to do.
+ */
+bool LoadQueue::isFinished() const
+{
+	return getProgress() == 100;
+}
+
+/**
+ * Runs all the jobs left and waits for the workers to be done.
+ * @throws Exception with the error of the first job that failed.
+ */
+void LoadQueue::finish()
+{
+	while (_nextMain < _mainJobs.size())
+	{
+		run(_mainJobs[_nextMain++]);
+	}
+	while (runNext());
+	for (std::vector<SDL_Thread*>::iterator i = _threads.begin(); i != _threads.end(); ++i)
+	{
+		SDL_WaitThread(*i, 0);
+	}
+	_threads.clear();
+	if (!_error.empty())
+	{
+		throw Exception(_error);
+	}
+}
+
+/**
+ * Adds time spent on loading done outside of the queue to a category,
+ * so it shows up with the rest.
+ * @param category Category name.
+ * @param time Time in milliseconds.
+ */
+void LoadQueue::addTime(const std::string &category, Uint32 time)
+{
+	SDL_mutexP(_mutex);
+	_times[category] += time;
+	SDL_mutexV(_mutex);
+}
+
+/**
+ * Logs the time spent on every category. Worker time adds up
+ * over all the threads, so it can be more than the time it took.
+ */
+void LoadQueue::logTimes() const
+{
+	for (std::map<std::string, Uint32>::const_iterator i = _times.begin(); i != _times.end(); ++i)
+	{
+		Log(LOG_INFO) << "Loading " << i->first << " took " << i->second << "ms";
+	}
+}
+
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_LOADQUEUE_H
+#define OPENXCOM_LOADQUEUE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <SDL.h>
+#include <SDL_thread.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Runs a batch of loading work, spread over a few worker threads.
+ * Work that has to stay on the main thread (anything touching
+ * SDL_mixer or SDL_image) is run in small slices from the game loop,
+ * so the screen can keep showing the progress.
+ * The time spent is added up by category, to see where it goes.
+ */
+class LoadQueue
+{
+public:
+	/// A piece of loading work.
+	class Job
+	{
+	public:
+		virtual ~Job() {}
+		/// Does the work, throwing an Exception if it fails.
+		virtual void run() = 0;
+	};
+private:
+	struct Entry
+	{
+		Job *job;
+		std::string category;
+	};
+	std::vector<Entry> _jobs, _mainJobs;
+	size_t _next, _nextMain;
+	int _done;
+	std::string _error;
+	std::map<std::string, Uint32> _times;
+	std::vector<SDL_Thread*> _threads;
+	SDL_mutex *_mutex;
+	/// Runs a job, keeping track of its time and errors.
+	void run(const Entry &entry);
+	/// Runs the next worker job, if there's any left.
+	bool runNext();
+	/// Runs worker jobs until there's none left.
+	static int worker(void *data);
+public:
+	/// Creates an empty queue.
+	LoadQueue();
+	/// Waits for the workers and cleans up the queue.
+	~LoadQueue();
+	/// Adds a job to the queue.
+	void add(Job *job, const std::string &category, bool mainThread = false);
+	/// Starts the worker threads.
+	void start(int threads);
+	/// Runs main thread jobs for a while.
+	bool update(Uint32 budget);
+	/// Gets the percentage of jobs done.
+	int getProgress() const;
+	/// Gets if all the jobs are done.
+	bool isFinished() const;
+	/// Finishes all the jobs, throwing the first error.
+	void finish();
+	/// Adds time spent loading outside the queue.
+	void addTime(const std::string &category, Uint32 time);
+	/// Logs the time spent on each category.
+	void logTimes() const;
+};
+
+}
+
+#endif
@@ -42,6 +42,10 @@ std::string _dataFolder = "";
 std::vector<std::string> _dataList;
 std::string _userFolder = "";
 std::string _configFolder = "";
+std::string _packFile = "";
+std::string _cacheMode = "";
+std::string _convertSave = "", _simulateSave = "", _simulateBattle = "", _simulateTerrain = "", _simulateRace = "";
+int _simulateDays = 30, _simulateTurns = 20, _simulateSeed = 0, _benchmarkGlobe = 0;
 std::vector<std::string> _userList;
 std::map<std::string, std::string> _options, _commandLineOptions;
 std::vector<std::string> _rulesets;
@@ -107,6 +111,14 @@ void createDefault()
 	setBool("globeAllRadarsOnBaseBuild", true);
 	setBool("allowChangeListValuesByMouseWheel", false); // It applies only for lists, not for scientists/engineers screen
 	setInt("autosave", 0);
+	setBool("binarySaves", false);
+	setInt("loadingThreads", 4);
+	setInt("aiThreads", 1);
+	setBool("battleCheckFOV", false); // check the field of view sweep against the old sight lines, slow
+	setInt("assetCacheSize", 16);
+	setString("dataPack", "openxcom.pak");
+	setBool("rulesetCache", true);
+	setBool("geoscapeTimeSkip", true);
 	setInt("changeValueByMouseWheel", 10);
 	setInt("audioSampleRate", 22050);
 	setInt("audioBitDepth", 16);
@@ -278,6 +290,50 @@ void loadArgs(int argc, char** args)
 				{
 					_userFolder = CrossPlatform::endPath(args[i+1]);
 				}
+				else if (argname == "pack")
+				{
+					_packFile = args[i+1];
+				}
+				else if (argname == "cache")
+				{
+					_cacheMode = args[i+1];
+				}
+				else if (argname == "convert")
+				{
+					_convertSave = args[i+1];
+				}
+				else if (argname == "simulate")
+				{
+					_simulateSave = args[i+1];
+				}
+				else if (argname == "days")
+				{
+					std::stringstream(args[i+1]) >> _simulateDays;
+				}
+				else if (argname == "seed")
+				{
+					std::stringstream(args[i+1]) >> _simulateSeed;
+				}
+				else if (argname == "battle")
+				{
+					_simulateBattle = args[i+1];
+				}
+				else if (argname == "turns")
+				{
+					std::stringstream(args[i+1]) >> _simulateTurns;
+				}
+				else if (argname == "terrain")
+				{
+					_simulateTerrain = args[i+1];
+				}
+				else if (argname == "race")
+				{
+					_simulateRace = args[i+1];
+				}
+				else if (argname == "globe")
+				{
+					std::stringstream(args[i+1]) >> _benchmarkGlobe;
+				}
 				else
 				{
 					// case insensitive lookup of the argument
@@ -322,6 +378,19 @@ bool showHelp(int argc, char** args)
 	help << "        use PATH as the default Data Folder instead of auto-detecting" << std::endl << std::endl;
 	help << "-user PATH" << std::endl;
 	help << "        use PATH as the default User Folder instead of auto-detecting" << std::endl << std::endl;
+	help << "-pack FILE" << std::endl;
+	help << "        pack the Data Folder files into FILE and quit, put it in the Data Folder as the dataPack option to use it" << std::endl << std::endl;
+	help << "-cache build|verify" << std::endl;
+	help << "        rebuild the ruleset cache in the User Folder, or check it matches the ruleset files, and quit" << std::endl << std::endl;
+	help << "-convert SAVE" << std::endl;
+	help << "        convert SAVE in the User Folder from YAML to the binary format or back, and quit" << std::endl << std::endl;
+	help << "-simulate SAVE [-days N] [-seed N]" << std::endl;
+	help << "        load SAVE from the User Folder, advance it N days (default 30) with no display or player, report the timings and quit" << std::endl << std::endl;
+	help << "-battle SAVE|MISSION [-turns N] [-terrain TERRAIN] [-race RACE] [-seed N]" << std::endl;
+	help << "        load the battle in SAVE from the User Folder, or generate a MISSION (eg. STR_SMALL_SCOUT), let the AI play both sides for N turns (default 20), report the timings and quit" << std::endl;
+	help << "        add -battleCheckFOV true to fail if the field of view sweep ever sees differently from the old sight lines" << std::endl << std::endl;
+	help << "-globe N" << std::endl;
+	help << "        draw the globe N times at every zoom level with the old and new drawing code, report the timings and quit" << std::endl << std::endl;
 	help << "-KEY VALUE" << std::endl;
 	help << "        set option KEY to VALUE instead of default/loaded value (eg. -displayWidth 640)" << std::endl << std::endl;
 	help << "-help" << std::endl;
@@ -545,6 +614,112 @@ std::string getDataFolder()
 	return _dataFolder;
 }
 
+/**
+ * Returns the data pack to build instead of running
+ * the game, if one was given in the command line.
+ * @return Full path to the pack, or "" if there's none.
+ */
+std::string getPackFile()
+{
+	return _packFile;
+}
+
+/**
+ * Returns what to do with the ruleset cache instead
+ * of running the game, if given in the command line.
+ * @return "build", "verify", or "" if there's nothing to do.
+ */
+std::string getCacheMode()
+{
+	return _cacheMode;
+}
+
+/**
+ * Returns the saved game to convert to the other save
+ * format, if given in the command line.
+ * @return Save name without extension, or "" if there's none.
+ */
+std::string getConvertSave()
+{
+	return _convertSave;
+}
+
+/**
+ * Returns the saved game to simulate instead of
+ * running the game, if given in the command line.
+ * @return Save name without extension, or "" if there's none.
+ */
+std::string getSimulateSave()
+{
+	return _simulateSave;
+}
+
+/**
+ * Returns how many game days to simulate.
+ * @return Number of days.
+ */
+int getSimulateDays()
+{
+	return _simulateDays;
+}
+
+/**
+ * Returns the seed to reset the RNG to before simulating,
+ * so every run of the same save gives the same results.
+ * @return RNG seed.
+ */
+int getSimulateSeed()
+{
+	return _simulateSeed;
+}
+
+/**
+ * Returns the battle to simulate instead of
+ * running the game, if given in the command line.
+ * @return Save name without extension or mission type, or "" if there's none.
+ */
+std::string getSimulateBattle()
+{
+	return _simulateBattle;
+}
+
+/**
+ * Returns how many battle turns to simulate.
+ * @return Number of turns.
+ */
+int getSimulateTurns()
+{
+	return _simulateTurns;
+}
+
+/**
+ * Returns the terrain to generate the simulated battle on.
+ * @return Terrain type, or "" for the first one available.
+ */
+std::string getSimulateTerrain()
+{
+	return _simulateTerrain;
+}
+
+/**
+ * Returns the alien race to generate the simulated battle with.
+ * @return Alien race, or "" for the first one available.
+ */
+std::string getSimulateRace()
+{
+	return _simulateRace;
+}
+
+/**
+ * Returns how many times to draw the globe for benchmarking
+ * instead of starting the game.
+ * @return Number of frames, or 0 to start the game normally.
+ */
+int getBenchmarkGlobe()
+{
+	return _benchmarkGlobe;
+}
+
 /**
  * Changes the game's current Data folder where resources
  * and X-Com files are loaded from.
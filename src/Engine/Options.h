@@ -53,6 +53,28 @@ namespace Options
 	std::string getDataFolder();
 	/// Sets the game's data folder.
 	void setDataFolder(const std::string &folder);
+	/// Gets the data pack to build.
+	std::string getPackFile();
+	/// Gets the ruleset cache action.
+	std::string getCacheMode();
+	/// Gets the saved game to convert.
+	std::string getConvertSave();
+	/// Gets the saved game to simulate.
+	std::string getSimulateSave();
+	/// Gets the number of days to simulate.
+	int getSimulateDays();
+	/// Gets the RNG seed for simulating.
+	int getSimulateSeed();
+	/// Gets the battle to simulate.
+	std::string getSimulateBattle();
+	/// Gets the number of battle turns to simulate.
+	int getSimulateTurns();
+	/// Gets the terrain of the simulated battle.
+	std::string getSimulateTerrain();
+	/// Gets the alien race of the simulated battle.
+	std::string getSimulateRace();
+	/// Gets the number of frames to benchmark the globe.
+	int getBenchmarkGlobe();
 	/// Gets the game's data list.
 	std::vector<std::string> *getDataList();
 	/// Gets the game's user folder.
@@ -19,7 +19,6 @@
 #include "RNG.h"
 #define _USE_MATH_DEFINES
 #include <cmath>
-#include <cstdlib>
 #include <ctime>
 
 namespace OpenXcom
@@ -27,47 +26,153 @@ namespace OpenXcom
 namespace RNG
 {
 
-unsigned int _seed = 0;
-long _count = 0;
+State _streams[STREAMS];
+Stream _current = STREAM_GEOSCAPE;
 
 /**
- * Seeds the random generator with a new number.
- * Defaults to the current time if none is set.
- * @param count Number of generations.
- * @param seed New seed.
+ * Rotates the bits of a number left.
+ * @param x Number.
+ * @param k Bits to rotate by.
+ * @return Rotated number.
  */
-void init(long count, unsigned int seed)
+inline Uint32 rotl(Uint32 x, int k)
 {
-	_seed = seed;
-	_count = count;
-	if (count == -1)
-	{
-		_seed = (unsigned int)time(NULL);
-		_count = 0;
-		srand(_seed);
-	}
-	else
+	return (x << k) | (x >> (32 - k));
+}
+
+/**
+ * Advances a state and gets the next raw number out of it.
+ * @param state State to advance.
+ * @return Random 32-bit number.
+ */
+Uint32 next(State &state)
+{
+	Uint32 *s = state.s;
+	Uint32 result = rotl(s[1] * 5, 7) * 9;
+	Uint32 t = s[1] << 9;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl(s[3], 11);
+
+	return result;
+}
+
+/**
+ * Advances a state by 2^64 numbers, to give a stream
+ * that won't overlap with the original.
+ * @param state State to advance.
+ */
+void jump(State &state)
+{
+	static const Uint32 JUMP[] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+
+	Uint32 s[4] = { 0, 0, 0, 0 };
+	for (int i = 0; i < 4; ++i)
 	{
-		srand(_seed);
-		for (long i = 0; i < count; ++i)
+		for (int b = 0; b < 32; ++b)
 		{
-			rand();
+			if (JUMP[i] & (Uint32(1) << b))
+			{
+				for (int j = 0; j < 4; ++j)
+				{
+					s[j] ^= state.s[j];
+				}
+			}
+			next(state);
 		}
 	}
+	for (int j = 0; j < 4; ++j)
+	{
+		state.s[j] = s[j];
+	}
+}
+
+/**
+ * Spreads a seed over a state, so that similar seeds
+ * still give very different states (splitmix32).
+ * @param state State to fill.
+ * @param seed Seed.
+ */
+void fill(State &state, Uint32 seed)
+{
+	for (int i = 0; i < 4; ++i)
+	{
+		seed += 0x9e3779b9;
+		Uint32 z = seed;
+		z = (z ^ (z >> 16)) * 0x85ebca6b;
+		z = (z ^ (z >> 13)) * 0xc2b2ae35;
+		state.s[i] = z ^ (z >> 16);
+	}
+	// the all-zero state is the one state that never leaves itself
+	if (!state.s[0] && !state.s[1] && !state.s[2] && !state.s[3])
+	{
+		state.s[0] = 1;
+	}
+}
+
+/**
+ * Seeds the random generator with the current time.
+ */
+void init()
+{
+	seed((Uint32)time(NULL));
+}
+
+/**
+ * Seeds the random generator with a new number.
+ * Every stream starts 2^64 numbers after the previous one.
+ * @param seed New seed.
+ */
+void seed(Uint32 seed)
+{
+	fill(_streams[0], seed);
+	for (int i = 1; i < STREAMS; ++i)
+	{
+		_streams[i] = _streams[i - 1];
+		jump(_streams[i]);
+	}
+	_current = STREAM_GEOSCAPE;
 }
 
 /**
  * Loads the RNG from a YAML file.
+ * Older saves only stored the seed and how many numbers were drawn from the
+ * C library generator, which can't be restored without drawing them all again,
+ * so those get a fresh generator seeded from both.
  * @param node YAML node.
  */
 void load(const YAML::Node &node)
 {
-	int count, seed;
-	if (node.FindValue("rngCount") != 0)
+	if (const YAML::Node *pName = node.FindValue("rngState"))
 	{
+		for (int i = 0; i < STREAMS && i < (int)pName->size(); ++i)
+		{
+			for (int j = 0; j < 4; ++j)
+			{
+				(*pName)[i][j] >> _streams[i].s[j];
+			}
+		}
+		int stream = STREAM_GEOSCAPE;
+		if (const YAML::Node *pStream = node.FindValue("rngStream"))
+		{
+			*pStream >> stream;
+		}
+		if (stream < 0 || stream >= STREAMS)
+		{
+			stream = STREAM_GEOSCAPE;
+		}
+		_current = (Stream)stream;
+	}
+	else if (node.FindValue("rngCount") != 0)
+	{
+		Uint32 count, seed;
 		node["rngCount"] >> count;
 		node["rngSeed"] >> seed;
-		init(count, seed);
+		RNG::seed(seed ^ (count * 0x9e3779b9));
 	}
 }
 
@@ -77,8 +182,80 @@ void load(const YAML::Node &node)
  */
 void save(YAML::Emitter &out)
 {
-	out << YAML::Key << "rngCount" << YAML::Value << _count;
-	out << YAML::Key << "rngSeed" << YAML::Value << _seed;
+	out << YAML::Key << "rngState" << YAML::Value << YAML::BeginSeq;
+	for (int i = 0; i < STREAMS; ++i)
+	{
+		out << YAML::Flow << YAML::BeginSeq;
+		for (int j = 0; j < 4; ++j)
+		{
+			out << _streams[i].s[j];
+		}
+		out << YAML::EndSeq;
+	}
+	out << YAML::EndSeq;
+	out << YAML::Key << "rngStream" << YAML::Value << (int)_current;
+}
+
+/**
+ * Gets the state of the whole generator, so it can be put back
+ * later after something else has reseeded or reloaded it.
+ * @return Snapshot of every stream.
+ */
+Snapshot snapshot()
+{
+	Snapshot snapshot;
+	for (int i = 0; i < STREAMS; ++i)
+	{
+		snapshot.streams[i] = _streams[i];
+	}
+	snapshot.current = _current;
+	return snapshot;
+}
+
+/**
+ * Puts the whole generator back the way it was in a snapshot.
+ * @param snapshot Snapshot of every stream.
+ */
+void restore(const Snapshot &snapshot)
+{
+	for (int i = 0; i < STREAMS; ++i)
+	{
+		_streams[i] = snapshot.streams[i];
+	}
+	_current = snapshot.current;
+}
+
+/**
+ * Switches the stream numbers are generated from.
+ * @param stream New stream.
+ */
+void setStream(Stream stream)
+{
+	_current = stream;
+}
+
+/**
+ * Gets the stream numbers are generated from.
+ * @return Current stream.
+ */
+Stream getStream()
+{
+	return _current;
+}
+
+/**
+ * Creates the state of an independent substream of the current stream,
+ * for work that needs its own numbers, like a thread. The same id
+ * from the same point of the current stream always gives the same substream.
+ * @param id Substream identifier.
+ * @return State to generate numbers from.
+ */
+State split(Uint32 id)
+{
+	State state = _streams[_current];
+	Uint32 mix = next(state) ^ (id * 0x9e3779b9);
+	fill(state, mix ^ next(state));
+	return state;
 }
 
 /**
@@ -89,9 +266,7 @@ void save(YAML::Emitter &out)
  */
 int generate(int min, int max)
 {
-	_count++;
-	int num = rand();
-	return (num % (max - min + 1) + min);
+	return generate(_streams[_current], min, max);
 }
 
 /**
@@ -102,11 +277,23 @@ int generate(int min, int max)
  */
 double generate(double min, double max)
 {
-	_count++;
-	int num = rand();
-	return (num * (max - min) / RAND_MAX + min);
+	Uint32 num = next(_streams[_current]);
+	return (num * (max - min) / 4294967295.0 + min);
 }
 
+/**
+ * Generates a random integer number within a certain range,
+ * from a state of its own instead of the current stream.
+ * @param state State to generate from.
+ * @param min Minimum number.
+ * @param max Maximum number.
+ * @return Generated number.
+ */
+int generate(State &state, int min, int max)
+{
+	Uint32 num = next(state);
+	return (int)(num % (Uint32)(max - min + 1)) + min;
+}
 /**
  * Normal random variate generator
  * @param m mean
@@ -20,28 +20,58 @@
 #define OPENXCOM_RNG_H
 
 #include <yaml-cpp/yaml.h>
+#include <SDL_types.h>
 
 namespace OpenXcom
 {
 
 /**
  * Random Number Generator used throughout the game
- * for all your randomness needs. It's really just the
- * standard C generator, but wrapped in a way that we
- * can store its seed for later use if necessary.
+ * for all your randomness needs. It's a xoshiro128** generator,
+ * so the whole state fits in four numbers and is the same on every
+ * platform, and can be stored and restored in one go.
+ * Separate parts of the game draw from their own independent stream,
+ * so they don't disturb each other's sequence of numbers.
  */
 namespace RNG
 {
-	/// Initializes the generator.
-	void init(long count = -1, unsigned int seed = 0);
+	/// Independent streams of random numbers.
+	enum Stream { STREAM_GEOSCAPE, STREAM_BATTLESCAPE, STREAMS };
+	/// State of a stream of random numbers.
+	struct State
+	{
+		Uint32 s[4];
+	};
+	/// State of the whole generator, every stream included.
+	struct Snapshot
+	{
+		State streams[STREAMS];
+		Stream current;
+	};
+	/// Initializes the generator with the current time.
+	void init();
+	/// Initializes the generator with a specific seed.
+	void seed(Uint32 seed);
 	/// Loads the RNG from YAML.
 	void load(const YAML::Node& node);
 	/// Saves the RNG to YAML.
 	void save(YAML::Emitter& out);
+	/// Gets the state of the whole generator.
+	Snapshot snapshot();
+	/// Restores the state of the whole generator.
+	void restore(const Snapshot &snapshot);
+	/// Switches to another stream.
+	void setStream(Stream stream);
+	/// Gets the current stream.
+	Stream getStream();
+	/// Creates a state for an independent substream of the current stream.
+	State split(Uint32 id);
 	/// Generates a random integer number.
 	int generate(int min, int max);
 	/// Generates a random decimal number.
 	double generate(double min, double max);
+	/// Generates a random integer number from a specific state.
+	int generate(State &state, int min, int max);
 	/// Get normally distributed value.
 	double boxMuller(double m = 0, double s = 1);
 }
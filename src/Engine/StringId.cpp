@@ -0,0 +1,84 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "StringId.h"
+#include <map>
+#include <vector>
+
+namespace OpenXcom
+{
+namespace StringId
+{
+
+std::map<std::string, int> _handles;
+std::vector<const std::string*> _strings;
+
+/**
+ * Gets the handle of a string. Strings that were never seen
+ * before get the next free handle.
+ * @param s String ID.
+ * @return Handle.
+ */
+int intern(const std::string &s)
+{
+	std::map<std::string, int>::iterator i = _handles.lower_bound(s);
+	if (i == _handles.end() || i->first != s)
+	{
+		i = _handles.insert(i, std::make_pair(s, (int)_strings.size()));
+		_strings.push_back(&i->first);
+	}
+	return i->second;
+}
+
+/**
+ * Gets the handle of a string without adding it.
+ * @param s String ID.
+ * @return Handle, or -1 if the string was never interned.
+ */
+int find(const std::string &s)
+{
+	std::map<std::string, int>::const_iterator i = _handles.find(s);
+	if (i == _handles.end())
+	{
+		return -1;
+	}
+	return i->second;
+}
+
+/**
+ * Gets the string a handle was given to.
+ * @param handle Handle.
+ * @return String ID.
+ */
+const std::string &get(int handle)
+{
+	return *_strings.at(handle);
+}
+
+/**
+ * Gets the number of handles given out so far.
+ * Handles go from 0 to this number minus one.
+ * @return Number of handles.
+ */
+int count()
+{
+	return _strings.size();
+}
+
+}
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_STRINGID_H
+#define OPENXCOM_STRINGID_H
+
+#include <string>
+
+namespace OpenXcom
+{
+
+/**
+ * Turns the string IDs used by the rulesets (items, inventory slots, etc.)
+ * into small integer handles, so they can be compared and used as array
+ * indexes instead of being looked up by name all the time.
+ * The same string always gets the same handle for the whole session.
+ */
+namespace StringId
+{
+	/// Gets the handle of a string, adding it if it's new.
+	int intern(const std::string &s);
+	/// Gets the handle of a string, if there is one.
+	int find(const std::string &s);
+	/// Gets the string of a handle.
+	const std::string &get(int handle);
+	/// Gets the number of handles given out.
+	int count();
+}
+
+}
+
+#endif
@@ -19,14 +19,16 @@
 #include "Surface.h"
 #include "Screen.h"
 #include "ShaderDraw.h"
-#include <fstream>
 #include <SDL_gfxPrimitives.h>
 #include <SDL_image.h>
 #include <SDL_endian.h>
 #include "Palette.h"
 #include "Exception.h"
+#include "DataBuffer.h"
 #include "ShaderMove.h"
 #include <stdlib.h>
+#include <cstring>
+#include <algorithm>
 #ifdef _WIN32
 #include <malloc.h>
 #endif
@@ -135,8 +137,8 @@ Surface::~Surface()
 void Surface::loadScr(const std::string &filename)
 {
 	// Load file and put pixels in surface
-	std::ifstream imgFile (filename.c_str(), std::ios::in | std::ios::binary);
-	if (!imgFile)
+	DataBuffer imgFile;
+	if (!imgFile.open(filename))
 	{
 		throw Exception(filename + " not found");
 	}
@@ -144,23 +146,19 @@ void Surface::loadScr(const std::string &filename)
 	// Lock the surface
 	lock();
 
-	Uint8 value;
-	int x = 0, y = 0;
-
-	while (imgFile.read((char*)&value, 1))
+	// copy the rows straight from the file contents
+	const Uint8 *data = imgFile.getData();
+	size_t size = imgFile.getSize();
+	for (int y = 0; y < getHeight() && size > 0; ++y)
 	{
-		setPixelIterative(&x, &y, value);
-	}
-
-	if (!imgFile.eof())
-	{
-		throw Exception("Invalid SCR file");
+		size_t row = std::min(size, (size_t)getWidth());
+		memcpy((Uint8 *)_surface->pixels + y * _surface->pitch, data, row);
+		data += row;
+		size -= row;
 	}
 
 	// Unlock the surface
 	unlock();
-
-	imgFile.close();
 }
 
 /**
@@ -204,8 +202,8 @@ void Surface::loadImage(const std::string &filename)
 void Surface::loadSpk(const std::string &filename)
 {
 	// Load file and put pixels in surface
-	std::ifstream imgFile (filename.c_str(), std::ios::in | std::ios::binary);
-	if (!imgFile)
+	DataBuffer imgFile;
+	if (!imgFile.open(filename))
 	{
 		throw Exception(filename + " not found");
 	}
@@ -245,8 +243,6 @@ void Surface::loadSpk(const std::string &filename)
 
 	// Unlock the surface
 	unlock();
-
-	imgFile.close();
 }
 
 /**
@@ -259,8 +255,8 @@ void Surface::loadSpk(const std::string &filename)
 void Surface::loadBdy(const std::string &filename)
 {
 	// Load file and put pixels in surface
-	std::ifstream imgFile (filename.c_str(), std::ios::in | std::ios::binary);
-	if (!imgFile)
+	DataBuffer imgFile;
+	if (!imgFile.open(filename))
 	{
 		throw Exception(filename + " not found");
 	}
@@ -301,8 +297,6 @@ void Surface::loadBdy(const std::string &filename)
 
 	// Unlock the surface
 	unlock();
-
-	imgFile.close();
 }
 
 
@@ -18,8 +18,9 @@
  */
 #include "SurfaceSet.h"
 #include <SDL_endian.h>
-#include <fstream>
+#include <cstring>
 #include "Surface.h"
+#include "DataBuffer.h"
 #include "Exception.h"
 
 namespace OpenXcom
@@ -75,8 +76,8 @@ void SurfaceSet::loadPck(const std::string &pck, const std::string &tab)
 	int nframes = 0;
 
 	// Load TAB and get image offsets
-	std::ifstream offsetFile (tab.c_str(), std::ios::in | std::ios::binary);
-	if (!offsetFile)
+	DataBuffer offsetFile;
+	if (!offsetFile.open(tab))
 	{
 		nframes = 1;
 		Surface *surface = new Surface(_width, _height);
@@ -84,33 +85,32 @@ void SurfaceSet::loadPck(const std::string &pck, const std::string &tab)
 	}
 	else
 	{
-		Uint16 off;
-		while (offsetFile.read((char*)&off, sizeof(off)))
+		nframes = offsetFile.getSize() / sizeof(Uint16);
+		for (int i = 0; i < nframes; ++i)
 		{
-			off = SDL_SwapLE16(off);
 			Surface *surface = new Surface(_width, _height);
-			_frames[nframes] = surface;
-			nframes++;
+			_frames[i] = surface;
 		}
 	}
 
 	// Load PCX and put pixels in surfaces
-	std::ifstream imgFile (pck.c_str(), std::ios::in | std::ios::binary);
-	if (!imgFile)
+	DataBuffer imgFile;
+	if (!imgFile.open(pck))
 	{
 		throw Exception(pck + " not found");
 	}
 
-	Uint8 value;
+	// decode straight from the file contents
+	const Uint8 *data = imgFile.getData(), *end = data + imgFile.getSize();
 
-	for (int frame = 0; frame < nframes; frame++)
+	for (int frame = 0; frame < nframes && data != end; frame++)
 	{
 		int x = 0, y = 0;
 
 		// Lock the surface
 		_frames[frame]->lock();
 
-		imgFile.read((char*)&value, 1);
+		Uint8 value = *data++;
 		for (int i = 0; i < value; ++i)
 		{
 			for (int j = 0; j < _width; ++j)
@@ -119,11 +119,13 @@ void SurfaceSet::loadPck(const std::string &pck, const std::string &tab)
 			}
 		}
 
-		while (imgFile.read((char*)&value, 1) && value != 255)
+		while (data != end && (value = *data++) != 255)
 		{
 			if (value == 254)
 			{
-				imgFile.read((char*)&value, 1);
+				if (data == end)
+					break;
+				value = *data++;
 				for (int i = 0; i < value; ++i)
 				{
 					_frames[frame]->setPixelIterative(&x, &y, 0);
@@ -138,9 +140,6 @@ void SurfaceSet::loadPck(const std::string &pck, const std::string &tab)
 		// Unlock the surface
 		_frames[frame]->unlock();
 	}
-
-	imgFile.close();
-	offsetFile.close();
 }
 
 /**
@@ -156,51 +155,31 @@ void SurfaceSet::loadDat(const std::string &filename)
 	int nframes = 0;
 
 	// Load file and put pixels in surface
-	std::ifstream imgFile (filename.c_str(), std::ios::in | std::ios::binary);
-	if (!imgFile)
+	DataBuffer imgFile;
+	if (!imgFile.open(filename))
 	{
 		throw Exception(filename + " not found");
 	}
 
-	imgFile.seekg(0, std::ios::end);
-	std::streamoff size = imgFile.tellg();
-	imgFile.seekg(0, std::ios::beg);
-
-	nframes = (int)size / (_width * _height);
+	nframes = (int)imgFile.getSize() / (_width * _height);
 
+	// every frame is a block of uncompressed rows, so copy them whole
+	const Uint8 *data = imgFile.getData();
 	for (int i = 0; i < nframes; ++i)
 	{
 		Surface *surface = new Surface(_width, _height);
 		_frames[i] = surface;
-	}
-
-	Uint8 value;
-	int x = 0, y = 0, frame = 0;
-
-	// Lock the surface
-	_frames[frame]->lock();
-
-	while (imgFile.read((char*)&value, 1))
-	{
-		_frames[frame]->setPixelIterative(&x, &y, value);
 
-		if (y >= _height)
+		// Lock the surface
+		surface->lock();
+		SDL_Surface *s = surface->getSurface();
+		for (int y = 0; y < _height; ++y, data += _width)
 		{
-			// Unlock the surface
-			_frames[frame]->unlock();
-
-			frame++;
-			x = 0;
-			y = 0;
-
-			if (frame >= nframes)
-				break;
-			else
-				_frames[frame]->lock();
+			memcpy((Uint8*)s->pixels + y * s->pitch, data, _width);
 		}
+		// Unlock the surface
+		surface->unlock();
 	}
-
-	imgFile.close();
 }
 
 /**
@@ -0,0 +1,191 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "GeoscapeSimulation.h"
+#include <iomanip>
+#include <sstream>
+#include "GeoscapeState.h"
+#include "../Engine/Game.h"
+#include "../Engine/Exception.h"
+#include "../Engine/Logger.h"
+#include "../Engine/RNG.h"
+#include "../Engine/CrossPlatform.h"
+#include "../Savegame/SavedGame.h"
+
+namespace OpenXcom
+{
+
+/// Geoscape handler for each time trigger.
+void (GeoscapeState::*const TRIGGER_HANDLERS[])() =
+{
+	&GeoscapeState::time5Seconds,
+	&GeoscapeState::time10Minutes,
+	&GeoscapeState::time30Minutes,
+	&GeoscapeState::time1Hour,
+	&GeoscapeState::time1Day,
+	&GeoscapeState::time1Month
+};
+
+/// Name of each time trigger in the report.
+const char *const TRIGGER_NAMES[] = {"5 sec", "10 min", "30 min", "1 hour", "1 day", "1 month"};
+
+/// Number of 5 second steps in a day.
+const int STEPS_PER_DAY = 12 * 60 * 24;
+
+/**
+ * Creates a simulation for a game that
+ * has its resources and ruleset loaded.
+ * @param game Pointer to the core game.
+ */
+GeoscapeSimulation::GeoscapeSimulation(Game *game) : _game(game), _geoscape(0), _skipped(0)
+{
+	for (int i = 0; i < TRIGGERS; ++i)
+	{
+		_time[i] = 0.0;
+		_calls[i] = 0;
+	}
+}
+
+/**
+ * Deletes the Geoscape used for the simulation.
+ */
+GeoscapeSimulation::~GeoscapeSimulation()
+{
+	delete _geoscape;
+}
+
+/**
+ * Loads a saved game into the game and sets up a headless
+ * Geoscape for it, then resets the RNG to the given seed
+ * so the results don't depend on the state stored in the save.
+ * @param filename Name of the save in the User Folder, without extension.
+ * @param seed RNG seed.
+ */
+void GeoscapeSimulation::load(const std::string &filename, int seed)
+{
+	SavedGame *save = new SavedGame();
+	try
+	{
+		save->load(filename, _game->getRuleset());
+	}
+	catch (...)
+	{
+		delete save;
+		throw;
+	}
+	_game->setSavedGame(save);
+	if (save->getSavedBattle() != 0)
+	{
+		throw Exception(filename + " is saved in the middle of a battle");
+	}
+	if (save->getMonthsPassed() == -1)
+	{
+		throw Exception(filename + " has not started yet");
+	}
+	_geoscape = new GeoscapeState(_game);
+	_geoscape->setHeadless(true);
+	RNG::seed(seed);
+	RNG::setStream(RNG::STREAM_GEOSCAPE);
+}
+
+/**
+ * Advances the game time by 5 seconds, running all
+ * the triggers that come due like the Geoscape timer
+ * does, and adds up how long each of them takes.
+ * @return False if the game is lost and can't go on.
+ */
+bool GeoscapeSimulation::step()
+{
+	if (_game->getSavedGame()->getBases()->empty())
+	{
+		return false;
+	}
+	TimeTrigger trigger = _game->getSavedGame()->getTime()->advance();
+	for (int i = trigger; i >= TIME_5SEC; --i)
+	{
+		double start = CrossPlatform::getMicroseconds();
+		(_geoscape->*TRIGGER_HANDLERS[i])();
+		_time[i] += CrossPlatform::getMicroseconds() - start;
+		_calls[i]++;
+	}
+	return true;
+}
+
+/**
+ * Runs the loaded game forward for a number of days, or
+ * until the game is lost, and reports the results. Idle time
+ * is skipped like the Geoscape does, so running with the
+ * geoscapeTimeSkip option off must give the same checksum.
+ * @param days Number of game days.
+ */
+void GeoscapeSimulation::run(int days)
+{
+	Log(LOG_INFO) << "Simulating " << days << " days...";
+	double start = CrossPlatform::getMicroseconds();
+	int steps = 0;
+	while (steps < days * STEPS_PER_DAY)
+	{
+		int skipped = _geoscape->skipIdleTime(days * STEPS_PER_DAY - steps - 1);
+		_skipped += skipped;
+		steps += skipped;
+		if (!step())
+		{
+			break;
+		}
+		++steps;
+	}
+	double time = CrossPlatform::getMicroseconds() - start;
+	if (steps < days * STEPS_PER_DAY)
+	{
+		Log(LOG_WARNING) << "The game was lost after " << steps / STEPS_PER_DAY << " days.";
+	}
+	report(steps / STEPS_PER_DAY, time);
+}
+
+/**
+ * Logs how long the simulation took in total and
+ * in each time trigger, and the checksum of the
+ * resulting game state to compare runs against.
+ * @param days Number of game days simulated.
+ * @param time Total time in microseconds.
+ */
+void GeoscapeSimulation::report(int days, double time) const
+{
+	std::ostringstream ss;
+	ss << std::fixed << std::setprecision(1);
+	ss << "Simulated " << days << " days in " << time / 1000.0 << "ms";
+	if (time > 0.0)
+	{
+		ss << " (" << days / (time / 1000000.0) << " days/s)";
+	}
+	Log(LOG_INFO) << ss.str();
+	Log(LOG_INFO) << "Skipped " << _skipped << " idle steps out of " << days * STEPS_PER_DAY << ".";
+	for (int i = 0; i < TRIGGERS; ++i)
+	{
+		std::ostringstream line;
+		line << std::fixed << std::setprecision(1);
+		line << std::setw(8) << TRIGGER_NAMES[i] << ": " << std::setw(8) << _calls[i] << " calls, " << std::setw(10) << _time[i] / 1000.0 << "ms total, ";
+		line << std::setw(8) << (_calls[i] > 0 ? _time[i] / _calls[i] : 0.0) << "us each";
+		Log(LOG_INFO) << line.str();
+	}
+	std::ostringstream hash;
+	hash << std::hex << std::setw(8) << std::setfill('0') << _game->getSavedGame()->getChecksum();
+	Log(LOG_INFO) << "Game state checksum: " << hash.str();
+}
+
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_GEOSCAPESIMULATION_H
+#define OPENXCOM_GEOSCAPESIMULATION_H
+
+#include <string>
+#include "../Savegame/GameTime.h"
+
+namespace OpenXcom
+{
+
+class Game;
+class GeoscapeState;
+
+/**
+ * Runs the Geoscape of a saved game forward with no player,
+ * as fast as it can go, timing every time trigger along the way.
+ * Used as a reproducible benchmark of the strategic layer: the
+ * RNG is reset to a fixed seed, so the same save always ends in
+ * the same game state, which is reported as a checksum.
+ */
+class GeoscapeSimulation
+{
+private:
+	static const int TRIGGERS = TIME_1MONTH + 1;
+	Game *_game;
+	GeoscapeState *_geoscape;
+	double _time[TRIGGERS];
+	int _calls[TRIGGERS], _skipped;
+	/// Advances the game by 5 seconds.
+	bool step();
+	/// Logs the results of the simulation.
+	void report(int days, double time) const;
+public:
+	/// Creates a simulation for a game.
+	GeoscapeSimulation(Game *game);
+	/// Cleans up the simulation.
+	~GeoscapeSimulation();
+	/// Loads the saved game to simulate.
+	void load(const std::string &filename, int seed);
+	/// Simulates a number of days.
+	void run(int days);
+};
+
+}
+
+#endif
@@ -111,7 +111,7 @@ namespace OpenXcom
  * Initializes all the elements in the Geoscape screen.
  * @param game Pointer to the core game.
  */
-GeoscapeState::GeoscapeState(Game *game) : State(game), _pause(false), _music(false), _zoomInEffectDone(false), _zoomOutEffectDone(false), _battleMusic(false), _popups(), _dogfights(), _dogfightsToBeStarted(), _minimizedDogfights(0)
+GeoscapeState::GeoscapeState(Game *game) : State(game), _pause(false), _music(false), _zoomInEffectDone(false), _zoomOutEffectDone(false), _battleMusic(false), _popups(), _dogfights(), _dogfightsToBeStarted(), _minimizedDogfights(0), _headless(false)
 {
 	int screenWidth = Options::getInt("baseXResolution");
 	int screenHeight = Options::getInt("baseYResolution");
@@ -587,6 +587,7 @@ void GeoscapeState::timeAdvance()
 
 	for (int i = 0; i < timeSpan && !_pause; ++i)
 	{
+		i += skipIdleTime(timeSpan - i - 1);
 		TimeTrigger trigger;
 		trigger = _game->getSavedGame()->getTime()->advance();
 		switch (trigger)
@@ -661,7 +662,12 @@ void GeoscapeState::time5Seconds()
 						(*i)->setDestination(0);
 						base->setupDefenses();
 						timerReset();
-						if (base->getDefenses()->size() > 0)
+						if (_headless)
+						{
+							// Battles aren't simulated, the UFO just gives up
+							(*i)->setStatus(Ufo::DESTROYED);
+						}
+						else if (base->getDefenses()->size() > 0)
 						{
 							popup(new BaseDefenseState(_game, base, *i, this));
 						}
@@ -708,21 +714,15 @@ void GeoscapeState::time5Seconds()
 		{
 			if ((*j)->isDestroyed())
 			{
-				for(std::vector<Country*>::iterator country = _game->getSavedGame()->getCountries()->begin(); country != _game->getSavedGame()->getCountries()->end(); ++country)
+				Country *country = _game->getSavedGame()->locateCountry((*j)->getLongitude(), (*j)->getLatitude(), _game->getRuleset());
+				if (country)
 				{
-					if((*country)->getRules()->insideCountry((*j)->getLongitude(), (*j)->getLatitude()))
-					{
-						(*country)->addActivityXcom(-(*j)->getRules()->getScore());
-						break;
-					}
+					country->addActivityXcom(-(*j)->getRules()->getScore());
 				}
-				for(std::vector<Region*>::iterator region = _game->getSavedGame()->getRegions()->begin(); region != _game->getSavedGame()->getRegions()->end(); ++region)
+				Region *region = _game->getSavedGame()->locateRegion(**j, _game->getRuleset());
+				if (region)
 				{
-					if((*region)->getRules()->insideRegion((*j)->getLongitude(), (*j)->getLatitude()))
-					{
-						(*region)->addActivityXcom(-(*j)->getRules()->getScore());
-						break;
-					}
+					region->addActivityXcom(-(*j)->getRules()->getScore());
 				}
 
 				delete *j;
@@ -734,7 +734,7 @@ void GeoscapeState::time5Seconds()
 				Ufo* u = dynamic_cast<Ufo*>((*j)->getDestination());
 				if (u != 0 && !u->getDetected())
 				{
-					if (u->getTrajectory().getID() == "__RETALIATION_ASSAULT_RUN" && (u->getStatus() == Ufo::LANDED || u->getStatus() == Ufo::DESTROYED))
+					if ((u->getTrajectory().getID() == "__RETALIATION_ASSAULT_RUN" && (u->getStatus() == Ufo::LANDED || u->getStatus() == Ufo::DESTROYED)) || _headless)
 					{
 						(*j)->returnToBase();
 					}
@@ -774,7 +774,12 @@ void GeoscapeState::time5Seconds()
 							++j;
 							continue;
 						}
-						if(!(*j)->isInDogfight() && !(*j)->getDistance(u))
+						if(_headless && !(*j)->getDistance(u))
+						{
+							// Dogfights need a player, so call off the interception
+							(*j)->returnToBase();
+						}
+						else if(!(*j)->isInDogfight() && !(*j)->getDistance(u))
 						{
 							_dogfightsToBeStarted.push_back(new DogfightState(_game, _globe, (*j), u));
 
@@ -801,11 +806,7 @@ void GeoscapeState::time5Seconds()
 						{
 							if(!(*j)->isInDogfight())
 							{
-								// look up polygons texture
-								int texture, shade;
-								_globe->getPolygonTextureAndShade(u->getLongitude(), u->getLatitude(), &texture, &shade);
-								timerReset();
-								popup(new ConfirmLandingState(_game, *j, texture, shade, this));
+								confirmLanding(*j, u);
 							}
 						}
 						else if (u->getStatus() != Ufo::LANDED)
@@ -824,11 +825,7 @@ void GeoscapeState::time5Seconds()
 				{
 					if ((*j)->getNumSoldiers() > 0)
 					{
-						// look up polygons texture
-						int texture, shade;
-						_globe->getPolygonTextureAndShade(t->getLongitude(), t->getLatitude(), &texture, &shade);
-						timerReset();
-						popup(new ConfirmLandingState(_game, *j, texture, shade, this));
+						confirmLanding(*j, t);
 					}
 					else
 					{
@@ -841,10 +838,7 @@ void GeoscapeState::time5Seconds()
 					{
 						if((*j)->getNumSoldiers() > 0)
 						{
-							int texture, shade;
-							_globe->getPolygonTextureAndShade(b->getLongitude(), b->getLatitude(), &texture, &shade);
-							timerReset();
-							popup(new ConfirmLandingState(_game, *j, texture, shade, this));
+							confirmLanding(*j, b);
 						}
 						else
 						{
@@ -1055,20 +1049,17 @@ bool GeoscapeState::processTerrorSite(TerrorSite *ts) const
 		return false;
 	}
 	// Score and delete it.
-	Region *region = _game->getSavedGame()->locateRegion(*ts);
+	Region *region = _game->getSavedGame()->locateRegion(*ts, _game->getRuleset());
 	if (region)
 	{
 		//TODO: This should come from mission rules!
 		region->addActivityAlien(1000);
 		//kids, tell your folks... don't ignore terror sites.
 	}
-	for (std::vector<Country*>::iterator k = _game->getSavedGame()->getCountries()->begin(); k != _game->getSavedGame()->getCountries()->end(); ++k)
+	Country *country = _game->getSavedGame()->locateCountry(ts->getLongitude(), ts->getLatitude(), _game->getRuleset());
+	if (country)
 	{
-		if ((*k)->getRules()->insideCountry(ts->getLongitude(), ts->getLatitude()))
-		{
-			(*k)->addActivityAlien(1000);
-			break;
-		}
+		country->addActivityAlien(1000);
 	}
 	delete ts;
 	return true;
@@ -1172,24 +1163,20 @@ void GeoscapeState::time30Minutes()
 			points++;
 		case Ufo::FLYING:
 			points++;
-			// Get area
-			for (std::vector<Region*>::iterator k = _game->getSavedGame()->getRegions()->begin(); k != _game->getSavedGame()->getRegions()->end(); ++k)
 			{
-				if ((*k)->getRules()->insideRegion((*u)->getLongitude(), (*u)->getLatitude()))
+				// Get area
+				Region *region = _game->getSavedGame()->locateRegion(**u, _game->getRuleset());
+				if (region)
 				{
 					//one point per UFO in-flight per half hour
-					(*k)->addActivityAlien(points);
-					break;
+					region->addActivityAlien(points);
 				}
-			}
-			// Get country
-			for (std::vector<Country*>::iterator k = _game->getSavedGame()->getCountries()->begin(); k != _game->getSavedGame()->getCountries()->end(); ++k)
-			{
-				if ((*k)->getRules()->insideCountry((*u)->getLongitude(), (*u)->getLatitude()))
+				// Get country
+				Country *country = _game->getSavedGame()->locateCountry((*u)->getLongitude(), (*u)->getLatitude(), _game->getRuleset());
+				if (country)
 				{
 					//one point per UFO in-flight per half hour
-					(*k)->addActivityAlien(points);
-					break;
+					country->addActivityAlien(points);
 				}
 			}
 			if (!(*u)->getDetected())
@@ -1506,21 +1493,15 @@ void GeoscapeState::time1Day()
 	// handle regional and country points for alien bases
 	for(std::vector<AlienBase*>::const_iterator b = _game->getSavedGame()->getAlienBases()->begin(); b != _game->getSavedGame()->getAlienBases()->end(); ++b)
 	{
-		for (std::vector<Region*>::iterator k = _game->getSavedGame()->getRegions()->begin(); k != _game->getSavedGame()->getRegions()->end(); ++k)
+		Region *region = _game->getSavedGame()->locateRegion(**b, _game->getRuleset());
+		if (region)
 		{
-			if ((*k)->getRules()->insideRegion((*b)->getLongitude(), (*b)->getLatitude()))
-			{
-				(*k)->addActivityAlien(5);
-				break;
-			}
+			region->addActivityAlien(5);
 		}
-		for (std::vector<Country*>::iterator k = _game->getSavedGame()->getCountries()->begin(); k != _game->getSavedGame()->getCountries()->end(); ++k)
+		Country *country = _game->getSavedGame()->locateCountry((*b)->getLongitude(), (*b)->getLatitude(), _game->getRuleset());
+		if (country)
 		{
-			if ((*k)->getRules()->insideCountry((*b)->getLongitude(), (*b)->getLatitude()))
-			{
-				(*k)->addActivityAlien(5);
-				break;
-			}
+			country->addActivityAlien(5);
 		}
 	}
 
@@ -1529,7 +1510,7 @@ void GeoscapeState::time1Day()
 		      GenerateSupplyMission(*_game->getRuleset(), *_game->getSavedGame()));
 
 	// Autosave
-	if (Options::getInt("autosave") >= 2)
+	if (Options::getInt("autosave") >= 2 && !_headless)
 		_game->pushState(new SaveState(_game, true, false));
 }
 
@@ -1643,10 +1624,16 @@ void GeoscapeState::musicStop(bool)
  * Adds a new popup window to the queue
  * (this prevents popups from overlapping)
  * and pauses the game timer respectively.
+ * When headless the popup is dismissed right away.
  * @param state Pointer to popup state.
  */
 void GeoscapeState::popup(State *state)
 {
+	if (_headless)
+	{
+		delete state;
+		return;
+	}
 	_pause = true;
 	_popups.push_back(state);
 }
@@ -2098,4 +2085,88 @@ void GeoscapeState::btnTimerClick(Action *action)
 	action->getSender()->mousePress(&a, this);
 }
 
+/**
+ * Makes the Geoscape run with nobody to answer it, for
+ * simulating the game. Popups are dismissed as soon as
+ * they show up, and anything that needs a decision or a
+ * battle is turned down: crafts return to base instead of
+ * landing or intercepting, and UFOs attacking bases give up.
+ * @param headless True to run headless.
+ */
+void GeoscapeState::setHeadless(bool headless)
+{
+	_headless = headless;
+}
+
+/**
+ * Asks the player if a craft should land on the target
+ * it has reached, or sends it back to base if headless.
+ * @param craft Pointer to the craft.
+ * @param target Pointer to the target it has reached.
+ */
+void GeoscapeState::confirmLanding(Craft *craft, Target *target)
+{
+	if (_headless)
+	{
+		craft->returnToBase();
+		return;
+	}
+	// look up polygons texture
+	int texture, shade;
+	_globe->getPolygonTextureAndShade(target->getLongitude(), target->getLatitude(), &texture, &shade);
+	timerReset();
+	popup(new ConfirmLandingState(_game, craft, texture, shade, this));
+}
+
+/**
+ * Checks if there are no UFOs, waypoints or dogfights on
+ * the globe and every craft is sitting at its base. Then the
+ * 5 second logic only repeats what it did before and the
+ * 10 minute logic has nothing to do.
+ * @return True if nothing is moving.
+ */
+bool GeoscapeState::isIdle() const
+{
+	SavedGame *save = _game->getSavedGame();
+	if (save->getBases()->empty() || !save->getUfos()->empty() || !save->getWaypoints()->empty() || !_dogfights.empty() || !_dogfightsToBeStarted.empty())
+	{
+		return false;
+	}
+	for (std::vector<Base*>::const_iterator i = save->getBases()->begin(); i != save->getBases()->end(); ++i)
+	{
+		for (std::vector<Craft*>::const_iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end(); ++j)
+		{
+			if ((*j)->getStatus() == "STR_OUT" || (*j)->getDestination() != 0 || (*j)->isDestroyed())
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * Skips ahead over the time where nothing can happen. While
+ * nothing is moving on the globe, every event comes from the half
+ * hour logic or above (missions, transfers, research, production),
+ * so the time can jump straight to the step before the next half hour
+ * with the same results as advancing 5 seconds at a time.
+ * @param maxSteps Most 5 second steps to skip.
+ * @return Number of steps skipped.
+ */
+int GeoscapeState::skipIdleTime(int maxSteps)
+{
+	if (maxSteps <= 0 || !Options::getBool("geoscapeTimeSkip") || !isIdle())
+	{
+		return 0;
+	}
+	GameTime *time = _game->getSavedGame()->getTime();
+	int steps = std::min(maxSteps, time->getStepsUntil(TIME_30MIN) - 1);
+	for (int i = 0; i < steps; ++i)
+	{
+		time->advance();
+	}
+	return steps;
+}
+
 }
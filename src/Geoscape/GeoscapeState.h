@@ -35,6 +35,8 @@ class DogfightState;
 class Ufo;
 class TerrorSite;
 class Base;
+class Craft;
+class Target;
 
 /**
  * Geoscape screen which shows an overview of
@@ -57,6 +59,7 @@ private:
 	std::vector<DogfightState*> _dogfights, _dogfightsToBeStarted;
 	size_t _minimizedDogfights;
 	bool _gameStarted;
+	bool _headless;
 	bool _showFundsOnGeoscape;  // this is a cache for Options::getBool("showFundsOnGeoscape")
 public:
 	/// Creates the Geoscape state.
@@ -153,7 +156,15 @@ public:
 	bool processTerrorSite(TerrorSite *ts) const;
 	/// Handles base defense
 	void handleBaseDefense(Base *base, Ufo *ufo);
+	/// Runs the Geoscape with nobody to answer it.
+	void setHeadless(bool headless);
+	/// Skips ahead over time where nothing can happen.
+	int skipIdleTime(int maxSteps);
 private:
+	/// Checks if there's nothing moving on the globe.
+	bool isIdle() const;
+	/// Asks the player to land a craft at its destination.
+	void confirmLanding(Craft *craft, Target *target);
 	/// Handle alien mission generation.
 	void determineAlienMissions(bool atGameStart = false);
 };
@@ -19,7 +19,10 @@
 #define _USE_MATH_DEFINES
 #include "Globe.h"
 #include <cmath>
+#include <cstring>
 #include <fstream>
+#include <algorithm>
+#include <iomanip>
 #include "../aresame.h"
 #include "../Engine/Action.h"
 #include "../Engine/SurfaceSet.h"
@@ -56,6 +59,19 @@
 #include "../Ruleset/RuleBaseFacility.h"
 #include "../Ruleset/RuleCraft.h"
 #include "../Ruleset/Ruleset.h"
+#include "../Engine/Zoom.h"
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/Logger.h"
+
+#if (_MSC_VER >= 1400) || (defined(__MINGW32__) && defined(__SSE2__))
+#ifndef __SSE2__
+#define __SSE2__ true
+#endif
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 namespace OpenXcom
 {
@@ -68,11 +84,16 @@ const double Globe::ROTATE_LATITUDE = 0.15;
 namespace
 {
 	
+///light indexes for pixels too dark or too bright for the shading gradient
+const int LIGHT_MIN = -111, LIGHT_MAX = 121;
+
 ///helper class for `Globe` for drawing earth globe with shadows
 struct GlobeStaticData
 {
 	///array of shading gradient
-	Sint16 shade_gradient[240];
+	Sint16 shade_gradient[241];
+	///shading gradient by light index, including the levels past both ends
+	Sint16 light_levels[LIGHT_MAX - LIGHT_MIN + 1];
 	///size of x & y of noise surface
 	const int random_surf_size;
 	
@@ -113,7 +134,7 @@ struct GlobeStaticData
 	GlobeStaticData() : random_surf_size(60)
 	{
 		//filling terminator gradient LUT
-		for (int i=0; i<240; ++i)
+		for (int i=0; i<241; ++i)
 		{
 			int j = i - 120;
 
@@ -156,6 +177,15 @@ struct GlobeStaticData
 			shade_gradient[i]= j+16;
 		}
 
+		for (int i=LIGHT_MIN; i<=LIGHT_MAX; ++i)
+		{
+			if (i == LIGHT_MIN)
+				light_levels[i - LIGHT_MIN] = -31;
+			else if (i == LIGHT_MAX)
+				light_levels[i - LIGHT_MIN] = 50;
+			else
+				light_levels[i - LIGHT_MIN] = shade_gradient[i + 120];
+		}
 	}
 };
 
@@ -172,6 +202,11 @@ struct Ocean
 struct CreateShadow
 {
 	static inline Uint8 getShadowValue(const Uint8& dest, const Cord& earth, const Cord& sun, const Sint16& noise)
+	{
+		return getShadowValue(dest, getLight(earth, sun) - noise);
+	}
+
+	static inline Sint16 getLight(const Cord& earth, const Cord& sun)
 	{
 		Cord temp = earth;
 		//diff
@@ -193,11 +228,14 @@ struct CreateShadow
 		else
 			temp.x = static_data.shade_gradient[(Sint16)temp.x + 120];
 
-		temp.x -= noise;
+		return (Sint16)temp.x;
+	}
 
-		if(temp.x > 0.)
+	static inline Uint8 getShadowValue(const Uint8& dest, const Sint16& light)
+	{
+		if(light > 0)
 		{
-			const Sint16 val = (temp.x> 31)? 31 : (Sint16)temp.x;
+			const Sint16 val = (light > 31)? 31 : light;
 			const int d = dest & helper::ColorGroup;
 			if(d ==  Palette::blockOffset(12) || d ==  Palette::blockOffset(13))
 			{
@@ -240,6 +278,171 @@ struct CreateShadow
 	}
 };
 
+/**
+ * Works out the light index of a globe pixel from its normal,
+ * the same as CreateShadow::getLight but in single precision.
+ * @param x X of the pixel normal.
+ * @param y Y of the pixel normal.
+ * @param z Z of the pixel normal.
+ * @param sun Direction of the sun.
+ * @return Light index, LIGHT_MIN or LIGHT_MAX past the ends of the gradient.
+ */
+inline int getLightIndex(float x, float y, float z, const float *sun)
+{
+	const float dx = x - sun[0], dy = y - sun[1], dz = z - sun[2];
+	const float t = (dx * dx + (dz * dz + dy * dy) - 2.0f) * 125.0f;
+	if (t < -110.0f)
+		return LIGHT_MIN;
+	if (t > 120.0f)
+		return LIGHT_MAX;
+	return (int)t;
+}
+
+/**
+ * Works out the light of a row of globe pixels.
+ * @param x X of the pixel normals.
+ * @param y Y of the pixel normals.
+ * @param z Z of the pixel normals.
+ * @param count Number of pixels.
+ * @param sun Direction of the sun.
+ * @param light Returns the light of each pixel.
+ */
+void getLightRow(const float *x, const float *y, const float *z, int count, const float *sun, Sint16 *light)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		light[i] = static_data.light_levels[getLightIndex(x[i], y[i], z[i], sun) - LIGHT_MIN];
+	}
+}
+
+#ifdef __SSE2__
+/**
+ * Works out the light of a row of globe pixels four at a time.
+ * Gives the same results as getLightRow.
+ * @param x X of the pixel normals.
+ * @param y Y of the pixel normals.
+ * @param z Z of the pixel normals.
+ * @param count Number of pixels.
+ * @param sun Direction of the sun.
+ * @param light Returns the light of each pixel.
+ */
+void getLightRow_SSE2(const float *x, const float *y, const float *z, int count, const float *sun, Sint16 *light)
+{
+	const __m128 sunX = _mm_set1_ps(sun[0]), sunY = _mm_set1_ps(sun[1]), sunZ = _mm_set1_ps(sun[2]);
+	const __m128 two = _mm_set1_ps(2.0f), scale = _mm_set1_ps(125.0f), low = _mm_set1_ps(-110.0f), high = _mm_set1_ps(120.0f);
+	const __m128i lightMin = _mm_set1_epi32(LIGHT_MIN), lightMax = _mm_set1_epi32(LIGHT_MAX);
+	int index[4];
+	int i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), sunX);
+		const __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), sunY);
+		const __m128 dz = _mm_sub_ps(_mm_loadu_ps(z + i), sunZ);
+		const __m128 t = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_add_ps(_mm_mul_ps(dz, dz), _mm_mul_ps(dy, dy))), two), scale);
+		const __m128i below = _mm_castps_si128(_mm_cmplt_ps(t, low));
+		const __m128i above = _mm_castps_si128(_mm_cmpgt_ps(t, high));
+		__m128i result = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(t, low), high));
+		result = _mm_or_si128(_mm_andnot_si128(below, result), _mm_and_si128(below, lightMin));
+		result = _mm_or_si128(_mm_andnot_si128(above, result), _mm_and_si128(above, lightMax));
+		_mm_storeu_si128((__m128i*)index, result);
+		light[i] = static_data.light_levels[index[0] - LIGHT_MIN];
+		light[i + 1] = static_data.light_levels[index[1] - LIGHT_MIN];
+		light[i + 2] = static_data.light_levels[index[2] - LIGHT_MIN];
+		light[i + 3] = static_data.light_levels[index[3] - LIGHT_MIN];
+	}
+	getLightRow(x + i, y + i, z + i, count - i, sun, light + i);
+}
+#endif
+
+/**
+ * Fills a polygon with a texture tiled over the surface.
+ * Covers the same pixels as SDL_gfx's texturedPolygon, but
+ * copies the texture straight into a locked 8bpp surface a tile
+ * row at a time, instead of blitting every span.
+ * @param dst Destination surface, locked.
+ * @param vx X coordinates of the points.
+ * @param vy Y coordinates of the points.
+ * @param n Number of points, up to 4.
+ * @param texture Texture surface, with the same palette.
+ */
+void fillTexturedPolygon(SDL_Surface *dst, const Sint16 *vx, const Sint16 *vy, int n, SDL_Surface *texture)
+{
+	if (n < 3 || n > 4)
+		return;
+	int minY = vy[0], maxY = vy[0];
+	for (int i = 1; i < n; ++i)
+	{
+		minY = std::min(minY, (int)vy[i]);
+		maxY = std::max(maxY, (int)vy[i]);
+	}
+	const bool keyed = (texture->flags & SDL_SRCCOLORKEY) != 0;
+	const Uint8 key = texture->format->colorkey;
+	int ints[4];
+	for (int y = std::max(minY, 0); y <= std::min(maxY, dst->h - 1); ++y)
+	{
+		int count = 0;
+		for (int i = 0; i < n; ++i)
+		{
+			int ind1 = (i == 0) ? n - 1 : i - 1, ind2 = i;
+			int x1, x2, y1 = vy[ind1], y2 = vy[ind2];
+			if (y1 < y2)
+			{
+				x1 = vx[ind1];
+				x2 = vx[ind2];
+			}
+			else if (y1 > y2)
+			{
+				y2 = vy[ind1];
+				y1 = vy[ind2];
+				x2 = vx[ind1];
+				x1 = vx[ind2];
+			}
+			else
+			{
+				continue;
+			}
+			if ((y >= y1 && y < y2) || (y == maxY && y > y1 && y <= y2))
+			{
+				ints[count++] = ((65536 * (y - y1)) / (y2 - y1)) * (x2 - x1) + (65536 * x1);
+			}
+		}
+		std::sort(ints, ints + count);
+
+		const Uint8 *tex = (const Uint8*)texture->pixels + (y % texture->h) * texture->pitch;
+		Uint8 *row = (Uint8*)dst->pixels + y * dst->pitch;
+		for (int i = 0; i + 1 < count; i += 2)
+		{
+			int xa = ints[i] + 1;
+			xa = (xa >> 16) + ((xa & 32768) >> 15);
+			int xb = ints[i + 1] - 1;
+			xb = (xb >> 16) + ((xb & 32768) >> 15);
+			if (xa > xb)
+				std::swap(xa, xb);
+			xa = std::max(xa, 0);
+			xb = std::min(xb, dst->w - 1);
+			// copy one texture tile at a time
+			for (int x = xa; x <= xb;)
+			{
+				const int tx = x % texture->w;
+				const int run = std::min(texture->w - tx, xb - x + 1);
+				if (keyed)
+				{
+					for (int j = 0; j < run; ++j)
+					{
+						if (tex[tx + j] != key)
+							row[x + j] = tex[tx + j];
+					}
+				}
+				else
+				{
+					memcpy(row + x, tex + tx, run);
+				}
+				x += run;
+			}
+		}
+	}
+}
+
 }//namespace
 
 
@@ -376,14 +579,17 @@ Globe::Globe(Game *game, int cenX, int cenY, int width, int height, int x, int y
 	_radius.push_back(3.60*height);
 	_earthData.resize(_radius.size());
 
-	//filling normal field for each radius
+	//filling normal field for each radius, each row holds all the x, then all the y, then all the z
 	for(unsigned int r = 0; r<_radius.size(); ++r)
 	{
-		_earthData[r].resize(width * height);
+		_earthData[r].resize(width * height * 3);
 		for(int j=0; j<height; ++j)
 			for(int i=0; i<width; ++i)
 			{
-				_earthData[r][width*j + i] = static_data.circle_norm(width/2, height/2, _radius[r], i+.5, j+.5);
+				Cord normal = static_data.circle_norm(width/2, height/2, _radius[r], i+.5, j+.5);
+				_earthData[r][width*3*j + i] = normal.x;
+				_earthData[r][width*3*j + width + i] = normal.y;
+				_earthData[r][width*3*j + width*2 + i] = normal.z;
 			}
 	}
 
@@ -723,9 +929,20 @@ bool Globe::insideLand(double lon, double lat) const
 	double oldLon = _cenLon, oldLat = _cenLat;
 	globe->_cenLon = lon;
 	globe->_cenLat = lat;
-	for (std::list<Polygon*>::iterator i = _game->getResourcePack()->getPolygons()->begin(); i != _game->getResourcePack()->getPolygons()->end() && !inside; ++i)
+	const std::vector<int> *nearby = _game->getResourcePack()->getPolygonsNear(lon, lat);
+	if (nearby != 0)
 	{
-		inside = insidePolygon(lon, lat, *i);
+		for (std::vector<int>::const_iterator i = nearby->begin(); i != nearby->end() && !inside; ++i)
+		{
+			inside = insidePolygon(lon, lat, _game->getResourcePack()->getPolygon(*i));
+		}
+	}
+	else
+	{
+		for (std::list<Polygon*>::iterator i = _game->getResourcePack()->getPolygons()->begin(); i != _game->getResourcePack()->getPolygons()->end() && !inside; ++i)
+		{
+			inside = insidePolygon(lon, lat, *i);
+		}
 	}
 	globe->_cenLon = oldLon;
 	globe->_cenLat = oldLat;
@@ -998,6 +1215,9 @@ void Globe::drawLand()
 {
 	Sint16 x[4], y[4];
 
+	// Apply textures according to zoom and shade
+	int zoom = (2 - (int)floor(_zoom / 2.0)) * NUM_TEXTURES;
+	lock();
 	for (std::list<Polygon*>::iterator i = _cacheLand.begin(); i != _cacheLand.end(); ++i)
 	{
 		// Convert coordinates
@@ -1007,10 +1227,9 @@ void Globe::drawLand()
 			y[j] = (*i)->getY(j);
 		}
 
-		// Apply textures according to zoom and shade
-		int zoom = (2 - (int)floor(_zoom / 2.0)) * NUM_TEXTURES;
-		drawTexturedPolygon(x, y, (*i)->getPoints(), _texture->getFrame((*i)->getTexture() + zoom), 0, 0);
+		fillTexturedPolygon(getSurface(), x, y, (*i)->getPoints(), _texture->getFrame((*i)->getTexture() + zoom)->getSurface());
 	}
+	unlock();
 }
 
 /**
@@ -1069,17 +1288,176 @@ Cord Globe::getSunDirection(double lon, double lat) const
 }
 
 
+/**
+ * Shades the globe according to the time of day,
+ * working out the light of a whole row of pixels at once.
+ */
 void Globe::drawShadow()
 {
-	ShaderMove<Cord> earth = ShaderMove<Cord>(_earthData[_zoom], getWidth(), getHeight());
-	ShaderRepeat<Sint16> noise = ShaderRepeat<Sint16>(_randomNoiseData, static_data.random_surf_size, static_data.random_surf_size);
-	
-	earth.setMove(_cenX-getWidth()/2, _cenY-getHeight()/2);
-	
+#ifdef __SSE2__
+	static bool _haveSSE2 = Zoom::haveSSE2();
+	drawShadow(_haveSSE2);
+#else
+	drawShadow(false);
+#endif
+}
+
+/**
+ * Shades the globe according to the time of day.
+ * @param simd Use SSE2 to work out the light.
+ */
+void Globe::drawShadow(bool simd)
+{
+	const int width = getWidth(), height = getHeight(), noiseSize = static_data.random_surf_size;
+	// the normal field is centered on the globe
+	const int moveX = _cenX - width/2 - getX(), moveY = _cenY - height/2 - getY();
+	const int firstX = std::max(0, moveX), lastX = std::min(width, width + moveX);
+	const int firstY = std::max(0, moveY), lastY = std::min(height, height + moveY);
+	if (firstX >= lastX || firstY >= lastY)
+		return;
+
+	const Cord sun = getSunDirection(_cenLon, _cenLat);
+	const float sunf[3] = {(float)sun.x, (float)sun.y, (float)sun.z};
+	std::vector<Sint16> light(width);
+
 	lock();
-	ShaderDraw<CreateShadow>(ShaderSurface(this), earth, ShaderScalar(getSunDirection(_cenLon, _cenLat)), noise);
+	for (int y = firstY; y < lastY; ++y)
+	{
+		const float *normalX = &_earthData[_zoom][(y - moveY) * width * 3 + firstX - moveX];
+		const float *normalY = normalX + width, *normalZ = normalX + width * 2;
+#ifdef __SSE2__
+		if (simd)
+			getLightRow_SSE2(normalX, normalY, normalZ, lastX - firstX, sunf, &light[0]);
+		else
+#endif
+			getLightRow(normalX, normalY, normalZ, lastX - firstX, sunf, &light[0]);
+
+		Uint8 *row = (Uint8*)getSurface()->pixels + y * getSurface()->pitch;
+		const Sint16 *noise = &_randomNoiseData[((y + getY()) % noiseSize + noiseSize) % noiseSize * noiseSize];
+		int noiseX = ((firstX + getX()) % noiseSize + noiseSize) % noiseSize;
+		for (int x = firstX; x < lastX; ++x)
+		{
+			Uint8 &dest = row[x];
+			if (dest && normalZ[x - firstX] != 0.0f)
+				dest = CreateShadow::getShadowValue(dest, light[x - firstX] - noise[noiseX]);
+			else
+				dest = 0;
+			if (++noiseX == noiseSize)
+				noiseX = 0;
+		}
+	}
 	unlock();
-		
+}
+
+/**
+ * Times redrawing the land and shading of the globe at every zoom
+ * level, with the old and new ways of drawing them, and logs how
+ * long each took and how many pixels came out different.
+ * @param frames Number of times to draw each.
+ */
+void Globe::benchmark(int frames)
+{
+	size_t oldZoom = _zoom;
+	SDL_Surface *surface = getSurface();
+	const size_t size = surface->pitch * surface->h;
+	Log(LOG_INFO) << "Drawing a " << getWidth() << "x" << getHeight() << " globe " << frames << " times per zoom level";
+	for (_zoom = 0; _zoom < _radius.size(); ++_zoom)
+	{
+		cachePolygons();
+		int zoom = (2 - (int)floor(_zoom / 2.0)) * NUM_TEXTURES;
+		Sint64 landOld = 0, landNew = 0, shadeOld = 0, shadeScalar = 0, shadeSimd = 0;
+
+		// land with SDL_gfx
+		std::vector<Uint8> before;
+		for (int f = 0; f < frames; ++f)
+		{
+			drawOcean();
+			Sint64 start = CrossPlatform::getMicroseconds();
+			Sint16 x[4], y[4];
+			for (std::list<Polygon*>::iterator i = _cacheLand.begin(); i != _cacheLand.end(); ++i)
+			{
+				for (int j = 0; j < (*i)->getPoints(); ++j)
+				{
+					x[j] = (*i)->getX(j);
+					y[j] = (*i)->getY(j);
+				}
+				drawTexturedPolygon(x, y, (*i)->getPoints(), _texture->getFrame((*i)->getTexture() + zoom), 0, 0);
+			}
+			landOld += CrossPlatform::getMicroseconds() - start;
+		}
+		lock();
+		before.assign((Uint8*)surface->pixels, (Uint8*)surface->pixels + size);
+		unlock();
+		for (int f = 0; f < frames; ++f)
+		{
+			drawOcean();
+			Sint64 start = CrossPlatform::getMicroseconds();
+			drawLand();
+			landNew += CrossPlatform::getMicroseconds() - start;
+		}
+		lock();
+		int landDiff = 0;
+		for (size_t i = 0; i < size; ++i)
+			landDiff += (before[i] != ((Uint8*)surface->pixels)[i]);
+		unlock();
+
+		// shading with the old double precision normals
+		std::vector<Cord> earth(getWidth() * getHeight());
+		for (int j = 0; j < getHeight(); ++j)
+			for (int i = 0; i < getWidth(); ++i)
+				earth[getWidth()*j + i] = static_data.circle_norm(getWidth()/2, getHeight()/2, _radius[_zoom], i+.5, j+.5);
+		ShaderMove<Cord> earthShader = ShaderMove<Cord>(earth, getWidth(), getHeight());
+		ShaderRepeat<Sint16> noise = ShaderRepeat<Sint16>(_randomNoiseData, static_data.random_surf_size, static_data.random_surf_size);
+		earthShader.setMove(_cenX-getWidth()/2, _cenY-getHeight()/2);
+		for (int f = 0; f < frames; ++f)
+		{
+			drawOcean();
+			drawLand();
+			Sint64 start = CrossPlatform::getMicroseconds();
+			lock();
+			ShaderDraw<CreateShadow>(ShaderSurface(this), earthShader, ShaderScalar(getSunDirection(_cenLon, _cenLat)), noise);
+			unlock();
+			shadeOld += CrossPlatform::getMicroseconds() - start;
+		}
+		lock();
+		before.assign((Uint8*)surface->pixels, (Uint8*)surface->pixels + size);
+		unlock();
+		for (int f = 0; f < frames; ++f)
+		{
+			drawOcean();
+			drawLand();
+			Sint64 start = CrossPlatform::getMicroseconds();
+			drawShadow(false);
+			shadeScalar += CrossPlatform::getMicroseconds() - start;
+		}
+#ifdef __SSE2__
+		for (int f = 0; f < frames; ++f)
+		{
+			drawOcean();
+			drawLand();
+			Sint64 start = CrossPlatform::getMicroseconds();
+			drawShadow(true);
+			shadeSimd += CrossPlatform::getMicroseconds() - start;
+		}
+#endif
+		lock();
+		int shadeDiff = 0;
+		for (size_t i = 0; i < size; ++i)
+			shadeDiff += (before[i] != ((Uint8*)surface->pixels)[i]);
+		unlock();
+
+		Log(LOG_INFO) << "Zoom " << _zoom << ": " << _cacheLand.size() << " polygons" << std::fixed << std::setprecision(1)
+			<< ", land " << (double)landOld / frames << "us -> " << (double)landNew / frames << "us (" << landDiff << " pixels differ)"
+			<< ", shading " << (double)shadeOld / frames << "us -> " << (double)shadeScalar / frames << "us scalar, "
+#ifdef __SSE2__
+			<< (double)shadeSimd / frames << "us SSE2"
+#else
+			<< "no SSE2"
+#endif
+			<< " (" << shadeDiff << " pixels differ)";
+	}
+	_zoom = oldZoom;
+	cachePolygons();
 }
 
 
@@ -1716,12 +2094,28 @@ void Globe::getPolygonTextureAndShade(double lon, double lat, int *texture, int
 	double oldLon = _cenLon, oldLat = _cenLat;
 	globe->_cenLon = lon;
 	globe->_cenLat = lat;
-	for (std::list<Polygon*>::iterator i = _game->getResourcePack()->getPolygons()->begin(); i != _game->getResourcePack()->getPolygons()->end(); ++i)
+	const std::vector<int> *nearby = _game->getResourcePack()->getPolygonsNear(lon, lat);
+	if (nearby != 0)
 	{
-		if (insidePolygon(lon, lat, *i))
+		for (std::vector<int>::const_iterator i = nearby->begin(); i != nearby->end(); ++i)
 		{
-			*texture = (*i)->getTexture();
-			break;
+			Polygon *poly = _game->getResourcePack()->getPolygon(*i);
+			if (insidePolygon(lon, lat, poly))
+			{
+				*texture = poly->getTexture();
+				break;
+			}
+		}
+	}
+	else
+	{
+		for (std::list<Polygon*>::iterator i = _game->getResourcePack()->getPolygons()->begin(); i != _game->getResourcePack()->getPolygons()->end(); ++i)
+		{
+			if (insidePolygon(lon, lat, *i))
+			{
+				*texture = (*i)->getTexture();
+				break;
+			}
 		}
 	}
 	globe->_cenLon = oldLon;
@@ -65,8 +65,8 @@ private:
 	Surface *_mkXcomBase, *_mkAlienBase, *_mkCraft, *_mkWaypoint, *_mkCity;
 	Surface *_mkFlyingUfo, *_mkLandedUfo, *_mkCrashedUfo, *_mkAlienSite;
 	FastLineClip *_clipper;
-	///normal of each pixel in earth globe per zoom level
-	std::vector<std::vector<Cord> > _earthData;
+	///normal of each pixel in earth globe per zoom level, split into x, y and z rows
+	std::vector<std::vector<float> > _earthData;
 	///data sample used for noise in shading
 	std::vector<Sint16> _randomNoiseData;
 	///list of dimension of earth on screen per zoom level
@@ -85,6 +85,8 @@ private:
 	void cache(std::list<Polygon*> *polygons, std::list<Polygon*> *cache);
 	/// Get position of sun relative to given position in polar cords and date.
 	Cord getSunDirection(double lon, double lat) const;
+	/// Draws the shadow, with or without SSE2.
+	void drawShadow(bool simd);
 public:
 	/// Creates a new globe at the specified position and size.
 	Globe(Game *game, int cenX, int cenY, int width, int height, int x = 0, int y = 0);
@@ -143,6 +145,8 @@ public:
 	void drawLand();
 	/// Draws the shadow.
 	void drawShadow();
+	/// Times drawing the globe at every zoom level.
+	void benchmark(int frames);
 	/// Draws the country details of the globe.
 	void drawRadars();
 	/// Draws the country details of the globe.
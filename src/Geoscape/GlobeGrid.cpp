@@ -0,0 +1,150 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#define _USE_MATH_DEFINES
+#include "GlobeGrid.h"
+#include <cmath>
+
+namespace OpenXcom
+{
+
+/**
+ * Returns the cell column of a longitude.
+ * @param lon Longitude in radians (0 to 2*PI).
+ * @param cells Number of columns.
+ * @return Column, clamped to the grid.
+ */
+static int lonToCell(double lon, int cells)
+{
+	int cell = (int)floor(lon / (2 * M_PI) * cells);
+	if (cell < 0)
+		return 0;
+	if (cell >= cells)
+		return cells - 1;
+	return cell;
+}
+
+/**
+ * Returns the cell row of a latitude.
+ * @param lat Latitude in radians (-PI/2 to PI/2).
+ * @param cells Number of rows.
+ * @return Row, clamped to the grid.
+ */
+static int latToCell(double lat, int cells)
+{
+	int cell = (int)floor((lat + M_PI_2) / M_PI * cells);
+	if (cell < 0)
+		return 0;
+	if (cell >= cells)
+		return cells - 1;
+	return cell;
+}
+
+/**
+ * Creates a grid with no areas in it.
+ */
+GlobeGrid::GlobeGrid() : _cells()
+{
+}
+
+/**
+ *
+ */
+GlobeGrid::~GlobeGrid()
+{
+}
+
+/**
+ * Removes every area from the grid, so
+ * all points are looked up the slow way.
+ */
+void GlobeGrid::clear()
+{
+	_cells.clear();
+}
+
+/**
+ * Lists an area in a range of cells. Areas are listed
+ * once per cell, in the order they're added.
+ * @param id ID of the area.
+ * @param lonFirst First column.
+ * @param lonLast Last column.
+ * @param latFirst First row.
+ * @param latLast Last row.
+ */
+void GlobeGrid::addCells(int id, int lonFirst, int lonLast, int latFirst, int latLast)
+{
+	for (int y = latFirst; y <= latLast; ++y)
+	{
+		for (int x = lonFirst; x <= lonLast; ++x)
+		{
+			std::vector<int> &cell = _cells[y * LON_CELLS + x];
+			if (cell.empty() || cell.back() != id)
+			{
+				cell.push_back(id);
+			}
+		}
+	}
+}
+
+/**
+ * Adds the bounds of an area to the grid. Areas made of
+ * several boxes add each of them with the same ID. IDs must
+ * be added in increasing order, so lookups find them in order.
+ * @param id ID of the area.
+ * @param lonMin Minimum longitude. Bigger than the maximum if the area wraps around.
+ * @param lonMax Maximum longitude.
+ * @param latMin Minimum latitude.
+ * @param latMax Maximum latitude.
+ */
+void GlobeGrid::add(int id, double lonMin, double lonMax, double latMin, double latMax)
+{
+	if (_cells.empty())
+	{
+		_cells.resize(LON_CELLS * LAT_CELLS);
+	}
+	int latFirst = latToCell(latMin, LAT_CELLS), latLast = latToCell(latMax, LAT_CELLS);
+	if (lonMin <= lonMax)
+	{
+		addCells(id, lonToCell(lonMin, LON_CELLS), lonToCell(lonMax, LON_CELLS), latFirst, latLast);
+	}
+	else
+	{
+		addCells(id, lonToCell(lonMin, LON_CELLS), LON_CELLS - 1, latFirst, latLast);
+		addCells(id, 0, lonToCell(lonMax, LON_CELLS), latFirst, latLast);
+	}
+}
+
+/**
+ * Returns the areas that might contain a point, in the
+ * order they were added. Any area containing the point is
+ * guaranteed to be listed, but it might not contain it exactly.
+ * @param lon Longitude of the point.
+ * @param lat Latitude of the point.
+ * @return Pointer to the list of area IDs, or 0 if the grid can't tell (the point is off the grid or the grid is empty).
+ */
+const std::vector<int> *GlobeGrid::find(double lon, double lat) const
+{
+	if (_cells.empty() || !(lon >= 0 && lon < 2 * M_PI && lat >= -M_PI_2 && lat <= M_PI_2))
+	{
+		return 0;
+	}
+	return &_cells[latToCell(lat, LAT_CELLS) * LON_CELLS + lonToCell(lon, LON_CELLS)];
+}
+
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_GLOBEGRID_H
+#define OPENXCOM_GLOBEGRID_H
+
+#include <vector>
+
+namespace OpenXcom
+{
+
+/**
+ * Spatial index of areas on the globe, for finding which
+ * regions, countries or polygons contain a point without
+ * checking every one of them. The globe is split into a grid
+ * of longitude/latitude cells, each listing the areas whose
+ * bounds overlap it, in the order they were added. The areas
+ * listed for a cell still need to be checked exactly.
+ */
+class GlobeGrid
+{
+private:
+	static const int LON_CELLS = 72, LAT_CELLS = 36;
+	std::vector<std::vector<int> > _cells;
+
+	/// Adds an area to a range of cells.
+	void addCells(int id, int lonFirst, int lonLast, int latFirst, int latLast);
+public:
+	/// Creates an empty grid.
+	GlobeGrid();
+	/// Cleans up the grid.
+	~GlobeGrid();
+	/// Removes every area from the grid.
+	void clear();
+	/// Adds the bounds of an area.
+	void add(int id, double lonMin, double lonMax, double latMin, double latMax);
+	/// Gets the areas that might contain a point.
+	const std::vector<int> *find(double lon, double lat) const;
+};
+
+}
+
+#endif
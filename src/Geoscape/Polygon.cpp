@@ -16,7 +16,10 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
+#define _USE_MATH_DEFINES
 #include "Polygon.h"
+#include <cmath>
+#include <algorithm>
 
 namespace OpenXcom
 {
@@ -180,4 +183,48 @@ int Polygon::getPoints() const
 	return _points;
 }
 
+/**
+ * Returns the smallest longitude/latitude box containing all the
+ * points of the polygon. Polygons across the zero meridian give
+ * a box that wraps around, with the minimum longitude bigger than
+ * the maximum, and ones too wide to tell cover all longitudes.
+ * @param lonMin Returns the minimum longitude.
+ * @param lonMax Returns the maximum longitude.
+ * @param latMin Returns the minimum latitude.
+ * @param latMax Returns the maximum latitude.
+ */
+void Polygon::getBounds(double *lonMin, double *lonMax, double *latMin, double *latMax) const
+{
+	*lonMin = *lonMax = _lon[0];
+	*latMin = *latMax = _lat[0];
+	for (int i = 1; i < _points; ++i)
+	{
+		*lonMin = std::min(*lonMin, _lon[i]);
+		*lonMax = std::max(*lonMax, _lon[i]);
+		*latMin = std::min(*latMin, _lat[i]);
+		*latMax = std::max(*latMax, _lat[i]);
+	}
+	if (*lonMax - *lonMin > M_PI)
+	{
+		// try going the other way around the globe
+		double wrapMin = 4 * M_PI, wrapMax = 0;
+		for (int i = 0; i < _points; ++i)
+		{
+			double lon = (_lon[i] < M_PI) ? _lon[i] + 2 * M_PI : _lon[i];
+			wrapMin = std::min(wrapMin, lon);
+			wrapMax = std::max(wrapMax, lon);
+		}
+		if (wrapMax - wrapMin > M_PI)
+		{
+			*lonMin = 0;
+			*lonMax = 2 * M_PI;
+		}
+		else
+		{
+			*lonMin = wrapMin;
+			*lonMax = wrapMax - 2 * M_PI;
+		}
+	}
+}
+
 }
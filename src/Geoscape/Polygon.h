@@ -64,6 +64,8 @@ public:
 	void setTexture(int tex);
 	/// Gets the number of points of the polygon.
 	int getPoints() const;
+	/// Gets the longitude/latitude bounds of the polygon.
+	void getBounds(double *lonMin, double *lonMax, double *latMin, double *latMax) const;
 };
 
 }
@@ -19,6 +19,7 @@
 #include "StartState.h"
 #include <SDL.h>
 #include <assert.h>
+#include <sstream>
 #include "../Engine/Logger.h"
 #include "../Engine/Game.h"
 #include "../Engine/Action.h"
@@ -31,7 +32,15 @@
 #include "../Engine/Screen.h"
 #include "../Engine/Music.h"
 #include "../Engine/Sound.h"
+#include "../Engine/LoadQueue.h"
+#include "../Engine/DataPack.h"
+#include "../Engine/Palette.h"
+#include "../Resource/ResourcePack.h"
 #include "../Ruleset/Ruleset.h"
+#include "../Savegame/SavedGame.h"
+#include "../Geoscape/Globe.h"
+#include "../Geoscape/GeoscapeSimulation.h"
+#include "../Battlescape/BattlescapeSimulation.h"
 #include "TestState.h"
 #include "NoteState.h"
 #include "LanguageState.h"
@@ -44,7 +53,7 @@ namespace OpenXcom
  * Initializes all the elements in the Loading screen.
  * @param game Pointer to the core game.
  */
-StartState::StartState(Game *game) : State(game), _load(LOADING_NONE)
+StartState::StartState(Game *game) : State(game), _load(LOADING_NONE), _queue(0), _resources(0), _startTime(0), _progress(-1)
 {
 	// Create objects
 	int dx = (Options::getInt("baseXResolution") - 320) / 2;
@@ -77,7 +86,8 @@ StartState::StartState(Game *game) : State(game), _load(LOADING_NONE)
  */
 StartState::~StartState()
 {
-
+	delete _queue;
+	delete _resources;
 }
 
 
@@ -418,8 +428,98 @@ static void audioHandler()
 	(*audioSequence)();
 }
 
+/**
+ * Finishes off the resources once the queue is done with them,
+ * then plays the intro.
+ */
+void StartState::finishLoading()
+{
+	Uint32 time = SDL_GetTicks();
+	_queue->finish();
+	_resources->finishLoading();
+	_queue->addTime("finishing", SDL_GetTicks() - time);
+	_queue->logTimes();
+	Log(LOG_INFO) << "Resources loaded successfully in " << (SDL_GetTicks() - _startTime) << "ms.";
+	_game->setResourcePack(_resources);
+	_resources = 0;
+	delete _queue;
+	_queue = 0;
+
+	std::vector<std::string> langs = Language::getList(0);
+	if (langs.empty())
+	{
+		throw Exception("No languages available");
+	}
+	_load = LOADING_SUCCESSFUL;
+
+	// loading done? let's play intro!
+	std::string introFile = CrossPlatform::getDataFile("UFOINTRO/UFOINT.FLI");
+	if (Options::getBool("playIntro") && Options::getConvertSave().empty() && Options::getSimulateSave().empty() && Options::getSimulateBattle().empty() && Options::getBenchmarkGlobe() == 0 && CrossPlatform::fileExists(introFile))
+	{
+		audioSequence = new AudioSequence(_game->getResourcePack());
+		Flc::flc.realscreen = _game->getScreen();
+		Flc::FlcInit(introFile.c_str());
+		Flc::flc.dx = (Options::getInt("baseXResolution") - 320) / 2;
+		Flc::flc.dy = (Options::getInt("baseYResolution") - 200) / 2;
+		Flc::flc.loop = 0; // just the one time, please
+		Flc::FlcMain(&audioHandler);
+		Flc::FlcDeInit();
+		delete audioSequence;
+
+
+		// fade out!
+		Mix_FadeOutChannel(-1, 45*20);
+		if (Mix_GetMusicType(0) != MUS_MID) { Mix_FadeOutMusic(45*20); } // SDL_Mixer has trouble with native midi and volume on windows, which is the most likely use case, so f@%# it.
+		else { Mix_HaltMusic(); }
+
+		SDL_Color pal[256];
+		SDL_Color pal2[256];
+		memcpy(pal, _game->getScreen()->getPalette(), sizeof(SDL_Color) * 256);
+		for (int i = 20; i > 0; --i)
+		{
+			SDL_Event event;
+			if (SDL_PollEvent(&event) && event.type == SDL_KEYDOWN) break;
+			for (int color = 0; color < 256; ++color)
+			{
+				pal2[color].r = (((int)pal[color].r) * i) / 20;
+				pal2[color].g = (((int)pal[color].g) * i) / 20;
+				pal2[color].b = (((int)pal[color].b) * i) / 20;
+			}
+			_game->getScreen()->setPalette(pal2, 0, 256, true);
+			_game->getScreen()->flip();
+			SDL_Delay(45);
+		}
+		_game->getScreen()->clear();
+		_game->getScreen()->flip();
+
+		_game->setVolume(Options::getInt("soundVolume"), Options::getInt("musicVolume"));
+
+		Mix_HaltChannel(-1);
+	}
+}
+
+/**
+ * Shows an error message when the loading fails.
+ * @param message Error message.
+ */
+void StartState::error(const std::string &message)
+{
+	_load = LOADING_FAILED;
+	_surface->clear();
+	_surface->drawString(1, 9, "ERROR:", 2);
+	_surface->drawString(1, 17, message.c_str(), 2);
+	_surface->drawString(1, 49, "Make sure you installed OpenXcom", 1);
+	_surface->drawString(1, 57, "correctly.", 1);
+	_surface->drawString(1, 73, "Check the requirements and", 1);
+	_surface->drawString(1, 81, "documentation for more details.", 1);
+	_surface->drawString(75, 183, "Press any key to quit", 1);
+	Log(LOG_ERROR) << message;
+}
+
 /**
  * Waits a cycle to load the resources so the screen is blitted first.
+ * The resources are then loaded in the background, with the screen
+ * showing how far along they are.
  * If the loading fails, it shows an error, otherwise moves on to the game.
  */
 void StartState::think()
@@ -431,76 +531,47 @@ void StartState::think()
 	case LOADING_STARTED:
 		try
 		{
+			std::string pack = CrossPlatform::getDataFile(Options::getString("dataPack"));
+			if (!Options::getString("dataPack").empty() && CrossPlatform::fileExists(pack))
+			{
+				DataPack::open(pack);
+			}
 			Log(LOG_INFO) << "Loading ruleset...";
 			_game->loadRuleset();
 			Log(LOG_INFO) << "Ruleset loaded successfully.";
 			Log(LOG_INFO) << "Loading resources...";
-			_game->setResourcePack(new XcomResourcePack(_game->getRuleset()->getExtraSprites(), _game->getRuleset()->getExtraSounds()));
-			Log(LOG_INFO) << "Resources loaded successfully.";
-			std::vector<std::string> langs = Language::getList(0);
-			if (langs.empty())
+			_startTime = SDL_GetTicks();
+			_queue = new LoadQueue();
+			_resources = new XcomResourcePack(_game->getRuleset()->getExtraSprites(), _game->getRuleset()->getExtraSounds(), _queue);
+			_queue->start(Options::getInt("loadingThreads"));
+			_load = LOADING_RESOURCES;
+		}
+		catch (Exception &e)
+		{
+			error(e.what());
+		}
+		break;
+	case LOADING_RESOURCES:
+		try
+		{
+			bool finished = _queue->update(20);
+			int progress = _queue->getProgress();
+			if (progress != _progress)
 			{
-				throw Exception("No languages available");
+				std::stringstream ss;
+				ss << "Loading... " << progress << "%";
+				_surface->clear();
+				_surface->drawString(120, 96, ss.str().c_str(), 1);
+				_progress = progress;
 			}
-			_load = LOADING_SUCCESSFUL;
-
-			// loading done? let's play intro!
-			std::string introFile = CrossPlatform::getDataFile("UFOINTRO/UFOINT.FLI");
-			if (Options::getBool("playIntro") && CrossPlatform::fileExists(introFile))
+			if (finished)
 			{
-				audioSequence = new AudioSequence(_game->getResourcePack());
-				Flc::flc.realscreen = _game->getScreen();
-				Flc::FlcInit(introFile.c_str());
-				Flc::flc.dx = (Options::getInt("baseXResolution") - 320) / 2;
-				Flc::flc.dy = (Options::getInt("baseYResolution") - 200) / 2;
-				Flc::flc.loop = 0; // just the one time, please
-				Flc::FlcMain(&audioHandler);
-				Flc::FlcDeInit();
-				delete audioSequence;
-
-
-				// fade out!
-				Mix_FadeOutChannel(-1, 45*20);
-				if (Mix_GetMusicType(0) != MUS_MID) { Mix_FadeOutMusic(45*20); } // SDL_Mixer has trouble with native midi and volume on windows, which is the most likely use case, so f@%# it.
-				else { Mix_HaltMusic(); }
-
-				SDL_Color pal[256];
-				SDL_Color pal2[256];
-				memcpy(pal, _game->getScreen()->getPalette(), sizeof(SDL_Color) * 256);
-				for (int i = 20; i > 0; --i)
-				{
-					SDL_Event event;
-					if (SDL_PollEvent(&event) && event.type == SDL_KEYDOWN) break;
-					for (int color = 0; color < 256; ++color)
-					{
-						pal2[color].r = (((int)pal[color].r) * i) / 20;
-						pal2[color].g = (((int)pal[color].g) * i) / 20;
-						pal2[color].b = (((int)pal[color].b) * i) / 20;
-					}
-					_game->getScreen()->setPalette(pal2, 0, 256, true);
-					_game->getScreen()->flip();
-					SDL_Delay(45);
-				}
-				_game->getScreen()->clear();
-				_game->getScreen()->flip();
-
-				_game->setVolume(Options::getInt("soundVolume"), Options::getInt("musicVolume"));
-
-				Mix_HaltChannel(-1);
+				finishLoading();
 			}
 		}
 		catch (Exception &e)
 		{
-			_load = LOADING_FAILED;
-			_surface->clear();
-			_surface->drawString(1, 9, "ERROR:", 2);
-			_surface->drawString(1, 17, e.what(), 2);
-			_surface->drawString(1, 49, "Make sure you installed OpenXcom", 1);
-			_surface->drawString(1, 57, "correctly.", 1);
-			_surface->drawString(1, 73, "Check the requirements and", 1);
-			_surface->drawString(1, 81, "documentation for more details.", 1);
-			_surface->drawString(75, 183, "Press any key to quit", 1);
-			Log(LOG_ERROR) << e.what();
+			error(e.what());
 		}
 		break;
 	case LOADING_NONE:
@@ -508,7 +579,54 @@ void StartState::think()
 		break;
 	case LOADING_SUCCESSFUL:
 		Log(LOG_INFO) << "OpenXcom started successfully!";
-		if (Options::getString("language").empty())
+		if (!Options::getConvertSave().empty())
+		{
+			std::string save = Options::getConvertSave();
+			try
+			{
+				bool binary = SavedGame::convert(save, _game->getRuleset());
+				Log(LOG_INFO) << "Converted " << save << ".sav to the " << (binary ? "binary" : "YAML") << " format.";
+			}
+			catch (Exception &e)
+			{
+				Log(LOG_ERROR) << e.what();
+			}
+			catch (YAML::Exception &e)
+			{
+				Log(LOG_ERROR) << e.what();
+			}
+			_game->quit();
+		}
+		else if (!Options::getSimulateSave().empty() || !Options::getSimulateBattle().empty())
+		{
+			std::string language = Options::getString("language");
+			_game->loadLanguage(language.empty() ? "English" : language);
+			if (!Options::getSimulateSave().empty())
+			{
+				GeoscapeSimulation simulation(_game);
+				simulation.load(Options::getSimulateSave(), Options::getSimulateSeed());
+				simulation.run(Options::getSimulateDays());
+			}
+			else
+			{
+				BattlescapeSimulation simulation(_game);
+				simulation.load(Options::getSimulateBattle(), Options::getSimulateSeed());
+				simulation.run(Options::getSimulateTurns());
+			}
+			_game->quit();
+		}
+		else if (Options::getBenchmarkGlobe() > 0)
+		{
+			int screenWidth = Options::getInt("baseXResolution");
+			int screenHeight = Options::getInt("baseYResolution");
+			_game->setSavedGame(_game->getRuleset()->newSave());
+			Globe globe(_game, (screenWidth-64)/2, screenHeight/2, screenWidth-64, screenHeight, 0, 0);
+			SDL_Color *colors = _game->getResourcePack()->getPalette("PALETTES.DAT_0")->getColors();
+			globe.setPalette(colors);
+			globe.benchmark(Options::getBenchmarkGlobe());
+			_game->quit();
+		}
+		else if (Options::getString("language").empty())
 		{
 			_game->setState(new LanguageState(_game));
 		}
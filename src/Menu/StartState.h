@@ -26,8 +26,9 @@ namespace OpenXcom
 {
 
 class Surface;
+class LoadQueue;
 
-enum LoadingPhase { LOADING_NONE, LOADING_STARTED, LOADING_FAILED, LOADING_SUCCESSFUL };
+enum LoadingPhase { LOADING_NONE, LOADING_STARTED, LOADING_RESOURCES, LOADING_FAILED, LOADING_SUCCESSFUL };
 
 /**
  * Initializes the game and loads all required content.
@@ -37,6 +38,14 @@ class StartState : public State
 private:
 	Surface *_surface;
 	LoadingPhase _load;
+	LoadQueue *_queue;
+	XcomResourcePack *_resources;
+	Uint32 _startTime;
+	int _progress;
+	/// Finishes loading the resources and plays the intro.
+	void finishLoading();
+	/// Shows a loading error.
+	void error(const std::string &message);
 public:
 	/// Creates the Start state.
 	StartState(Game *game);
@@ -0,0 +1,345 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "AssetCache.h"
+#include "../Engine/Logger.h"
+#include "../Engine/Surface.h"
+#include "../Engine/SurfaceSet.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates an empty cache.
+ * @param budget Memory budget in bytes for the loaded resources.
+ */
+AssetCache::AssetCache(size_t budget) : _entries(), _budget(budget), _residentSize(0), _residentCount(0), _clock(0), _hits(0), _loads(0), _evictions(0)
+{
+}
+
+/**
+ * Unloads and deletes all the resources in the cache.
+ */
+AssetCache::~AssetCache()
+{
+	for (std::map<std::string, Entry>::iterator i = _entries.begin(); i != _entries.end(); ++i)
+	{
+		unload(i->second);
+		delete i->second.asset;
+	}
+}
+
+/**
+ * Makes sure a resource is loaded, and marks it as just used.
+ * @param entry Cache entry.
+ */
+void AssetCache::load(Entry &entry)
+{
+	if (entry.resident)
+	{
+		_hits++;
+	}
+	else
+	{
+		entry.size = entry.asset->load();
+		entry.resident = true;
+		_residentSize += entry.size;
+		_residentCount++;
+		_loads++;
+	}
+	entry.lastUse = ++_clock;
+}
+
+/**
+ * Unloads a resource, if it's loaded.
+ * @param entry Cache entry.
+ */
+void AssetCache::unload(Entry &entry)
+{
+	if (entry.resident)
+	{
+		entry.asset->unload();
+		entry.resident = false;
+		_residentSize -= entry.size;
+		_residentCount--;
+		entry.size = 0;
+	}
+}
+
+/**
+ * Adds a resource to the cache, which takes care of deleting it.
+ * It isn't loaded until something asks for it.
+ * @param name Resource name.
+ * @param asset Resource to add.
+ * @param group Name of the group the resource belongs to.
+ */
+void AssetCache::add(const std::string &name, Asset *asset, const std::string &group)
+{
+	remove(name);
+	Entry entry;
+	entry.asset = asset;
+	entry.group = group;
+	entry.refs = 0;
+	entry.resident = false;
+	entry.size = 0;
+	entry.lastUse = 0;
+	_entries[name] = entry;
+}
+
+/**
+ * Unloads and removes a resource from the cache,
+ * for when something else takes its place.
+ * @param name Resource name.
+ */
+void AssetCache::remove(const std::string &name)
+{
+	std::map<std::string, Entry>::iterator i = _entries.find(name);
+	if (i != _entries.end())
+	{
+		unload(i->second);
+		delete i->second.asset;
+		_entries.erase(i);
+	}
+}
+
+/**
+ * Checks if a resource is handled by the cache.
+ * @param name Resource name.
+ * @return True if the cache has the resource.
+ */
+bool AssetCache::has(const std::string &name) const
+{
+	return _entries.find(name) != _entries.end();
+}
+
+/**
+ * Loads a resource if it isn't loaded already,
+ * without keeping it from being unloaded later.
+ * @param name Resource name.
+ * @return True if the cache has the resource.
+ */
+bool AssetCache::load(const std::string &name)
+{
+	std::map<std::string, Entry>::iterator i = _entries.find(name);
+	if (i == _entries.end())
+		return false;
+	load(i->second);
+	return true;
+}
+
+/**
+ * Loads a resource and keeps it loaded until it's released.
+ * @param name Resource name.
+ */
+void AssetCache::acquire(const std::string &name)
+{
+	std::map<std::string, Entry>::iterator i = _entries.find(name);
+	if (i != _entries.end())
+	{
+		load(i->second);
+		i->second.refs++;
+	}
+}
+
+/**
+ * Lets a resource be unloaded again once nothing else uses it.
+ * @param name Resource name.
+ */
+void AssetCache::release(const std::string &name)
+{
+	std::map<std::string, Entry>::iterator i = _entries.find(name);
+	if (i != _entries.end() && i->second.refs > 0)
+	{
+		i->second.refs--;
+		i->second.lastUse = ++_clock;
+	}
+	trim();
+}
+
+/**
+ * Loads all the resources in a group and keeps them loaded until they're released.
+ * @param group Group name.
+ */
+void AssetCache::acquireGroup(const std::string &group)
+{
+	for (std::map<std::string, Entry>::iterator i = _entries.begin(); i != _entries.end(); ++i)
+	{
+		if (i->second.group == group)
+		{
+			load(i->second);
+			i->second.refs++;
+		}
+	}
+}
+
+/**
+ * Lets all the resources in a group be unloaded again once nothing else uses them.
+ * @param group Group name.
+ */
+void AssetCache::releaseGroup(const std::string &group)
+{
+	for (std::map<std::string, Entry>::iterator i = _entries.begin(); i != _entries.end(); ++i)
+	{
+		if (i->second.group == group && i->second.refs > 0)
+		{
+			i->second.refs--;
+			i->second.lastUse = ++_clock;
+		}
+	}
+	trim();
+}
+
+/**
+ * Unloads the least recently used resources that aren't in use,
+ * until the loaded resources fit in the budget again.
+ */
+void AssetCache::trim()
+{
+	while (_residentSize > _budget)
+	{
+		std::map<std::string, Entry>::iterator oldest = _entries.end();
+		for (std::map<std::string, Entry>::iterator i = _entries.begin(); i != _entries.end(); ++i)
+		{
+			if (i->second.resident && i->second.refs == 0 && (oldest == _entries.end() || i->second.lastUse < oldest->second.lastUse))
+			{
+				oldest = i;
+			}
+		}
+		if (oldest == _entries.end())
+			break;
+		unload(oldest->second);
+		_evictions++;
+	}
+}
+
+/**
+ * Gets the memory budget for the loaded resources.
+ * @return Budget in bytes.
+ */
+size_t AssetCache::getBudget() const
+{
+	return _budget;
+}
+
+/**
+ * Changes the memory budget for the loaded resources,
+ * unloading any that don't fit anymore.
+ * @param budget Budget in bytes.
+ */
+void AssetCache::setBudget(size_t budget)
+{
+	_budget = budget;
+	trim();
+}
+
+/**
+ * Gets the total size of the resources currently loaded.
+ * @return Size in bytes.
+ */
+size_t AssetCache::getResidentSize() const
+{
+	return _residentSize;
+}
+
+/**
+ * Gets the number of resources currently loaded.
+ * @return Number of resources.
+ */
+int AssetCache::getResidentCount() const
+{
+	return _residentCount;
+}
+
+/**
+ * Gets the number of resources currently in use.
+ * @return Number of resources.
+ */
+int AssetCache::getPinnedCount() const
+{
+	int pinned = 0;
+	for (std::map<std::string, Entry>::const_iterator i = _entries.begin(); i != _entries.end(); ++i)
+	{
+		if (i->second.refs > 0)
+			pinned++;
+	}
+	return pinned;
+}
+
+/**
+ * Gets the number of times a resource was asked for and was already loaded.
+ * @return Number of hits.
+ */
+int AssetCache::getHits() const
+{
+	return _hits;
+}
+
+/**
+ * Gets the number of times a resource had to be loaded.
+ * @return Number of loads.
+ */
+int AssetCache::getLoads() const
+{
+	return _loads;
+}
+
+/**
+ * Gets the number of times an unused resource was unloaded to fit in the budget.
+ * @return Number of evictions.
+ */
+int AssetCache::getEvictions() const
+{
+	return _evictions;
+}
+
+/**
+ * Logs how many resources are loaded and how much memory they take.
+ */
+void AssetCache::logStats() const
+{
+	Log(LOG_INFO) << "Asset cache: " << _residentCount << "/" << _entries.size() << " loaded (" << getPinnedCount() << " in use), "
+		<< _residentSize / 1024 << "KB of " << _budget / 1024 << "KB, "
+		<< _hits << " hits, " << _loads << " loads, " << _evictions << " evictions";
+}
+
+/**
+ * Gets the memory taken by the pixels of a surface.
+ * @param surface Pointer to surface.
+ * @return Size in bytes.
+ */
+size_t AssetCache::getSize(Surface *surface)
+{
+	return surface->getSurface()->pitch * surface->getHeight();
+}
+
+/**
+ * Gets the memory taken by the pixels of all the frames in a surface set.
+ * @param set Pointer to surface set.
+ * @return Size in bytes.
+ */
+size_t AssetCache::getSize(SurfaceSet *set)
+{
+	size_t size = 0;
+	for (std::map<int, Surface*>::iterator i = set->getFrames()->begin(); i != set->getFrames()->end(); ++i)
+	{
+		size += getSize(i->second);
+	}
+	return size;
+}
+
+}
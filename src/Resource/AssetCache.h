@@ -0,0 +1,122 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_ASSETCACHE_H
+#define OPENXCOM_ASSETCACHE_H
+
+#include <map>
+#include <string>
+#include <SDL_types.h>
+
+namespace OpenXcom
+{
+
+class Surface;
+class SurfaceSet;
+
+/**
+ * Keeps track of resources that are only loaded when needed.
+ * Resources in use are pinned by reference counting. Once nothing
+ * uses them anymore they are kept around in case they're needed again,
+ * until the total size goes over the budget, at which point the least
+ * recently used ones are unloaded.
+ * Unloading only happens when a resource is released, so pointers
+ * to resources stay valid while they're being drawn.
+ */
+class AssetCache
+{
+public:
+	/// A resource that can be loaded and unloaded at will.
+	class Asset
+	{
+	public:
+		virtual ~Asset() {}
+		/// Loads the resource, returning its size in bytes.
+		virtual size_t load() = 0;
+		/// Frees the resource.
+		virtual void unload() = 0;
+	};
+private:
+	struct Entry
+	{
+		Asset *asset;
+		std::string group;
+		int refs;
+		bool resident;
+		size_t size;
+		Uint32 lastUse;
+	};
+	std::map<std::string, Entry> _entries;
+	size_t _budget, _residentSize;
+	int _residentCount;
+	Uint32 _clock;
+	int _hits, _loads, _evictions;
+	/// Makes sure an entry is loaded.
+	void load(Entry &entry);
+	/// Unloads an entry.
+	void unload(Entry &entry);
+public:
+	/// Creates an empty cache.
+	AssetCache(size_t budget);
+	/// Cleans up the cache.
+	~AssetCache();
+	/// Adds a resource to the cache.
+	void add(const std::string &name, Asset *asset, const std::string &group = "");
+	/// Removes a resource from the cache.
+	void remove(const std::string &name);
+	/// Checks if the cache has a resource.
+	bool has(const std::string &name) const;
+	/// Loads a resource if it isn't already.
+	bool load(const std::string &name);
+	/// Loads a resource and keeps it loaded.
+	void acquire(const std::string &name);
+	/// Lets a resource be unloaded again.
+	void release(const std::string &name);
+	/// Loads a group of resources and keeps them loaded.
+	void acquireGroup(const std::string &group);
+	/// Lets a group of resources be unloaded again.
+	void releaseGroup(const std::string &group);
+	/// Unloads unused resources until the cache fits its budget.
+	void trim();
+	/// Gets the memory budget.
+	size_t getBudget() const;
+	/// Sets the memory budget.
+	void setBudget(size_t budget);
+	/// Gets the size of the loaded resources.
+	size_t getResidentSize() const;
+	/// Gets the number of loaded resources.
+	int getResidentCount() const;
+	/// Gets the number of resources in use.
+	int getPinnedCount() const;
+	/// Gets the number of resources that were found already loaded.
+	int getHits() const;
+	/// Gets the number of times a resource was loaded.
+	int getLoads() const;
+	/// Gets the number of times a resource was unloaded to save memory.
+	int getEvictions() const;
+	/// Logs the cache statistics.
+	void logStats() const;
+	/// Gets the size of a surface.
+	static size_t getSize(Surface *surface);
+	/// Gets the size of a surface set.
+	static size_t getSize(SurfaceSet *set);
+};
+
+}
+
+#endif
@@ -16,7 +16,10 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
+#define _USE_MATH_DEFINES
 #include "ResourcePack.h"
+#include <cmath>
+#include <cstring>
 #include "../Engine/Palette.h"
 #include "../Engine/Font.h"
 #include "../Engine/Surface.h"
@@ -29,17 +32,47 @@
 #include "../Engine/Sound.h"
 #include "../Engine/RNG.h"
 #include "../Engine/Options.h"
+#include "../Ruleset/MapDataSet.h"
+#include "../Ruleset/MapData.h"
+#include "AssetCache.h"
 
 namespace OpenXcom
 {
 
+namespace
+{
+
+/**
+ * The objects and sprites of a terrain, loaded on demand.
+ */
+class TerrainAsset : public AssetCache::Asset
+{
+private:
+	MapDataSet *_terrain;
+public:
+	TerrainAsset(MapDataSet *terrain) : _terrain(terrain) {}
+	size_t load()
+	{
+		_terrain->loadData();
+		return AssetCache::getSize(_terrain->getSurfaceset()) + _terrain->getSize() * sizeof(MapData);
+	}
+	void unload()
+	{
+		_terrain->unloadData();
+	}
+};
+
+}
+
 /**
  * Initializes a blank resource set pointing to a folder.
  */
-ResourcePack::ResourcePack() : _palettes(), _fonts(), _surfaces(), _sets(), _sounds(), _polygons(), _polylines(), _musics()
+ResourcePack::ResourcePack() : _palettes(), _fonts(), _surfaces(), _sets(), _sounds(), _polygons(), _polygonsById(), _polygonGrid(), _polylines(), _musics()
 {
 	_muteMusic = new Music();
 	_muteSound = new Sound();
+	_cache = new AssetCache(Options::getInt("assetCacheSize") * 1024 * 1024);
+	memset(_colors, 0, sizeof(_colors));
 }
 
 /**
@@ -47,6 +80,8 @@ ResourcePack::ResourcePack() : _palettes(), _fonts(), _surfaces(), _sets(), _sou
  */
 ResourcePack::~ResourcePack()
 {
+	// cached resources take themselves out of the lists
+	delete _cache;
 	delete _muteMusic;
 	delete _muteSound;
 	for (std::map<std::string, Font*>::iterator i = _fonts.begin(); i != _fonts.end(); ++i)
@@ -96,23 +131,33 @@ Font *ResourcePack::getFont(const std::string &name) const
 
 /**
  * Returns a specific surface from the resource set.
+ * Cached surfaces are loaded if they aren't already.
  * @param name Name of the surface.
  * @return Pointer to the surface.
  */
 Surface *ResourcePack::getSurface(const std::string &name) const
 {
 	std::map<std::string, Surface*>::const_iterator i = _surfaces.find(name);
+	if (_surfaces.end() == i && _cache->load(name))
+	{
+		i = _surfaces.find(name);
+	}
 	if (_surfaces.end() != i) return i->second; else return 0;
 }
 
 /**
  * Returns a specific surface set from the resource set.
+ * Cached surface sets are loaded if they aren't already.
  * @param name Name of the surface set.
  * @return Pointer to the surface set.
  */
 SurfaceSet *ResourcePack::getSurfaceSet(const std::string &name) const
 {
 	std::map<std::string, SurfaceSet*>::const_iterator i = _sets.find(name);
+	if (_sets.end() == i && _cache->load(name))
+	{
+		i = _sets.find(name);
+	}
 	if (_sets.end() != i) return i->second; else return 0;
 }
 
@@ -125,6 +170,81 @@ std::list<Polygon*> *ResourcePack::getPolygons()
 	return &_polygons;
 }
 
+/**
+ * Sorts the world polygons into a grid by their bounds, so
+ * the globe only needs to check the ones near a point to find
+ * which contains it. The bounds are widened a bit since the globe
+ * checks polygons projected around the point, which can bulge out
+ * from their longitude/latitude box, especially near the poles.
+ * Must be called again if the list of polygons changes.
+ */
+void ResourcePack::indexPolygons()
+{
+	const double margin = M_PI / 36, polar = M_PI / 3;
+	_polygonsById.assign(_polygons.begin(), _polygons.end());
+	_polygonGrid.clear();
+	for (size_t i = 0; i < _polygonsById.size(); ++i)
+	{
+		double lonMin, lonMax, latMin, latMax;
+		_polygonsById[i]->getBounds(&lonMin, &lonMax, &latMin, &latMax);
+		bool allLon = (lonMin == 0 && lonMax == 2 * M_PI);
+		latMin -= margin;
+		latMax += margin;
+		if (latMax > polar)
+		{
+			latMax = M_PI_2;
+			allLon = true;
+		}
+		if (latMin < -polar)
+		{
+			latMin = -M_PI_2;
+			allLon = true;
+		}
+		if (allLon)
+		{
+			lonMin = 0;
+			lonMax = 2 * M_PI;
+		}
+		else
+		{
+			// degrees of longitude shrink away from the equator
+			lonMin -= margin * 2;
+			lonMax += margin * 2;
+			if (lonMin < 0)
+				lonMin += 2 * M_PI;
+			if (lonMax >= 2 * M_PI)
+				lonMax -= 2 * M_PI;
+		}
+		_polygonGrid.add(i, lonMin, lonMax, latMin, latMax);
+	}
+}
+
+/**
+ * Returns the world polygons that might contain a point,
+ * in the same order as the list of polygons.
+ * @param lon Longitude of the point.
+ * @param lat Latitude of the point.
+ * @return Pointer to the list of polygon indexes, or 0 if every polygon has to be checked.
+ */
+const std::vector<int> *ResourcePack::getPolygonsNear(double lon, double lat) const
+{
+	if (_polygonsById.size() != _polygons.size())
+	{
+		return 0;
+	}
+	return _polygonGrid.find(lon, lat);
+}
+
+/**
+ * Returns a world polygon by its place in the list of polygons.
+ * @param id Polygon index.
+ * @return Pointer to the polygon.
+ */
+Polygon *ResourcePack::getPolygon(int id) const
+{
+	return _polygonsById[id];
+}
+
 /**
  * Returns the list of polylines in the resource set.
  * @return Pointer to the list of polylines.
@@ -218,6 +338,8 @@ Palette *ResourcePack::getPalette(const std::string &name) const
  */
 void ResourcePack::setPalette(SDL_Color *colors, int firstcolor, int ncolors)
 {
+	// keep the colors for any resources loaded later
+	memcpy(_colors + firstcolor, colors, sizeof(SDL_Color) * ncolors);
 	for (std::map<std::string, Font*>::iterator i = _fonts.begin(); i != _fonts.end(); ++i)
 	{
 		i->second->getSurface()->setPalette(colors, firstcolor, ncolors);
@@ -242,4 +364,59 @@ std::vector<Uint16> *ResourcePack::getVoxelData()
 	return &_voxelData;
 }
 
+/**
+ * Returns the cache of resources that are only
+ * loaded when needed, to check on its memory usage.
+ * @return Pointer to the asset cache.
+ */
+AssetCache *ResourcePack::getAssetCache() const
+{
+	return _cache;
+}
+
+/**
+ * Loads the resources only used in battle
+ * and keeps them loaded until they're released.
+ */
+void ResourcePack::acquireBattlescapeResources()
+{
+	_cache->acquireGroup("battlescape");
+	_cache->logStats();
+}
+
+/**
+ * Lets the resources only used in battle be unloaded
+ * when the memory is needed.
+ */
+void ResourcePack::releaseBattlescapeResources()
+{
+	_cache->releaseGroup("battlescape");
+	_cache->logStats();
+}
+
+/**
+ * Loads the objects and sprites of a terrain
+ * and keeps them loaded until they're released.
+ * @param terrain Pointer to the terrain data.
+ */
+void ResourcePack::acquireTerrain(MapDataSet *terrain)
+{
+	std::string name = "TERRAIN/" + terrain->getName();
+	if (!_cache->has(name))
+	{
+		_cache->add(name, new TerrainAsset(terrain), "terrain");
+	}
+	_cache->acquire(name);
+}
+
+/**
+ * Lets the objects and sprites of a terrain be unloaded
+ * when the memory is needed.
+ * @param terrain Pointer to the terrain data.
+ */
+void ResourcePack::releaseTerrain(MapDataSet *terrain)
+{
+	_cache->release("TERRAIN/" + terrain->getName());
+}
+
 }
@@ -24,6 +24,7 @@
 #include <list>
 #include <vector>
 #include <SDL.h>
+#include "../Geoscape/GlobeGrid.h"
 
 namespace OpenXcom
 {
@@ -40,6 +41,8 @@ class Sound;
 class SavedBattleGame;
 class RuleTerrain;
 class MapBlock;
+class MapDataSet;
+class AssetCache;
 
 /**
  * Packs of external game media.
@@ -62,9 +65,13 @@ protected:
 	std::map<std::string, SurfaceSet*> _sets;
 	std::map<std::string, SoundSet*> _sounds;
 	std::list<Polygon*> _polygons;
+	std::vector<Polygon*> _polygonsById;
+	GlobeGrid _polygonGrid;
 	std::list<Polyline*> _polylines;
 	std::map<std::string, Music*> _musics;
 	std::vector<Uint16> _voxelData;
+	AssetCache *_cache;
+	SDL_Color _colors[256];
 public:
 	/// Create a new resource pack with a folder's contents.
 	ResourcePack();
@@ -78,6 +85,12 @@ public:
 	SurfaceSet *getSurfaceSet(const std::string &name) const;
 	/// Gets the list of world polygons.
 	std::list<Polygon*> *getPolygons();
+	/// Indexes the world polygons by location.
+	void indexPolygons();
+	/// Gets the world polygons that might contain a point.
+	const std::vector<int> *getPolygonsNear(double lon, double lat) const;
+	/// Gets a world polygon by its index.
+	Polygon *getPolygon(int id) const;
 	/// Gets the list of world polylines.
 	std::list<Polyline*> *getPolylines();
 	/// Gets a particular music.
@@ -92,6 +105,16 @@ public:
 	void setPalette(SDL_Color *colors, int firstcolor, int ncolors);
 	/// Gets list of voxel data.
 	std::vector<Uint16> *getVoxelData();
+	/// Gets the cache of resources loaded on demand.
+	AssetCache *getAssetCache() const;
+	/// Keeps the battlescape resources loaded.
+	void acquireBattlescapeResources();
+	/// Lets the battlescape resources be unloaded.
+	void releaseBattlescapeResources();
+	/// Keeps a terrain's data loaded.
+	void acquireTerrain(MapDataSet *terrain);
+	/// Lets a terrain's data be unloaded.
+	void releaseTerrain(MapDataSet *terrain);
 };
 
 }
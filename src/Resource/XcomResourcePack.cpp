@@ -29,6 +29,8 @@
 #include "../Engine/SoundSet.h"
 #include "../Engine/Sound.h"
 #include "../Engine/Options.h"
+#include "../Engine/LoadQueue.h"
+#include "AssetCache.h"
 #include "../Geoscape/Globe.h"
 #include "../Geoscape/Polygon.h"
 #include "../Geoscape/Polyline.h"
@@ -68,13 +70,238 @@ struct HairBleach
 	}
 };
 
+/**
+ * Decodes a palette.
+ */
+class PaletteJob : public LoadQueue::Job
+{
+	Palette *_palette;
+	std::string _file;
+	int _ncolors, _offset;
+public:
+	PaletteJob(Palette *palette, const std::string &file, int ncolors, int offset = 0) : _palette(palette), _file(file), _ncolors(ncolors), _offset(offset) {}
+	void run() { _palette->loadDat(_file, _ncolors, _offset); }
+};
+
+/**
+ * Decodes an image into a surface.
+ */
+class SurfaceJob : public LoadQueue::Job
+{
+public:
+	enum Format { FORMAT_SCR, FORMAT_SPK, FORMAT_IMAGE };
+private:
+	Surface *_surface;
+	std::string _file;
+	Format _format;
+public:
+	SurfaceJob(Surface *surface, const std::string &file, Format format) : _surface(surface), _file(file), _format(format) {}
+	void run()
+	{
+		switch (_format)
+		{
+		case FORMAT_SCR:
+			_surface->loadScr(_file);
+			break;
+		case FORMAT_SPK:
+			_surface->loadSpk(_file);
+			break;
+		case FORMAT_IMAGE:
+			_surface->loadImage(_file);
+			break;
+		}
+	}
+};
+
+/**
+ * Decodes a PCK/TAB or DAT image file into a surface set.
+ */
+class SurfaceSetJob : public LoadQueue::Job
+{
+	SurfaceSet *_set;
+	std::string _file, _tab;
+public:
+	SurfaceSetJob(SurfaceSet *set, const std::string &file, const std::string &tab) : _set(set), _file(file), _tab(tab) {}
+	void run()
+	{
+		if (_tab.empty())
+		{
+			_set->loadDat(_file);
+		}
+		else
+		{
+			_set->loadPck(_file, _tab);
+		}
+	}
+};
+
+/**
+ * Loads the globe polygons.
+ */
+class PolygonJob : public LoadQueue::Job
+{
+	std::string _file;
+	std::list<Polygon*> *_polygons;
+public:
+	PolygonJob(const std::string &file, std::list<Polygon*> *polygons) : _file(file), _polygons(polygons) {}
+	void run() { Globe::loadDat(_file, _polygons); }
+};
+
+/**
+ * Loads the voxel data of the battlescape objects.
+ */
+class VoxelJob : public LoadQueue::Job
+{
+	std::string _file;
+	std::vector<Uint16> *_voxelData;
+public:
+	VoxelJob(const std::string &file, std::vector<Uint16> *voxelData) : _file(file), _voxelData(voxelData) {}
+	void run() { MapDataSet::loadLOFTEMPS(_file, _voxelData); }
+};
+
+/**
+ * The voxel data of the battlescape objects, loaded on demand.
+ */
+class VoxelAsset : public AssetCache::Asset
+{
+	std::string _file;
+	std::vector<Uint16> *_voxelData;
+public:
+	VoxelAsset(const std::string &file, std::vector<Uint16> *voxelData) : _file(file), _voxelData(voxelData) {}
+	size_t load()
+	{
+		MapDataSet::loadLOFTEMPS(_file, _voxelData);
+		return _voxelData->size() * sizeof(Uint16);
+	}
+	void unload()
+	{
+		_voxelData->clear();
+	}
+};
+
 }
-	
+
 /**
- * Initializes the resource pack by loading all the resources
- * contained in the original game folder.
+ * Runs one of the resource pack's own loading steps.
  */
-XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprites *> > extraSprites, std::vector<std::pair<std::string, ExtraSounds *> > extraSounds) : ResourcePack()
+class XcomResourcePack::PackJob : public LoadQueue::Job
+{
+	XcomResourcePack *_pack;
+	void (XcomResourcePack::*_step)();
+public:
+	PackJob(XcomResourcePack *pack, void (XcomResourcePack::*step)()) : _pack(pack), _step(step) {}
+	void run() { (_pack->*_step)(); }
+};
+
+/**
+ * A surface set of the original game, loaded on demand.
+ */
+class XcomResourcePack::SetAsset : public AssetCache::Asset
+{
+	XcomResourcePack *_pack;
+	std::string _name, _file, _tab;
+	int _width, _height;
+public:
+	SetAsset(XcomResourcePack *pack, const std::string &name, const std::string &file, const std::string &tab, int width, int height) : _pack(pack), _name(name), _file(file), _tab(tab), _width(width), _height(height) {}
+	size_t load()
+	{
+		SurfaceSet *set = new SurfaceSet(_width, _height);
+		try
+		{
+			SurfaceSetJob(set, _file, _tab).run();
+		}
+		catch (Exception &)
+		{
+			delete set;
+			throw;
+		}
+		_pack->_sets[_name] = set;
+		_pack->patchSet(_name);
+		set->setPalette(_pack->_colors);
+		return AssetCache::getSize(set);
+	}
+	void unload()
+	{
+		delete _pack->_sets[_name];
+		_pack->_sets.erase(_name);
+	}
+};
+
+/**
+ * A copy of another surface set, made on demand.
+ */
+class XcomResourcePack::CopyAsset : public AssetCache::Asset
+{
+	XcomResourcePack *_pack;
+	std::string _name, _original;
+public:
+	CopyAsset(XcomResourcePack *pack, const std::string &name, const std::string &original) : _pack(pack), _name(name), _original(original) {}
+	size_t load()
+	{
+		// copy constructor doesn't like doing this directly, so let's make a copy the old fashioned way.
+		SurfaceSet *original = _pack->getSurfaceSet(_original);
+		SurfaceSet *set = new SurfaceSet(original->getWidth(), original->getHeight());
+		std::map<int, Surface*> *frames = original->getFrames();
+		for (std::map<int, Surface*>::const_iterator i = frames->begin(); i != frames->end(); ++i)
+		{
+			(i->second)->blit(set->addFrame(i->first));
+		}
+		_pack->_sets[_name] = set;
+		set->setPalette(_pack->_colors);
+		return AssetCache::getSize(set);
+	}
+	void unload()
+	{
+		delete _pack->_sets[_name];
+		_pack->_sets.erase(_name);
+	}
+};
+
+/**
+ * A surface of the original game, loaded on demand.
+ */
+class XcomResourcePack::SurfaceAsset : public AssetCache::Asset
+{
+	XcomResourcePack *_pack;
+	std::string _name, _file;
+	SurfaceJob::Format _format;
+public:
+	SurfaceAsset(XcomResourcePack *pack, const std::string &name, const std::string &file, SurfaceJob::Format format) : _pack(pack), _name(name), _file(file), _format(format) {}
+	size_t load()
+	{
+		Surface *surface = new Surface(320, 200);
+		try
+		{
+			SurfaceJob(surface, _file, _format).run();
+		}
+		catch (Exception &)
+		{
+			delete surface;
+			throw;
+		}
+		_pack->_surfaces[_name] = surface;
+		surface->setPalette(_pack->_colors);
+		return AssetCache::getSize(surface);
+	}
+	void unload()
+	{
+		delete _pack->_surfaces[_name];
+		_pack->_surfaces.erase(_name);
+	}
+};
+
+/**
+ * Initializes the resource pack and queues up the loading of all the resources
+ * contained in the original game folder. The files are decoded by the queue's
+ * worker threads, except music, sounds and other images, which are left to
+ * the main thread. Once the queue is finished, finishLoading() needs to be called
+ * to put everything together. The battlescape resources are left for the
+ * asset cache to load once a battle needs them.
+ * @param extraSprites Extra sprites from the rulesets.
+ * @param extraSounds Extra sounds from the rulesets.
+ * @param queue Queue to add the loading jobs to.
+ */
+XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprites *> > extraSprites, std::vector<std::pair<std::string, ExtraSounds *> > extraSounds, LoadQueue *queue) : ResourcePack(), _extraSprites(extraSprites), _extraSounds(extraSounds)
 {
 	// Load palettes
 	for (int i = 0; i < 5; ++i)
@@ -83,14 +310,14 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 		s1 << "GEODATA/PALETTES.DAT";
 		s2 << "PALETTES.DAT_" << i;
 		_palettes[s2.str()] = new Palette();
-		_palettes[s2.str()]->loadDat(CrossPlatform::getDataFile(s1.str()), 256, Palette::palOffset(i));
+		queue->add(new PaletteJob(_palettes[s2.str()], CrossPlatform::getDataFile(s1.str()), 256, Palette::palOffset(i)), "palettes");
 	}
 
 	std::stringstream s1, s2;
 	s1 << "GEODATA/BACKPALS.DAT";
 	s2 << "BACKPALS.DAT";
 	_palettes[s2.str()] = new Palette();
-	_palettes[s2.str()]->loadDat(CrossPlatform::getDataFile(s1.str()), 128);
+	queue->add(new PaletteJob(_palettes[s2.str()], CrossPlatform::getDataFile(s1.str()), 128), "palettes");
 
 	// Load fonts
 	Font::loadIndex(CrossPlatform::getDataFile("Language/Font.dat"));
@@ -106,8 +333,7 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 			_fonts[font[i]] = new Font(16, 16, 0);
 		else if (font[i] == "Small.fnt")
 			_fonts[font[i]] = new Font(8, 9, -1);
-		_fonts[font[i]]->getSurface()->loadScr(CrossPlatform::getDataFile(s.str()));
-		_fonts[font[i]]->load();
+		queue->add(new SurfaceJob(_fonts[font[i]]->getSurface(), CrossPlatform::getDataFile(s.str()), SurfaceJob::FORMAT_SCR), "fonts");
 	}
 
 	// Load surfaces
@@ -115,7 +341,7 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 		std::stringstream s;
 		s << "GEODATA/" << "INTERWIN.DAT";
 		_surfaces["INTERWIN.DAT"] = new Surface(160, 556);
-		_surfaces["INTERWIN.DAT"]->loadScr(CrossPlatform::getDataFile(s.str()));
+		queue->add(new SurfaceJob(_surfaces["INTERWIN.DAT"], CrossPlatform::getDataFile(s.str()), SurfaceJob::FORMAT_SCR), "surfaces");
 	}
 
 	std::string scrs[] = {"BACK01.SCR",
@@ -142,22 +368,12 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 	{
 		std::stringstream s;
 		s << "GEOGRAPH/" << scrs[i];
-		_surfaces[scrs[i]] = new Surface(320, 200);
-		_surfaces[scrs[i]]->loadScr(CrossPlatform::getDataFile(s.str()));
+		addBattlescapeSurface(scrs[i], CrossPlatform::getDataFile(s.str()), SurfaceJob::FORMAT_SCR);
 	}
 
 	// here we create an "alternate" background surface for the base info screen.
 	_surfaces["ALTBACK07.SCR"] = new Surface(320, 200);
-	_surfaces["ALTBACK07.SCR"]->loadScr(CrossPlatform::getDataFile("GEOGRAPH/BACK07.SCR"));
-	for (int y = 172; y >= 152; --y)
-		for (int x = 5; x <= 314; ++x)
-			_surfaces["ALTBACK07.SCR"]->setPixel(x, y+4, _surfaces["ALTBACK07.SCR"]->getPixel(x,y));
-	for (int y = 147; y >= 134; --y)
-		for (int x = 5; x <= 314; ++x)
-			_surfaces["ALTBACK07.SCR"]->setPixel(x, y+9, _surfaces["ALTBACK07.SCR"]->getPixel(x,y));
-	for (int y = 132; y >= 109; --y)
-		for (int x = 5; x <= 314; ++x)
-			_surfaces["ALTBACK07.SCR"]->setPixel(x, y+10, _surfaces["ALTBACK07.SCR"]->getPixel(x,y));
+	queue->add(new SurfaceJob(_surfaces["ALTBACK07.SCR"], CrossPlatform::getDataFile("GEOGRAPH/BACK07.SCR"), SurfaceJob::FORMAT_SCR), "surfaces");
 
 
 	std::string spks[] = {"UP001.SPK",
@@ -208,10 +424,10 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 	{
 		std::stringstream s;
 		s << "GEOGRAPH/" << spks[i];
-		_surfaces[spks[i]] = new Surface(320, 200);
-		_surfaces[spks[i]]->loadSpk(CrossPlatform::getDataFile(s.str()));
+		addBattlescapeSurface(spks[i], CrossPlatform::getDataFile(s.str()), SurfaceJob::FORMAT_SPK);
 	}
 	
+	// SDL_image isn't guaranteed to be reentrant, so these stay on the main thread
 	std::string lbms[] = {"PICT1.LBM",
 						  "PICT2.LBM",
 						  "PICT3.LBM",
@@ -225,7 +441,7 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 		std::stringstream s;
 		s << "UFOINTRO/" << lbms[i];
 		_surfaces[lbms[i]] = new Surface(320, 200);
-		_surfaces[lbms[i]]->loadImage(CrossPlatform::getDataFile(s.str()));
+		queue->add(new SurfaceJob(_surfaces[lbms[i]], CrossPlatform::getDataFile(s.str()), SurfaceJob::FORMAT_IMAGE), "images", true);
 	}
 	// Load surface sets
 	std::string sets[] = {"BASEBITS.PCK",
@@ -244,22 +460,22 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 			std::stringstream s2;
 			s2 << "GEOGRAPH/" << tab;
 			_sets[sets[i]] = new SurfaceSet(32, 40);
-			_sets[sets[i]]->loadPck(CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
+			queue->add(new SurfaceSetJob(_sets[sets[i]], CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str())), "surface sets");
 		}
 		else
 		{
 			_sets[sets[i]] = new SurfaceSet(32, 32);
-			_sets[sets[i]]->loadDat(CrossPlatform::getDataFile(s.str()));
+			queue->add(new SurfaceSetJob(_sets[sets[i]], CrossPlatform::getDataFile(s.str()), ""), "surface sets");
 		}
 	}
 	_sets["SCANG.DAT"] = new SurfaceSet(4, 4);
 	std::stringstream scang;
 	scang << "GEODATA/" << "SCANG.DAT";
-	_sets["SCANG.DAT"]->loadDat (CrossPlatform::getDataFile(scang.str()));
+	queue->add(new SurfaceSetJob(_sets["SCANG.DAT"], CrossPlatform::getDataFile(scang.str()), ""), "surface sets");
 	// Load polygons
 	std::stringstream s;
 	s << "GEODATA/" << "WORLD.DAT";
-	Globe::loadDat(CrossPlatform::getDataFile(s.str()), &_polygons);
+	queue->add(new PolygonJob(CrossPlatform::getDataFile(s.str()), &_polygons), "globe");
 
 	// Load polylines (extracted from game)
 	// -10 = Start of line
@@ -329,412 +545,363 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 
 	if (!Options::getBool("mute"))
 	{
-		// Load musics
-		std::string mus[] = {"GMDEFEND",
-							 "GMENBASE",
-							 "GMGEO1",
-							 "GMGEO2",
-							 "GMGEO3",
-							 "GMGEO4",
-							 "GMINTER",
-							 "GMINTRO1",
-							 "GMINTRO2",
-							 "GMINTRO3",
-							 "GMLOSE",
-							 "GMMARS",
-							 "GMNEWMAR",
-							 "GMSTORY",
-							 "GMTACTIC",
-							 "GMTACTIC2",
-							 "GMWIN"};
-		std::string exts[] = {"flac", "ogg", "mp3", "mod"};
-		int tracks[] = {3, 6, 0, 18, -1, -1, 2, 19, 20, 21, 10, 9, 8, 12, 17, -1, 11};
-
-		// Check which music version is available
-		bool cat = true;
-		GMCatFile *gmcat = 0;
-
-		std::string musDos = "SOUND/GM.CAT";
-		if (CrossPlatform::fileExists(CrossPlatform::getDataFile(musDos)))
-		{
-			cat = true;
-			gmcat = new GMCatFile(CrossPlatform::getDataFile(musDos).c_str());
-		}
-		else
+		queue->add(new PackJob(this, &XcomResourcePack::loadMusic), "music", true);
+		queue->add(new PackJob(this, &XcomResourcePack::loadSounds), "sounds", true);
+	}
+
+	loadBattlescapeResources();
+}
+
+/**
+ * Loads all the music tracks, whichever version is available.
+ * Music goes through SDL_mixer, so this has to run on the main thread.
+ */
+void XcomResourcePack::loadMusic()
+{
+	// Load musics
+	std::string mus[] = {"GMDEFEND",
+						 "GMENBASE",
+						 "GMGEO1",
+						 "GMGEO2",
+						 "GMGEO3",
+						 "GMGEO4",
+						 "GMINTER",
+						 "GMINTRO1",
+						 "GMINTRO2",
+						 "GMINTRO3",
+						 "GMLOSE",
+						 "GMMARS",
+						 "GMNEWMAR",
+						 "GMSTORY",
+						 "GMTACTIC",
+						 "GMTACTIC2",
+						 "GMWIN"};
+	std::string exts[] = {"flac", "ogg", "mp3", "mod"};
+	int tracks[] = {3, 6, 0, 18, -1, -1, 2, 19, 20, 21, 10, 9, 8, 12, 17, -1, 11};
+
+	// Check which music version is available
+	bool cat = true;
+	GMCatFile *gmcat = 0;
+
+	std::string musDos = "SOUND/GM.CAT";
+	if (CrossPlatform::fileExists(CrossPlatform::getDataFile(musDos)))
+	{
+		cat = true;
+		gmcat = new GMCatFile(CrossPlatform::getDataFile(musDos).c_str());
+	}
+	else
+	{
+		cat = false;
+	}
+
+	for (int i = 0; i < 17; ++i)
+	{
+		bool loaded = false;
+		// Try digital tracks
+		for (int j = 0; j < 3; ++j)
 		{
-			cat = false;
+			std::stringstream s;
+			s << "SOUND/" << mus[i] << "." << exts[j];
+			if (CrossPlatform::fileExists(CrossPlatform::getDataFile(s.str())))
+			{
+				_musics[mus[i]] = new Music();
+				_musics[mus[i]]->load(CrossPlatform::getDataFile(s.str()));
+				loaded = true;
+				break;
+			}
 		}
-
-		for (int i = 0; i < 17; ++i)
+		if (!loaded)
 		{
-			bool loaded = false;
-			// Try digital tracks
-			for (int j = 0; j < 3; ++j)
+			// Try Adlib music
+			if (cat && tracks[i] != -1)
+			{
+				_musics[mus[i]] = gmcat->loadMIDI(tracks[i]);
+				loaded = true;
+			}
+			// Try MIDI music
+			else
 			{
 				std::stringstream s;
-				s << "SOUND/" << mus[i] << "." << exts[j];
+				s << "SOUND/" << mus[i] << ".mid";
 				if (CrossPlatform::fileExists(CrossPlatform::getDataFile(s.str())))
 				{
 					_musics[mus[i]] = new Music();
 					_musics[mus[i]]->load(CrossPlatform::getDataFile(s.str()));
 					loaded = true;
-					break;
 				}
 			}
-			if (!loaded)
-			{
-				// Try Adlib music
-				if (cat && tracks[i] != -1)
-				{
-					_musics[mus[i]] = gmcat->loadMIDI(tracks[i]);
-					loaded = true;
-				}
-				// Try MIDI music
-				else
-				{
-					std::stringstream s;
-					s << "SOUND/" << mus[i] << ".mid";
-					if (CrossPlatform::fileExists(CrossPlatform::getDataFile(s.str())))
-					{
-						_musics[mus[i]] = new Music();
-						_musics[mus[i]]->load(CrossPlatform::getDataFile(s.str()));
-						loaded = true;
-					}
-				}
-			}
-			if (!loaded && tracks[i] != -1)
-			{
-				throw Exception(mus[i] + " not found");
-			}
 		}
-		delete gmcat;
+		if (!loaded && tracks[i] != -1)
+		{
+			throw Exception(mus[i] + " not found");
+		}
+	}
+	delete gmcat;
+}
 
-		// Load sounds
-		std::string catsId[] = {"GEO.CAT",
-								"BATTLE.CAT"};
-		std::string catsDos[] = {"SOUND2.CAT",
-								"SOUND1.CAT"};
-		std::string catsWin[] = {"SAMPLE.CAT",
-								"SAMPLE2.CAT"};
+/**
+ * Loads all the sound sets, whichever version is available.
+ * Sounds go through SDL_mixer, so this has to run on the main thread.
+ */
+void XcomResourcePack::loadSounds()
+{
+	// Load sounds
+	std::string catsId[] = {"GEO.CAT",
+							"BATTLE.CAT"};
+	std::string catsDos[] = {"SOUND2.CAT",
+							"SOUND1.CAT"};
+	std::string catsWin[] = {"SAMPLE.CAT",
+							"SAMPLE2.CAT"};
 
-		// Check which sound version is available
-		std::string *cats = 0;
-		bool wav = true;
+	// Check which sound version is available
+	std::string *cats = 0;
+	bool wav = true;
 
-		std::stringstream win, dos;
-		win << "SOUND/" << catsWin[0];
-		dos << "SOUND/" << catsDos[0];
-		if (CrossPlatform::fileExists(CrossPlatform::getDataFile(win.str())))
-		{
-			cats = catsWin;
-			wav = true;
-		}
-		else if (CrossPlatform::fileExists(CrossPlatform::getDataFile(dos.str())))
-		{
-			cats = catsDos;
-			wav = false;
-		}
+	std::stringstream win, dos;
+	win << "SOUND/" << catsWin[0];
+	dos << "SOUND/" << catsDos[0];
+	if (CrossPlatform::fileExists(CrossPlatform::getDataFile(win.str())))
+	{
+		cats = catsWin;
+		wav = true;
+	}
+	else if (CrossPlatform::fileExists(CrossPlatform::getDataFile(dos.str())))
+	{
+		cats = catsDos;
+		wav = false;
+	}
 
-		for (int i = 0; i < 2; ++i)
+	for (int i = 0; i < 2; ++i)
+	{
+		if (cats == 0)
 		{
-			if (cats == 0)
-			{
-				std::stringstream ss;
-				ss << catsDos[i] << " not found";
-				throw Exception(ss.str());
-			}
-			else
-			{
-				std::stringstream s;
-				s << "SOUND/" << cats[i];
-				_sounds[catsId[i]] = new SoundSet();
-				_sounds[catsId[i]]->loadCat(CrossPlatform::getDataFile(s.str()), wav);
-			}
+			std::stringstream ss;
+			ss << catsDos[i] << " not found";
+			throw Exception(ss.str());
 		}
-		
-		if (CrossPlatform::fileExists(CrossPlatform::getDataFile("SOUND/INTRO.CAT")))
-		{
-			SoundSet *s = _sounds["INTRO.CAT"] = new SoundSet();
-			s->loadCat(CrossPlatform::getDataFile("SOUND/INTRO.CAT"), false);
-		} else
+		else
 		{
-			Log(LOG_WARNING) << "INTRO.CAT is missing! :(";
+			std::stringstream s;
+			s << "SOUND/" << cats[i];
+			_sounds[catsId[i]] = new SoundSet();
+			_sounds[catsId[i]]->loadCat(CrossPlatform::getDataFile(s.str()), wav);
 		}
+	}
+	
+	if (CrossPlatform::fileExists(CrossPlatform::getDataFile("SOUND/INTRO.CAT")))
+	{
+		SoundSet *s = _sounds["INTRO.CAT"] = new SoundSet();
+		s->loadCat(CrossPlatform::getDataFile("SOUND/INTRO.CAT"), false);
+	} else
+	{
+		Log(LOG_WARNING) << "INTRO.CAT is missing! :(";
+	}
 
-		if (CrossPlatform::fileExists(CrossPlatform::getDataFile("SOUND/SAMPLE3.CAT")))
-		{
-			SoundSet *s = _sounds["SAMPLE3.CAT"] = new SoundSet();
-			wav = true;
-			s->loadCat(CrossPlatform::getDataFile("SOUND/SAMPLE3.CAT"), true);
-		} else
-		{
-			Log(LOG_WARNING) << "SAMPLE3.CAT is missing! :(";
-		}
-		
+	if (CrossPlatform::fileExists(CrossPlatform::getDataFile("SOUND/SAMPLE3.CAT")))
+	{
+		SoundSet *s = _sounds["SAMPLE3.CAT"] = new SoundSet();
+		wav = true;
+		s->loadCat(CrossPlatform::getDataFile("SOUND/SAMPLE3.CAT"), true);
+	} else
+	{
+		Log(LOG_WARNING) << "SAMPLE3.CAT is missing! :(";
 	}
+	
+}
+
+/**
+ * Puts together everything that depends on more than one loaded
+ * resource, and adds the extra resources from the rulesets on top.
+ * Must be called on the main thread once the loading queue is finished.
+ */
+void XcomResourcePack::finishLoading()
+{
+	for (std::map<std::string, Font*>::iterator i = _fonts.begin(); i != _fonts.end(); ++i)
+	{
+		i->second->load();
+	}
+
+	for (int y = 172; y >= 152; --y)
+		for (int x = 5; x <= 314; ++x)
+			_surfaces["ALTBACK07.SCR"]->setPixel(x, y+4, _surfaces["ALTBACK07.SCR"]->getPixel(x,y));
+	for (int y = 147; y >= 134; --y)
+		for (int x = 5; x <= 314; ++x)
+			_surfaces["ALTBACK07.SCR"]->setPixel(x, y+9, _surfaces["ALTBACK07.SCR"]->getPixel(x,y));
+	for (int y = 132; y >= 109; --y)
+		for (int x = 5; x <= 314; ++x)
+			_surfaces["ALTBACK07.SCR"]->setPixel(x, y+10, _surfaces["ALTBACK07.SCR"]->getPixel(x,y));
 
 	TextButton::soundPress = getSound("GEO.CAT", 0);
 	Window::soundPopup[0] = getSound("GEO.CAT", 1);
 	Window::soundPopup[1] = getSound("GEO.CAT", 2);
 	Window::soundPopup[2] = getSound("GEO.CAT", 3);
 
-	loadBattlescapeResources(); // TODO load this at battlescape start, unload at battlescape end?
-	
-	//"fix" of hair color of male personal armor
-	SurfaceSet *xcom_1 = _sets["XCOM_1.PCK"];
-	
-	for(int i=0; i< 16; ++i )
-	{
-		//cheast frame
-		Surface *surf = xcom_1->getFrame(4*8 + i);
-		ShaderMove<Uint8> head = ShaderMove<Uint8>(surf);
-		GraphSubset dim = head.getBaseDomain();
-		surf->lock();
-		dim.beg_y = 6;
-		dim.end_y = 9;
-		head.setDomain(dim);
-		ShaderDraw<HairBleach>(head, ShaderScalar<Uint8>(HairBleach::Face+5));
-		dim.beg_y = 9;
-		dim.end_y = 10;
-		head.setDomain(dim);
-		ShaderDraw<HairBleach>(head, ShaderScalar<Uint8>(HairBleach::Face+6));
-		surf->unlock();
-	}
-	
-	for(int i=0; i< 3; ++i )
-	{
-		//fall frame
-		Surface *surf = xcom_1->getFrame(264 + i);
-		ShaderMove<Uint8> head = ShaderMove<Uint8>(surf);
-		GraphSubset dim = head.getBaseDomain();
-		dim.beg_y = 0;
-		dim.end_y = 24;
-		dim.beg_x = 11;
-		dim.end_x = 20;
-		head.setDomain(dim);
-		surf->lock();
-		ShaderDraw<HairBleach>(head, ShaderScalar<Uint8>(HairBleach::Face+6));
-		surf->unlock();
-	}
-	
+	indexPolygons();
+
 	Log(LOG_INFO) << "Loading extra resources from ruleset...";
 	bool debugOutput = Options::getBool("debug");
+	std::stringstream s;
 	
-	for (std::vector<std::pair<std::string, ExtraSprites *> >::const_iterator i = extraSprites.begin(); i != extraSprites.end(); ++i)
+	for (std::vector<std::pair<std::string, ExtraSprites *> >::const_iterator i = _extraSprites.begin(); i != _extraSprites.end(); ++i)
 	{
-		std::string sheetName = i->first;
-		ExtraSprites *spritePack = i->second;
-		bool subdivision = (spritePack->getSubX() != 0 && spritePack->getSubY() != 0);
-		if (spritePack->getSingleImage())
+		if (_cache->has(i->first))
 		{
-			if (_surfaces.find(sheetName) == _surfaces.end())
-			{
-				if (debugOutput)
-				{
-					Log(LOG_INFO) << "Creating new single image: " << sheetName;
-				}
-				_surfaces[sheetName] = new Surface(spritePack->getWidth(), spritePack->getHeight());
-			}
-			else
+			// cached sets get their extra sprites whenever they're loaded,
+			// cached images are just replaced
+			if (!i->second->getSingleImage())
+				continue;
+			_cache->remove(i->first);
+		}
+		loadExtraSprites(i->first, i->second);
+	}
+
+	for (std::vector<std::pair<std::string, ExtraSounds *> >::const_iterator i = _extraSounds.begin(); i != _extraSounds.end(); ++i)
+	{
+		std::string setName = i->first;
+		ExtraSounds *soundPack = i->second;
+		if (_sounds.find(setName) == _sounds.end())
+		{
+			if (debugOutput)
 			{
-				if (debugOutput)
-				{
-					Log(LOG_INFO) << "Adding/Replacing single image: " << sheetName;
-				}
-				delete _surfaces[sheetName];
-				_surfaces[sheetName] = new Surface(spritePack->getWidth(), spritePack->getHeight());
+				Log(LOG_INFO) << "Creating new sound set: " << setName << ", this will likely have no in-game use.";
 			}
-			s.str("");
-			s << CrossPlatform::getDataFile(spritePack->getSprites()->operator[](0));
-			_surfaces[sheetName]->loadImage(s.str());
+			_sounds[setName] = new SoundSet();
 		}
-		else
+		else if (debugOutput)
+		{
+			Log(LOG_INFO) << "Adding/Replacing items in sound set: " << setName;
+		}
+		for (std::map<int, std::string>::iterator j = soundPack->getSounds()->begin(); j != soundPack->getSounds()->end(); ++j)
 		{
-			bool adding = false;
-			if (_sets.find(sheetName) == _sets.end())
+			int startSound = j->first;
+			std::string fileName = j->second;
+			s.str("");
+			if (fileName.substr(fileName.length() - 1, 1) == "/")
 			{
 				if (debugOutput)
 				{
-					Log(LOG_INFO) << "Creating new surface set: " << sheetName;
+					Log(LOG_INFO) << "Loading sound set from folder: " << fileName << " starting at index: " << startSound;
 				}
-				adding = true;
-				 if (subdivision)
-				 {
-					_sets[sheetName] = new SurfaceSet(spritePack->getSubX(), spritePack->getSubY());
-				 }
-				 else
-				 {
-					_sets[sheetName] = new SurfaceSet(spritePack->getWidth(), spritePack->getHeight());
-				 }
-			}
-			else if (debugOutput)
-			{
-				Log(LOG_INFO) << "Adding/Replacing items in surface set: " << sheetName;
-			}
-			
-			if (subdivision && debugOutput)
-			{
-				int frames = (spritePack->getWidth() / spritePack->getSubX())*(spritePack->getHeight() / spritePack->getSubY());
-				Log(LOG_INFO) << "Subdividing into " << frames << " frames.";
-			}
-
-			for (std::map<int, std::string>::iterator j = spritePack->getSprites()->begin(); j != spritePack->getSprites()->end(); ++j)
-			{
-				int startFrame = j->first;
-				std:: string fileName = j->second;
-				s.str("");
-				if (fileName.substr(fileName.length() - 1, 1) == "/")
+				int offset = startSound;
+				std::stringstream folder;
+				folder << CrossPlatform::getDataFolder(fileName);
+				std::vector<std::string> contents = CrossPlatform::getFolderContents(folder.str());
+				for (std::vector<std::string>::iterator k = contents.begin();
+					k != contents.end(); ++k)
 				{
-					if (debugOutput)
+					s.str("");
+					s << folder.str() << CrossPlatform::getDataFile(*k);
+					if (_sounds[setName]->getSound(offset))
 					{
-						Log(LOG_INFO) << "Loading surface set from folder: " << fileName << " starting at frame: " << startFrame;
+						_sounds[setName]->getSound(offset)->load(s.str());
 					}
-					int offset = startFrame;
-					std::stringstream folder;
-					folder << CrossPlatform::getDataFolder(fileName);
-					std::vector<std::string> contents = CrossPlatform::getFolderContents(folder.str());
-					for (std::vector<std::string>::iterator k = contents.begin();
-						k != contents.end(); ++k)
+					else
 					{
-						s.str("");
-						s << folder.str() << CrossPlatform::getDataFile(*k);
-						if (_sets[sheetName]->getFrame(offset))
-						{
-							if (debugOutput)
-							{
-								Log(LOG_INFO) << "Replacing frame: " << offset;
-							}
-							_sets[sheetName]->getFrame(offset)->loadImage(s.str());
-						}
-						else
-						{
-							if (adding)
-							{
-								_sets[sheetName]->addFrame(offset)->loadImage(s.str());
-							}
-							else
-							{
-								if (debugOutput)
-								{
-									Log(LOG_INFO) << "Adding frame: " << offset + spritePack->getModIndex();
-								}
-								_sets[sheetName]->addFrame(offset + spritePack->getModIndex())->loadImage(s.str());
-							}
-						}
-						offset++;
+						_sounds[setName]->addSound(offset + soundPack->getModIndex())->load(s.str());
 					}
+					offset++;
 				}
-				else
+			}
+			else
+			{
+				s << CrossPlatform::getDataFile(fileName);
+				if (_sounds[setName]->getSound(startSound))
 				{
-					if (spritePack->getSubX() == 0 && spritePack->getSubY() == 0)
+					if (debugOutput)
 					{
-						s << CrossPlatform::getDataFile(fileName);
-						if (_sets[sheetName]->getFrame(startFrame))
-						{
-							if (debugOutput)
-							{
-								Log(LOG_INFO) << "Replacing frame: " << startFrame;
-							}
-							_sets[sheetName]->getFrame(startFrame)->loadImage(s.str());
-						}
-						else
-						{
-							if (debugOutput)
-							{
-								Log(LOG_INFO) << "Adding frame: " << startFrame << ", using index: " << startFrame + spritePack->getModIndex();
-							}
-							_sets[sheetName]->addFrame(startFrame + spritePack->getModIndex())->loadImage(s.str());
-						}
+						Log(LOG_INFO) << "Replacing index: " << startSound;
 					}
-					else
+					_sounds[setName]->getSound(startSound)->load(s.str());
+				}
+				else
+				{
+					if (debugOutput)
 					{
-						_surfaces["tempSurface"] = new Surface(spritePack->getWidth(), spritePack->getHeight());
-						s.str("");
-						s << CrossPlatform::getDataFile(spritePack->getSprites()->operator[](startFrame));
-						_surfaces["tempSurface"]->loadImage(s.str());
-						int xDivision = spritePack->getWidth() / spritePack->getSubX();
-						int yDivision = spritePack->getHeight() / spritePack->getSubY();
-						int offset = startFrame;
-
-						for (int y = 0; y != yDivision; ++y)
-						{
-							for (int x = 0; x != xDivision; ++x)
-							{
-								if (_sets[sheetName]->getFrame(offset))
-								{
-									if (debugOutput)
-									{
-										Log(LOG_INFO) << "Replacing frame: " << offset;
-									}
-									_sets[sheetName]->getFrame(offset)->clear();
-									// for some reason regular blit() doesn't work here how i want it, so i use this function instead.
-									_surfaces["tempSurface"]->blitNShade(_sets[sheetName]->getFrame(offset), 0 - (x * spritePack->getSubX()), 0 - (y * spritePack->getSubY()), 0);
-								}
-								else
-								{
-									if (adding)
-									{
-										// for some reason regular blit() doesn't work here how i want it, so i use this function instead.
-										_surfaces["tempSurface"]->blitNShade(_sets[sheetName]->addFrame(offset), 0 - (x * spritePack->getSubX()), 0 - (y * spritePack->getSubY()), 0);
-									}
-									else
-									{
-										if (debugOutput)
-										{
-											Log(LOG_INFO) << "Adding frame: " << offset + spritePack->getModIndex();
-										}
-										// for some reason regular blit() doesn't work here how i want it, so i use this function instead.
-										_surfaces["tempSurface"]->blitNShade(_sets[sheetName]->addFrame(offset + spritePack->getModIndex()), 0 - (x * spritePack->getSubX()), 0 - (y * spritePack->getSubY()), 0);
-									}
-								}
-								++offset;
-							}
-						}
-						delete _surfaces["tempSurface"];
-						_surfaces.erase("tempSurface");
+						Log(LOG_INFO) << "Adding index: " << startSound;
 					}
+					_sounds[setName]->addSound(startSound + soundPack->getModIndex())->load(s.str());
 				}
 			}
 		}
 	}
+}
 
-	// copy constructor doesn't like doing this directly, so let's make a second handobs file the old fashioned way.
-	// handob2 is used for all the left handed sprites.
-	_sets["HANDOB2.PCK"] = new SurfaceSet(_sets["HANDOB.PCK"]->getWidth(), _sets["HANDOB.PCK"]->getHeight());
-	std::map<int, Surface*> *handob = _sets["HANDOB.PCK"]->getFrames();
-	for (std::map<int, Surface*>::const_iterator i = handob->begin(); i != handob->end(); ++i)
+/**
+ * Loads a sheet of extra sprites from the rulesets, either as a new
+ * single image or surface set, or into an existing surface set.
+ * @param sheetName Name of the image or surface set.
+ * @param spritePack Extra sprites to load.
+ */
+void XcomResourcePack::loadExtraSprites(const std::string &sheetName, ExtraSprites *spritePack)
+{
+	bool debugOutput = Options::getBool("debug");
+	std::stringstream s;
+	bool subdivision = (spritePack->getSubX() != 0 && spritePack->getSubY() != 0);
+	if (spritePack->getSingleImage())
 	{
-		(i->second)->blit(_sets["HANDOB2.PCK"]->addFrame(i->first));
+		if (_surfaces.find(sheetName) == _surfaces.end())
+		{
+			if (debugOutput)
+			{
+				Log(LOG_INFO) << "Creating new single image: " << sheetName;
+			}
+			_surfaces[sheetName] = new Surface(spritePack->getWidth(), spritePack->getHeight());
+		}
+		else
+		{
+			if (debugOutput)
+			{
+				Log(LOG_INFO) << "Adding/Replacing single image: " << sheetName;
+			}
+			delete _surfaces[sheetName];
+			_surfaces[sheetName] = new Surface(spritePack->getWidth(), spritePack->getHeight());
+		}
+		s.str("");
+		s << CrossPlatform::getDataFile(spritePack->getSprites()->operator[](0));
+		_surfaces[sheetName]->loadImage(s.str());
 	}
-
-	for (std::vector<std::pair<std::string, ExtraSounds *> >::const_iterator i = extraSounds.begin(); i != extraSounds.end(); ++i)
+	else
 	{
-		std::string setName = i->first;
-		ExtraSounds *soundPack = i->second;
-		if (_sounds.find(setName) == _sounds.end())
+		bool adding = false;
+		if (_sets.find(sheetName) == _sets.end())
 		{
 			if (debugOutput)
 			{
-				Log(LOG_INFO) << "Creating new sound set: " << setName << ", this will likely have no in-game use.";
+				Log(LOG_INFO) << "Creating new surface set: " << sheetName;
 			}
-			_sounds[setName] = new SoundSet();
+			adding = true;
+			 if (subdivision)
+			 {
+				_sets[sheetName] = new SurfaceSet(spritePack->getSubX(), spritePack->getSubY());
+			 }
+			 else
+			 {
+				_sets[sheetName] = new SurfaceSet(spritePack->getWidth(), spritePack->getHeight());
+			 }
 		}
 		else if (debugOutput)
 		{
-			Log(LOG_INFO) << "Adding/Replacing items in sound set: " << setName;
+			Log(LOG_INFO) << "Adding/Replacing items in surface set: " << sheetName;
 		}
-		for (std::map<int, std::string>::iterator j = soundPack->getSounds()->begin(); j != soundPack->getSounds()->end(); ++j)
+		
+		if (subdivision && debugOutput)
 		{
-			int startSound = j->first;
-			std::string fileName = j->second;
+			int frames = (spritePack->getWidth() / spritePack->getSubX())*(spritePack->getHeight() / spritePack->getSubY());
+			Log(LOG_INFO) << "Subdividing into " << frames << " frames.";
+		}
+
+		for (std::map<int, std::string>::iterator j = spritePack->getSprites()->begin(); j != spritePack->getSprites()->end(); ++j)
+		{
+			int startFrame = j->first;
+			std:: string fileName = j->second;
 			s.str("");
 			if (fileName.substr(fileName.length() - 1, 1) == "/")
 			{
 				if (debugOutput)
 				{
-					Log(LOG_INFO) << "Loading sound set from folder: " << fileName << " starting at index: " << startSound;
+					Log(LOG_INFO) << "Loading surface set from folder: " << fileName << " starting at frame: " << startFrame;
 				}
-				int offset = startSound;
+				int offset = startFrame;
 				std::stringstream folder;
 				folder << CrossPlatform::getDataFolder(fileName);
 				std::vector<std::string> contents = CrossPlatform::getFolderContents(folder.str());
@@ -743,41 +910,161 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 				{
 					s.str("");
 					s << folder.str() << CrossPlatform::getDataFile(*k);
-					if (_sounds[setName]->getSound(offset))
+					if (_sets[sheetName]->getFrame(offset))
 					{
-						_sounds[setName]->getSound(offset)->load(s.str());
+						if (debugOutput)
+						{
+							Log(LOG_INFO) << "Replacing frame: " << offset;
+						}
+						_sets[sheetName]->getFrame(offset)->loadImage(s.str());
 					}
 					else
 					{
-						_sounds[setName]->addSound(offset + soundPack->getModIndex())->load(s.str());
+						if (adding)
+						{
+							_sets[sheetName]->addFrame(offset)->loadImage(s.str());
+						}
+						else
+						{
+							if (debugOutput)
+							{
+								Log(LOG_INFO) << "Adding frame: " << offset + spritePack->getModIndex();
+							}
+							_sets[sheetName]->addFrame(offset + spritePack->getModIndex())->loadImage(s.str());
+						}
 					}
 					offset++;
 				}
 			}
 			else
 			{
-				s << CrossPlatform::getDataFile(fileName);
-				if (_sounds[setName]->getSound(startSound))
+				if (spritePack->getSubX() == 0 && spritePack->getSubY() == 0)
 				{
-					if (debugOutput)
+					s << CrossPlatform::getDataFile(fileName);
+					if (_sets[sheetName]->getFrame(startFrame))
 					{
-						Log(LOG_INFO) << "Replacing index: " << startSound;
+						if (debugOutput)
+						{
+							Log(LOG_INFO) << "Replacing frame: " << startFrame;
+						}
+						_sets[sheetName]->getFrame(startFrame)->loadImage(s.str());
+					}
+					else
+					{
+						if (debugOutput)
+						{
+							Log(LOG_INFO) << "Adding frame: " << startFrame << ", using index: " << startFrame + spritePack->getModIndex();
+						}
+						_sets[sheetName]->addFrame(startFrame + spritePack->getModIndex())->loadImage(s.str());
 					}
-					_sounds[setName]->getSound(startSound)->load(s.str());
 				}
 				else
 				{
-					if (debugOutput)
+					_surfaces["tempSurface"] = new Surface(spritePack->getWidth(), spritePack->getHeight());
+					s.str("");
+					s << CrossPlatform::getDataFile(spritePack->getSprites()->operator[](startFrame));
+					_surfaces["tempSurface"]->loadImage(s.str());
+					int xDivision = spritePack->getWidth() / spritePack->getSubX();
+					int yDivision = spritePack->getHeight() / spritePack->getSubY();
+					int offset = startFrame;
+
+					for (int y = 0; y != yDivision; ++y)
 					{
-						Log(LOG_INFO) << "Adding index: " << startSound;
+						for (int x = 0; x != xDivision; ++x)
+						{
+							if (_sets[sheetName]->getFrame(offset))
+							{
+								if (debugOutput)
+								{
+									Log(LOG_INFO) << "Replacing frame: " << offset;
+								}
+								_sets[sheetName]->getFrame(offset)->clear();
+								// for some reason regular blit() doesn't work here how i want it, so i use this function instead.
+								_surfaces["tempSurface"]->blitNShade(_sets[sheetName]->getFrame(offset), 0 - (x * spritePack->getSubX()), 0 - (y * spritePack->getSubY()), 0);
+							}
+							else
+							{
+								if (adding)
+								{
+									// for some reason regular blit() doesn't work here how i want it, so i use this function instead.
+									_surfaces["tempSurface"]->blitNShade(_sets[sheetName]->addFrame(offset), 0 - (x * spritePack->getSubX()), 0 - (y * spritePack->getSubY()), 0);
+								}
+								else
+								{
+									if (debugOutput)
+									{
+										Log(LOG_INFO) << "Adding frame: " << offset + spritePack->getModIndex();
+									}
+									// for some reason regular blit() doesn't work here how i want it, so i use this function instead.
+									_surfaces["tempSurface"]->blitNShade(_sets[sheetName]->addFrame(offset + spritePack->getModIndex()), 0 - (x * spritePack->getSubX()), 0 - (y * spritePack->getSubY()), 0);
+								}
+							}
+							++offset;
+						}
 					}
-					_sounds[setName]->addSound(startSound + soundPack->getModIndex())->load(s.str());
+					delete _surfaces["tempSurface"];
+					_surfaces.erase("tempSurface");
 				}
 			}
 		}
 	}
 }
 
+/**
+ * Applies the fixes to a surface set of the original game, and adds
+ * any extra sprites from the rulesets. Needs to be done every time the set is loaded.
+ * @param name Name of the surface set.
+ */
+void XcomResourcePack::patchSet(const std::string &name)
+{
+	if (name == "XCOM_1.PCK")
+	{
+		//"fix" of hair color of male personal armor
+		SurfaceSet *xcom_1 = _sets[name];
+		
+		for(int i=0; i< 16; ++i )
+		{
+			//cheast frame
+			Surface *surf = xcom_1->getFrame(4*8 + i);
+			ShaderMove<Uint8> head = ShaderMove<Uint8>(surf);
+			GraphSubset dim = head.getBaseDomain();
+			surf->lock();
+			dim.beg_y = 6;
+			dim.end_y = 9;
+			head.setDomain(dim);
+			ShaderDraw<HairBleach>(head, ShaderScalar<Uint8>(HairBleach::Face+5));
+			dim.beg_y = 9;
+			dim.end_y = 10;
+			head.setDomain(dim);
+			ShaderDraw<HairBleach>(head, ShaderScalar<Uint8>(HairBleach::Face+6));
+			surf->unlock();
+		}
+		
+		for(int i=0; i< 3; ++i )
+		{
+			//fall frame
+			Surface *surf = xcom_1->getFrame(264 + i);
+			ShaderMove<Uint8> head = ShaderMove<Uint8>(surf);
+			GraphSubset dim = head.getBaseDomain();
+			dim.beg_y = 0;
+			dim.end_y = 24;
+			dim.beg_x = 11;
+			dim.end_x = 20;
+			head.setDomain(dim);
+			surf->lock();
+			ShaderDraw<HairBleach>(head, ShaderScalar<Uint8>(HairBleach::Face+6));
+			surf->unlock();
+		}
+	}
+	for (std::vector<std::pair<std::string, ExtraSprites *> >::const_iterator i = _extraSprites.begin(); i != _extraSprites.end(); ++i)
+	{
+		if (i->first == name && !i->second->getSingleImage())
+		{
+			loadExtraSprites(i->first, i->second);
+		}
+	}
+}
+
 /**
  *
  */
@@ -786,51 +1073,48 @@ XcomResourcePack::~XcomResourcePack()
 }
 
 
+/**
+ * Adds the battlescape specific resources to the asset cache,
+ * so they're only loaded once a battle needs them.
+ */
 void XcomResourcePack::loadBattlescapeResources()
 {
 	// Load Battlescape ICONS
 	std::stringstream s;
 	s << "UFOGRAPH/" << "SPICONS.DAT";
-	_sets["SPICONS.DAT"] = new SurfaceSet(32, 24);
-	_sets["SPICONS.DAT"]->loadDat(CrossPlatform::getDataFile(s.str()));
+	addBattlescapeSet("SPICONS.DAT", CrossPlatform::getDataFile(s.str()), "", 32, 24);
 
 	s.str("");
 	std::stringstream s2;
 	s << "UFOGRAPH/" << "CURSOR.PCK";
 	s2 << "UFOGRAPH/" << "CURSOR.TAB";
-	_sets["CURSOR.PCK"] = new SurfaceSet(32, 40);
-	_sets["CURSOR.PCK"]->loadPck(CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
+	addBattlescapeSet("CURSOR.PCK", CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()), 32, 40);
 
 	s.str("");
 	s2.str("");
 	s << "UFOGRAPH/" << "SMOKE.PCK";
 	s2 << "UFOGRAPH/" << "SMOKE.TAB";
-	_sets["SMOKE.PCK"] = new SurfaceSet(32, 40);
-	_sets["SMOKE.PCK"]->loadPck(CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
+	addBattlescapeSet("SMOKE.PCK", CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()), 32, 40);
 	
 	s.str("");
 	s2.str("");
 	s << "UFOGRAPH/" << "HIT.PCK";
 	s2 << "UFOGRAPH/" << "HIT.TAB";
-	_sets["HIT.PCK"] = new SurfaceSet(32, 40);
-	_sets["HIT.PCK"]->loadPck(CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
+	addBattlescapeSet("HIT.PCK", CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()), 32, 40);
 
 	s.str("");
 	s2.str("");
 	s << "UFOGRAPH/" << "X1.PCK";
 	s2 << "UFOGRAPH/" << "X1.TAB";
-	_sets["X1.PCK"] = new SurfaceSet(128, 64);
-	_sets["X1.PCK"]->loadPck(CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
+	addBattlescapeSet("X1.PCK", CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()), 128, 64);
 
 	s.str("");
-	_sets["MEDIBITS.DAT"] = new SurfaceSet(52, 58);
 	s << "UFOGRAPH/" << "MEDIBITS.DAT";
-	_sets["MEDIBITS.DAT"]->loadDat (CrossPlatform::getDataFile(s.str()));
+	addBattlescapeSet("MEDIBITS.DAT", CrossPlatform::getDataFile(s.str()), "", 52, 58);
 
 	s.str("");
-	_sets["DETBLOB.DAT"] = new SurfaceSet(16, 16);
 	s << "UFOGRAPH/" << "DETBLOB.DAT";
-	_sets["DETBLOB.DAT"]->loadDat (CrossPlatform::getDataFile(s.str()));
+	addBattlescapeSet("DETBLOB.DAT", CrossPlatform::getDataFile(s.str()), "", 16, 16);
 
 	// Load Battlescape Terrain (only blacks are loaded, others are loaded just in time)
 	std::string bsets[] = {"BLANKS.PCK"};
@@ -842,8 +1126,7 @@ void XcomResourcePack::loadBattlescapeResources()
 		std::string tab = bsets[i].substr(0, bsets[i].length()-4) + ".TAB";
 		std::stringstream s2;
 		s2 << "TERRAIN/" << tab;
-		_sets[bsets[i]] = new SurfaceSet(32, 40);
-		_sets[bsets[i]]->loadPck(CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
+		addBattlescapeSet(bsets[i], CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()), 32, 40);
 	}
 
 	// Load Battlescape units
@@ -876,20 +1159,20 @@ void XcomResourcePack::loadBattlescapeResources()
 		std::string tab = usets[i].substr(0, usets[i].length()-4) + ".TAB";
 		std::stringstream s2;
 		s2 << "UNITS/" << tab;
-		_sets[usets[i]] = new SurfaceSet(32, 40);
-		_sets[usets[i]]->loadPck(CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
+		addBattlescapeSet(usets[i], CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()), 32, 40);
 	}
+	// handob2 is used for all the left handed sprites.
+	_cache->add("HANDOB2.PCK", new CopyAsset(this, "HANDOB2.PCK", "HANDOB.PCK"), "battlescape");
 
 	s.str("");
 	s << "UNITS/" << "BIGOBS.PCK";
 	s2.str("");
 	s2 << "UNITS/" << "BIGOBS.TAB";
-	_sets["BIGOBS.PCK"] = new SurfaceSet(32, 48);
-	_sets["BIGOBS.PCK"]->loadPck(CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
+	addBattlescapeSet("BIGOBS.PCK", CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()), 32, 48);
 
 	s.str("");
 	s << "GEODATA/" << "LOFTEMPS.DAT";
-	MapDataSet::loadLOFTEMPS(CrossPlatform::getDataFile(s.str()), &_voxelData);
+	_cache->add("LOFTEMPS.DAT", new VoxelAsset(CrossPlatform::getDataFile(s.str()), &_voxelData), "battlescape");
 
 	std::string scrs[] = {"TAC00.SCR"};
 
@@ -897,8 +1180,7 @@ void XcomResourcePack::loadBattlescapeResources()
 	{
 		std::stringstream s;
 		s << "UFOGRAPH/" << scrs[i];
-		_surfaces[scrs[i]] = new Surface(320, 200);
-		_surfaces[scrs[i]]->loadScr(CrossPlatform::getDataFile(s.str()));
+		addBattlescapeSurface(scrs[i], CrossPlatform::getDataFile(s.str()), SurfaceJob::FORMAT_SCR);
 	}
 
 	std::string spks[] = {"TAC01.SCR",
@@ -913,8 +1195,7 @@ void XcomResourcePack::loadBattlescapeResources()
 	{
 		std::stringstream s;
 		s << "UFOGRAPH/" << spks[i];
-		_surfaces[spks[i]] = new Surface(320, 200);
-		_surfaces[spks[i]]->loadSpk(CrossPlatform::getDataFile(s.str()));
+		addBattlescapeSurface(spks[i], CrossPlatform::getDataFile(s.str()), SurfaceJob::FORMAT_SPK);
 	}
 
 	std::string invs[] = {"MAN_0",
@@ -940,8 +1221,7 @@ void XcomResourcePack::loadBattlescapeResources()
 		// Load fixed inventory image
 		if (CrossPlatform::fileExists(CrossPlatform::getDataFile(s1full.str())))
 		{
-			_surfaces[s1.str()] = new Surface(320, 200);
-			_surfaces[s1.str()]->loadSpk(CrossPlatform::getDataFile(s1full.str()));
+			addBattlescapeSurface(s1.str(), CrossPlatform::getDataFile(s1full.str()), SurfaceJob::FORMAT_SPK);
 		}
 		// Load gender-based inventory image
 		if (CrossPlatform::fileExists(CrossPlatform::getDataFile(s2full.str())))
@@ -951,11 +1231,34 @@ void XcomResourcePack::loadBattlescapeResources()
 				std::stringstream s3, s3full;
 				s3 << invs[i] << sets[j] << ".SPK";
 				s3full << "UFOGRAPH/" << s3.str();
-				_surfaces[s3.str()] = new Surface(320, 200);
-				_surfaces[s3.str()]->loadSpk(CrossPlatform::getDataFile(s3full.str()));
+				addBattlescapeSurface(s3.str(), CrossPlatform::getDataFile(s3full.str()), SurfaceJob::FORMAT_SPK);
 			}
 		}
 	}
 }
 
+/**
+ * Adds a surface set to the battlescape resources in the asset cache.
+ * @param name Name of the surface set.
+ * @param file Path to the PCK or DAT file.
+ * @param tab Path to the TAB file, empty for DAT files.
+ * @param width Frame width.
+ * @param height Frame height.
+ */
+void XcomResourcePack::addBattlescapeSet(const std::string &name, const std::string &file, const std::string &tab, int width, int height)
+{
+	_cache->add(name, new SetAsset(this, name, file, tab, width, height), "battlescape");
+}
+
+/**
+ * Adds a surface to the battlescape resources in the asset cache.
+ * @param name Name of the surface.
+ * @param file Path to the image file.
+ * @param format Format of the image file (SCR or SPK).
+ */
+void XcomResourcePack::addBattlescapeSurface(const std::string &name, const std::string &file, int format)
+{
+	_cache->add(name, new SurfaceAsset(this, name, file, (SurfaceJob::Format)format), "battlescape");
+}
+
 }
@@ -25,19 +25,41 @@ namespace OpenXcom
 {
 class ExtraSprites;
 class ExtraSounds;
+class LoadQueue;
 
 /**
  * Resource pack for the X-Com: UFO Defense game.
  */
 class XcomResourcePack : public ResourcePack
 {
+private:
+	class PackJob;
+	class SetAsset;
+	class CopyAsset;
+	class SurfaceAsset;
+	std::vector<std::pair<std::string, ExtraSprites *> > _extraSprites;
+	std::vector<std::pair<std::string, ExtraSounds *> > _extraSounds;
+	/// Loads the music.
+	void loadMusic();
+	/// Loads the sounds.
+	void loadSounds();
+	/// Loads a sheet of extra sprites.
+	void loadExtraSprites(const std::string &sheetName, ExtraSprites *spritePack);
+	/// Applies the fixes and extra sprites to a surface set.
+	void patchSet(const std::string &name);
+	/// Adds a surface set to the battlescape resources.
+	void addBattlescapeSet(const std::string &name, const std::string &file, const std::string &tab, int width, int height);
+	/// Adds a surface to the battlescape resources.
+	void addBattlescapeSurface(const std::string &name, const std::string &file, int format);
 public:
 	/// Creates the X-Com ruleset.
-	XcomResourcePack(std::vector<std::pair<std::string, ExtraSprites *> > extraSprites, std::vector<std::pair<std::string, ExtraSounds *> > extraSounds);
+	XcomResourcePack(std::vector<std::pair<std::string, ExtraSprites *> > extraSprites, std::vector<std::pair<std::string, ExtraSounds *> > extraSounds, LoadQueue *queue);
 	/// Cleans up the X-Com ruleset.
 	~XcomResourcePack();
 	/// Loads battlescape specific resources
 	void loadBattlescapeResources();
+	/// Finishes loading once the queue is done.
+	void finishLoading();
 };
 
 }
@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "AlienDeployment.h"
+#include "RulesetCache.h"
 
 namespace OpenXcom
 {
@@ -218,4 +219,52 @@ std::string AlienDeployment::getNextStage() const
 	return _nextStage;
 }
 
-}
\ No newline at end of file
+/// Write an ItemSet to the ruleset cache.
+CacheWriter &operator<<(CacheWriter &out, const ItemSet &s)
+{
+	out << s.items;
+	return out;
+}
+
+/// Read an ItemSet from the ruleset cache.
+CacheReader &operator>>(CacheReader &in, ItemSet &s)
+{
+	in >> s.items;
+	return in;
+}
+
+/// Write a DeploymentData to the ruleset cache.
+CacheWriter &operator<<(CacheWriter &out, const DeploymentData &s)
+{
+	out << s.alienRank << s.lowQty << s.highQty << s.dQty << s.percentageOutsideUfo << s.itemSets;
+	return out;
+}
+
+/// Read a DeploymentData from the ruleset cache.
+CacheReader &operator>>(CacheReader &in, DeploymentData &s)
+{
+	in >> s.alienRank >> s.lowQty >> s.highQty >> s.dQty >> s.percentageOutsideUfo >> s.itemSets;
+	return in;
+}
+
+/**
+ * Loads the Alien Deployment data from the ruleset cache.
+ * @param in Ruleset cache.
+ */
+void AlienDeployment::loadCache(CacheReader &in)
+{
+	in >> _type >> _data >> _width >> _length >> _height >> _civilians;
+	in >> _roadTypeOdds >> _terrain >> _shade >> _nextStage;
+}
+
+/**
+ * Saves the Alien Deployment data to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void AlienDeployment::saveCache(CacheWriter &out) const
+{
+	out << _type << _data << _width << _length << _height << _civilians;
+	out << _roadTypeOdds << _terrain << _shade << _nextStage;
+}
+
+}
@@ -26,6 +26,8 @@
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
 class RuleTerrain;
 class Ruleset;
 
@@ -71,6 +73,10 @@ public:
 	void load(const YAML::Node& node);
 	/// Saves the Alien Deployment data to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the Alien Deployment data from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Saves the Alien Deployment data to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Gets the Alien Deployment's type.
 	std::string getType() const;
 	/// Gets a pointer to the data.
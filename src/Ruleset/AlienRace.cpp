@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "AlienRace.h"
+#include "RulesetCache.h"
 
 namespace OpenXcom
 {
@@ -86,4 +87,22 @@ std::string AlienRace::getMember(int id) const
 	return _members[id];
 }
 
+/**
+ * Loads the alien race data from the ruleset cache.
+ * @param in Ruleset cache.
+ */
+void AlienRace::loadCache(CacheReader &in)
+{
+	in >> _id >> _members;
+}
+
+/**
+ * Saves the alien race data to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void AlienRace::saveCache(CacheWriter &out) const
+{
+	out << _id << _members;
+}
+
 }
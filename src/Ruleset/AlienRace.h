@@ -28,6 +28,9 @@ enum AlienRank{AR_HUMAN = -1, AR_COMMANDER, AR_LEADER, AR_ENGINEER, AR_MEDIC, AR
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
+
 /**
  * Represents a specific race "family", or a "main race" if you wish.
  * Here is defined which ranks it contains and also which accompanying terror units.
@@ -46,6 +49,10 @@ public:
 	void load(const YAML::Node& node);
 	/// Saves the alien race data to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the alien race data from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Saves the alien race data to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Gets the alien race's id.
 	std::string getId() const;
 	/// Gets a certain member of this alien race family.
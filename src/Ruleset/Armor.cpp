@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "Armor.h"
+#include "RulesetCache.h"
 
 namespace OpenXcom
 {
@@ -286,4 +287,36 @@ std::vector<int> Armor::getLoftempsSet() const
 	return _loftempsSet;
 }
 
+/**
+ * Loads the armor data from the ruleset cache.
+ * @param in Ruleset cache.
+ */
+void Armor::loadCache(CacheReader &in)
+{
+	int movementType;
+	in >> _type >> _spriteSheet >> _spriteInv >> _corpseItem >> _storeItem;
+	in >> _frontArmor >> _sideArmor >> _rearArmor >> _underArmor >> _drawingRoutine >> movementType >> _size;
+	_movementType = (MovementType)movementType;
+	for (int i = 0; i < DAMAGE_TYPES; ++i)
+	{
+		in >> _damageModifier[i];
+	}
+	in >> _loftempsSet;
+}
+
+/**
+ * Saves the armor data to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void Armor::saveCache(CacheWriter &out) const
+{
+	out << _type << _spriteSheet << _spriteInv << _corpseItem << _storeItem;
+	out << _frontArmor << _sideArmor << _rearArmor << _underArmor << _drawingRoutine << (int)_movementType << _size;
+	for (int i = 0; i < DAMAGE_TYPES; ++i)
+	{
+		out << _damageModifier[i];
+	}
+	out << _loftempsSet;
+}
+
 }
@@ -27,6 +27,9 @@
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
+
 /**
  * Represents a specific type of armor.
  * Not only soldier armor, but also alien armor - some alien races wear Soldier Armor, Leader Armor or Commander Armor
@@ -51,6 +54,10 @@ public:
 	void load(const YAML::Node& node);
 	/// Saves the armor data to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the armor data from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Saves the armor data to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Gets the armor's type.
 	std::string getType() const;
 	/// Gets the unit's sprite sheet.
@@ -18,6 +18,7 @@
  */
 
 #include "ArticleDefinition.h"
+#include "RulesetCache.h"
 
 namespace OpenXcom
 {
@@ -104,6 +105,26 @@ namespace OpenXcom
 		out << YAML::Key << "requires" << YAML::Value << requires;
 	}
 
+	/**
+	 * Loads the article definition from the ruleset cache.
+	 * @param in Ruleset cache.
+	 */
+	void ArticleDefinition::loadCache(CacheReader &in)
+	{
+		int type;
+		in >> id >> type >> title >> section >> requires >> _listOrder;
+		_type_id = (UfopaediaTypeId)type;
+	}
+
+	/**
+	 * Saves the article definition to the ruleset cache.
+	 * @param out Ruleset cache.
+	 */
+	void ArticleDefinition::saveCache(CacheWriter &out) const
+	{
+		out << id << (int)_type_id << title << section << requires << _listOrder;
+	}
+
 	/*
 	 * @return the list weight of the article.
 	 */
@@ -147,6 +168,18 @@ namespace OpenXcom
 		return out;
 	}
 
+	CacheReader& operator>> (CacheReader& in, ArticleDefinitionRect& rect)
+	{
+		in >> rect.x >> rect.y >> rect.width >> rect.height;
+		return in;
+	}
+
+	CacheWriter& operator<< (CacheWriter& out, const ArticleDefinitionRect& rect)
+	{
+		out << rect.x << rect.y << rect.width << rect.height;
+		return out;
+	}
+
 	/**
 	 * Constructor (only setting type of base class)
 	 */
@@ -198,6 +231,26 @@ namespace OpenXcom
 		out << YAML::EndMap;
 	}
 
+	/**
+	 * Loads the article definition from the ruleset cache.
+	 * @param in Ruleset cache.
+	 */
+	void ArticleDefinitionCraft::loadCache(CacheReader &in)
+	{
+		ArticleDefinition::loadCache(in);
+		in >> image_id >> rect_stats >> rect_text >> text;
+	}
+
+	/**
+	 * Saves the article definition to the ruleset cache.
+	 * @param out Ruleset cache.
+	 */
+	void ArticleDefinitionCraft::saveCache(CacheWriter &out) const
+	{
+		ArticleDefinition::saveCache(out);
+		out << image_id << rect_stats << rect_text << text;
+	}
+
 	/**
 	 * Constructor (only setting type of base class)
 	 */
@@ -239,6 +292,26 @@ namespace OpenXcom
 		out << YAML::EndMap;
 	}
 
+	/**
+	 * Loads the article definition from the ruleset cache.
+	 * @param in Ruleset cache.
+	 */
+	void ArticleDefinitionCraftWeapon::loadCache(CacheReader &in)
+	{
+		ArticleDefinition::loadCache(in);
+		in >> image_id >> text;
+	}
+
+	/**
+	 * Saves the article definition to the ruleset cache.
+	 * @param out Ruleset cache.
+	 */
+	void ArticleDefinitionCraftWeapon::saveCache(CacheWriter &out) const
+	{
+		ArticleDefinition::saveCache(out);
+		out << image_id << text;
+	}
+
 	/**
 	 * Constructor (only setting type of base class)
 	 */
@@ -275,6 +348,26 @@ namespace OpenXcom
 		out << YAML::EndMap;
 	}
 
+	/**
+	 * Loads the article definition from the ruleset cache.
+	 * @param in Ruleset cache.
+	 */
+	void ArticleDefinitionText::loadCache(CacheReader &in)
+	{
+		ArticleDefinition::loadCache(in);
+		in >> text;
+	}
+
+	/**
+	 * Saves the article definition to the ruleset cache.
+	 * @param out Ruleset cache.
+	 */
+	void ArticleDefinitionText::saveCache(CacheWriter &out) const
+	{
+		ArticleDefinition::saveCache(out);
+		out << text;
+	}
+
 	/**
 	 * Constructor (only setting type of base class)
 	 */
@@ -321,6 +414,26 @@ namespace OpenXcom
 		out << YAML::EndMap;
 	}
 
+	/**
+	 * Loads the article definition from the ruleset cache.
+	 * @param in Ruleset cache.
+	 */
+	void ArticleDefinitionTextImage::loadCache(CacheReader &in)
+	{
+		ArticleDefinition::loadCache(in);
+		in >> image_id >> text >> text_width;
+	}
+
+	/**
+	 * Saves the article definition to the ruleset cache.
+	 * @param out Ruleset cache.
+	 */
+	void ArticleDefinitionTextImage::saveCache(CacheWriter &out) const
+	{
+		ArticleDefinition::saveCache(out);
+		out << image_id << text << text_width;
+	}
+
 	/**
 	 * Constructor (only setting type of base class)
 	 */
@@ -357,6 +470,26 @@ namespace OpenXcom
 		out << YAML::EndMap;
 	}
 
+	/**
+	 * Loads the article definition from the ruleset cache.
+	 * @param in Ruleset cache.
+	 */
+	void ArticleDefinitionBaseFacility::loadCache(CacheReader &in)
+	{
+		ArticleDefinition::loadCache(in);
+		in >> text;
+	}
+
+	/**
+	 * Saves the article definition to the ruleset cache.
+	 * @param out Ruleset cache.
+	 */
+	void ArticleDefinitionBaseFacility::saveCache(CacheWriter &out) const
+	{
+		ArticleDefinition::saveCache(out);
+		out << text;
+	}
+
 	/**
 	 * Constructor (only setting type of base class)
 	 */
@@ -393,6 +526,26 @@ namespace OpenXcom
 		out << YAML::EndMap;
 	}
 
+	/**
+	 * Loads the article definition from the ruleset cache.
+	 * @param in Ruleset cache.
+	 */
+	void ArticleDefinitionItem::loadCache(CacheReader &in)
+	{
+		ArticleDefinition::loadCache(in);
+		in >> text;
+	}
+
+	/**
+	 * Saves the article definition to the ruleset cache.
+	 * @param out Ruleset cache.
+	 */
+	void ArticleDefinitionItem::saveCache(CacheWriter &out) const
+	{
+		ArticleDefinition::saveCache(out);
+		out << text;
+	}
+
 	/**
 	 * Constructor (only setting type of base class)
 	 */
@@ -429,6 +582,26 @@ namespace OpenXcom
 		out << YAML::EndMap;
 	}
 
+	/**
+	 * Loads the article definition from the ruleset cache.
+	 * @param in Ruleset cache.
+	 */
+	void ArticleDefinitionUfo::loadCache(CacheReader &in)
+	{
+		ArticleDefinition::loadCache(in);
+		in >> text;
+	}
+
+	/**
+	 * Saves the article definition to the ruleset cache.
+	 * @param out Ruleset cache.
+	 */
+	void ArticleDefinitionUfo::saveCache(CacheWriter &out) const
+	{
+		ArticleDefinition::saveCache(out);
+		out << text;
+	}
+
 	/**
 	 * Constructor (only setting type of base class)
 	 */
@@ -496,4 +669,24 @@ namespace OpenXcom
 		out << YAML::EndMap;
 	}
 
+	/**
+	 * Loads the article definition from the ruleset cache.
+	 * @param in Ruleset cache.
+	 */
+	void ArticleDefinitionVehicle::loadCache(CacheReader &in)
+	{
+		ArticleDefinition::loadCache(in);
+		in >> text >> weapon;
+	}
+
+	/**
+	 * Saves the article definition to the ruleset cache.
+	 * @param out Ruleset cache.
+	 */
+	void ArticleDefinitionVehicle::saveCache(CacheWriter &out) const
+	{
+		ArticleDefinition::saveCache(out);
+		out << text << weapon;
+	}
+
 }
@@ -26,6 +26,9 @@
 
 namespace OpenXcom
 {
+	class CacheReader;
+	class CacheWriter;
+
 	/// define article types
 	enum UfopaediaTypeId {
 		UFOPAEDIA_TYPE_UNKNOWN         = 0,
@@ -61,6 +64,10 @@ namespace OpenXcom
 		virtual void load(const YAML::Node& node, int listOrder);
 		/// Saves the article to YAML.
 		virtual void save(YAML::Emitter& out) const;
+		/// Loads the article from the ruleset cache.
+		virtual void loadCache(CacheReader &in);
+		/// Saves the article to the ruleset cache.
+		virtual void saveCache(CacheWriter &out) const;
 		/// Gets the article's list weight
 		int getListOrder() const;
 
@@ -89,6 +96,8 @@ namespace OpenXcom
 	};
 	void operator>> (const YAML::Node& node, ArticleDefinitionRect& rect);
 	YAML::Emitter& operator<< (YAML::Emitter& out, const ArticleDefinitionRect& rect);
+	CacheReader& operator>> (CacheReader& in, ArticleDefinitionRect& rect);
+	CacheWriter& operator<< (CacheWriter& out, const ArticleDefinitionRect& rect);
 
 	/**
 	 * ArticleDefinitionCraft defines articles for craft, e.g. SKYRANGER.
@@ -104,6 +113,10 @@ namespace OpenXcom
 		void load(const YAML::Node& node, int listOrder);
 		/// Saves the article to YAML.
 		void save(YAML::Emitter& out) const;
+		/// Loads the article from the ruleset cache.
+		void loadCache(CacheReader &in);
+		/// Saves the article to the ruleset cache.
+		void saveCache(CacheWriter &out) const;
 
 		std::string image_id;
 		ArticleDefinitionRect rect_stats;
@@ -125,6 +138,10 @@ namespace OpenXcom
 		void load(const YAML::Node& node, int listOrder);
 		/// Saves the article to YAML.
 		void save(YAML::Emitter& out) const;
+		/// Loads the article from the ruleset cache.
+		void loadCache(CacheReader &in);
+		/// Saves the article to the ruleset cache.
+		void saveCache(CacheWriter &out) const;
 
 		std::string image_id;
 		std::string text;
@@ -143,6 +160,10 @@ namespace OpenXcom
 		void load(const YAML::Node& node, int listOrder);
 		/// Saves the article to YAML.
 		void save(YAML::Emitter& out) const;
+		/// Loads the article from the ruleset cache.
+		void loadCache(CacheReader &in);
+		/// Saves the article to the ruleset cache.
+		void saveCache(CacheWriter &out) const;
 
 		std::string text;
 	};
@@ -161,6 +182,10 @@ namespace OpenXcom
 		void load(const YAML::Node& node, int listOrder);
 		/// Saves the article to YAML.
 		void save(YAML::Emitter& out) const;
+		/// Loads the article from the ruleset cache.
+		void loadCache(CacheReader &in);
+		/// Saves the article to the ruleset cache.
+		void saveCache(CacheWriter &out) const;
 
 		std::string image_id;
 		std::string text;
@@ -181,6 +206,10 @@ namespace OpenXcom
 		void load(const YAML::Node& node, int listOrder);
 		/// Saves the article to YAML.
 		void save(YAML::Emitter& out) const;
+		/// Loads the article from the ruleset cache.
+		void loadCache(CacheReader &in);
+		/// Saves the article to the ruleset cache.
+		void saveCache(CacheWriter &out) const;
 
 		std::string text;
 	};
@@ -199,6 +228,10 @@ namespace OpenXcom
 		void load(const YAML::Node& node, int listOrder);
 		/// Saves the article to YAML.
 		void save(YAML::Emitter& out) const;
+		/// Loads the article from the ruleset cache.
+		void loadCache(CacheReader &in);
+		/// Saves the article to the ruleset cache.
+		void saveCache(CacheWriter &out) const;
 
 		std::string text;
 	};
@@ -217,6 +250,10 @@ namespace OpenXcom
 		void load(const YAML::Node& node, int listOrder);
 		/// Saves the article to YAML.
 		void save(YAML::Emitter& out) const;
+		/// Loads the article from the ruleset cache.
+		void loadCache(CacheReader &in);
+		/// Saves the article to the ruleset cache.
+		void saveCache(CacheWriter &out) const;
 
 		std::string text;
 	};
@@ -251,6 +288,10 @@ namespace OpenXcom
 		void load(const YAML::Node& node, int listOrder);
 		/// Saves the article to YAML.
 		void save(YAML::Emitter& out) const;
+		/// Loads the article from the ruleset cache.
+		void loadCache(CacheReader &in);
+		/// Saves the article to the ruleset cache.
+		void saveCache(CacheWriter &out) const;
 		std::string text;
 		std::string weapon;
 	};
@@ -18,6 +18,7 @@
  */
 #define _USE_MATH_DEFINES
 #include "City.h"
+#include "RulesetCache.h"
 #include <math.h>
 
 namespace OpenXcom
@@ -107,4 +108,22 @@ double City::getLongitude() const
 	return _lon;
 }
 
+/**
+ * Loads the city from the ruleset cache.
+ * @param in Ruleset cache.
+ */
+void City::loadCache(CacheReader &in)
+{
+	in >> _name >> _lon >> _lat;
+}
+
+/**
+ * Saves the city to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void City::saveCache(CacheWriter &out) const
+{
+	out << _name << _lon << _lat;
+}
+
 }
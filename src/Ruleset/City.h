@@ -25,6 +25,9 @@
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
+
 /**
  * Represents a city of the world.
  * Aliens target cities for certain missions.
@@ -43,6 +46,10 @@ public:
 	void load(const YAML::Node& node);
 	/// Saves the city to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the city from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Saves the city to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Gets the city's name.
 	std::string getName() const;
 	/// Gets the city's latitude.
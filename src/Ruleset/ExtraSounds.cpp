@@ -18,6 +18,7 @@
  */
 
 #include "ExtraSounds.h"
+#include "RulesetCache.h"
 
 namespace OpenXcom
 {
@@ -77,4 +78,23 @@ int ExtraSounds::getModIndex()
 {
 	return _modIndex;
 }
-}
\ No newline at end of file
+
+/**
+ * Loads the data from the ruleset cache.
+ * @param in Ruleset cache.
+ */
+void ExtraSounds::loadCache(CacheReader &in)
+{
+	in >> _sounds >> _modIndex;
+}
+
+/**
+ * Saves the data to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void ExtraSounds::saveCache(CacheWriter &out) const
+{
+	out << _sounds << _modIndex;
+}
+
+}
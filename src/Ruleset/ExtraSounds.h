@@ -24,6 +24,9 @@
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
+
 class ExtraSounds
 {
 private:
@@ -36,6 +39,10 @@ public:
 	virtual ~ExtraSounds();
 	/// Loads the data from yaml
 	void load(const YAML::Node &node, int modIndex);
+	/// Loads the data from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Saves the data to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Gets the list of sounds defined by this mod
 	std::map<int, std::string> *getSounds();
 	/// get the mod index for this external sound set.
@@ -18,6 +18,7 @@
  */
 
 #include "ExtraSprites.h"
+#include "RulesetCache.h"
 
 namespace OpenXcom
 {
@@ -132,4 +133,22 @@ int ExtraSprites::getSubY() const
 	return _subY;
 }
 
-}
\ No newline at end of file
+/**
+ * Loads the data from the ruleset cache.
+ * @param in Ruleset cache.
+ */
+void ExtraSprites::loadCache(CacheReader &in)
+{
+	in >> _sprites >> _width >> _height >> _singleImage >> _modIndex >> _subX >> _subY;
+}
+
+/**
+ * Saves the data to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void ExtraSprites::saveCache(CacheWriter &out) const
+{
+	out << _sprites << _width << _height << _singleImage << _modIndex << _subX << _subY;
+}
+
+}
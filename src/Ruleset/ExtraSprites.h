@@ -24,6 +24,9 @@
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
+
 class ExtraSprites
 {
 private:
@@ -38,6 +41,10 @@ public:
 	virtual ~ExtraSprites();
 	/// Loads the data from yaml
 	void load(const YAML::Node &node, int modIndex);
+	/// Loads the data from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Saves the data to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Gets the list of sprites defined by this mod
 	std::map<int, std::string> *getSprites();
 	/// get the width of the surfaces (used for single images and new spritesets)
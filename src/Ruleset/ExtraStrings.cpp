@@ -18,6 +18,7 @@
  */
 
 #include "ExtraStrings.h"
+#include "RulesetCache.h"
 
 namespace OpenXcom
 {
@@ -67,4 +68,23 @@ std::map<std::string, std::string> *ExtraStrings::getStrings()
 {
 	return &_strings;
 }
-}
\ No newline at end of file
+
+/**
+ * Loads the data from the ruleset cache.
+ * @param in Ruleset cache.
+ */
+void ExtraStrings::loadCache(CacheReader &in)
+{
+	in >> _strings;
+}
+
+/**
+ * Saves the data to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void ExtraStrings::saveCache(CacheWriter &out) const
+{
+	out << _strings;
+}
+
+}
@@ -26,6 +26,9 @@
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
+
 class ExtraStrings
 {
 private:
@@ -37,6 +40,10 @@ public:
 	virtual ~ExtraStrings();
 	/// Loads the data from yaml
 	void load(const YAML::Node &node);
+	/// Loads the data from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Saves the data to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Gets the list of strings defined by this mod
 	std::map<std::string, std::string> *getStrings();
 };
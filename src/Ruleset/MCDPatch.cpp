@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "MCDPatch.h"
+#include "RulesetCache.h"
 #include "Ruleset.h"
 #include "MapDataSet.h"
 #include "MapData.h"
@@ -137,4 +138,49 @@ void MCDPatch::modifyData(MapDataSet *dataSet) const
 	}
 }
 
+/// Write a list of MCD entry changes to the ruleset cache.
+CacheWriter &operator<<(CacheWriter &out, const std::vector<std::pair<size_t, int> > &patch)
+{
+	out << (unsigned int)patch.size();
+	for (std::vector<std::pair<size_t, int> >::const_iterator i = patch.begin(); i != patch.end(); ++i)
+	{
+		out << (unsigned int)i->first << i->second;
+	}
+	return out;
+}
+
+/// Read a list of MCD entry changes from the ruleset cache.
+CacheReader &operator>>(CacheReader &in, std::vector<std::pair<size_t, int> > &patch)
+{
+	unsigned int size;
+	in >> size;
+	patch.clear();
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		unsigned int entry;
+		int value;
+		in >> entry >> value;
+		patch.push_back(std::make_pair((size_t)entry, value));
+	}
+	return in;
+}
+
+/**
+ * Loads the MCD Patch from the ruleset cache.
+ * @param in Ruleset cache.
+ */
+void MCDPatch::loadCache(CacheReader &in)
+{
+	in >> _bigWalls >> _TUWalks >> _TUFlys >> _TUSlides >> _deathTiles >> _terrainHeight;
+}
+
+/**
+ * Saves the MCD Patch to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void MCDPatch::saveCache(CacheWriter &out) const
+{
+	out << _bigWalls << _TUWalks << _TUFlys << _TUSlides << _deathTiles << _terrainHeight;
+}
+
 }
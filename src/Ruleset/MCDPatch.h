@@ -24,6 +24,8 @@
 
 namespace OpenXcom
 {
+class CacheReader;
+class CacheWriter;
 class Ruleset;
 class MapDataSet;
 /**
@@ -42,6 +44,10 @@ public:
 	void load(const YAML::Node& node);
 	/// Saves the MCD Patch to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the MCD Patch from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Saves the MCD Patch to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Applies an MCD patch to a mapDataSet
 	void modifyData(MapDataSet *dataSet) const;
 };
@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "MapBlock.h"
+#include "RulesetCache.h"
 
 namespace OpenXcom
 {
@@ -206,4 +207,25 @@ void MapBlock::reset()
 	_timesUsed = 0;
 }
 
+/**
+ * Loads the map block from the ruleset cache.
+ * @param in Ruleset cache.
+ */
+void MapBlock::loadCache(CacheReader &in)
+{
+	int type, subType;
+	in >> _name >> _size_x >> _size_y >> _size_z >> type >> subType >> _frequency >> _timesUsed >> _maxCount;
+	_type = (MapBlockType)type;
+	_subType = (MapBlockType)subType;
+}
+
+/**
+ * Saves the map block to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void MapBlock::saveCache(CacheWriter &out) const
+{
+	out << _name << _size_x << _size_y << _size_z << (int)_type << (int)_subType << _frequency << _timesUsed << _maxCount;
+}
+
 }
@@ -25,6 +25,9 @@
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
+
 enum MapBlockType {MT_UNDEFINED = -1, MT_DEFAULT, MT_LANDINGZONE, MT_EWROAD, MT_NSROAD, MT_CROSSING, MT_DIRT, MT_XCOMSPAWN, MT_UBASECOMM, MT_FINALCOMM };
 class RuleTerrain;
 
@@ -49,6 +52,10 @@ public:
 	void load(const YAML::Node& node);
 	/// Saves the map block to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the map block from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Saves the map block to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Gets the mapblock's name (used for MAP generation).
 	std::string getName() const;
 	/// Gets the mapblock's x size.
@@ -18,12 +18,12 @@
  */
 #include "MapDataSet.h"
 #include "MapData.h"
-#include <fstream>
 #include <sstream>
 #include <SDL_endian.h>
 #include "../Engine/Exception.h"
 #include "../Engine/SurfaceSet.h"
 #include "../Engine/CrossPlatform.h"
+#include "../Engine/DataBuffer.h"
 #include "../Resource/ResourcePack.h"
 
 namespace OpenXcom
@@ -170,12 +170,13 @@ void MapDataSet::loadData()
 	s << "TERRAIN/" << _name << ".MCD";
 
 	// Load file
-	std::ifstream mapFile (CrossPlatform::getDataFile(s.str()).c_str(), std::ios::in | std::ios::binary);
-	if (!mapFile)
+	DataBuffer mapFile;
+	if (!mapFile.open(CrossPlatform::getDataFile(s.str())))
 	{
 		throw Exception(s.str() + " not found");
 	}
 
+	_objects.reserve(mapFile.getSize() / sizeof(MCD));
 	while (mapFile.read((char*)&mcd, sizeof(MCD)))
 	{
 		MapData *to = new MapData(this);
@@ -219,14 +220,6 @@ void MapDataSet::loadData()
 		objNumber++;
 	}
 
-
-	if (!mapFile.eof())
-	{
-		throw Exception("Invalid MCD file");
-	}
-
-	mapFile.close();
-
 	// process the mapdataset to put block values on floortiles (as we don't have em in UFO)
 	for (std::vector<MapData*>::iterator i = _objects.begin(); i != _objects.end(); ++i)
 	{
@@ -249,15 +242,25 @@ void MapDataSet::loadData()
 
 }
 
+/**
+ * Unloads the terrain data to free memory, it can be loaded again later.
+ */
 void MapDataSet::unloadData()
 {
 	if (_loaded)
 	{
 		for (std::vector<MapData*>::iterator i = _objects.begin(); i != _objects.end(); ++i)
 		{
+			if (*i == _blankTile)
+				_blankTile = 0;
+			if (*i == _scorchedTile)
+				_scorchedTile = 0;
 			delete *i;
 		}
+		_objects.clear();
 		delete _surfaceSet;
+		_surfaceSet = 0;
+		_loaded = false;
 	}
 }
 
@@ -269,26 +272,20 @@ void MapDataSet::unloadData()
 void MapDataSet::loadLOFTEMPS(const std::string &filename, std::vector<Uint16> *voxelData)
 {
 	// Load file
-	std::ifstream mapFile (filename.c_str(), std::ios::in | std::ios::binary);
-	if (!mapFile)
+	DataBuffer mapFile;
+	if (!mapFile.open(filename))
 	{
 		throw Exception(filename + " not found");
 	}
 
 	Uint16 value;
 
+	voxelData->reserve(voxelData->size() + mapFile.getSize() / sizeof(value));
 	while (mapFile.read((char*)&value, sizeof(value)))
 	{
 		value = SDL_SwapLE16(value);
 		voxelData->push_back(value);
 	}
-
-	if (!mapFile.eof())
-	{
-		throw Exception("Invalid LOFTEMPS");
-	}
-
-	mapFile.close();
 }
 
 MapData *MapDataSet::getBlankFloorTile()
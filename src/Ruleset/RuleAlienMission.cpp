@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "RuleAlienMission.h"
+#include "RulesetCache.h"
 #include "Ruleset.h"
 #include "../Savegame/WeightedOptions.h"
 #include "../Engine/RNG.h"
@@ -161,4 +162,52 @@ void operator>>(const YAML::Node &node, MissionWave &wave)
 	node["timer"] >> wave.spawnTimer;
 }
 
+/// Write a MissionWave to the ruleset cache.
+CacheWriter &operator<<(CacheWriter &out, const MissionWave &wave)
+{
+	out << wave.ufoType << wave.ufoCount << wave.trajectory << wave.spawnTimer;
+	return out;
+}
+
+/// Read a MissionWave from the ruleset cache.
+CacheReader &operator>>(CacheReader &in, MissionWave &wave)
+{
+	in >> wave.ufoType >> wave.ufoCount >> wave.trajectory >> wave.spawnTimer;
+	return in;
+}
+
+/**
+ * Loads the alien mission data from the ruleset cache.
+ * @param in Ruleset cache.
+ */
+void RuleAlienMission::loadCache(CacheReader &in)
+{
+	unsigned int distribution;
+	in >> _type >> distribution;
+	for (unsigned int i = 0; i < distribution; ++i)
+	{
+		unsigned int month;
+		in >> month;
+		std::auto_ptr<WeightedOptions> races(new WeightedOptions);
+		races->loadCache(in);
+		_raceDistribution.push_back(std::make_pair(month, races.release()));
+	}
+	in >> _waves >> _points;
+}
+
+/**
+ * Saves the alien mission data to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void RuleAlienMission::saveCache(CacheWriter &out) const
+{
+	out << _type << (unsigned int)_raceDistribution.size();
+	for (std::vector<std::pair<unsigned, WeightedOptions*> >::const_iterator i = _raceDistribution.begin(); i != _raceDistribution.end(); ++i)
+	{
+		out << i->first;
+		i->second->saveCache(out);
+	}
+	out << _waves << _points;
+}
+
 }
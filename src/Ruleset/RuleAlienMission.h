@@ -26,6 +26,8 @@
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
 class Ruleset;
 class WeightedOptions;
 class Region;
@@ -76,6 +78,10 @@ public:
 	void load(const YAML::Node &node);
 	/// Saves the alien mission data to YAML.
 	void save(YAML::Emitter &out) const;
+	/// Loads the alien mission data from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Saves the alien mission data to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Get the number of waves.
 	unsigned getWaveCount() const { return _waves.size(); }
 	/// Gets the full wave information.
@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "RuleBaseFacility.h"
+#include "RulesetCache.h"
 
 namespace OpenXcom
 {
@@ -476,4 +477,27 @@ int RuleBaseFacility::getListOrder() const
 {
 	return _listOrder;
 }
+
+/**
+ * Loads the facility from the ruleset cache.
+ * @param in Ruleset cache.
+ */
+void RuleBaseFacility::loadCache(CacheReader &in)
+{
+	in >> _type >> _requires >> _spriteShape >> _spriteFacility >> _lift >> _hyper >> _mind >> _grav;
+	in >> _size >> _buildCost >> _buildTime >> _monthlyCost >> _storage >> _personnel >> _aliens >> _crafts >> _labs >> _workshops >> _psiLabs;
+	in >> _radarRange >> _radarChance >> _defense >> _hitRatio >> _fireSound >> _hitSound >> _mapName >> _listOrder;
+}
+
+/**
+ * Saves the facility to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void RuleBaseFacility::saveCache(CacheWriter &out) const
+{
+	out << _type << _requires << _spriteShape << _spriteFacility << _lift << _hyper << _mind << _grav;
+	out << _size << _buildCost << _buildTime << _monthlyCost << _storage << _personnel << _aliens << _crafts << _labs << _workshops << _psiLabs;
+	out << _radarRange << _radarChance << _defense << _hitRatio << _fireSound << _hitSound << _mapName << _listOrder;
+}
+
 }
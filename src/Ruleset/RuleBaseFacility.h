@@ -26,6 +26,9 @@
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
+
 /**
  * Represents a specific type of base facility.
  * Contains constant info about a facility like
@@ -53,6 +56,10 @@ public:
 	void load(const YAML::Node& node, int modIndex, int listOrder);
 	/// Saves the facility to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the facility from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Saves the facility to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Gets the facility's type.
 	std::string getType() const;
 	/// Gets the facility's requirements.
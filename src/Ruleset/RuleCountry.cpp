@@ -18,6 +18,7 @@
  */
 #define _USE_MATH_DEFINES
 #include "RuleCountry.h"
+#include "RulesetCache.h"
 #include "../Engine/RNG.h"
 #include <math.h>
 
@@ -178,4 +179,25 @@ bool RuleCountry::insideCountry(double lon, double lat) const
 	}
 	return false;
 }
+
+/**
+ * Loads the country from the ruleset cache.
+ * @param in Ruleset cache.
+ */
+void RuleCountry::loadCache(CacheReader &in)
+{
+	in >> _type >> _fundingBase >> _fundingCap >> _labelLon >> _labelLat;
+	in >> _lonMin >> _lonMax >> _latMin >> _latMax;
+}
+
+/**
+ * Saves the country to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void RuleCountry::saveCache(CacheWriter &out) const
+{
+	out << _type << _fundingBase << _fundingCap << _labelLon << _labelLat;
+	out << _lonMin << _lonMax << _latMin << _latMax;
+}
+
 }
@@ -25,6 +25,9 @@
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
+
 /**
  * Represents a specific funding country.
  * Contains constant info like its location in the
@@ -46,6 +49,10 @@ public:
 	void load(const YAML::Node& node);
 	/// Saves the country to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the country from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Saves the country to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Gets the country's type.
 	std::string getType() const;
 	/// Generates the country's starting funding.
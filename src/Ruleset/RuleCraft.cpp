@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "RuleCraft.h"
+#include "RulesetCache.h"
 #include "RuleTerrain.h"
 
 namespace OpenXcom
@@ -406,5 +407,40 @@ int RuleCraft::getListOrder() const
 {
 	 return _listOrder;
 }
+
+/**
+ * Loads the craft data from the ruleset cache.
+ * @param in Ruleset cache.
+ * @param ruleset Ruleset the map data sets come from.
+ */
+void RuleCraft::loadCache(CacheReader &in, Ruleset *ruleset)
+{
+	in >> _type >> _requires >> _sprite >> _fuelMax >> _damageMax >> _speedMax >> _accel >> _weapons >> _soldiers >> _vehicles;
+	in >> _costBuy >> _costRent >> _costSell >> _refuelItem >> _repairRate >> _refuelRate >> _radarRange >> _transferTime >> _score;
+	bool terrain;
+	in >> terrain;
+	if (terrain)
+	{
+		_battlescapeTerrainData = new RuleTerrain("");
+		_battlescapeTerrainData->loadCache(in, ruleset);
+	}
+	in >> _spacecraft >> _listOrder;
 }
 
+/**
+ * Saves the craft data to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void RuleCraft::saveCache(CacheWriter &out) const
+{
+	out << _type << _requires << _sprite << _fuelMax << _damageMax << _speedMax << _accel << _weapons << _soldiers << _vehicles;
+	out << _costBuy << _costRent << _costSell << _refuelItem << _repairRate << _refuelRate << _radarRange << _transferTime << _score;
+	out << (_battlescapeTerrainData != 0);
+	if (_battlescapeTerrainData != 0)
+	{
+		_battlescapeTerrainData->saveCache(out);
+	}
+	out << _spacecraft << _listOrder;
+}
+
+}
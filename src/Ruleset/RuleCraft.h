@@ -26,6 +26,8 @@
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
 class RuleTerrain;
 class Ruleset;
 
@@ -57,6 +59,10 @@ public:
 	void load(const YAML::Node& node, Ruleset *ruleset, int modIndex, int nextCraftIndex);
 	/// Saves the craft data to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the craft data from the ruleset cache.
+	void loadCache(CacheReader &in, Ruleset *ruleset);
+	/// Saves the craft data to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Gets the craft's type.
 	std::string getType() const;
 	/// Gets the craft's requirements.
@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "RuleCraftWeapon.h"
+#include "RulesetCache.h"
 
 namespace OpenXcom
 {
@@ -289,4 +290,24 @@ int RuleCraftWeapon::getProjectileSpeed() const
 	return _projectileSpeed;
 }
 
+/**
+ * Loads the craft weapon data from the ruleset cache.
+ * @param in Ruleset cache.
+ */
+void RuleCraftWeapon::loadCache(CacheReader &in)
+{
+	in >> _type >> _sprite >> _sound >> _damage >> _range >> _accuracy >> _reloadCautious >> _reloadStandard >> _reloadAggressive;
+	in >> _ammoMax >> _rearmRate >> _projectileType >> _projectileSpeed >> _launcher >> _clip;
+}
+
+/**
+ * Saves the craft weapon data to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void RuleCraftWeapon::saveCache(CacheWriter &out) const
+{
+	out << _type << _sprite << _sound << _damage << _range << _accuracy << _reloadCautious << _reloadStandard << _reloadAggressive;
+	out << _ammoMax << _rearmRate << _projectileType << _projectileSpeed << _launcher << _clip;
+}
+
 }
@@ -25,6 +25,9 @@
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
+
 /**
  * Represents a specific type of craft weapon.
  * Contains constant info about a craft weapon like
@@ -46,6 +49,10 @@ public:
 	void load(const YAML::Node& node, int modIndex);
 	/// Saves the craft weapon data to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the craft weapon data from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Saves the craft weapon data to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Gets the craft weapon's type.
 	std::string getType() const;
 	/// Gets the craft weapon's sprite.
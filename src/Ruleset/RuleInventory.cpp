@@ -17,6 +17,8 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "RuleInventory.h"
+#include "RulesetCache.h"
+#include "../Engine/StringId.h"
 #include <cmath>
 #include "RuleItem.h"
 
@@ -40,7 +42,7 @@ YAML::Emitter& operator << (YAML::Emitter& out, const RuleSlot& s)
  * type of inventory section.
  * @param id String defining the id.
  */
-RuleInventory::RuleInventory(const std::string &id): _id(id), _x(0), _y(0), _type(INV_SLOT), _slots(), _costs()
+RuleInventory::RuleInventory(const std::string &id): _id(id), _handle(StringId::intern(id)), _x(0), _y(0), _type(INV_SLOT), _slots(), _costs()
 {
 }
 
@@ -108,11 +110,20 @@ void RuleInventory::save(YAML::Emitter &out) const
  * this inventory section. Each section has a unique name.
  * @return Section name.
  */
-std::string RuleInventory::getId() const
+const std::string &RuleInventory::getId() const
 {
 	return _id;
 }
 
+/**
+ * Returns the handle of the inventory section's id, for quick comparisons.
+ * @return Section handle.
+ */
+int RuleInventory::getHandle() const
+{
+	return _handle;
+}
+
 /**
  * Returns the X position of the inventory section on the screen.
  * @return Position in pixels.
@@ -261,4 +272,38 @@ int RuleInventory::getCost(RuleInventory* slot) const
 	return _costs.find(slot->getId())->second;
 }
 
+/// Write a RuleSlot to the ruleset cache.
+CacheWriter &operator<<(CacheWriter &out, const RuleSlot &s)
+{
+	out << s.x << s.y;
+	return out;
+}
+
+/// Read a RuleSlot from the ruleset cache.
+CacheReader &operator>>(CacheReader &in, RuleSlot &s)
+{
+	in >> s.x >> s.y;
+	return in;
+}
+
+/**
+ * Loads the inventory data from the ruleset cache.
+ * @param in Ruleset cache.
+ */
+void RuleInventory::loadCache(CacheReader &in)
+{
+	int type;
+	in >> _id >> _x >> _y >> type >> _slots >> _costs;
+	_type = (InventoryType)type;
+}
+
+/**
+ * Saves the inventory data to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void RuleInventory::saveCache(CacheWriter &out) const
+{
+	out << _id << _x << _y << (int)_type << _slots << _costs;
+}
+
 }
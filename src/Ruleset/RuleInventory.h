@@ -27,6 +27,9 @@
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
+
 struct RuleSlot
 {
 	int x, y;
@@ -45,6 +48,7 @@ class RuleInventory
 {
 private:
 	std::string _id;
+	int _handle;
 	int _x, _y;
 	InventoryType _type;
 	std::vector<struct RuleSlot> _slots;
@@ -62,8 +66,14 @@ public:
 	void load(const YAML::Node& node);
 	/// Saves the inventory data to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the inventory data from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Saves the inventory data to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Gets the inventory's id.
-	std::string getId() const;
+	const std::string &getId() const;
+	/// Gets the inventory's handle.
+	int getHandle() const;
 	/// Gets the X position of the inventory.
 	int getX() const;
 	/// Gets the Y position of the inventory.
@@ -17,6 +17,8 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "RuleItem.h"
+#include "RulesetCache.h"
+#include "../Engine/StringId.h"
 #include "RuleInventory.h"
 #include "../Engine/SurfaceSet.h"
 #include "../Engine/Surface.h"
@@ -33,7 +35,7 @@ RuleItem::RuleItem(const std::string &type) : _type(type), _name(type), _size(0.
 											_accuracyAuto(0), _accuracySnap(0), _accuracyAimed(0), _tuAuto(0), _tuSnap(0), _tuAimed(0), _clipSize(0), _accuracyMelee(0), _tuMelee(0),
 											_battleType(BT_NONE), _twoHanded(false), _waypoint(false), _fixedWeapon(false), _invWidth(1), _invHeight(1),
 											_painKiller(0), _heal(0), _stimulant(0), _healAmount(0), _healthAmount(0), _stun(0), _energy(0), _tuUse(0), _recoveryPoints(0), _armor(20), _turretType(-1),
-											_recover(true), _liveAlien(false), _blastRadius(-1), _attraction(0), _flatRate(false), _arcingShot(false), _listOrder(0), _range(0), _bulletSpeed(0)
+											_recover(true), _liveAlien(false), _blastRadius(-1), _attraction(0), _flatRate(false), _arcingShot(false), _listOrder(0), _range(0), _bulletSpeed(0), _handle(StringId::intern(type))
 {
 }
 
@@ -372,6 +374,15 @@ std::string RuleItem::getType() const
 	return _type;
 }
 
+/**
+ * Returns the handle of the item type, for quick lookups.
+ * @return Item handle.
+ */
+int RuleItem::getHandle() const
+{
+	return _handle;
+}
+
 /**
  * Returns the language string that names
  * this item. This is not necessarily unique.
@@ -884,4 +895,39 @@ int RuleItem::getBulletSpeed() const
 	return _bulletSpeed;
 }
 
+/**
+ * Loads the item data from the ruleset cache.
+ * @param in Ruleset cache.
+ */
+void RuleItem::loadCache(CacheReader &in)
+{
+	in >> _type >> _name >> _requires >> _size >> _costBuy >> _costSell >> _transferTime >> _weight;
+	in >> _bigSprite >> _floorSprite >> _handSprite >> _bulletSprite >> _fireSound >> _hitSound >> _hitAnimation >> _power >> _compatibleAmmo;
+	int damageType, battleType;
+	in >> damageType;
+	_damageType = (ItemDamageType)damageType;
+	in >> _accuracyAuto >> _accuracySnap >> _accuracyAimed >> _tuAuto >> _tuSnap >> _tuAimed >> _clipSize >> _accuracyMelee >> _tuMelee;
+	in >> battleType;
+	_battleType = (BattleType)battleType;
+	in >> _twoHanded >> _waypoint >> _fixedWeapon >> _invWidth >> _invHeight >> _painKiller >> _heal >> _stimulant >> _healAmount >> _healthAmount;
+	in >> _stun >> _energy >> _tuUse >> _recoveryPoints >> _armor >> _turretType >> _recover >> _liveAlien >> _blastRadius >> _attraction;
+	in >> _flatRate >> _arcingShot >> _listOrder >> _range >> _bulletSpeed;
+}
+
+/**
+ * Saves the item data to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void RuleItem::saveCache(CacheWriter &out) const
+{
+	out << _type << _name << _requires << _size << _costBuy << _costSell << _transferTime << _weight;
+	out << _bigSprite << _floorSprite << _handSprite << _bulletSprite << _fireSound << _hitSound << _hitAnimation << _power << _compatibleAmmo;
+	out << (int)_damageType;
+	out << _accuracyAuto << _accuracySnap << _accuracyAimed << _tuAuto << _tuSnap << _tuAimed << _clipSize << _accuracyMelee << _tuMelee;
+	out << (int)_battleType;
+	out << _twoHanded << _waypoint << _fixedWeapon << _invWidth << _invHeight << _painKiller << _heal << _stimulant << _healAmount << _healthAmount;
+	out << _stun << _energy << _tuUse << _recoveryPoints << _armor << _turretType << _recover << _liveAlien << _blastRadius << _attraction;
+	out << _flatRate << _arcingShot << _listOrder << _range << _bulletSpeed;
+}
+
 }
@@ -29,6 +29,8 @@ enum BattleType { BT_NONE, BT_FIREARM, BT_AMMO, BT_MELEE, BT_GRENADE, BT_PROXIMI
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
 class SurfaceSet;
 class Surface;
 class RuleManufacture;
@@ -67,6 +69,7 @@ private:
 	int _blastRadius, _attraction;
 	bool _flatRate, _arcingShot;
 	int _listOrder, _range, _bulletSpeed;
+	int _handle;
 public:
 	/// Creates a blank item ruleset.
 	RuleItem(const std::string &type);
@@ -76,8 +79,14 @@ public:
 	void load(const YAML::Node& node, int modIndex, int listIndex);
 	/// Saves the item data to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the item data from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Saves the item data to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Gets the item's type.
 	std::string getType() const;
+	/// Gets the item's handle.
+	int getHandle() const;
 	/// Gets the item's name.
 	std::string getName() const;
 	/// Gets the item's requirements.
@@ -17,6 +17,9 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "RuleManufacture.h"
+#include "RulesetCache.h"
+#include "RuleResearch.h"
+#include "Ruleset.h"
 
 namespace OpenXcom
 {
@@ -123,6 +126,42 @@ const std::vector<std::string> &RuleManufacture::getRequirements() const
 	return _requires;
 }
 
+/**
+ * Gets the IDs of the research required to manufacture this object.
+ * @return A list of research IDs.
+ */
+const std::vector<int> &RuleManufacture::getRequirementIds() const
+{
+	return _requireIds;
+}
+
+/**
+ * Converts the required research to IDs, and registers this
+ * manufacture with every research it requires.
+ * Unknown research becomes -1, which is never discovered.
+ * @param ruleset Pointer to the ruleset.
+ */
+void RuleManufacture::resolve(const Ruleset *ruleset)
+{
+	_requireIds.clear();
+	for (std::vector<std::string>::const_iterator i = _requires.begin(); i != _requires.end(); ++i)
+	{
+		RuleResearch *research = ruleset->getResearch(*i);
+		if (research)
+		{
+			_requireIds.push_back(research->getId());
+			if (research->getManufacture().empty() || research->getManufacture().back() != this)
+			{
+				research->addManufacture(this);
+			}
+		}
+		else
+		{
+			_requireIds.push_back(-1);
+		}
+	}
+}
+
 /**
  * Get the required workspace
  * @return the required workspace to start production
@@ -167,4 +206,23 @@ int RuleManufacture::getListOrder() const
 {
 	return _listOrder;
 }
+
+/**
+ * Loads the manufacture from the ruleset cache.
+ * @param in Ruleset cache.
+ */
+void RuleManufacture::loadCache(CacheReader &in)
+{
+	in >> _name >> _category >> _requires >> _space >> _time >> _cost >> _requiredItems >> _listOrder;
+}
+
+/**
+ * Saves the manufacture to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void RuleManufacture::saveCache(CacheWriter &out) const
+{
+	out << _name << _category << _requires << _space << _time << _cost << _requiredItems << _listOrder;
+}
+
 }
@@ -25,6 +25,11 @@
 
 namespace OpenXcom
 {
+
+class CacheReader;
+class CacheWriter;
+class Ruleset;
+
 /**
  * Represents information needed to manufacture an object
 */
@@ -33,6 +38,7 @@ class RuleManufacture
 private:
 	std::string _name, _category;
 	std::vector<std::string> _requires;
+	std::vector<int> _requireIds;
 	int _space, _time, _cost;
 	std::map<std::string, int> _requiredItems;
 	int _listOrder;
@@ -43,12 +49,20 @@ public:
 	void load(const YAML::Node& node, int listOrder);
 	/// Saves the manufacture to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the manufacture from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Saves the manufacture to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	///Get the manufacture name
 	std::string getName () const;
 	///Get the manufacture category
 	std::string getCategory () const;
 	/// Gets the manufacture's requirements.
 	const std::vector<std::string> &getRequirements () const;
+	/// Gets the IDs of the manufacture's requirements.
+	const std::vector<int> &getRequirementIds () const;
+	/// Links the manufacture to the research tree.
+	void resolve(const Ruleset *ruleset);
 	///Get the required workshop space
 	int getRequiredSpace () const;
 	///Get the time required to manufacture one object
@@ -19,6 +19,7 @@
 #define _USE_MATH_DEFINES
 #include <assert.h>
 #include "RuleRegion.h"
+#include "RulesetCache.h"
 #include "City.h"
 #include "../Engine/Exception.h"
 #include "../Engine/RNG.h"
@@ -291,4 +292,67 @@ std::pair<double, double> RuleRegion::getRandomPoint(unsigned zone) const
 	return std::make_pair(0.0, 0.0);
 }
 
+/// Write a MissionArea to the ruleset cache.
+CacheWriter &operator<<(CacheWriter &out, const MissionArea &ma)
+{
+	out << ma.lonMin << ma.lonMax << ma.latMin << ma.latMax;
+	return out;
+}
+
+/// Read a MissionArea from the ruleset cache.
+CacheReader &operator>>(CacheReader &in, MissionArea &ma)
+{
+	in >> ma.lonMin >> ma.lonMax >> ma.latMin >> ma.latMax;
+	return in;
+}
+
+/// Write a MissionZone to the ruleset cache.
+CacheWriter &operator<<(CacheWriter &out, const MissionZone &mz)
+{
+	out << mz.areas;
+	return out;
+}
+
+/// Read a MissionZone from the ruleset cache.
+CacheReader &operator>>(CacheReader &in, MissionZone &mz)
+{
+	in >> mz.areas;
+	return in;
+}
+
+/**
+ * Loads the region from the ruleset cache.
+ * @param in Ruleset cache.
+ */
+void RuleRegion::loadCache(CacheReader &in)
+{
+	in >> _type >> _cost >> _lonMin >> _lonMax >> _latMin >> _latMax;
+	unsigned int cities;
+	in >> cities;
+	for (unsigned int i = 0; i < cities; ++i)
+	{
+		City *city = new City("", 0.0, 0.0);
+		city->loadCache(in);
+		_cities.push_back(city);
+	}
+	_missionWeights.loadCache(in);
+	in >> _regionWeight >> _missionZones >> _missionRegion;
+}
+
+/**
+ * Saves the region to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void RuleRegion::saveCache(CacheWriter &out) const
+{
+	out << _type << _cost << _lonMin << _lonMax << _latMin << _latMax;
+	out << (unsigned int)_cities.size();
+	for (std::vector<City*>::const_iterator i = _cities.begin(); i != _cities.end(); ++i)
+	{
+		(*i)->saveCache(out);
+	}
+	_missionWeights.saveCache(out);
+	out << _regionWeight << _missionZones << _missionRegion;
+}
+
 }
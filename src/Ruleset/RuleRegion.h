@@ -27,6 +27,8 @@
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
 class City;
 struct MissionZone;
 
@@ -56,6 +58,10 @@ public:
 	void load(const YAML::Node& node);
 	/// Saves the region to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the region from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Saves the region to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Gets the region's type.
 	std::string getType() const;
 	/// Gets the region's base cost.
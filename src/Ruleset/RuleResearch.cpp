@@ -17,11 +17,14 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "RuleResearch.h"
+#include "RulesetCache.h"
+#include <algorithm>
+#include "Ruleset.h"
 
 namespace OpenXcom
 {
 
-RuleResearch::RuleResearch(const std::string & name) : _name(name), _lookup(""), _cost(0), _points(0), _getOneFree(0), _requires(0), _needItem(false), _listOrder(0)
+RuleResearch::RuleResearch(const std::string & name) : _name(name), _lookup(""), _cost(0), _points(0), _getOneFree(0), _requires(0), _needItem(false), _listOrder(0), _id(-1)
 {
 }
 
@@ -187,4 +190,159 @@ int RuleResearch::getListOrder() const
 	return _listOrder;
 }
 
+/**
+ * Gets the ID of this research, which is its position in the sorted research list.
+ * @return Research ID, or -1 if the ruleset hasn't been sorted yet.
+ */
+int RuleResearch::getId() const
+{
+	return _id;
+}
+
+/**
+ * Sets the ID of this research.
+ * @param id Research ID.
+ */
+void RuleResearch::setId(int id)
+{
+	_id = id;
+}
+
+/**
+ * Converts a list of research names to their IDs.
+ * Unknown research becomes -1, which is never discovered.
+ * @param names Research names.
+ * @param ids Vector to fill with IDs.
+ * @param ruleset Pointer to the ruleset.
+ */
+void RuleResearch::resolveNames(const std::vector<std::string> &names, std::vector<int> &ids, const Ruleset *ruleset)
+{
+	ids.clear();
+	for (std::vector<std::string>::const_iterator i = names.begin(); i != names.end(); ++i)
+	{
+		RuleResearch *research = ruleset->getResearch(*i);
+		ids.push_back(research ? research->getId() : -1);
+	}
+}
+
+/**
+ * Converts all the research names to IDs, and registers this
+ * research with every research it depends on or unlocks, so the
+ * tree can also be walked the other way. Every research must
+ * have its ID set before this is called.
+ * @param ruleset Pointer to the ruleset.
+ */
+void RuleResearch::resolve(const Ruleset *ruleset)
+{
+	resolveNames(_dependencies, _dependencyIds, ruleset);
+	resolveNames(_unlocks, _unlockIds, ruleset);
+	resolveNames(_getOneFree, _getOneFreeIds, ruleset);
+	resolveNames(_requires, _requireIds, ruleset);
+
+	std::vector<int> related = _dependencyIds;
+	related.insert(related.end(), _unlockIds.begin(), _unlockIds.end());
+	std::sort(related.begin(), related.end());
+	related.erase(std::unique(related.begin(), related.end()), related.end());
+	for (std::vector<int>::const_iterator i = related.begin(); i != related.end(); ++i)
+	{
+		if (*i != -1)
+		{
+			ruleset->getResearch(*i)->addDependent(_id);
+		}
+	}
+}
+
+/**
+ * Adds a research that has this one as a dependency or unlock.
+ * @param id Research ID.
+ */
+void RuleResearch::addDependent(int id)
+{
+	_dependents.push_back(id);
+}
+
+/**
+ * Adds a manufacture that has this research as a requirement.
+ * @param manufacture Pointer to the manufacture rules.
+ */
+void RuleResearch::addManufacture(RuleManufacture *manufacture)
+{
+	_manufacture.push_back(manufacture);
+}
+
+/**
+ * Gets the IDs of the research dependencies.
+ * @return List of research IDs.
+ */
+const std::vector<int> &RuleResearch::getDependencyIds() const
+{
+	return _dependencyIds;
+}
+
+/**
+ * Gets the IDs of the research unlocked by this research.
+ * @return List of research IDs.
+ */
+const std::vector<int> &RuleResearch::getUnlockIds() const
+{
+	return _unlockIds;
+}
+
+/**
+ * Gets the IDs of the research granted at random for free by this research.
+ * @return List of research IDs.
+ */
+const std::vector<int> &RuleResearch::getGetOneFreeIds() const
+{
+	return _getOneFreeIds;
+}
+
+/**
+ * Gets the IDs of the research required to start this research.
+ * @return List of research IDs.
+ */
+const std::vector<int> &RuleResearch::getRequirementIds() const
+{
+	return _requireIds;
+}
+
+/**
+ * Gets the IDs of the research which have this one as a dependency or unlock,
+ * in list order.
+ * @return List of research IDs.
+ */
+const std::vector<int> &RuleResearch::getDependents() const
+{
+	return _dependents;
+}
+
+/**
+ * Gets the manufacture which have this research as a requirement, in list order.
+ * @return List of manufacture rules.
+ */
+const std::vector<RuleManufacture*> &RuleResearch::getManufacture() const
+{
+	return _manufacture;
+}
+
+/**
+ * Loads the research from the ruleset cache.
+ * @param in Ruleset cache.
+ */
+void RuleResearch::loadCache(CacheReader &in)
+{
+	in >> _name >> _lookup >> _cost >> _points >> _dependencies >> _unlocks;
+	in >> _getOneFree >> _requires >> _needItem >> _listOrder;
+}
+
+/**
+ * Saves the research to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void RuleResearch::saveCache(CacheWriter &out) const
+{
+	out << _name << _lookup << _cost << _points << _dependencies << _unlocks;
+	out << _getOneFree << _requires << _needItem << _listOrder;
+}
+
 }
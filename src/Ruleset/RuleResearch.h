@@ -25,6 +25,12 @@
 
 namespace OpenXcom
 {
+
+class CacheReader;
+class CacheWriter;
+class Ruleset;
+class RuleManufacture;
+
 /**
    Represent one research project.
    Dependency and unlock. Dependency is the list of RuleResearch which must be discovered before a RuleResearch became available. Unlock  are used to immediately unlock a RuleResearch(even if not all dependency have been researched).
@@ -43,12 +49,21 @@ class RuleResearch
 	std::vector<std::string> _dependencies, _unlocks, _getOneFree, _requires;
 	bool _needItem;
 	int _listOrder;
+	int _id;
+	std::vector<int> _dependencyIds, _unlockIds, _getOneFreeIds, _requireIds, _dependents;
+	std::vector<RuleManufacture*> _manufacture;
+	/// Converts a list of research names to IDs.
+	static void resolveNames(const std::vector<std::string> &names, std::vector<int> &ids, const Ruleset *ruleset);
 public:
 	RuleResearch(const std::string & name);
 	/// Loads the research from YAML.
 	void load(const YAML::Node& node, int listOrder);
 	/// Saves the research to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the research from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Saves the research to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Get time needed to discover this ResearchProject
 	int getCost() const;
 	/// Get the research name
@@ -69,6 +84,28 @@ public:
 	const std::vector<std::string> & getRequirements() const;
 	/// get the list weight for this research item.
 	int getListOrder() const;
+	/// Gets the research ID.
+	int getId() const;
+	/// Sets the research ID.
+	void setId(int id);
+	/// Links the research to the rest of the research tree.
+	void resolve(const Ruleset *ruleset);
+	/// Adds a research that depends on or is unlocked along with this one.
+	void addDependent(int id);
+	/// Adds a manufacture that requires this research.
+	void addManufacture(RuleManufacture *manufacture);
+	/// Gets the IDs of the research dependencies.
+	const std::vector<int> &getDependencyIds() const;
+	/// Gets the IDs of the unlocked research.
+	const std::vector<int> &getUnlockIds() const;
+	/// Gets the IDs of the research granted for free.
+	const std::vector<int> &getGetOneFreeIds() const;
+	/// Gets the IDs of the required research.
+	const std::vector<int> &getRequirementIds() const;
+	/// Gets the IDs of the research that refer to this one.
+	const std::vector<int> &getDependents() const;
+	/// Gets the manufacture that requires this research.
+	const std::vector<RuleManufacture*> &getManufacture() const;
 };
 }
 
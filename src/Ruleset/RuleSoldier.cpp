@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "RuleSoldier.h"
+#include "RulesetCache.h"
 
 namespace OpenXcom
 {
@@ -148,4 +149,22 @@ std::string RuleSoldier::getArmor() const
 	return _armor;
 }
 
+/**
+ * Loads the unit data from the ruleset cache.
+ * @param in Ruleset cache.
+ */
+void RuleSoldier::loadCache(CacheReader &in)
+{
+	in >> _type >> _minStats >> _maxStats >> _statCaps >> _armor >> _standHeight >> _kneelHeight >> _floatHeight;
+}
+
+/**
+ * Saves the unit data to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void RuleSoldier::saveCache(CacheWriter &out) const
+{
+	out << _type << _minStats << _maxStats << _statCaps << _armor << _standHeight << _kneelHeight << _floatHeight;
+}
+
 }
@@ -25,6 +25,9 @@
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
+
 /**
  * Represents the creation data for a specific type of unit.
  * This info is copied to either Soldier for x-com soldiers or BattleUnit for aliens and civilians.
@@ -46,6 +49,10 @@ public:
 	void load(const YAML::Node& node);
 	/// Saves the unit data to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the unit data from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Saves the unit data to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Gets the unit's type.
 	std::string getType() const;
 	/// Get the minimum stats for the random stats generator.
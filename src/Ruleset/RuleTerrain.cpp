@@ -18,6 +18,7 @@
  */
 
 #include "RuleTerrain.h"
+#include "RulesetCache.h"
 #include "MapBlock.h"
 #include "MapDataSet.h"
 #include "../Engine/RNG.h"
@@ -258,5 +259,46 @@ int RuleTerrain::getHemisphere() const
 	return _hemisphere;
 }
 
+/**
+ * Loads the terrain from the ruleset cache.
+ * @param in Ruleset cache.
+ * @param ruleset Ruleset the map data sets come from.
+ */
+void RuleTerrain::loadCache(CacheReader &in, Ruleset *ruleset)
+{
+	std::vector<std::string> mapDataSets;
+	unsigned int mapBlocks;
+	in >> mapDataSets >> mapBlocks;
+	for (std::vector<std::string>::const_iterator i = mapDataSets.begin(); i != mapDataSets.end(); ++i)
+	{
+		_mapDataSets.push_back(ruleset->getMapDataSet(*i));
+	}
+	for (unsigned int i = 0; i < mapBlocks; ++i)
+	{
+		MapBlock *map = new MapBlock(this, "", 0, 0, MT_DEFAULT);
+		map->loadCache(in);
+		_mapBlocks.push_back(map);
+	}
+	in >> _name >> _largeBlockLimit >> _textures >> _hemisphere;
+}
+
+/**
+ * Saves the terrain to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void RuleTerrain::saveCache(CacheWriter &out) const
+{
+	out << (unsigned int)_mapDataSets.size();
+	for (std::vector<MapDataSet*>::const_iterator i = _mapDataSets.begin(); i != _mapDataSets.end(); ++i)
+	{
+		out << (*i)->getName();
+	}
+	out << (unsigned int)_mapBlocks.size();
+	for (std::vector<MapBlock*>::const_iterator i = _mapBlocks.begin(); i != _mapBlocks.end(); ++i)
+	{
+		(*i)->saveCache(out);
+	}
+	out << _name << _largeBlockLimit << _textures << _hemisphere;
+}
 
 }
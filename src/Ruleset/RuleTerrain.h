@@ -27,6 +27,8 @@
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
 class MapBlock;
 class MapDataSet;
 class MapData;
@@ -54,6 +56,10 @@ public:
 	void load(const YAML::Node& node, Ruleset *ruleset);
 	/// Saves the terrain to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the terrain from the ruleset cache.
+	void loadCache(CacheReader &in, Ruleset *ruleset);
+	/// Saves the terrain to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Gets the terrain's name (used for MAP generation).
 	std::string getName() const;
 	/// Gets the terrain's mapblocks.
@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "RuleUfo.h"
+#include "RulesetCache.h"
 #include "RuleTerrain.h"
 
 namespace OpenXcom
@@ -291,4 +292,37 @@ std::string RuleUfo::getModSprite() const
 	return _modSprite;
 }
 
-}
\ No newline at end of file
+/**
+ * Loads the UFO data from the ruleset cache.
+ * @param in Ruleset cache.
+ * @param ruleset Ruleset the map data sets come from.
+ */
+void RuleUfo::loadCache(CacheReader &in, Ruleset *ruleset)
+{
+	in >> _type >> _size >> _sprite >> _damageMax >> _speedMax >> _accel >> _power >> _range >> _score >> _reload >> _breakOffTime;
+	bool terrain;
+	in >> terrain;
+	if (terrain)
+	{
+		_battlescapeTerrainData = new RuleTerrain("");
+		_battlescapeTerrainData->loadCache(in, ruleset);
+	}
+	in >> _modSprite;
+}
+
+/**
+ * Saves the UFO data to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void RuleUfo::saveCache(CacheWriter &out) const
+{
+	out << _type << _size << _sprite << _damageMax << _speedMax << _accel << _power << _range << _score << _reload << _breakOffTime;
+	out << (_battlescapeTerrainData != 0);
+	if (_battlescapeTerrainData != 0)
+	{
+		_battlescapeTerrainData->saveCache(out);
+	}
+	out << _modSprite;
+}
+
+}
@@ -25,6 +25,8 @@
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
 class RuleTerrain;
 class Ruleset;
 
@@ -52,6 +54,10 @@ public:
 	void load(const YAML::Node& node, Ruleset *ruleset);
 	/// Saves the UFO data to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the UFO data from the ruleset cache.
+	void loadCache(CacheReader &in, Ruleset *ruleset);
+	/// Saves the UFO data to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Gets the UFO's type.
 	std::string getType() const;
 	/// Gets the UFO's size.
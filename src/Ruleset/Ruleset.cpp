@@ -58,7 +58,11 @@
 #include "City.h"
 #include "MCDPatch.h"
 #include "../Engine/Logger.h"
+#include "RulesetCache.h"
+#include "../version.h"
 #include <algorithm>
+#include <iterator>
+#include <sstream>
 
 namespace OpenXcom
 {
@@ -195,11 +199,11 @@ Ruleset::~Ruleset()
  */
 void Ruleset::load(const std::string &source)
 {
-	std::string dirname = CrossPlatform::getDataFolder("Ruleset/" + source + '/');
-	if (!CrossPlatform::folderExists(dirname))
-		loadFile(CrossPlatform::getDataFile("Ruleset/" + source + ".rul"));
-	else
-		loadFiles(dirname);
+	std::vector<std::string> files = getSourceFiles(source);
+	for (std::vector<std::string>::iterator i = files.begin(); i != files.end(); ++i)
+	{
+		loadFile(*i);
+	}
 }
 
 /**
@@ -340,6 +344,11 @@ void Ruleset::loadFile(const std::string &filename)
 					rule = new RuleItem(type);
 					_items[type] = rule;
 					_itemsIndex.push_back(type);
+					if ((size_t)rule->getHandle() >= _itemsByHandle.size())
+					{
+						_itemsByHandle.resize(rule->getHandle() + 1, 0);
+					}
+					_itemsByHandle[rule->getHandle()] = rule;
 				}
 				_itemListOrder += 100;
 				rule->load(*j, _modIndex, _itemListOrder);
@@ -720,17 +729,28 @@ void Ruleset::loadFile(const std::string &filename)
 }
 
 /**
- * Load the contents of all rule files in the given directory.
- * @param dirname The name of an existing directory containing rule files.
+ * Returns the rule files that a source is loaded from, which
+ * are either a single file or all the files in a directory.
+ * @param source The source to use.
+ * @return Full paths to the rule files, in loading order.
  */
-void Ruleset::loadFiles(const std::string &dirname)
+std::vector<std::string> Ruleset::getSourceFiles(const std::string &source)
 {
-	std::vector<std::string> names = CrossPlatform::getFolderContents(dirname, "rul");
-
-	for (std::vector<std::string>::iterator i = names.begin(); i != names.end(); ++i)
+	std::vector<std::string> files;
+	std::string dirname = CrossPlatform::getDataFolder("Ruleset/" + source + '/');
+	if (!CrossPlatform::folderExists(dirname))
+	{
+		files.push_back(CrossPlatform::getDataFile("Ruleset/" + source + ".rul"));
+	}
+	else
 	{
-		loadFile(dirname + *i);
+		std::vector<std::string> names = CrossPlatform::getFolderContents(dirname, "rul");
+		for (std::vector<std::string>::iterator i = names.begin(); i != names.end(); ++i)
+		{
+			files.push_back(dirname + *i);
+		}
 	}
+	return files;
 }
 
 /**
@@ -747,7 +767,18 @@ void Ruleset::save(const std::string &filename) const
 	}
 
 	YAML::Emitter out;
+	save(out);
+	sav << out.c_str();
+	sav.close();
+}
 
+/**
+ * Saves a ruleset's contents to a YAML emitter,
+ * using each rule's own YAML save.
+ * @param out YAML emitter.
+ */
+void Ruleset::save(YAML::Emitter &out) const
+{
 	out << YAML::BeginMap;
 	out << YAML::Key << "countries" << YAML::Value;
 	out << YAML::BeginSeq;
@@ -896,8 +927,6 @@ void Ruleset::save(const std::string &filename) const
 	out << YAML::Key << "costScientist" << YAML::Value << _costScientist;
 	out << YAML::Key << "timePersonnel" << YAML::Value << _timePersonnel;
 	out << YAML::EndMap;
-	sav << out.c_str();
-	sav.close();
 }
 
 /**
@@ -1102,6 +1131,18 @@ RuleItem *Ruleset::getItem(const std::string &id) const
 		return 0;
 }
 
+/**
+ * Returns the rules for the item type with the specified handle.
+ * @param handle Item handle (see StringId).
+ * @return Rules for the item, or 0 if the handle isn't an item.
+ */
+RuleItem *Ruleset::getItem(int handle) const
+{
+	if (handle < 0 || (size_t)handle >= _itemsByHandle.size())
+		return 0;
+	return _itemsByHandle[handle];
+}
+
 /**
  * Returns the list of all items
  * provided by the ruleset.
@@ -1360,6 +1401,17 @@ const std::vector<std::string> &Ruleset::getResearchList () const
 	return _researchIndex;
 }
 
+/**
+ * Returns the rules for the research project with the specified ID.
+ * IDs follow the order of the research list.
+ * @param id Research project ID.
+ * @return Rules for the research project.
+ */
+RuleResearch *Ruleset::getResearch (int id) const
+{
+	return _researchById.at(id);
+}
+
 /**
  * Returns the rules for the specified manufacture project.
  * @param id Manufacture project type.
@@ -1670,4 +1722,575 @@ void Ruleset::sortLists()
 	list.clear();
 	offset = 0;
 }
+
+/**
+ * Gives every research project an ID based on its place in the research list,
+ * and converts all the references between research and manufacture to IDs,
+ * so availability can be checked without looking up names.
+ * Must be called after the lists are sorted.
+ */
+void Ruleset::resolveResearch()
+{
+	_researchById.clear();
+	for (std::vector<std::string>::const_iterator i = _researchIndex.begin(); i != _researchIndex.end(); ++i)
+	{
+		RuleResearch *research = getResearch(*i);
+		research->setId(_researchById.size());
+		_researchById.push_back(research);
+	}
+	for (std::vector<RuleResearch *>::const_iterator i = _researchById.begin(); i != _researchById.end(); ++i)
+	{
+		(*i)->resolve(this);
+	}
+	for (std::vector<std::string>::const_iterator i = _manufactureIndex.begin(); i != _manufactureIndex.end(); ++i)
+	{
+		getManufacture(*i)->resolve(this);
+	}
+}
+
+/**
+ * Sorts the regions and countries into grids by the bounds of
+ * their areas, so finding which one contains a point only needs
+ * to check the ones near it. Must be called after the lists are sorted.
+ */
+void Ruleset::indexZones()
+{
+	_regionsById.clear();
+	_regionGrid.clear();
+	for (std::vector<std::string>::const_iterator i = _regionsIndex.begin(); i != _regionsIndex.end(); ++i)
+	{
+		RuleRegion *region = getRegion(*i);
+		for (size_t j = 0; j < region->getLonMin().size(); ++j)
+		{
+			_regionGrid.add(_regionsById.size(), region->getLonMin()[j], region->getLonMax()[j], region->getLatMin()[j], region->getLatMax()[j]);
+		}
+		_regionsById.push_back(region);
+	}
+	_countriesById.clear();
+	_countryGrid.clear();
+	for (std::vector<std::string>::const_iterator i = _countriesIndex.begin(); i != _countriesIndex.end(); ++i)
+	{
+		RuleCountry *country = getCountry(*i);
+		for (size_t j = 0; j < country->getLonMin().size(); ++j)
+		{
+			_countryGrid.add(_countriesById.size(), country->getLonMin()[j], country->getLonMax()[j], country->getLatMin()[j], country->getLatMax()[j]);
+		}
+		_countriesById.push_back(country);
+	}
+}
+
+/**
+ * Finds the region containing a point. If regions
+ * overlap, the first one in the list is returned.
+ * @param lon Longitude of the point.
+ * @param lat Latitude of the point.
+ * @return Pointer to the region rules, or 0 if it's in no region.
+ */
+RuleRegion *Ruleset::locateRegion(double lon, double lat) const
+{
+	const std::vector<int> *nearby = _regionGrid.find(lon, lat);
+	if (nearby != 0)
+	{
+		for (std::vector<int>::const_iterator i = nearby->begin(); i != nearby->end(); ++i)
+		{
+			if (_regionsById[*i]->insideRegion(lon, lat))
+				return _regionsById[*i];
+		}
+		return 0;
+	}
+	for (std::vector<std::string>::const_iterator i = _regionsIndex.begin(); i != _regionsIndex.end(); ++i)
+	{
+		RuleRegion *region = getRegion(*i);
+		if (region->insideRegion(lon, lat))
+			return region;
+	}
+	return 0;
+}
+
+/**
+ * Finds the country containing a point. If countries
+ * overlap, the first one in the list is returned.
+ * @param lon Longitude of the point.
+ * @param lat Latitude of the point.
+ * @return Pointer to the country rules, or 0 if it's in no country.
+ */
+RuleCountry *Ruleset::locateCountry(double lon, double lat) const
+{
+	const std::vector<int> *nearby = _countryGrid.find(lon, lat);
+	if (nearby != 0)
+	{
+		for (std::vector<int>::const_iterator i = nearby->begin(); i != nearby->end(); ++i)
+		{
+			if (_countriesById[*i]->insideCountry(lon, lat))
+				return _countriesById[*i];
+		}
+		return 0;
+	}
+	for (std::vector<std::string>::const_iterator i = _countriesIndex.begin(); i != _countriesIndex.end(); ++i)
+	{
+		RuleCountry *country = getCountry(*i);
+		if (country->insideCountry(lon, lat))
+			return country;
+	}
+	return 0;
+}
+
+/// Version of the ruleset cache layout, bump it when any rule's saveCache() changes.
+const unsigned int CACHE_VERSION = 1;
+const char CACHE_MAGIC[4] = {'O', 'X', 'R', 'C'};
+
+/// Creates a blank rule of a certain type, for the cache to fill in.
+template <typename T>
+T *createRule(const std::string &type)
+{
+	return new T(type);
+}
+
+template <>
+Armor *createRule<Armor>(const std::string &type)
+{
+	return new Armor(type, "", 0);
+}
+
+template <>
+Unit *createRule<Unit>(const std::string &type)
+{
+	return new Unit(type, "", "");
+}
+
+template <>
+UfoTrajectory *createRule<UfoTrajectory>(const std::string &)
+{
+	return new UfoTrajectory();
+}
+
+template <>
+RuleAlienMission *createRule<RuleAlienMission>(const std::string &)
+{
+	return new RuleAlienMission();
+}
+
+template <>
+MCDPatch *createRule<MCDPatch>(const std::string &)
+{
+	return new MCDPatch();
+}
+
+template <>
+ExtraSprites *createRule<ExtraSprites>(const std::string &)
+{
+	return new ExtraSprites();
+}
+
+template <>
+ExtraSounds *createRule<ExtraSounds>(const std::string &)
+{
+	return new ExtraSounds();
+}
+
+template <>
+ExtraStrings *createRule<ExtraStrings>(const std::string &)
+{
+	return new ExtraStrings();
+}
+
+/// Gets the types of a set of rules in the order they're cached.
+template <typename T>
+std::vector<std::string> getRuleTypes(const std::map<std::string, T*> &rules)
+{
+	std::vector<std::string> types;
+	for (typename std::map<std::string, T*>::const_iterator i = rules.begin(); i != rules.end(); ++i)
+	{
+		types.push_back(i->first);
+	}
+	return types;
+}
+
+/// Writes a set of rules to the ruleset cache, in the order of their index.
+template <typename T>
+void saveRules(CacheWriter &out, const std::map<std::string, T*> &rules, const std::vector<std::string> &index)
+{
+	out << (unsigned int)index.size();
+	for (std::vector<std::string>::const_iterator i = index.begin(); i != index.end(); ++i)
+	{
+		out << *i;
+		rules.find(*i)->second->saveCache(out);
+	}
+}
+
+/// Reads a set of rules from the ruleset cache, rebuilding their index.
+template <typename T>
+void loadRules(CacheReader &in, std::map<std::string, T*> &rules, std::vector<std::string> *index)
+{
+	unsigned int size;
+	in >> size;
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		std::string type;
+		in >> type;
+		std::auto_ptr<T> rule(createRule<T>(type));
+		rule->loadCache(in);
+		rules[type] = rule.release();
+		if (index != 0)
+		{
+			index->push_back(type);
+		}
+	}
+}
+
+/// Reads a set of rules that refer to map data sets from the ruleset cache.
+template <typename T>
+void loadRules(CacheReader &in, std::map<std::string, T*> &rules, std::vector<std::string> *index, Ruleset *ruleset)
+{
+	unsigned int size;
+	in >> size;
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		std::string type;
+		in >> type;
+		std::auto_ptr<T> rule(createRule<T>(type));
+		rule->loadCache(in, ruleset);
+		rules[type] = rule.release();
+		index->push_back(type);
+	}
+}
+
+/// Writes a list of external resources to the ruleset cache.
+template <typename T>
+void saveExtras(CacheWriter &out, const std::vector<std::pair<std::string, T*> > &extras)
+{
+	out << (unsigned int)extras.size();
+	for (typename std::vector<std::pair<std::string, T*> >::const_iterator i = extras.begin(); i != extras.end(); ++i)
+	{
+		out << i->first;
+		i->second->saveCache(out);
+	}
+}
+
+/// Reads a list of external resources from the ruleset cache.
+template <typename T>
+void loadExtras(CacheReader &in, std::vector<std::pair<std::string, T*> > &extras, std::vector<std::string> &index)
+{
+	unsigned int size;
+	in >> size;
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		std::string type;
+		in >> type;
+		std::auto_ptr<T> extra(createRule<T>(type));
+		extra->loadCache(in);
+		extras.push_back(std::make_pair(type, extra.release()));
+		index.push_back(type);
+	}
+}
+
+/// Writes a YAML node to the ruleset cache as YAML text.
+void saveNode(CacheWriter &out, const std::auto_ptr<YAML::Node> &node)
+{
+	out << (node.get() != 0);
+	if (node.get() != 0)
+	{
+		YAML::Emitter emitter;
+		emitter << *node;
+		out << std::string(emitter.c_str());
+	}
+}
+
+/// Reads a YAML node from the ruleset cache.
+void loadNode(CacheReader &in, std::auto_ptr<YAML::Node> &node)
+{
+	bool exists;
+	in >> exists;
+	if (exists)
+	{
+		std::string text;
+		in >> text;
+		std::istringstream stream(text);
+		YAML::Parser parser(stream);
+		YAML::Node doc;
+		parser.GetNextDocument(doc);
+		node = doc.Clone();
+	}
+}
+
+/**
+ * Returns a key that identifies the exact ruleset files a set of
+ * sources is loaded from, including their sizes and modification
+ * times and the game version, so any change invalidates the cache.
+ * @param sources The sources to use.
+ * @return Cache key.
+ */
+std::string Ruleset::getCacheKey(const std::vector<std::string> &sources)
+{
+	std::ostringstream key;
+	key << CACHE_VERSION << ' ' << OPENXCOM_VERSION_LONG << OPENXCOM_VERSION_GIT << '\n';
+	for (std::vector<std::string>::const_iterator i = sources.begin(); i != sources.end(); ++i)
+	{
+		std::vector<std::string> files = getSourceFiles(*i);
+		for (std::vector<std::string>::const_iterator j = files.begin(); j != files.end(); ++j)
+		{
+			unsigned long size = 0, modified = 0;
+			CrossPlatform::getFileInfo(*j, &size, &modified);
+			key << *j << ' ' << size << ' ' << modified << '\n';
+		}
+	}
+	return key.str();
+}
+
+/**
+ * Loads all the rules from the ruleset cache, as they
+ * were after loading the YAML files they came from.
+ * @param in Ruleset cache.
+ */
+void Ruleset::loadCache(CacheReader &in)
+{
+	loadRules(in, _countries, &_countriesIndex);
+	loadRules(in, _regions, &_regionsIndex);
+	loadRules(in, _facilities, &_facilitiesIndex);
+	loadRules(in, _crafts, &_craftsIndex, this);
+	loadRules(in, _craftWeapons, &_craftWeaponsIndex);
+	loadRules(in, _items, &_itemsIndex);
+	for (std::map<std::string, RuleItem*>::iterator i = _items.begin(); i != _items.end(); ++i)
+	{
+		if ((size_t)i->second->getHandle() >= _itemsByHandle.size())
+		{
+			_itemsByHandle.resize(i->second->getHandle() + 1, 0);
+		}
+		_itemsByHandle[i->second->getHandle()] = i->second;
+	}
+	loadRules(in, _ufos, &_ufosIndex, this);
+	loadRules(in, _invs, 0);
+	loadRules(in, _terrains, &_terrainIndex, this);
+	loadRules(in, _armors, &_armorsIndex);
+	loadRules(in, _soldiers, 0);
+	loadRules(in, _units, 0);
+	loadRules(in, _alienRaces, &_aliensIndex);
+	loadRules(in, _alienDeployments, &_deploymentsIndex);
+	loadRules(in, _research, &_researchIndex);
+	loadRules(in, _manufacture, &_manufactureIndex);
+
+	unsigned int articles;
+	in >> articles;
+	for (unsigned int i = 0; i < articles; ++i)
+	{
+		std::string id;
+		int type;
+		in >> id >> type;
+		std::auto_ptr<ArticleDefinition> rule;
+		switch ((UfopaediaTypeId)type)
+		{
+		case UFOPAEDIA_TYPE_CRAFT: rule.reset(new ArticleDefinitionCraft()); break;
+		case UFOPAEDIA_TYPE_CRAFT_WEAPON: rule.reset(new ArticleDefinitionCraftWeapon()); break;
+		case UFOPAEDIA_TYPE_VEHICLE: rule.reset(new ArticleDefinitionVehicle()); break;
+		case UFOPAEDIA_TYPE_ITEM: rule.reset(new ArticleDefinitionItem()); break;
+		case UFOPAEDIA_TYPE_ARMOR: rule.reset(new ArticleDefinitionArmor()); break;
+		case UFOPAEDIA_TYPE_BASE_FACILITY: rule.reset(new ArticleDefinitionBaseFacility()); break;
+		case UFOPAEDIA_TYPE_TEXTIMAGE: rule.reset(new ArticleDefinitionTextImage()); break;
+		case UFOPAEDIA_TYPE_TEXT: rule.reset(new ArticleDefinitionText()); break;
+		case UFOPAEDIA_TYPE_UFO: rule.reset(new ArticleDefinitionUfo()); break;
+		default: throw Exception("Ruleset cache has an invalid article " + id);
+		}
+		rule->loadCache(in);
+		_ufopaediaArticles[id] = rule.release();
+		_ufopaediaIndex.push_back(id);
+	}
+
+	loadNode(in, _startingBase);
+	loadNode(in, _startingTime);
+	in >> _costSoldier >> _costEngineer >> _costScientist >> _timePersonnel;
+	loadRules(in, _ufoTrajectories, 0);
+	loadRules(in, _alienMissions, &_alienMissionsIndex);
+	in >> _alienItemLevels;
+	loadRules(in, _MCDPatches, &_MCDPatchesIndex);
+	loadExtras(in, _extraSprites, _extraSpritesIndex);
+	loadExtras(in, _extraSounds, _extraSoundsIndex);
+	loadRules(in, _extraStrings, &_extraStringsIndex);
+	in >> _modIndex >> _facilityListOrder >> _craftListOrder >> _itemListOrder >> _researchListOrder >> _manufactureListOrder >> _ufopaediaListOrder;
+}
+
+/**
+ * Saves all the rules to the ruleset cache. Has to be
+ * done before the lists are sorted and the research
+ * tree is linked, just like after loading the YAML files.
+ * @param out Ruleset cache.
+ */
+void Ruleset::saveCache(CacheWriter &out) const
+{
+	saveRules(out, _countries, _countriesIndex);
+	saveRules(out, _regions, _regionsIndex);
+	saveRules(out, _facilities, _facilitiesIndex);
+	saveRules(out, _crafts, _craftsIndex);
+	saveRules(out, _craftWeapons, _craftWeaponsIndex);
+	saveRules(out, _items, _itemsIndex);
+	saveRules(out, _ufos, _ufosIndex);
+	saveRules(out, _invs, getRuleTypes(_invs));
+	saveRules(out, _terrains, _terrainIndex);
+	saveRules(out, _armors, _armorsIndex);
+	saveRules(out, _soldiers, getRuleTypes(_soldiers));
+	saveRules(out, _units, getRuleTypes(_units));
+	saveRules(out, _alienRaces, _aliensIndex);
+	saveRules(out, _alienDeployments, _deploymentsIndex);
+	saveRules(out, _research, _researchIndex);
+	saveRules(out, _manufacture, _manufactureIndex);
+
+	out << (unsigned int)_ufopaediaIndex.size();
+	for (std::vector<std::string>::const_iterator i = _ufopaediaIndex.begin(); i != _ufopaediaIndex.end(); ++i)
+	{
+		ArticleDefinition *rule = _ufopaediaArticles.find(*i)->second;
+		out << *i << (int)rule->getType();
+		rule->saveCache(out);
+	}
+
+	saveNode(out, _startingBase);
+	saveNode(out, _startingTime);
+	out << _costSoldier << _costEngineer << _costScientist << _timePersonnel;
+	saveRules(out, _ufoTrajectories, getRuleTypes(_ufoTrajectories));
+	saveRules(out, _alienMissions, _alienMissionsIndex);
+	out << _alienItemLevels;
+	saveRules(out, _MCDPatches, _MCDPatchesIndex);
+	saveExtras(out, _extraSprites);
+	saveExtras(out, _extraSounds);
+	saveRules(out, _extraStrings, _extraStringsIndex);
+	out << _modIndex << _facilityListOrder << _craftListOrder << _itemListOrder << _researchListOrder << _manufactureListOrder << _ufopaediaListOrder;
+}
+
+/**
+ * Loads a blank ruleset from a cache file, if the file
+ * was saved for the same key. Throws an exception if the
+ * file matches but can't be read, which leaves the ruleset
+ * partly loaded so it has to be thrown away.
+ * @param filename Full path to the cache file.
+ * @param key Key of the ruleset files, see getCacheKey().
+ * @return True if the ruleset was loaded, False if the cache is missing or out of date.
+ */
+bool Ruleset::loadCache(const std::string &filename, const std::string &key)
+{
+	std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+	std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	file.close();
+	if (data.size() < sizeof(CACHE_MAGIC) || !std::equal(CACHE_MAGIC, CACHE_MAGIC + sizeof(CACHE_MAGIC), data.begin()))
+	{
+		return false;
+	}
+
+	CacheReader in(&data[0], data.size());
+	unsigned int version;
+	std::string oldKey;
+	in.skip(sizeof(CACHE_MAGIC));
+	in >> version;
+	if (version != CACHE_VERSION)
+	{
+		return false;
+	}
+	in >> oldKey;
+	if (oldKey != key)
+	{
+		return false;
+	}
+	loadCache(in);
+	if (!in.eof())
+	{
+		throw Exception(filename + " has unknown data at the end");
+	}
+	return true;
+}
+
+/**
+ * Saves the ruleset to a cache file, so the next run with
+ * the same key can load it without parsing the YAML files.
+ * @param filename Full path to the cache file.
+ * @param key Key of the ruleset files, see getCacheKey().
+ */
+void Ruleset::saveCache(const std::string &filename, const std::string &key) const
+{
+	CacheWriter out;
+	out.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	out << CACHE_VERSION << key;
+	saveCache(out);
+
+	std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary);
+	if (!file)
+	{
+		throw Exception("Failed to create " + filename);
+	}
+	file.write(&out.getData()[0], out.getData().size());
+	file.close();
+	if (!file)
+	{
+		throw Exception("Failed to save " + filename);
+	}
+}
+
+/**
+ * Rebuilds the cache file for a set of sources from their
+ * YAML files, or checks that the cache file on disk holds
+ * exactly the same rules as the YAML files.
+ * @param filename Full path to the cache file.
+ * @param sources The sources to use.
+ * @param verify True to only check the cache file.
+ * @return True if the cache was built or is valid.
+ */
+bool Ruleset::buildCache(const std::string &filename, const std::vector<std::string> &sources, bool verify)
+{
+	std::string key = getCacheKey(sources);
+	Ruleset yaml;
+	for (std::vector<std::string>::const_iterator i = sources.begin(); i != sources.end(); ++i)
+	{
+		yaml.load(*i);
+	}
+	if (!verify)
+	{
+		yaml.saveCache(filename, key);
+		Log(LOG_INFO) << "Ruleset cache saved to " << filename;
+		return true;
+	}
+
+	Ruleset cached;
+	if (!cached.loadCache(filename, key))
+	{
+		Log(LOG_ERROR) << "Ruleset cache " << filename << " is missing or out of date.";
+		return false;
+	}
+	// Compare through the rules' YAML saves so a field the cache
+	// drops or mangles on both ends can't hide the mismatch.
+	YAML::Emitter expected, actual;
+	yaml.save(expected);
+	cached.save(actual);
+	if (std::string(expected.c_str()) != std::string(actual.c_str()))
+	{
+		Log(LOG_ERROR) << "Ruleset cache " << filename << " doesn't match the ruleset files.";
+		return false;
+	}
+	if (yaml._countriesIndex != cached._countriesIndex || yaml._regionsIndex != cached._regionsIndex ||
+		yaml._facilitiesIndex != cached._facilitiesIndex || yaml._craftsIndex != cached._craftsIndex ||
+		yaml._craftWeaponsIndex != cached._craftWeaponsIndex || yaml._itemsIndex != cached._itemsIndex ||
+		yaml._ufosIndex != cached._ufosIndex || yaml._aliensIndex != cached._aliensIndex ||
+		yaml._deploymentsIndex != cached._deploymentsIndex || yaml._armorsIndex != cached._armorsIndex ||
+		yaml._ufopaediaIndex != cached._ufopaediaIndex || yaml._researchIndex != cached._researchIndex ||
+		yaml._manufactureIndex != cached._manufactureIndex || yaml._MCDPatchesIndex != cached._MCDPatchesIndex ||
+		yaml._alienMissionsIndex != cached._alienMissionsIndex || yaml._terrainIndex != cached._terrainIndex ||
+		yaml._extraSpritesIndex != cached._extraSpritesIndex || yaml._extraSoundsIndex != cached._extraSoundsIndex ||
+		yaml._extraStringsIndex != cached._extraStringsIndex)
+	{
+		Log(LOG_ERROR) << "Ruleset cache " << filename << " doesn't match the ruleset file order.";
+		return false;
+	}
+	// The extras and starting base have no YAML save, so they're
+	// still checked through the cache format.
+	CacheWriter expectedCache, actualCache;
+	yaml.saveCache(expectedCache);
+	cached.saveCache(actualCache);
+	if (expectedCache.getData() != actualCache.getData())
+	{
+		Log(LOG_ERROR) << "Ruleset cache " << filename << " doesn't match the ruleset files.";
+		return false;
+	}
+	Log(LOG_INFO) << "Ruleset cache " << filename << " matches the ruleset files.";
+	return true;
+}
+
 }
@@ -23,6 +23,7 @@
 #include <vector>
 #include <string>
 #include <yaml-cpp/yaml.h>
+#include "../Geoscape/GlobeGrid.h"
 
 namespace OpenXcom
 {
@@ -56,6 +57,8 @@ class MCDPatch;
 class ExtraSprites;
 class ExtraSounds;
 class ExtraStrings;
+class CacheReader;
+class CacheWriter;
 
 /**
  * Set of rules and stats for a game.
@@ -73,6 +76,7 @@ protected:
 	std::map<std::string, RuleCraft*> _crafts;
 	std::map<std::string, RuleCraftWeapon*> _craftWeapons;
 	std::map<std::string, RuleItem*> _items;
+	std::vector<RuleItem*> _itemsByHandle;
 	std::map<std::string, RuleUfo*> _ufos;
 	std::map<std::string, RuleTerrain*> _terrains;
 	std::map<std::string, MapDataSet*> _mapDataSets;
@@ -84,6 +88,7 @@ protected:
 	std::map<std::string, ArticleDefinition*> _ufopaediaArticles;
 	std::map<std::string, RuleInventory*> _invs;
 	std::map<std::string, RuleResearch *> _research;
+	std::vector<RuleResearch *> _researchById;
 	std::map<std::string, RuleManufacture *> _manufacture;
 	std::map<std::string, UfoTrajectory *> _ufoTrajectories;
 	std::map<std::string, RuleAlienMission *> _alienMissions;
@@ -97,11 +102,14 @@ protected:
 	std::vector<std::string> _aliensIndex, _deploymentsIndex, _armorsIndex, _ufopaediaIndex, _researchIndex, _manufactureIndex, _MCDPatchesIndex;
 	std::vector<std::string> _alienMissionsIndex, _terrainIndex, _extraSpritesIndex, _extraSoundsIndex, _extraStringsIndex;
 	std::vector<std::vector<int> > _alienItemLevels;
+	std::vector<RuleRegion*> _regionsById;
+	std::vector<RuleCountry*> _countriesById;
+	GlobeGrid _regionGrid, _countryGrid;
 	int _modIndex, _facilityListOrder, _craftListOrder, _itemListOrder, _researchListOrder,  _manufactureListOrder, _ufopaediaListOrder;
 	/// Loads a ruleset from a YAML file.
 	void loadFile(const std::string &filename);
-	/// Loads all ruleset files from a directory.
-	void loadFiles(const std::string &dirname);
+	/// Gets the ruleset files that make up a source.
+	static std::vector<std::string> getSourceFiles(const std::string &source);
 public:
 	/// Creates a blank ruleset.
 	Ruleset();
@@ -111,6 +119,20 @@ public:
 	void load(const std::string &source);
 	/// Saves a ruleset to a YAML file.
 	void save(const std::string &filename) const;
+	/// Saves a ruleset to a YAML emitter.
+	void save(YAML::Emitter &out) const;
+	/// Gets the key identifying the current ruleset files.
+	static std::string getCacheKey(const std::vector<std::string> &sources);
+	/// Loads a ruleset from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Saves a ruleset to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
+	/// Loads a ruleset from a cache file.
+	bool loadCache(const std::string &filename, const std::string &key);
+	/// Saves a ruleset to a cache file.
+	void saveCache(const std::string &filename, const std::string &key) const;
+	/// Builds or verifies the cache file for a set of sources.
+	static bool buildCache(const std::string &filename, const std::vector<std::string> &sources, bool verify);
 	/// Generates the starting saved game.
 	virtual SavedGame *newSave() const;
 	/// Gets the pool list for soldier names.
@@ -137,6 +159,8 @@ public:
 	const std::vector<std::string> &getCraftWeaponsList() const;
 	/// Gets the ruleset for an item type.
 	RuleItem *getItem(const std::string &id) const;
+	/// Gets the ruleset for an item type by its handle.
+	RuleItem *getItem(int handle) const;
 	/// Gets the available items.
 	const std::vector<std::string> &getItemsList() const;
 	/// Gets the ruleset for a UFO type.
@@ -183,6 +207,8 @@ public:
 	int getPersonnelTime() const;
 	/// Gets the ruleset for a specific research project.
 	RuleResearch *getResearch (const std::string &id) const;
+	/// Gets the ruleset for a research project by its ID.
+	RuleResearch *getResearch (int id) const;
 	/// Get the list of all research projects.
 	const std::vector<std::string> &getResearchList () const;
 	/// Gets the ruleset for a specific manufacture project.
@@ -213,6 +239,14 @@ public:
 	std::map<std::string, ExtraStrings *> getExtraStrings() const;
 	/// sort all our lists according to their weight.
 	void sortLists();
+	/// Links up the research tree.
+	void resolveResearch();
+	/// Indexes the regions and countries by location.
+	void indexZones();
+	/// Gets the region containing a point.
+	RuleRegion *locateRegion(double lon, double lat) const;
+	/// Gets the country containing a point.
+	RuleCountry *locateCountry(double lon, double lat) const;
 };
 
 }
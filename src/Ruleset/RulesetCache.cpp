@@ -0,0 +1,203 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "RulesetCache.h"
+#include <cstring>
+#include <SDL_types.h>
+#include "../Engine/Exception.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates an empty snapshot to write rules to.
+ * @param capacity Number of bytes to reserve up front.
+ */
+CacheWriter::CacheWriter(size_t capacity) : _data()
+{
+	_data.reserve(capacity);
+}
+
+/**
+ *
+ */
+CacheWriter::~CacheWriter()
+{
+}
+
+/**
+ * Appends some bytes to the end of the snapshot.
+ * @param data Pointer to the bytes.
+ * @param size Number of bytes.
+ */
+void CacheWriter::write(const void *data, size_t size)
+{
+	const char *bytes = (const char*)data;
+	_data.insert(_data.end(), bytes, bytes + size);
+}
+
+/**
+ * Returns everything written to the snapshot so far.
+ * @return Snapshot contents.
+ */
+const std::vector<char> &CacheWriter::getData() const
+{
+	return _data;
+}
+
+/**
+ * Creates a reader for the contents of a snapshot.
+ * @param data Pointer to the snapshot contents.
+ * @param size Size of the snapshot in bytes.
+ */
+CacheReader::CacheReader(const char *data, size_t size) : _data(data), _size(size), _pos(0)
+{
+}
+
+/**
+ *
+ */
+CacheReader::~CacheReader()
+{
+}
+
+/**
+ * Copies some bytes from the current position and moves past them.
+ * @param data Pointer to copy the bytes to.
+ * @param size Number of bytes.
+ */
+void CacheReader::read(void *data, size_t size)
+{
+	memcpy(data, skip(size), size);
+}
+
+/**
+ * Moves past some bytes without copying them.
+ * @param size Number of bytes.
+ * @return Pointer to the bytes skipped.
+ */
+const char *CacheReader::skip(size_t size)
+{
+	if (size > _size - _pos)
+	{
+		throw Exception("Binary data is truncated");
+	}
+	const char *data = _data + _pos;
+	_pos += size;
+	return data;
+}
+
+/**
+ * Checks if everything in the snapshot has been read.
+ * @return True if it's at the end of the snapshot.
+ */
+bool CacheReader::eof() const
+{
+	return _pos >= _size;
+}
+
+CacheWriter &operator<<(CacheWriter &out, int value)
+{
+	return out << (unsigned int)value;
+}
+
+CacheWriter &operator<<(CacheWriter &out, unsigned int value)
+{
+	Uint8 bytes[4];
+	for (int i = 0; i < 4; ++i)
+	{
+		bytes[i] = (Uint8)((value >> (i * 8)) & 0xFF);
+	}
+	out.write(bytes, sizeof(bytes));
+	return out;
+}
+
+CacheWriter &operator<<(CacheWriter &out, bool value)
+{
+	Uint8 v = value ? 1 : 0;
+	out.write(&v, sizeof(v));
+	return out;
+}
+
+CacheWriter &operator<<(CacheWriter &out, float value)
+{
+	out.write(&value, sizeof(value));
+	return out;
+}
+
+CacheWriter &operator<<(CacheWriter &out, double value)
+{
+	out.write(&value, sizeof(value));
+	return out;
+}
+
+CacheWriter &operator<<(CacheWriter &out, const std::string &value)
+{
+	out << (unsigned int)value.size();
+	out.write(value.data(), value.size());
+	return out;
+}
+
+CacheReader &operator>>(CacheReader &in, int &value)
+{
+	unsigned int v;
+	in >> v;
+	value = (Sint32)v;
+	return in;
+}
+
+CacheReader &operator>>(CacheReader &in, unsigned int &value)
+{
+	const Uint8 *bytes = (const Uint8*)in.skip(4);
+	value = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		value |= (Uint32)bytes[i] << (i * 8);
+	}
+	return in;
+}
+
+CacheReader &operator>>(CacheReader &in, bool &value)
+{
+	Uint8 v;
+	in.read(&v, sizeof(v));
+	value = (v != 0);
+	return in;
+}
+
+CacheReader &operator>>(CacheReader &in, float &value)
+{
+	in.read(&value, sizeof(value));
+	return in;
+}
+
+CacheReader &operator>>(CacheReader &in, double &value)
+{
+	in.read(&value, sizeof(value));
+	return in;
+}
+
+CacheReader &operator>>(CacheReader &in, std::string &value)
+{
+	unsigned int size;
+	in >> size;
+	value.assign(in.skip(size), size);
+	return in;
+}
+
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_RULESETCACHE_H
+#define OPENXCOM_RULESETCACHE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+
+namespace OpenXcom
+{
+
+/**
+ * Writes the rules of a loaded ruleset into a compact binary
+ * snapshot, so they can be restored later without parsing YAML.
+ * Every rule class saves all its contents in a fixed order,
+ * which its loadCache() has to read back in the same order.
+ * Binary saves use it for their battle records too, so numbers
+ * are always written in little endian order.
+ */
+class CacheWriter
+{
+private:
+	std::vector<char> _data;
+public:
+	/// Creates an empty snapshot.
+	CacheWriter(size_t capacity = 256 * 1024);
+	/// Cleans up the snapshot.
+	~CacheWriter();
+	/// Appends raw bytes.
+	void write(const void *data, size_t size);
+	/// Gets the snapshot contents.
+	const std::vector<char> &getData() const;
+};
+
+/**
+ * Reads the rules back from a binary ruleset snapshot.
+ * Running past the end of the snapshot throws an Exception,
+ * since it means the snapshot doesn't match the code.
+ */
+class CacheReader
+{
+private:
+	const char *_data;
+	size_t _size, _pos;
+public:
+	/// Creates a reader for a snapshot.
+	CacheReader(const char *data, size_t size);
+	/// Cleans up the reader.
+	~CacheReader();
+	/// Reads raw bytes.
+	void read(void *data, size_t size);
+	/// Skips over raw bytes.
+	const char *skip(size_t size);
+	/// Checks if the whole snapshot was read.
+	bool eof() const;
+};
+
+CacheWriter &operator<<(CacheWriter &out, int value);
+CacheWriter &operator<<(CacheWriter &out, unsigned int value);
+CacheWriter &operator<<(CacheWriter &out, bool value);
+CacheWriter &operator<<(CacheWriter &out, float value);
+CacheWriter &operator<<(CacheWriter &out, double value);
+CacheWriter &operator<<(CacheWriter &out, const std::string &value);
+CacheReader &operator>>(CacheReader &in, int &value);
+CacheReader &operator>>(CacheReader &in, unsigned int &value);
+CacheReader &operator>>(CacheReader &in, bool &value);
+CacheReader &operator>>(CacheReader &in, float &value);
+CacheReader &operator>>(CacheReader &in, double &value);
+CacheReader &operator>>(CacheReader &in, std::string &value);
+template <typename T> CacheWriter &operator<<(CacheWriter &out, const std::vector<T> &value);
+template <typename T> CacheReader &operator>>(CacheReader &in, std::vector<T> &value);
+template <typename A, typename B> CacheWriter &operator<<(CacheWriter &out, const std::pair<A, B> &value);
+template <typename A, typename B> CacheReader &operator>>(CacheReader &in, std::pair<A, B> &value);
+template <typename K, typename V> CacheWriter &operator<<(CacheWriter &out, const std::map<K, V> &value);
+template <typename K, typename V> CacheReader &operator>>(CacheReader &in, std::map<K, V> &value);
+
+/// Writes a list to the snapshot.
+template <typename T>
+CacheWriter &operator<<(CacheWriter &out, const std::vector<T> &value)
+{
+	out << (unsigned int)value.size();
+	for (typename std::vector<T>::const_iterator i = value.begin(); i != value.end(); ++i)
+	{
+		out << *i;
+	}
+	return out;
+}
+
+/// Reads a list from the snapshot.
+template <typename T>
+CacheReader &operator>>(CacheReader &in, std::vector<T> &value)
+{
+	unsigned int size;
+	in >> size;
+	value.clear();
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		T item;
+		in >> item;
+		value.push_back(item);
+	}
+	return in;
+}
+
+/// Writes a pair to the snapshot.
+template <typename A, typename B>
+CacheWriter &operator<<(CacheWriter &out, const std::pair<A, B> &value)
+{
+	out << value.first << value.second;
+	return out;
+}
+
+/// Reads a pair from the snapshot.
+template <typename A, typename B>
+CacheReader &operator>>(CacheReader &in, std::pair<A, B> &value)
+{
+	in >> value.first >> value.second;
+	return in;
+}
+
+/// Writes a map to the snapshot.
+template <typename K, typename V>
+CacheWriter &operator<<(CacheWriter &out, const std::map<K, V> &value)
+{
+	out << (unsigned int)value.size();
+	for (typename std::map<K, V>::const_iterator i = value.begin(); i != value.end(); ++i)
+	{
+		out << i->first << i->second;
+	}
+	return out;
+}
+
+/// Reads a map from the snapshot.
+template <typename K, typename V>
+CacheReader &operator>>(CacheReader &in, std::map<K, V> &value)
+{
+	unsigned int size;
+	in >> size;
+	value.clear();
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		K key;
+		in >> key;
+		in >> value[key];
+	}
+	return in;
+}
+
+}
+
+#endif
@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "UfoTrajectory.h"
+#include "RulesetCache.h"
 
 namespace {
 const char *altitudeString[] = {
@@ -98,4 +99,36 @@ std::string UfoTrajectory::getAltitude(unsigned wp) const
 	return altitudeString[_waypoints[wp].altitude];
 }
 
+/// Write a TrajectoryWaypoint to the ruleset cache.
+CacheWriter &operator<<(CacheWriter &out, const TrajectoryWaypoint &wp)
+{
+	out << wp.zone << wp.altitude << wp.speed;
+	return out;
+}
+
+/// Read a TrajectoryWaypoint from the ruleset cache.
+CacheReader &operator>>(CacheReader &in, TrajectoryWaypoint &wp)
+{
+	in >> wp.zone >> wp.altitude >> wp.speed;
+	return in;
+}
+
+/**
+ * Loads the trajectory data from the ruleset cache.
+ * @param in Ruleset cache.
+ */
+void UfoTrajectory::loadCache(CacheReader &in)
+{
+	in >> _id >> _groundTimer >> _waypoints;
+}
+
+/**
+ * Saves the trajectory data to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void UfoTrajectory::saveCache(CacheWriter &out) const
+{
+	out << _id << _groundTimer << _waypoints;
+}
+
 }
@@ -26,6 +26,9 @@
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
+
 /**
  * Information for points on a UFO trajectory.
  */
@@ -55,6 +58,10 @@ public:
 	void load(const YAML::Node &node);
 	/// Saves the trajectory data to YAML.
 	void save(YAML::Emitter &out) const;
+	/// Loads the trajectory data from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Saves the trajectory data to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Gets the number of waypoints in this trajectory.
 	unsigned getWaypointCount() const { return _waypoints.size(); }
 	/// Gets the zone index at a waypoint.
@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "Unit.h"
+#include "RulesetCache.h"
 
 namespace OpenXcom
 {
@@ -354,4 +355,54 @@ bool Unit::isLivingWeapon() const
 	return _livingWeapon;
 }
 
+/**
+ * Writes a set of unit stats to the ruleset cache.
+ * @param out Ruleset cache.
+ * @param stats Unit stats.
+ * @return Ruleset cache.
+ */
+CacheWriter &operator<<(CacheWriter &out, const UnitStats &stats)
+{
+	out << stats.tu << stats.stamina << stats.health << stats.bravery << stats.reactions << stats.firing;
+	out << stats.throwing << stats.strength << stats.psiStrength << stats.psiSkill << stats.melee;
+	return out;
+}
+
+/**
+ * Reads a set of unit stats from the ruleset cache.
+ * @param in Ruleset cache.
+ * @param stats Unit stats.
+ * @return Ruleset cache.
+ */
+CacheReader &operator>>(CacheReader &in, UnitStats &stats)
+{
+	in >> stats.tu >> stats.stamina >> stats.health >> stats.bravery >> stats.reactions >> stats.firing;
+	in >> stats.throwing >> stats.strength >> stats.psiStrength >> stats.psiSkill >> stats.melee;
+	return in;
+}
+
+/**
+ * Loads the unit data from the ruleset cache.
+ * @param in Ruleset cache.
+ */
+void Unit::loadCache(CacheReader &in)
+{
+	int specab;
+	in >> _type >> _race >> _rank >> _stats >> _armor >> _standHeight >> _kneelHeight >> _floatHeight;
+	in >> _value >> _deathSound >> _aggroSound >> _moveSound >> _intelligence >> _aggression >> specab;
+	in >> _zombieUnit >> _spawnUnit >> _livingWeapon;
+	_specab = (SpecialAbility)specab;
+}
+
+/**
+ * Saves the unit data to the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void Unit::saveCache(CacheWriter &out) const
+{
+	out << _type << _race << _rank << _stats << _armor << _standHeight << _kneelHeight << _floatHeight;
+	out << _value << _deathSound << _aggroSound << _moveSound << _intelligence << _aggression << (int)_specab;
+	out << _zombieUnit << _spawnUnit << _livingWeapon;
+}
+
 }
@@ -25,6 +25,9 @@
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
+
 enum SpecialAbility { SPECAB_NONE = 0, SPECAB_EXPLODEONDEATH, SPECAB_BURNFLOOR, SPECAB_RESPAWN };
 /**
  * This struct holds some plain unit attribute data together.
@@ -35,6 +38,8 @@ struct UnitStats
 };
 void operator>> (const YAML::Node& node, UnitStats& stats);
 YAML::Emitter& operator<< (YAML::Emitter& out, const UnitStats& stats);
+CacheWriter &operator<<(CacheWriter &out, const UnitStats &stats);
+CacheReader &operator>>(CacheReader &in, UnitStats &stats);
 
 /**
  * Represents the static data for a unit that is generated on the battlescape, this includes: HWPs, aliens and civilians.
@@ -63,6 +68,10 @@ public:
 	void load(const YAML::Node& node);
 	/// Saves the unit data to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the unit data from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Saves the unit data to the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 	/// Gets the unit's type.
 	std::string getType() const;
 	/// Get the unit's stats.
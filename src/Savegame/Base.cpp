@@ -152,15 +152,12 @@ void Base::load(const YAML::Node &node, SavedGame *save, bool newGame, bool newB
 
 	_items->load(node["items"]);
 	// Some old saves have bad items, better get rid of them to avoid further bugs
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end();)
+	const std::vector<int> &qty = _items->getQuantities();
+	for (size_t i = 0; i != qty.size(); ++i)
 	{
-		if (std::find(_rule->getItemsList().begin(), _rule->getItemsList().end(), i->first) == _rule->getItemsList().end())
+		if (qty[i] != 0 && _rule->getItem((int)i) == 0)
 		{
-			_items->getContents()->erase(i++);
-		}
-		else
-		{
-			++i;
+			_items->removeItem((int)i, qty[i]);
 		}
 	}
 
@@ -1027,11 +1024,12 @@ int Base::getUsedPsiLabs() const
 int Base::getUsedContainment() const
 {
 	int total = 0;
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end(); ++i)
+	const std::vector<int> &qty = _items->getQuantities();
+	for (size_t i = 0; i != qty.size(); ++i)
 	{
-		if (_rule->getItem((i)->first)->getAlien())
+		if (qty[i] != 0 && _rule->getItem((int)i)->getAlien())
 		{
-			total += (i)->second;
+			total += qty[i];
 		}
 	}
 	for (std::vector<Transfer*>::const_iterator i = _transfers.begin(); i != _transfers.end(); ++i)
@@ -1204,7 +1202,8 @@ void Base::setupDefenses()
 	}
 
 	// add vehicles left on the base
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end(); )
+	std::map<std::string, int> contents = _items->getContents();
+	for (std::map<std::string, int>::iterator i = contents.begin(); i != contents.end(); )
 	{
 		std::string itemId=(i)->first;
 		int iqty=(i)->second;
@@ -1236,7 +1235,8 @@ void Base::setupDefenses()
 				_items->removeItem(itemId, canBeAdded);
 			}
 
-			i = _items->getContents()->begin(); // we have to start over because iterator is broken because of the removeItem
+			contents = _items->getContents(); // we have to start over because the quantities changed
+			i = contents.begin();
 		}
 		else ++i;
 	}
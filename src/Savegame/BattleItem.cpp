@@ -21,6 +21,7 @@
 #include "Tile.h"
 #include "../Ruleset/RuleItem.h"
 #include "../Ruleset/RuleInventory.h"
+#include "../Ruleset/RulesetCache.h"
 
 namespace OpenXcom
 {
@@ -144,6 +145,26 @@ void BattleItem::save(YAML::Emitter &out) const
 	out << YAML::EndMap;
 }
 
+/**
+ * Loads the item from a record in a binary save. Its type, slot
+ * and links to other objects are read by the battle save.
+ * @param in Record reader.
+ */
+void BattleItem::loadBinary(CacheReader &in)
+{
+	in >> _inventoryX >> _inventoryY >> _ammoQuantity >> _painKiller >> _heal >> _stimulant >> _explodeTurn >> _droppedOnAlienTurn;
+}
+
+/**
+ * Saves the item to a record in a binary save. Its type, slot
+ * and links to other objects are written by the battle save.
+ * @param out Record writer.
+ */
+void BattleItem::saveBinary(CacheWriter &out) const
+{
+	out << _inventoryX << _inventoryY << _ammoQuantity << _painKiller << _heal << _stimulant << _explodeTurn << _droppedOnAlienTurn;
+}
+
 /**
  * Returns the ruleset for the item's type.
  * @return Pointer to ruleset.
@@ -30,6 +30,8 @@ class RuleItem;
 class RuleInventory;
 class BattleUnit;
 class Tile;
+class CacheReader;
+class CacheWriter;
 
 /**
  * Represents a single item in the battlescape.
@@ -60,6 +62,10 @@ public:
 	void load(const YAML::Node& node);
 	/// Saves the item to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the item from a binary save record.
+	void loadBinary(CacheReader &in);
+	/// Saves the item to a binary save record.
+	void saveBinary(CacheWriter &out) const;
 	/// Gets the item's ruleset.
 	RuleItem *getRules() const;
 	/// Gets the item's ammo quantity
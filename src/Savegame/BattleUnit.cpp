@@ -33,8 +33,10 @@
 #include "../Ruleset/Armor.h"
 #include "../Ruleset/Unit.h"
 #include "../Engine/RNG.h"
+#include "../Engine/StringId.h"
 #include "../Ruleset/RuleInventory.h"
 #include "../Ruleset/RuleSoldier.h"
+#include "../Ruleset/RulesetCache.h"
 #include "Tile.h"
 #include "SavedGame.h"
 
@@ -370,6 +372,48 @@ void BattleUnit::save(YAML::Emitter &out) const
 	out << YAML::EndMap;
 }
 
+/**
+ * Loads the unit from a record in a binary save. Its type
+ * and AI state are read by the battle save.
+ * @param in Record reader.
+ */
+void BattleUnit::loadBinary(CacheReader &in)
+{
+	int faction, status, killedBy, originalFaction;
+	in >> _id >> faction >> status >> _pos.x >> _pos.y >> _pos.z >> _direction >> _directionTurret;
+	in >> _tu >> _health >> _stunlevel >> _energy >> _morale >> _kneeled >> _floating;
+	for (int i = 0; i < 5; i++)
+		in >> _currentArmor[i];
+	for (int i = 0; i < 6; i++)
+		in >> _fatalWounds[i];
+	in >> _fire >> _expBravery >> _expReactions >> _expFiring >> _expThrowing >> _expPsiSkill >> _expMelee;
+	in >> _turretType >> _visible >> _turnsExposed >> killedBy >> _rankInt >> originalFaction >> _kills >> _dontReselect;
+	_faction = (UnitFaction)faction;
+	_status = (UnitStatus)status;
+	_killedBy = (UnitFaction)killedBy;
+	_originalFaction = (UnitFaction)originalFaction;
+	_charging = 0;
+	_toDirection = _direction;
+	_toDirectionTurret = _directionTurret;
+}
+
+/**
+ * Saves the unit to a record in a binary save. Its type
+ * and AI state are written by the battle save.
+ * @param out Record writer.
+ */
+void BattleUnit::saveBinary(CacheWriter &out) const
+{
+	out << _id << (int)_faction << (int)_status << _pos.x << _pos.y << _pos.z << _direction << _directionTurret;
+	out << _tu << _health << _stunlevel << _energy << _morale << _kneeled << _floating;
+	for (int i = 0; i < 5; i++)
+		out << _currentArmor[i];
+	for (int i = 0; i < 6; i++)
+		out << _fatalWounds[i];
+	out << _fire << _expBravery << _expReactions << _expFiring << _expThrowing << _expPsiSkill << _expMelee;
+	out << _turretType << _visible << _turnsExposed << (int)_killedBy << _rankInt << (int)_originalFaction << _kills << _dontReselect;
+}
+
 /**
  * Returns the BattleUnit's unique ID.
  * @return Unique ID.
@@ -1337,7 +1381,7 @@ double BattleUnit::getFiringAccuracy(BattleActionType actionType, BattleItem *it
 	if (item->getRules()->isTwoHanded())
 	{
 		// two handed weapon, means one hand should be empty
-		if (getItem("STR_RIGHT_HAND") != 0 && getItem("STR_LEFT_HAND") != 0)
+		if (getItem(getRightHandSlot()) != 0 && getItem(getLeftHandSlot()) != 0)
 		{
 			result *= 0.80;
 		}
@@ -1704,12 +1748,33 @@ BattleItem *BattleUnit::getItem(RuleInventory *slot, int x, int y) const
  */
 BattleItem *BattleUnit::getItem(const std::string &slot, int x, int y) const
 {
+	int handle = StringId::find(slot);
+	if (handle == -1)
+	{
+		return 0;
+	}
+	return getItem(handle, x, y);
+}
+
+/**
+ * Checks if there's an inventory item in the specified inventory
+ * position, going by the handle of the slot (see StringId) so
+ * callers that check the same slot all the time don't have to
+ * look it up by name every time.
+ * @param slot Handle of the inventory slot.
+ * @param x X position in slot.
+ * @param y Y position in slot.
+ * @return Item in the slot, or NULL if none.
+ */
+BattleItem *BattleUnit::getItem(int slot, int x, int y) const
+{
+	static const int ground = StringId::intern("STR_GROUND");
 	// Soldier items
-	if (slot != "STR_GROUND")
+	if (slot != ground)
 	{
 		for (std::vector<BattleItem*>::const_iterator i = _inventory.begin(); i != _inventory.end(); ++i)
 		{
-			if ((*i)->getSlot() != 0 && (*i)->getSlot()->getId() == slot && (*i)->occupiesSlot(x, y))
+			if ((*i)->getSlot() != 0 && (*i)->getSlot()->getHandle() == slot && (*i)->occupiesSlot(x, y))
 			{
 				return *i;
 			}
@@ -1729,6 +1794,28 @@ BattleItem *BattleUnit::getItem(const std::string &slot, int x, int y) const
 	return 0;
 }
 
+/**
+ * Gets the handle of the right hand inventory slot,
+ * which is only looked up the first time.
+ * @return Slot handle.
+ */
+int BattleUnit::getRightHandSlot()
+{
+	static const int handle = StringId::intern("STR_RIGHT_HAND");
+	return handle;
+}
+
+/**
+ * Gets the handle of the left hand inventory slot,
+ * which is only looked up the first time.
+ * @return Slot handle.
+ */
+int BattleUnit::getLeftHandSlot()
+{
+	static const int handle = StringId::intern("STR_LEFT_HAND");
+	return handle;
+}
+
 /**
 * Get the "main hand weapon" from the unit.
 * @param quickest Wether to get the quickest weapon, default true
@@ -1736,8 +1823,8 @@ BattleItem *BattleUnit::getItem(const std::string &slot, int x, int y) const
 */
 BattleItem *BattleUnit::getMainHandWeapon(bool quickest) const
 {
-	BattleItem *weaponRightHand = getItem("STR_RIGHT_HAND");
-	BattleItem *weaponLeftHand = getItem("STR_LEFT_HAND");
+	BattleItem *weaponRightHand = getItem(getRightHandSlot());
+	BattleItem *weaponLeftHand = getItem(getLeftHandSlot());
 
 	// if there is only one weapon, or only one weapon loaded (rules out grenades) it's easy:
 	if (!weaponRightHand || !weaponRightHand->getAmmoItem() || !weaponRightHand->getAmmoItem()->getAmmoQuantity())
@@ -1779,10 +1866,10 @@ BattleItem *BattleUnit::getGrenadeFromBelt() const
  */
 bool BattleUnit::checkAmmo()
 {
-	BattleItem *weapon = getItem("STR_RIGHT_HAND");
+	BattleItem *weapon = getItem(getRightHandSlot());
 	if (!weapon || weapon->getAmmoItem() != 0 || weapon->getRules()->getBattleType() == BT_MELEE || getTimeUnits() < 15)
 	{
-		weapon = getItem("STR_LEFT_HAND");
+		weapon = getItem(getLeftHandSlot());
 		if (!weapon || weapon->getAmmoItem() != 0 || weapon->getRules()->getBattleType() == BT_MELEE || getTimeUnits() < 15)
 		{
 			return false;
@@ -2311,7 +2398,7 @@ void BattleUnit::setActiveHand(const std::string &hand)
 std::string BattleUnit::getActiveHand() const
 {
 	if (getItem(_activeHand)) return _activeHand;
-	if (getItem("STR_LEFT_HAND")) return "STR_LEFT_HAND";
+	if (getItem(getLeftHandSlot())) return "STR_LEFT_HAND";
 	return "STR_RIGHT_HAND";
 }
 
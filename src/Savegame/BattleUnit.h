@@ -45,6 +45,8 @@ class SavedGame;
 class Language;
 class AggroBAIState;
 class PatrolBAIState;
+class CacheReader;
+class CacheWriter;
 
 enum UnitStatus {STATUS_STANDING, STATUS_WALKING, STATUS_FLYING, STATUS_TURNING, STATUS_AIMING, STATUS_COLLAPSING, STATUS_DEAD, STATUS_UNCONSCIOUS, STATUS_PANICKING, STATUS_BERSERK};
 enum UnitFaction {FACTION_PLAYER, FACTION_HOSTILE, FACTION_NEUTRAL};
@@ -124,6 +126,10 @@ public:
 	void load(const YAML::Node& node);
 	/// Saves the unit to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the unit from a binary save record.
+	void loadBinary(CacheReader &in);
+	/// Saves the unit to a binary save record.
+	void saveBinary(CacheWriter &out) const;
 	/// Gets the BattleUnit's ID.
 	int getId() const;
 	/// Sets the unit's position
@@ -272,6 +278,12 @@ public:
 	BattleItem *getItem(RuleInventory *slot, int x = 0, int y = 0) const;
 	/// Gets the item in the specified slot.
 	BattleItem *getItem(const std::string &slot, int x = 0, int y = 0) const;
+	/// Gets the item in the specified slot, by the handle of the slot.
+	BattleItem *getItem(int slot, int x = 0, int y = 0) const;
+	/// Gets the handle of the right hand slot.
+	static int getRightHandSlot();
+	/// Gets the handle of the left hand slot.
+	static int getLeftHandSlot();
 	/// Gets the item in the main hand.
 	BattleItem *getMainHandWeapon(bool quickest = true) const;
 	/// Gets a grenade from the belt, if any.
@@ -135,6 +135,34 @@ TimeTrigger GameTime::advance()
 	return trigger;
 }
 
+/**
+ * Returns how many times the time has to advance
+ * until it sends out a trigger of at least a certain
+ * time span, for time spans up to an hour.
+ * @param trigger Time span trigger.
+ * @return Number of 5 second advances.
+ */
+int GameTime::getStepsUntil(TimeTrigger trigger) const
+{
+	int period;
+	switch (trigger)
+	{
+	case TIME_5SEC:
+		return 1;
+	case TIME_10MIN:
+		period = 10;
+		break;
+	case TIME_30MIN:
+		period = 30;
+		break;
+	default:
+		period = 60;
+		break;
+	}
+	int minutes = period - _minute % period;
+	return (60 - _second) / 5 + (minutes - 1) * 12;
+}
+
 /**
  * Returns the current ingame second.
  * @return Second (0-59).
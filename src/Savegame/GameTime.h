@@ -50,6 +50,8 @@ public:
 	void save(YAML::Emitter& out) const;
 	/// Advances the time by 5 seconds.
 	TimeTrigger advance();
+	/// Gets the number of advances until a trigger.
+	int getStepsUntil(TimeTrigger trigger) const;
 	/// Gets the ingame second.
 	int getSecond() const;
 	/// Gets the ingame minute.
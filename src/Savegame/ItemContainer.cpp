@@ -19,6 +19,7 @@
 #include "ItemContainer.h"
 #include "../Ruleset/Ruleset.h"
 #include "../Ruleset/RuleItem.h"
+#include "../Engine/StringId.h"
 
 namespace OpenXcom
 {
@@ -43,7 +44,13 @@ ItemContainer::~ItemContainer()
  */
 void ItemContainer::load(const YAML::Node &node)
 {
-	node >> _qty;
+	std::map<std::string, int> qty;
+	node >> qty;
+	_qty.clear();
+	for (std::map<std::string, int>::const_iterator i = qty.begin(); i != qty.end(); ++i)
+	{
+		addItem(i->first, i->second);
+	}
 }
 
 /**
@@ -52,7 +59,7 @@ void ItemContainer::load(const YAML::Node &node)
  */
 void ItemContainer::save(YAML::Emitter &out) const
 {
-	out << _qty;
+	out << getContents();
 }
 
 /**
@@ -66,11 +73,7 @@ void ItemContainer::addItem(const std::string &id, int qty)
 	{
 		return;
 	}
-	if (_qty.find(id) == _qty.end())
-	{
-		_qty[id] = 0;
-	}
-	_qty[id] += qty;
+	addItem(StringId::intern(id), qty);
 }
 
 /**
@@ -80,18 +83,11 @@ void ItemContainer::addItem(const std::string &id, int qty)
  */
 void ItemContainer::removeItem(const std::string &id, int qty)
 {
-	if (id.empty() || _qty.find(id) == _qty.end())
+	if (id.empty())
 	{
 		return;
 	}
-	if (qty < _qty[id])
-	{
-		_qty[id] -= qty;
-	}
-	else
-	{
-		_qty.erase(id);
-	}
+	removeItem(StringId::find(id), qty);
 }
 
 /**
@@ -105,18 +101,62 @@ int ItemContainer::getItem(const std::string &id) const
 	{
 		return 0;
 	}
+	return getItem(StringId::find(id));
+}
 
-	std::map<std::string, int>::const_iterator it = _qty.find(id);
-	if (it == _qty.end())
+/**
+ * Adds an item amount to the container.
+ * @param handle Item handle.
+ * @param qty Item quantity.
+ */
+void ItemContainer::addItem(int handle, int qty)
+{
+	if (handle < 0)
 	{
-		return 0;
+		return;
+	}
+	if ((size_t)handle >= _qty.size())
+	{
+		_qty.resize(handle + 1, 0);
+	}
+	_qty[handle] += qty;
+}
+
+/**
+ * Removes an item amount from the container.
+ * @param handle Item handle.
+ * @param qty Item quantity.
+ */
+void ItemContainer::removeItem(int handle, int qty)
+{
+	if (handle < 0 || (size_t)handle >= _qty.size() || _qty[handle] == 0)
+	{
+		return;
+	}
+	if (qty < _qty[handle])
+	{
+		_qty[handle] -= qty;
 	}
 	else
 	{
-		return it->second;
+		_qty[handle] = 0;
 	}
 }
 
+/**
+ * Returns the quantity of an item in the container.
+ * @param handle Item handle.
+ * @return Item quantity.
+ */
+int ItemContainer::getItem(int handle) const
+{
+	if (handle < 0 || (size_t)handle >= _qty.size())
+	{
+		return 0;
+	}
+	return _qty[handle];
+}
+
 /**
  * Returns the total quantity of the items in the container.
  * @return Total item quantity.
@@ -124,9 +164,9 @@ int ItemContainer::getItem(const std::string &id) const
 int ItemContainer::getTotalQuantity() const
 {
 	int total = 0;
-	for (std::map<std::string, int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
+	for (std::vector<int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
 	{
-		total += i->second;
+		total += *i;
 	}
 	return total;
 }
@@ -139,20 +179,50 @@ int ItemContainer::getTotalQuantity() const
 double ItemContainer::getTotalSize(const Ruleset *rule) const
 {
 	double total = 0;
-	for (std::map<std::string, int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
+	for (size_t i = 0; i != _qty.size(); ++i)
 	{
-		total += rule->getItem(i->first)->getSize() * i->second;
+		if (_qty[i] != 0)
+		{
+			total += rule->getItem((int)i)->getSize() * _qty[i];
+		}
 	}
 	return total;
 }
 
 /**
- * Returns all the items currently contained within.
+ * Returns all the items currently contained within, by ID.
+ * This is a copy, changing it doesn't change the container.
  * @return List of contents.
  */
-std::map<std::string, int> *ItemContainer::getContents()
+std::map<std::string, int> ItemContainer::getContents() const
+{
+	std::map<std::string, int> contents;
+	for (size_t i = 0; i != _qty.size(); ++i)
+	{
+		if (_qty[i] != 0)
+		{
+			contents[StringId::get(i)] = _qty[i];
+		}
+	}
+	return contents;
+}
+
+/**
+ * Returns the quantities of all the items, indexed by item handle.
+ * Items that aren't in the container have a quantity of 0.
+ * @return List of quantities.
+ */
+const std::vector<int> &ItemContainer::getQuantities() const
+{
+	return _qty;
+}
+
+/**
+ * Removes all the items from the container.
+ */
+void ItemContainer::clear()
 {
-	return &_qty;
+	_qty.clear();
 }
 
 }
@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "Node.h"
+#include "../Ruleset/RulesetCache.h"
 
 namespace OpenXcom
 {
@@ -102,6 +103,24 @@ void Node::save(YAML::Emitter &out) const
 	out << YAML::EndMap;
 }
 
+/**
+ * Loads the node from a record in a binary save.
+ * @param in Record reader.
+ */
+void Node::loadBinary(CacheReader &in)
+{
+	in >> _id >> _pos.x >> _pos.y >> _pos.z >> _type >> _rank >> _flags >> _reserved >> _priority >> _allocated >> _nodeLinks;
+}
+
+/**
+ * Saves the node to a record in a binary save.
+ * @param out Record writer.
+ */
+void Node::saveBinary(CacheWriter &out) const
+{
+	out << _id << _pos.x << _pos.y << _pos.z << _type << _rank << _flags << _reserved << _priority << _allocated << _nodeLinks;
+}
+
 /**
  * Get the node's id
  * @return unique id
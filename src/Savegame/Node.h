@@ -25,6 +25,9 @@
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
+
 enum NodeRank{NR_SCOUT=0, NR_XCOM, NR_SOLDIER, NR_NAVIGATOR, NR_LEADER, NR_ENGINEER, NR_MISC1, NR_MEDIC, NR_MISC2};
 
 /**
@@ -60,6 +63,10 @@ public:
 	void load(const YAML::Node& node);
 	/// Saves the node to YAML.
 	void save(YAML::Emitter& out) const;
+	/// Loads the node from a binary save record.
+	void loadBinary(CacheReader &in);
+	/// Saves the node to a binary save record.
+	void saveBinary(CacheWriter &out) const;
 	/// get the node's id
 	int getID() const;
 	/// get the node's paths
@@ -0,0 +1,266 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "SaveContainer.h"
+#include <fstream>
+#include <cstring>
+#include "../Engine/Exception.h"
+
+namespace OpenXcom
+{
+
+const char SaveContainer::MAGIC[4] = {'O', 'X', 'C', 'S'};
+
+namespace
+{
+
+/**
+ * Writes a number in little endian order.
+ * @param out Output stream.
+ * @param value Number.
+ */
+void writeUint32(std::ostream &out, Uint32 value)
+{
+	char bytes[4];
+	for (int i = 0; i < 4; ++i)
+	{
+		bytes[i] = (char)((value >> (i * 8)) & 0xFF);
+	}
+	out.write(bytes, 4);
+}
+
+/**
+ * Reads a number in little endian order.
+ * @param data Data to read from.
+ * @return Number.
+ */
+Uint32 readUint32(const char *data)
+{
+	Uint32 value = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		value |= (Uint32)(Uint8)data[i] << (i * 8);
+	}
+	return value;
+}
+
+}
+
+/**
+ * Creates an empty container.
+ */
+SaveContainer::SaveContainer()
+{
+
+}
+
+/**
+ * Cleans up the container.
+ */
+SaveContainer::~SaveContainer()
+{
+
+}
+
+/**
+ * Checks if a file starts like a binary save, so it can be told
+ * apart from a YAML one.
+ * @param filename Full path of the file.
+ * @return True if it's a binary save.
+ */
+bool SaveContainer::isContainer(const std::string &filename)
+{
+	std::ifstream fin(filename.c_str(), std::ios::in | std::ios::binary);
+	char magic[4];
+	if (!fin || !fin.read(magic, 4))
+	{
+		return false;
+	}
+	return memcmp(magic, MAGIC, 4) == 0;
+}
+
+/**
+ * Loads the chunks of a binary save. The whole file is read in at once,
+ * unless only the first chunk is wanted, as for the list of saves.
+ * @param filename Full path of the file.
+ * @param firstOnly Only load the first chunk.
+ */
+void SaveContainer::load(const std::string &filename, bool firstOnly)
+{
+	std::ifstream fin(filename.c_str(), std::ios::in | std::ios::binary);
+	if (!fin)
+	{
+		throw Exception("Failed to load " + filename);
+	}
+
+	fin.seekg(0, std::ios::end);
+	std::streamoff end = fin.tellg();
+	fin.seekg(0, std::ios::beg);
+	if (end < 0)
+	{
+		throw Exception("Failed to load " + filename);
+	}
+	size_t fileSize = (size_t)end;
+
+	std::vector<char> buffer;
+	if (firstOnly)
+	{
+		// magic, version, chunk count, then the first chunk's header
+		buffer.resize(24);
+		if (!fin.read(&buffer[0], buffer.size()))
+		{
+			throw Exception(filename + " is not a valid save");
+		}
+		// don't trust the length until it's known to fit in the file
+		Uint32 length = readUint32(&buffer[20]);
+		if (length > fileSize - 24 || 24 + (size_t)length < 24)
+		{
+			throw Exception(filename + " is not a valid save");
+		}
+		buffer.resize(24 + length);
+		if (length && !fin.read(&buffer[24], length))
+		{
+			throw Exception(filename + " is not a valid save");
+		}
+	}
+	else
+	{
+		buffer.resize(fileSize);
+		if (buffer.size() < 12 || !fin.read(&buffer[0], buffer.size()))
+		{
+			throw Exception(filename + " is not a valid save");
+		}
+	}
+	fin.close();
+
+	if (memcmp(&buffer[0], MAGIC, 4) != 0)
+	{
+		throw Exception(filename + " is not a valid save");
+	}
+	if (readUint32(&buffer[4]) > VERSION)
+	{
+		throw Exception(filename + " was saved by a newer version");
+	}
+	Uint32 count = readUint32(&buffer[8]);
+	if (firstOnly && count > 1)
+	{
+		count = 1;
+	}
+
+	_chunks.clear();
+	size_t pos = 12;
+	for (Uint32 i = 0; i < count; ++i)
+	{
+		if (buffer.size() - pos < 12)
+		{
+			throw Exception(filename + " is truncated");
+		}
+		std::string tag(&buffer[pos], 4);
+		Uint32 flags = readUint32(&buffer[pos + 4]);
+		Uint32 length = readUint32(&buffer[pos + 8]);
+		pos += 12;
+		if (flags != 0)
+		{
+			throw Exception(filename + " uses an unsupported chunk format");
+		}
+		if (length > buffer.size() - pos)
+		{
+			throw Exception(filename + " is truncated");
+		}
+		_chunks.push_back(std::make_pair(tag, std::string(buffer.begin() + pos, buffer.begin() + pos + length)));
+		pos += length;
+	}
+}
+
+/**
+ * Saves the chunks to a binary save, in the order they were set.
+ * @param filename Full path of the file.
+ */
+void SaveContainer::save(const std::string &filename) const
+{
+	std::ofstream fout(filename.c_str(), std::ios::out | std::ios::binary);
+	if (!fout)
+	{
+		throw Exception("Failed to save " + filename);
+	}
+	fout.write(MAGIC, 4);
+	writeUint32(fout, VERSION);
+	writeUint32(fout, _chunks.size());
+	for (std::vector<std::pair<std::string, std::string> >::const_iterator i = _chunks.begin(); i != _chunks.end(); ++i)
+	{
+		fout.write(i->first.c_str(), 4);
+		writeUint32(fout, 0);
+		writeUint32(fout, i->second.size());
+		fout.write(i->second.data(), i->second.size());
+	}
+	fout.close();
+}
+
+/**
+ * Sets the data of a chunk, replacing any chunk with the same tag.
+ * @param tag Four letter tag.
+ * @param data Chunk contents.
+ */
+void SaveContainer::setChunk(const std::string &tag, const std::string &data)
+{
+	for (std::vector<std::pair<std::string, std::string> >::iterator i = _chunks.begin(); i != _chunks.end(); ++i)
+	{
+		if (i->first == tag)
+		{
+			i->second = data;
+			return;
+		}
+	}
+	_chunks.push_back(std::make_pair(tag, data));
+}
+
+/**
+ * Checks if the container has a chunk.
+ * @param tag Four letter tag.
+ * @return True if the chunk is present.
+ */
+bool SaveContainer::hasChunk(const std::string &tag) const
+{
+	for (std::vector<std::pair<std::string, std::string> >::const_iterator i = _chunks.begin(); i != _chunks.end(); ++i)
+	{
+		if (i->first == tag)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Gets the data of a chunk.
+ * @param tag Four letter tag.
+ * @return Chunk contents.
+ */
+const std::string &SaveContainer::getChunk(const std::string &tag) const
+{
+	for (std::vector<std::pair<std::string, std::string> >::const_iterator i = _chunks.begin(); i != _chunks.end(); ++i)
+	{
+		if (i->first == tag)
+		{
+			return i->second;
+		}
+	}
+	throw Exception("Save is missing the " + tag + " section");
+}
+
+}
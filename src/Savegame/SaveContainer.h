@@ -0,0 +1,64 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_SAVECONTAINER_H
+#define OPENXCOM_SAVECONTAINER_H
+
+#include <string>
+#include <vector>
+#include <SDL_types.h>
+
+namespace OpenXcom
+{
+
+/**
+ * A binary save file, made of tagged chunks of data.
+ * The file starts with a magic number and format version,
+ * followed by the chunks, each with a four letter tag, flags and
+ * its length in bytes. The whole file is read in one go.
+ * Version 2 added the battle's nodes, units and items as chunks
+ * of binary records. Version 1 saves kept them in the YAML.
+ */
+class SaveContainer
+{
+private:
+	static const char MAGIC[4];
+	static const Uint32 VERSION = 2;
+	std::vector<std::pair<std::string, std::string> > _chunks;
+public:
+	/// Creates an empty container.
+	SaveContainer();
+	/// Cleans up the container.
+	~SaveContainer();
+	/// Checks if a file is a binary save.
+	static bool isContainer(const std::string &filename);
+	/// Loads the container from a file.
+	void load(const std::string &filename, bool firstOnly = false);
+	/// Saves the container to a file.
+	void save(const std::string &filename) const;
+	/// Sets the data of a chunk.
+	void setChunk(const std::string &tag, const std::string &data);
+	/// Checks if a chunk is present.
+	bool hasChunk(const std::string &tag) const;
+	/// Gets the data of a chunk.
+	const std::string &getChunk(const std::string &tag) const;
+};
+
+}
+
+#endif
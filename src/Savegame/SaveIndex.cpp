@@ -0,0 +1,296 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "SaveIndex.h"
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <SDL.h>
+#include <SDL_thread.h>
+#include <yaml-cpp/yaml.h>
+#include "SaveContainer.h"
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/Exception.h"
+#include "../Engine/Logger.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+const char *INDEX_FILE = "saves.idx";
+
+/// Work shared by the threads reading saves.
+struct ParseJob
+{
+	std::string folder;
+	std::vector<SaveIndex::Entry*> entries;
+	size_t next;
+	SDL_mutex *mutex;
+};
+
+}
+
+/**
+ * Creates an empty entry.
+ */
+SaveIndex::Entry::Entry() : size(0), modified(0), time(6, 1, 1, 1999, 12, 0, 0), valid(false)
+{
+
+}
+
+/**
+ * Creates an index of the saves in a folder.
+ * @param folder Full path of the folder.
+ */
+SaveIndex::SaveIndex(const std::string &folder) : _folder(folder)
+{
+
+}
+
+/**
+ * Cleans up the index.
+ */
+SaveIndex::~SaveIndex()
+{
+
+}
+
+/**
+ * Loads the entries stored in the index file, if there is one.
+ * A broken index is just thrown away, it can always be rebuilt.
+ * @param entries Vector to add the entries to.
+ */
+void SaveIndex::load(std::vector<Entry> *entries) const
+{
+	std::string s = _folder + INDEX_FILE;
+	std::ifstream fin(s.c_str());
+	if (!fin)
+	{
+		return;
+	}
+	try
+	{
+		YAML::Parser parser(fin);
+		YAML::Node doc;
+		parser.GetNextDocument(doc);
+		for (YAML::Iterator i = doc.begin(); i != doc.end(); ++i)
+		{
+			Entry entry;
+			(*i)["file"] >> entry.file;
+			(*i)["size"] >> entry.size;
+			(*i)["modified"] >> entry.modified;
+			entry.time.load((*i)["time"]);
+			entry.valid = true;
+			entries->push_back(entry);
+		}
+	}
+	catch (YAML::Exception &e)
+	{
+		Log(LOG_WARNING) << INDEX_FILE << " is damaged and will be rebuilt: " << e.what();
+		entries->clear();
+	}
+	fin.close();
+}
+
+/**
+ * Saves the valid entries to the index file.
+ */
+void SaveIndex::save() const
+{
+	std::string s = _folder + INDEX_FILE;
+	std::ofstream fout(s.c_str());
+	if (!fout)
+	{
+		Log(LOG_WARNING) << "Failed to save " << INDEX_FILE;
+		return;
+	}
+	YAML::Emitter out;
+	out << YAML::BeginSeq;
+	for (std::vector<Entry>::const_iterator i = _entries.begin(); i != _entries.end(); ++i)
+	{
+		if (!i->valid)
+			continue;
+		out << YAML::BeginMap;
+		out << YAML::Key << "file" << YAML::Value << i->file;
+		out << YAML::Key << "size" << YAML::Value << i->size;
+		out << YAML::Key << "modified" << YAML::Value << i->modified;
+		out << YAML::Key << "time" << YAML::Value;
+		i->time.save(out);
+		out << YAML::EndMap;
+	}
+	out << YAML::EndSeq;
+	fout << out.c_str();
+	fout.close();
+}
+
+/**
+ * Reads the brief info of a save, from the first YAML document
+ * or the first chunk of a binary save. Errors are kept in the entry,
+ * since this runs outside the main thread.
+ * @param folder Full path of the folder.
+ * @param entry Entry to fill in.
+ */
+void SaveIndex::parse(const std::string &folder, Entry *entry)
+{
+	std::string fullname = folder + entry->file;
+	try
+	{
+		std::ifstream fin;
+		std::istringstream header;
+		std::istream *in = &fin;
+		if (SaveContainer::isContainer(fullname))
+		{
+			SaveContainer sav;
+			sav.load(fullname, true);
+			header.str(sav.getChunk("HEAD"));
+			in = &header;
+		}
+		else
+		{
+			fin.open(fullname.c_str());
+			if (!fin)
+			{
+				throw Exception("Failed to load " + entry->file);
+			}
+		}
+		YAML::Parser parser(*in);
+		YAML::Node doc;
+
+		parser.GetNextDocument(doc);
+		entry->time.load(doc["time"]);
+		entry->valid = true;
+	}
+	catch (Exception &e)
+	{
+		entry->error = e.what();
+	}
+	catch (YAML::Exception &e)
+	{
+		entry->error = e.what();
+	}
+}
+
+/**
+ * Keeps taking saves off the shared job and reading them until there's none left.
+ * @param data Pointer to the ParseJob.
+ * @return Always 0.
+ */
+int SaveIndex::parseThread(void *data)
+{
+	ParseJob *job = (ParseJob*)data;
+	while (true)
+	{
+		SDL_mutexP(job->mutex);
+		size_t next = job->next++;
+		SDL_mutexV(job->mutex);
+		if (next >= job->entries.size())
+			break;
+		parse(job->folder, job->entries[next]);
+	}
+	return 0;
+}
+
+/**
+ * Brings the index up to date with the saves in the folder.
+ * Saves with the same name, size and modification time as in the index file
+ * are taken from it, the rest are read again, and the index file is
+ * rewritten if anything changed.
+ */
+void SaveIndex::update()
+{
+	std::vector<Entry> cached;
+	load(&cached);
+	std::map<std::string, const Entry*> byName;
+	for (std::vector<Entry>::const_iterator i = cached.begin(); i != cached.end(); ++i)
+	{
+		byName[i->file] = &(*i);
+	}
+
+	std::vector<std::string> saves = CrossPlatform::getFolderContents(_folder, "sav");
+	bool changed = (saves.size() != cached.size());
+	_entries.clear();
+	_entries.resize(saves.size());
+	ParseJob job;
+	job.folder = _folder;
+	job.next = 0;
+	for (size_t i = 0; i < saves.size(); ++i)
+	{
+		Entry &entry = _entries[i];
+		entry.file = saves[i];
+		CrossPlatform::getFileInfo(_folder + entry.file, &entry.size, &entry.modified);
+		std::map<std::string, const Entry*>::const_iterator j = byName.find(entry.file);
+		if (j != byName.end() && j->second->size == entry.size && j->second->modified == entry.modified)
+		{
+			entry.time = j->second->time;
+			entry.valid = true;
+		}
+		else
+		{
+			job.entries.push_back(&entry);
+			changed = true;
+		}
+	}
+
+	if (!job.entries.empty())
+	{
+		job.mutex = SDL_CreateMutex();
+		std::vector<SDL_Thread*> threads;
+		for (int i = 1; i < THREADS && i < (int)job.entries.size(); ++i)
+		{
+			SDL_Thread *thread = SDL_CreateThread(parseThread, &job);
+			if (thread)
+			{
+				threads.push_back(thread);
+			}
+		}
+		// this thread does its share too
+		parseThread(&job);
+		for (std::vector<SDL_Thread*>::iterator i = threads.begin(); i != threads.end(); ++i)
+		{
+			SDL_WaitThread(*i, 0);
+		}
+		SDL_DestroyMutex(job.mutex);
+
+		for (std::vector<Entry*>::const_iterator i = job.entries.begin(); i != job.entries.end(); ++i)
+		{
+			if (!(*i)->valid)
+			{
+				Log(LOG_ERROR) << (*i)->error;
+			}
+		}
+	}
+
+	if (changed)
+	{
+		save();
+	}
+}
+
+/**
+ * Gets the saves in the index, in the order they are in the folder.
+ * Saves that couldn't be read are marked as not valid.
+ * @return List of entries.
+ */
+const std::vector<SaveIndex::Entry> &SaveIndex::getEntries() const
+{
+	return _entries;
+}
+
+}
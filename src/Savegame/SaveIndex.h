@@ -0,0 +1,73 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_SAVEINDEX_H
+#define OPENXCOM_SAVEINDEX_H
+
+#include <string>
+#include <vector>
+#include "GameTime.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Keeps the brief info of every save in a folder in one index file,
+ * so the list of saves doesn't have to open every one of them.
+ * Saves are recognized by their name, size and modification time,
+ * and only new or changed ones are read again, several at a time.
+ */
+class SaveIndex
+{
+public:
+	/// Brief info of a save.
+	struct Entry
+	{
+		std::string file;
+		unsigned long size, modified;
+		GameTime time;
+		bool valid;
+		std::string error;
+		Entry();
+	};
+private:
+	static const int THREADS = 4;
+	std::string _folder;
+	std::vector<Entry> _entries;
+	/// Loads the index file.
+	void load(std::vector<Entry> *entries) const;
+	/// Saves the index file.
+	void save() const;
+	/// Reads the brief info of a save.
+	static void parse(const std::string &folder, Entry *entry);
+	/// Reads saves until there's none left.
+	static int parseThread(void *data);
+public:
+	/// Creates an index of a folder.
+	SaveIndex(const std::string &folder);
+	/// Cleans up the index.
+	~SaveIndex();
+	/// Brings the index up to date with the folder.
+	void update();
+	/// Gets the saves in the index.
+	const std::vector<Entry> &getEntries() const;
+};
+
+}
+
+#endif
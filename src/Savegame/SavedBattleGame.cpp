@@ -22,10 +22,12 @@
 #include <vector>
 #include <deque>
 #include <queue>
+#include <new>
 
 #include "SavedBattleGame.h"
 #include "SavedGame.h"
 #include "Tile.h"
+#include "TileStore.h"
 #include "Node.h"
 #include <SDL.h>
 #include "../Ruleset/MapDataSet.h"
@@ -46,19 +48,55 @@
 #include "../Engine/RNG.h"
 #include "../Engine/Options.h"
 #include "../Engine/Logger.h"
+#include "../Engine/Exception.h"
 #include "SerializationHelper.h"
+#include "SaveContainer.h"
+#include "../Ruleset/RulesetCache.h"
 
 
 namespace OpenXcom
 {
 
+namespace
+{
+
+/**
+ * Appends a record to a chunk of a binary save, after its length,
+ * so readers can skip any fields added to it by newer versions.
+ * @param chunk Chunk writer.
+ * @param record Record contents.
+ */
+void writeRecord(CacheWriter &chunk, const CacheWriter &record)
+{
+	const std::vector<char> &data = record.getData();
+	chunk << (unsigned int)data.size();
+	if (!data.empty())
+	{
+		chunk.write(&data[0], data.size());
+	}
+}
+
+/**
+ * Reads the next record from a chunk of a binary save.
+ * @param chunk Chunk reader.
+ * @return Reader for the record contents.
+ */
+CacheReader readRecord(CacheReader &chunk)
+{
+	unsigned int size;
+	chunk >> size;
+	return CacheReader(chunk.skip(size), size);
+}
+
+}
+
 /**
  * Initializes a brand new battlescape saved game.
  */
 SavedBattleGame::SavedBattleGame() : _battleState(0), _mapsize_x(0), _mapsize_y(0),
-                                     _mapsize_z(0),   _tiles(), _selectedUnit(0),
+                                     _mapsize_z(0),   _tiles(), _tileBlock(0), _tileStore(0), _selectedUnit(0),
                                      _lastSelectedUnit(0), _nodes(), _units(),
-                                     _items(), _pathfinding(0), _tileEngine(0),
+                                     _items(), _pathfinding(0), _tileEngine(0), _resources(0),
                                      _missionType(""), _globalShade(0), _side(FACTION_PLAYER),
                                      _turn(1), _debugMode(false), _aborted(false),
                                      _itemId(0), _objectiveDestroyed(false), _fallingUnits(),
@@ -79,11 +117,7 @@ SavedBattleGame::SavedBattleGame() : _battleState(0), _mapsize_x(0), _mapsize_y(
  */
 SavedBattleGame::~SavedBattleGame()
 {
-	for (int i = 0; i < _mapsize_z * _mapsize_y * _mapsize_x; ++i)
-	{
-		delete _tiles[i];
-	}
-	delete[] _tiles;
+	deleteTiles();
 
 	for (std::vector<Node*>::iterator i = _nodes.begin(); i != _nodes.end(); ++i)
 	{
@@ -102,13 +136,22 @@ SavedBattleGame::~SavedBattleGame()
 
 	delete _pathfinding;
 	delete _tileEngine;
+
+	releaseMapDataSets();
+	if (_resources)
+	{
+		_resources->releaseBattlescapeResources();
+	}
 }
 
 /**
  * Loads the saved battle game from a YAML file.
  * @param node YAML node.
+ * @param rule Ruleset for the saved game.
+ * @param savedGame Pointer to the saved game.
+ * @param sav Binary save with the tiles, nodes, units and items, if they were saved apart from the YAML.
  */
-void SavedBattleGame::load(const YAML::Node &node, Ruleset *rule, SavedGame* savedGame)
+void SavedBattleGame::load(const YAML::Node &node, Ruleset *rule, SavedGame* savedGame, const SaveContainer *sav)
 {
 	int a,b;
 	int selectedUnit = 0;
@@ -166,9 +209,22 @@ void SavedBattleGame::load(const YAML::Node &node, Ruleset *rule, SavedGame* sav
 
 		// load binary tile data! 
 		YAML::Binary binTiles;
-		node["binTiles"] >> binTiles;
-
-		Uint8 *r = (Uint8*)binTiles.data();
+		Uint8 *r;
+		if (sav != 0 && sav->hasChunk("TILE") && !node.FindValue("binTiles"))
+		{
+			// binary saves keep the tiles in a chunk of their own
+			const std::string *tileData = &sav->getChunk("TILE");
+			if (tileData->size() < totalTiles * serKey.totalBytes)
+			{
+				throw Exception("Tile data is truncated");
+			}
+			r = (Uint8*)tileData->data();
+		}
+		else
+		{
+			node["binTiles"] >> binTiles;
+			r = (Uint8*)binTiles.data();
+		}
 		Uint8 *dataEnd = r + totalTiles * serKey.totalBytes;
 
 		while (r < dataEnd)
@@ -180,6 +236,18 @@ void SavedBattleGame::load(const YAML::Node &node, Ruleset *rule, SavedGame* sav
 		}		
 	}
 
+	if (node.FindValue("objectiveDestroyed"))
+	{
+		node["objectiveDestroyed"] >> _objectiveDestroyed;
+	}
+
+	if (sav != 0 && sav->hasChunk("UNIT"))
+	{
+		// binary saves keep the nodes, units and items as records
+		loadBinary(*sav, rule, savedGame, selectedUnit);
+		return;
+	}
+
 	for (YAML::Iterator i = node["nodes"].begin(); i != node["nodes"].end(); ++i)
 	{
 		Node *n = new Node();
@@ -305,9 +373,132 @@ void SavedBattleGame::load(const YAML::Node &node, Ruleset *rule, SavedGame* sav
 			}
 		}
 	}
-	if (node.FindValue("objectiveDestroyed"))
+}
+
+/**
+ * Loads the nodes, units and items from the record chunks of a binary
+ * save, the same way they're loaded from YAML, after the tiles.
+ * @param sav Binary save.
+ * @param rule Ruleset for the saved game.
+ * @param savedGame Pointer to the saved game.
+ * @param selectedUnit ID of the selected unit.
+ */
+void SavedBattleGame::loadBinary(const SaveContainer &sav, Ruleset *rule, SavedGame *savedGame, int selectedUnit)
+{
+	unsigned int count;
+
+	const std::string &nodeChunk = sav.getChunk("NODE");
+	CacheReader nodes(nodeChunk.data(), nodeChunk.size());
+	nodes >> count;
+	for (unsigned int i = 0; i < count; ++i)
 	{
-		node["objectiveDestroyed"] >> _objectiveDestroyed;
+		CacheReader in = readRecord(nodes);
+		Node *n = new Node();
+		n->loadBinary(in);
+		_nodes.push_back(n);
+	}
+
+	const std::string &unitChunk = sav.getChunk("UNIT");
+	CacheReader units(unitChunk.data(), unitChunk.size());
+	units >> count;
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		CacheReader in = readRecord(units);
+		int faction, id;
+		std::string type, armor, state;
+		in >> faction >> id >> type >> armor;
+
+		BattleUnit *b;
+		if (id < BattleUnit::MAX_SOLDIER_ID) // Unit is linked to a geoscape soldier
+		{
+			b = new BattleUnit(savedGame->getSoldier(id), (UnitFaction)faction);
+		}
+		else
+		{
+			b = new BattleUnit(rule->getUnit(type), (UnitFaction)faction, id, rule->getArmor(armor), savedGame->getDifficulty());
+		}
+		b->loadBinary(in);
+		_units.push_back(b);
+		in >> state;
+		if (faction == FACTION_PLAYER)
+		{
+			if (b->getId() == selectedUnit)
+				_selectedUnit = b;
+		}
+		else if (b->getStatus() != STATUS_DEAD)
+		{
+			BattleAIState *aiState;
+			if (state == "PATROL")
+			{
+				aiState = new PatrolBAIState(this, b, 0);
+			}
+			else if (state == "AGGRO")
+			{
+				aiState = new AggroBAIState(this, b);
+			}
+			else
+			{
+				continue;
+			}
+			aiState->loadBinary(in);
+			b->setAIState(aiState);
+		}
+	}
+	updateExposedUnits();
+	resetUnitTiles();
+
+	const std::string &itemChunk = sav.getChunk("ITEM");
+	CacheReader items(itemChunk.data(), itemChunk.size());
+	std::vector<int> ammoIds;
+	items >> count;
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		CacheReader in = readRecord(items);
+		int owner, unit, ammo;
+		std::string type, slot;
+		Position pos;
+		in >> _itemId >> type >> slot >> owner >> unit >> pos.x >> pos.y >> pos.z >> ammo;
+
+		BattleItem *item = new BattleItem(rule->getItem(type), &_itemId);
+		item->loadBinary(in);
+		if (slot != "NULL")
+			item->setSlot(rule->getInventory(slot));
+
+		// match up items and units
+		for (std::vector<BattleUnit*>::iterator bu = _units.begin(); bu != _units.end(); ++bu)
+		{
+			if ((*bu)->getId() == owner)
+			{
+				item->moveToOwner(*bu);
+			}
+			if ((*bu)->getId() == unit)
+			{
+				item->setUnit(*bu);
+			}
+		}
+
+		// match up items and tiles
+		if (item->getSlot() && item->getSlot()->getType() == INV_GROUND && pos.x != -1)
+		{
+			getTile(pos)->addItem(item, rule->getInventory("STR_GROUND"));
+		}
+		_items.push_back(item);
+		ammoIds.push_back(ammo);
+	}
+
+	// tie ammo items to their weapons
+	for (size_t i = 0; i != _items.size(); ++i)
+	{
+		if (ammoIds[i] == -1)
+			continue;
+		for (std::vector<BattleItem*>::iterator ammoi = _items.begin(); ammoi != _items.end(); ++ammoi)
+		{
+			if ((*ammoi)->getId() == ammoIds[i])
+			{
+				_items[i]->setAmmoItem(*ammoi);
+				break;
+			}
+		}
 	}
 }
 
@@ -318,9 +509,10 @@ void SavedBattleGame::load(const YAML::Node &node, Ruleset *rule, SavedGame* sav
 void SavedBattleGame::loadMapResources(Game *game)
 {
 	ResourcePack *res = game->getResourcePack();
+	acquireResources(res);
 	for (std::vector<MapDataSet*>::const_iterator i = _mapDataSets.begin(); i != _mapDataSets.end(); ++i)
 	{
-		(*i)->loadData();
+		res->acquireTerrain(*i);
 		if (game->getRuleset()->getMCDPatch((*i)->getName()))
 		{
 			game->getRuleset()->getMCDPatch((*i)->getName())->modifyData(*i);
@@ -351,8 +543,9 @@ void SavedBattleGame::loadMapResources(Game *game)
 /**
  * Saves the saved battle game to a YAML file.
  * @param out YAML emitter.
+ * @param sav If set, the tiles, nodes, units and items are stored in this binary save instead of in the YAML.
  */
-void SavedBattleGame::save(YAML::Emitter &out) const
+void SavedBattleGame::save(YAML::Emitter &out, SaveContainer *sav) const
 {
 	out << YAML::BeginMap;
 	if (_objectiveDestroyed)
@@ -412,37 +605,107 @@ void SavedBattleGame::save(YAML::Emitter &out) const
 		}
 	}
 	out << YAML::Key << "totalTiles" << YAML::Value << tileDataSize / Tile::serializationKey.totalBytes; // not strictly necessary, just convenient
-	out << YAML::Key << "binTiles" << YAML::Value << YAML::Binary(tileData, tileDataSize);
+	if (sav != 0)
+	{
+		sav->setChunk("TILE", std::string((const char*)tileData, tileDataSize));
+	}
+	else
+	{
+		out << YAML::Key << "binTiles" << YAML::Value << YAML::Binary(tileData, tileDataSize);
+	}
     free(tileData);
 
 
 #endif
 
-	out << YAML::Key << "nodes" << YAML::Value;
-	out << YAML::BeginSeq;
+	if (sav != 0)
+	{
+		saveBinary(*sav);
+	}
+	else
+	{
+		out << YAML::Key << "nodes" << YAML::Value;
+		out << YAML::BeginSeq;
+		for (std::vector<Node*>::const_iterator i = _nodes.begin(); i != _nodes.end(); ++i)
+		{
+			(*i)->save(out);
+		}
+		out << YAML::EndSeq;
+
+		out << YAML::Key << "units" << YAML::Value;
+		out << YAML::BeginSeq;
+		for (std::vector<BattleUnit*>::const_iterator i = _units.begin(); i != _units.end(); ++i)
+		{
+			(*i)->save(out);
+		}
+		out << YAML::EndSeq;
+
+		out << YAML::Key << "items" << YAML::Value;
+		out << YAML::BeginSeq;
+		for (std::vector<BattleItem*>::const_iterator i = _items.begin(); i != _items.end(); ++i)
+		{
+			(*i)->save(out);
+		}
+		out << YAML::EndSeq;
+	}
+
+	out << YAML::EndMap;
+}
+
+/**
+ * Saves the nodes, units and items to a binary save, each as
+ * a chunk of length-prefixed records after a record count.
+ * Anything a record links to is stored by its ID.
+ * @param sav Binary save.
+ */
+void SavedBattleGame::saveBinary(SaveContainer &sav) const
+{
+	CacheWriter nodes(_nodes.size() * 64);
+	nodes << (unsigned int)_nodes.size();
 	for (std::vector<Node*>::const_iterator i = _nodes.begin(); i != _nodes.end(); ++i)
 	{
-		(*i)->save(out);
+		CacheWriter record(64);
+		(*i)->saveBinary(record);
+		writeRecord(nodes, record);
 	}
-	out << YAML::EndSeq;
+	sav.setChunk("NODE", std::string(nodes.getData().begin(), nodes.getData().end()));
 
-	out << YAML::Key << "units" << YAML::Value;
-	out << YAML::BeginSeq;
+	CacheWriter units(_units.size() * 256);
+	units << (unsigned int)_units.size();
 	for (std::vector<BattleUnit*>::const_iterator i = _units.begin(); i != _units.end(); ++i)
 	{
-		(*i)->save(out);
+		CacheWriter record(256);
+		record << (int)(*i)->getFaction() << (*i)->getId() << (*i)->getType() << (*i)->getArmor()->getType();
+		(*i)->saveBinary(record);
+		if ((*i)->getCurrentAIState())
+		{
+			(*i)->getCurrentAIState()->saveBinary(record);
+		}
+		else
+		{
+			record << std::string();
+		}
+		writeRecord(units, record);
 	}
-	out << YAML::EndSeq;
+	sav.setChunk("UNIT", std::string(units.getData().begin(), units.getData().end()));
 
-	out << YAML::Key << "items" << YAML::Value;
-	out << YAML::BeginSeq;
+	CacheWriter items(_items.size() * 96);
+	items << (unsigned int)_items.size();
 	for (std::vector<BattleItem*>::const_iterator i = _items.begin(); i != _items.end(); ++i)
 	{
-		(*i)->save(out);
+		BattleItem *item = *i;
+		CacheWriter record(96);
+		record << item->getId() << item->getRules()->getType();
+		record << (item->getSlot() ? item->getSlot()->getId() : std::string("NULL"));
+		record << (item->getOwner() ? item->getOwner()->getId() : -1);
+		record << (item->getUnit() ? item->getUnit()->getId() : -1);
+		Position pos = item->getTile() ? item->getTile()->getPosition() : Position(-1, -1, -1);
+		record << pos.x << pos.y << pos.z;
+		record << (item->getAmmoItem() ? item->getAmmoItem()->getId() : -1);
+		item->saveBinary(record);
+		writeRecord(items, record);
 	}
-	out << YAML::EndSeq;
-
-	out << YAML::EndMap;
+	sav.setChunk("ITEM", std::string(items.getData().begin(), items.getData().end()));
 }
 
 /**
@@ -454,6 +717,16 @@ Tile **SavedBattleGame::getTiles() const
 	return _tiles;
 }
 
+/**
+ * Gets the arrays that hold the state of every tile, one field at a time,
+ * in the same order as the tiles.
+ * @return Pointer to the tile store.
+ */
+TileStore *SavedBattleGame::getTileStore() const
+{
+	return _tileStore;
+}
+
 /**
  * Initializes the array of tiles + creates a pathfinding object.
  * @param mapsize_x
@@ -464,11 +737,7 @@ void SavedBattleGame::initMap(int mapsize_x, int mapsize_y, int mapsize_z)
 {
 	if (!_nodes.empty())
 	{
-		for (int i = 0; i < _mapsize_z * _mapsize_y * _mapsize_x; ++i)
-		{
-			delete _tiles[i];
-		}
-		delete[] _tiles;
+		deleteTiles();
 
 		for (std::vector<Node*>::iterator i = _nodes.begin(); i != _nodes.end(); ++i)
 		{
@@ -476,32 +745,90 @@ void SavedBattleGame::initMap(int mapsize_x, int mapsize_y, int mapsize_z)
 		}
 
 		_nodes.clear();
-		_mapDataSets.clear();
+		releaseMapDataSets();
+	}
+	if (_tileEngine)
+	{
+		_tileEngine->resetMapCache();
+	}
+	if (_pathfinding)
+	{
+		_pathfinding->invalidateStepCosts();
 	}
 	_mapsize_x = mapsize_x;
 	_mapsize_y = mapsize_y;
 	_mapsize_z = mapsize_z;
 	_tiles = new Tile*[_mapsize_z * _mapsize_y * _mapsize_x];
-	/* create tile objects */
+	/* create tile objects, all in one block so sweeping the map walks through memory in order,
+	   with the fields the sweeps look at kept in arrays of their own */
+	_tileStore = new TileStore(_mapsize_z * _mapsize_y * _mapsize_x);
+	_tileBlock = static_cast<Tile*>(::operator new(sizeof(Tile) * _mapsize_z * _mapsize_y * _mapsize_x));
 	for (int i = 0; i < _mapsize_z * _mapsize_y * _mapsize_x; ++i)
 	{
 		Position pos;
 		getTileCoords(i, &pos.x, &pos.y, &pos.z);
-		_tiles[i] = new Tile(pos);
+		_tiles[i] = new (_tileBlock + i) Tile(pos, _tileStore, i);
 	}
 
 }
 
+/**
+ * Destroys the tiles of the map and frees their storage.
+ */
+void SavedBattleGame::deleteTiles()
+{
+	for (int i = 0; i < _mapsize_z * _mapsize_y * _mapsize_x; ++i)
+	{
+		_tiles[i]->~Tile();
+	}
+	::operator delete(_tileBlock);
+	delete _tileStore;
+	delete[] _tiles;
+	_tileBlock = 0;
+	_tileStore = 0;
+	_tiles = 0;
+}
+
 /**
  * Initializes the map utilities.
  * @param res Pointer to resource pack.
  */
 void SavedBattleGame::initUtilities(ResourcePack *res)
 {
+	acquireResources(res);
 	_pathfinding = new Pathfinding(this);
 	_tileEngine = new TileEngine(this, res->getVoxelData());
 }
 
+/**
+ * Keeps the resources only used in battle loaded until the battle is over.
+ * @param res Pointer to resource pack.
+ */
+void SavedBattleGame::acquireResources(ResourcePack *res)
+{
+	if (_resources == 0)
+	{
+		_resources = res;
+		_resources->acquireBattlescapeResources();
+	}
+}
+
+/**
+ * Lets go of the map data sets used by the map,
+ * so their data can be unloaded.
+ */
+void SavedBattleGame::releaseMapDataSets()
+{
+	if (_resources)
+	{
+		for (std::vector<MapDataSet*>::const_iterator i = _mapDataSets.begin(); i != _mapDataSets.end(); ++i)
+		{
+			_resources->releaseTerrain(*i);
+		}
+	}
+	_mapDataSets.clear();
+}
+
 /**
  * Sets the mission type.
  * @param missionType
@@ -1160,13 +1487,16 @@ void SavedBattleGame::prepareNewTurn()
 {
 	std::vector<Tile*> tilesOnFire;
 	std::vector<Tile*> tilesOnSmoke;
+	const int size = _mapsize_x * _mapsize_y * _mapsize_z;
+	const int *fire = _tileStore->getFire();
+	const int *smoke = _tileStore->getSmoke();
 
 	// prepare a list of tiles on fire
-	for (int i = 0; i < _mapsize_x * _mapsize_y * _mapsize_z; ++i)
+	for (int i = 0; i < size; ++i)
 	{
-		if (getTiles()[i]->getFire() > 0)
+		if (fire[i] > 0)
 		{
-			tilesOnFire.push_back(getTiles()[i]);
+			tilesOnFire.push_back(_tiles[i]);
 		}
 	}
 
@@ -1230,11 +1560,11 @@ void SavedBattleGame::prepareNewTurn()
 	}
 
 	// prepare a list of tiles on fire/with smoke in them (smoke acts as fire intensity)
-	for (int i = 0; i < _mapsize_x * _mapsize_y * _mapsize_z; ++i)
+	for (int i = 0; i < size; ++i)
 	{
-		if (getTiles()[i]->getSmoke() > 0)
+		if (smoke[i] > 0)
 		{
-			tilesOnSmoke.push_back(getTiles()[i]);
+			tilesOnSmoke.push_back(_tiles[i]);
 		}
 	}
 
@@ -1293,13 +1623,15 @@ void SavedBattleGame::prepareNewTurn()
 	if (!tilesOnFire.empty() || !tilesOnSmoke.empty())
 	{
 		// do damage to units, average out the smoke, etc.
-		for (int i = 0; i < _mapsize_x * _mapsize_y * _mapsize_z; ++i)
+		for (int i = 0; i < size; ++i)
 		{
-			if (getTiles()[i]->getSmoke() != 0)
-				getTiles()[i]->prepareNewTurn();
+			if (smoke[i] != 0)
+				_tiles[i]->prepareNewTurn();
 		}
 		// fires could have been started, stopped or smoke could reveal/conceal units.
 		getTileEngine()->calculateTerrainLighting();
+		// and burnt out terrain could have been destroyed
+		getPathfinding()->invalidateStepCosts();
 	}
 
 	reviveUnconsciousUnits();
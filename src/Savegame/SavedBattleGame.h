@@ -31,6 +31,7 @@ namespace OpenXcom
 {
 
 class Tile;
+class TileStore;
 class SavedGame;
 class MapDataSet;
 class RuleUnit;
@@ -46,6 +47,7 @@ class BattleItem;
 class Item;
 class RuleInventory;
 class Ruleset;
+class SaveContainer;
 
 /**
  * The battlescape data that gets written to disk when the game is saved.
@@ -59,12 +61,15 @@ private:
 	int _mapsize_x, _mapsize_y, _mapsize_z;
 	std::vector<MapDataSet*> _mapDataSets;
 	Tile **_tiles;
+	Tile *_tileBlock;
+	TileStore *_tileStore;
 	BattleUnit *_selectedUnit, *_lastSelectedUnit;
 	std::vector<Node*> _nodes;
 	std::vector<BattleUnit*> _units;
 	std::vector<BattleItem*> _items;
 	Pathfinding *_pathfinding;
 	TileEngine *_tileEngine;
+	ResourcePack *_resources;
 	std::string _missionType;
 	int _globalShade;
 	UnitFaction _side;
@@ -80,19 +85,29 @@ private:
 	std::vector<BattleUnit*> _exposedUnits;
 	std::list<BattleUnit*> _fallingUnits;
 	bool _unitsFalling, _strafeEnabled, _sneaky, _traceAI;
+	/// Lets go of the map data sets.
+	void releaseMapDataSets();
+	/// Destroys the tiles of the map.
+	void deleteTiles();
+	/// Loads the nodes, units and items from a binary save.
+	void loadBinary(const SaveContainer &sav, Ruleset *rule, SavedGame *savedGame, int selectedUnit);
+	/// Saves the nodes, units and items to a binary save.
+	void saveBinary(SaveContainer &sav) const;
 public:
 	/// Creates a new battle save, based on current generic save.
 	SavedBattleGame();
 	/// Cleans up the saved game.
 	~SavedBattleGame();
 	/// Loads a saved battle game from YAML.
-	void load(const YAML::Node& node, Ruleset *rule, SavedGame* savedGame);
+	void load(const YAML::Node& node, Ruleset *rule, SavedGame* savedGame, const SaveContainer *sav = 0);
 	/// Saves a saved battle game to YAML.
-	void save(YAML::Emitter& out) const;
+	void save(YAML::Emitter& out, SaveContainer *sav = 0) const;
 	/// Set the dimensions of the map and initializes it.
 	void initMap(int mapsize_x, int mapsize_y, int mapsize_z);
 	/// initialises pathfinding and tileengine
 	void initUtilities(ResourcePack *res);
+	/// Keeps the battle resources loaded.
+	void acquireResources(ResourcePack *res);
 	/// Gets the game's mapdatafiles.
 	std::vector<MapDataSet*> *getMapDataSets();
 	/// Set the mission type.
@@ -105,6 +120,8 @@ public:
 	int getGlobalShade() const;
 	/// Gets pointer to the tiles, a tile is the smallest component of battlescape.
 	Tile **getTiles() const;
+	/// Gets the per-field arrays the tiles keep their state in.
+	TileStore *getTileStore() const;
 	/// Get pointer to the list of nodes.
 	std::vector<Node*> *getNodes();
 	/// Get pointer to the list of items.
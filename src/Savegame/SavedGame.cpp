@@ -22,6 +22,7 @@
 #include <iomanip>
 #include <algorithm>
 #include <yaml-cpp/yaml.h>
+#include <SDL.h>
 #include "../version.h"
 #include "../Engine/Logger.h"
 #include "../Ruleset/Ruleset.h"
@@ -32,6 +33,8 @@
 #include "../Engine/Options.h"
 #include "../Engine/CrossPlatform.h"
 #include "SavedBattleGame.h"
+#include "SaveContainer.h"
+#include "SaveIndex.h"
 #include "GameTime.h"
 #include "Country.h"
 #include "Base.h"
@@ -50,18 +53,19 @@
 #include "AlienStrategy.h"
 #include "AlienMission.h"
 #include "../Ruleset/RuleRegion.h"
+#include "../Ruleset/RuleCountry.h"
 
 namespace OpenXcom
 {
 struct findRuleResearch : public std::unary_function<ResearchProject *,
 								bool>
 {
-	RuleResearch * _toFind;
-	findRuleResearch(RuleResearch * toFind);
+	const RuleResearch * _toFind;
+	findRuleResearch(const RuleResearch * toFind);
 	bool operator()(const ResearchProject *r) const;
 };
 
-findRuleResearch::findRuleResearch(RuleResearch * toFind) : _toFind(toFind)
+findRuleResearch::findRuleResearch(const RuleResearch * toFind) : _toFind(toFind)
 {
 }
 
@@ -87,6 +91,31 @@ bool equalProduction::operator()(const Production * p) const
 	return p->getRules() == _item;
 }
 
+/**
+ * Sets a research ID in a research bitset, growing it as needed.
+ * @param bits Research bitset.
+ * @param id Research ID, -1 is ignored.
+ */
+static void setBit(std::vector<bool> &bits, int id)
+{
+	if (id < 0)
+		return;
+	if ((size_t)id >= bits.size())
+		bits.resize(id + 1, false);
+	bits[id] = true;
+}
+
+/**
+ * Gets if a research ID is set in a research bitset.
+ * @param bits Research bitset.
+ * @param id Research ID.
+ * @return True if it's set, -1 never is.
+ */
+static bool getBit(const std::vector<bool> &bits, int id)
+{
+	return id >= 0 && (size_t)id < bits.size() && bits[id];
+}
+
 /**
  * Initializes a brand new saved game according to the specified difficulty.
  */
@@ -150,73 +179,103 @@ SavedGame::~SavedGame()
  */
 void SavedGame::getList(TextList *list, Language *lang)
 {
-	std::vector<std::string> saves = CrossPlatform::getFolderContents(Options::getUserFolder(), "sav");
+	SaveIndex index(Options::getUserFolder());
+	index.update();
 
-	for (std::vector<std::string>::iterator i = saves.begin(); i != saves.end(); ++i)
+	for (std::vector<SaveIndex::Entry>::const_iterator i = index.getEntries().begin(); i != index.getEntries().end(); ++i)
 	{
-		std::string file = (*i);
-		std::string fullname = Options::getUserFolder() + file;
-		std::ifstream fin(fullname.c_str());
-		try
-		{
-			if (!fin)
-			{
-				throw Exception("Failed to load " + file);
-			}
-			YAML::Parser parser(fin);
-			YAML::Node doc;
-
-			parser.GetNextDocument(doc);
-			GameTime time = GameTime(6, 1, 1, 1999, 12, 0, 0);
-			time.load(doc["time"]);
-			std::stringstream saveTime;
-			std::wstringstream saveDay, saveMonth, saveYear;
-			saveTime << time.getHour() << ":" << std::setfill('0') << std::setw(2) << time.getMinute();
-			saveDay << time.getDay() << lang->getString(time.getDayString());
-			saveMonth << lang->getString(time.getMonthString());
-			saveYear << time.getYear();
-
-			std::string s = file.substr(0, file.length()-4);
+		if (!i->valid)
+			continue;
+		const GameTime &time = i->time;
+		std::stringstream saveTime;
+		std::wstringstream saveDay, saveMonth, saveYear;
+		saveTime << time.getHour() << ":" << std::setfill('0') << std::setw(2) << time.getMinute();
+		saveDay << time.getDay() << lang->getString(time.getDayString());
+		saveMonth << lang->getString(time.getMonthString());
+		saveYear << time.getYear();
+
+		std::string s = i->file.substr(0, i->file.length()-4);
 #ifdef _WIN32
-			std::wstring wstr = Language::cpToWstr(s);
+		std::wstring wstr = Language::cpToWstr(s);
 #else
-			std::wstring wstr = Language::utf8ToWstr(s);
+		std::wstring wstr = Language::utf8ToWstr(s);
 #endif
-			list->addRow(5, wstr.c_str(), Language::utf8ToWstr(saveTime.str()).c_str(), saveDay.str().c_str(), saveMonth.str().c_str(), saveYear.str().c_str());
-			fin.close();
-		}
-		catch (Exception &e)
-		{
-			Log(LOG_ERROR) << e.what();
-			continue;
-		}
-		catch (YAML::Exception &e)
-		{
-			Log(LOG_ERROR) << e.what();
-			continue;
-		}
+		list->addRow(5, wstr.c_str(), Language::utf8ToWstr(saveTime.str()).c_str(), saveDay.str().c_str(), saveMonth.str().c_str(), saveYear.str().c_str());
 	}
 }
 
 /**
- * Loads a saved game's contents from a YAML file.
+ * Loads a saved game's contents from a YAML file or binary save.
  * @note Assumes the saved game is blank.
  * @param filename YAML filename.
  * @param rule Ruleset for the saved game.
  */
 void SavedGame::load(const std::string &filename, Ruleset *rule)
 {
+	Uint32 startTicks = SDL_GetTicks();
 	std::string s = Options::getUserFolder() + filename + ".sav";
-	std::ifstream fin(s.c_str());
-	if (!fin)
+	if (SaveContainer::isContainer(s))
 	{
-		throw Exception("Failed to load " + filename + ".sav");
+		SaveContainer sav;
+		sav.load(s);
+		YAML::Node doc;
+
+		// Get brief save info
+		std::istringstream head(sav.getChunk("HEAD"));
+		YAML::Parser headParser(head);
+		headParser.GetNextDocument(doc);
+		loadHeader(doc);
+
+		// Get full save data
+		std::istringstream game(sav.getChunk("GAME"));
+		YAML::Parser gameParser(game);
+		gameParser.GetNextDocument(doc);
+		loadGame(doc, rule);
+
+		if (sav.hasChunk("BATL"))
+		{
+			std::istringstream battle(sav.getChunk("BATL"));
+			YAML::Parser battleParser(battle);
+			battleParser.GetNextDocument(doc);
+			_battleGame = new SavedBattleGame();
+			_battleGame->load(doc, rule, this, &sav);
+		}
 	}
-	YAML::Parser parser(fin);
-	YAML::Node doc;
+	else
+	{
+		std::ifstream fin(s.c_str());
+		if (!fin)
+		{
+			throw Exception("Failed to load " + filename + ".sav");
+		}
+		YAML::Parser parser(fin);
+		YAML::Node doc;
+
+		// Get brief save info
+		parser.GetNextDocument(doc);
+		loadHeader(doc);
 
-	// Get brief save info
-	parser.GetNextDocument(doc);
+		// Get full save data
+		parser.GetNextDocument(doc);
+		loadGame(doc, rule);
+
+		if (const YAML::Node *pName = doc.FindValue("battleGame"))
+		{
+			_battleGame = new SavedBattleGame();
+			_battleGame->load(*pName, rule, this);
+		}
+
+		fin.close();
+	}
+	Log(LOG_INFO) << "Loaded " << filename << " in " << SDL_GetTicks() - startTicks << "ms.";
+}
+
+/**
+ * Loads the brief save info and checks it's compatible.
+ * @param doc YAML node.
+ */
+void SavedGame::loadHeader(const YAML::Node &doc)
+{
 	std::string v;
 	doc["version"] >> v;
 	if (v != OPENXCOM_VERSION_SHORT)
@@ -224,9 +283,15 @@ void SavedGame::load(const std::string &filename, Ruleset *rule)
 		throw Exception("Version mismatch");
 	}
 	_time->load(doc["time"]);
+}
 
-	// Get full save data
-	parser.GetNextDocument(doc);
+/**
+ * Loads the full save data, apart from the battle.
+ * @param doc YAML node.
+ * @param rule Ruleset for the saved game.
+ */
+void SavedGame::loadGame(const YAML::Node &doc, Ruleset *rule)
+{
 	int a = 0;
 	doc["difficulty"] >> a;
 	_difficulty = (GameDifficulty)a;
@@ -332,7 +397,7 @@ void SavedGame::load(const std::string &filename, Ruleset *rule)
 	{
 		std::string research;
 		*it >> research;
-		_discovered.push_back(rule->getResearch(research));
+		addDiscovered(rule->getResearch(research));
 	}
 	
 	if (const YAML::Node *pName = doc.FindValue("poppedResearch"))
@@ -345,40 +410,119 @@ void SavedGame::load(const std::string &filename, Ruleset *rule)
 		}
 	}
 	_alienStrategy->load(rule, doc["alienStrategy"]);
+}
 
-	if (const YAML::Node *pName = doc.FindValue("battleGame"))
+/**
+ * Saves a saved game's contents to a YAML file,
+ * or a binary save if the binarySaves option is on.
+ * @param filename YAML filename.
+ */
+void SavedGame::save(const std::string &filename) const
+{
+	Uint32 startTicks = SDL_GetTicks();
+	std::string s = Options::getUserFolder() + filename + ".sav";
+	if (Options::getBool("binarySaves"))
 	{
-		_battleGame = new SavedBattleGame();
-		_battleGame->load(*pName, rule, this);
+		saveBinary(s);
 	}
-
-	fin.close();
+	else
+	{
+		saveYaml(s);
+	}
+	Log(LOG_INFO) << "Saved " << filename << " in " << SDL_GetTicks() - startTicks << "ms.";
 }
 
 /**
  * Saves a saved game's contents to a YAML file.
- * @param filename YAML filename.
+ * @param filename Full path of the file.
  */
-void SavedGame::save(const std::string &filename) const
+void SavedGame::saveYaml(const std::string &filename) const
 {
-	std::string s = Options::getUserFolder() + filename + ".sav";
-	std::ofstream sav(s.c_str());
+	std::ofstream sav(filename.c_str());
 	if (!sav)
 	{
-		throw Exception("Failed to save " + filename + ".sav");
+		throw Exception("Failed to save " + filename);
 	}
 
 	YAML::Emitter out;
 
 	// Saves the brief game info used in the saves list
+	saveHeader(out);
+
+	// Saves the full game data to the save
+	out << YAML::BeginDoc;
+	saveGame(out, true);
+	sav << out.c_str();
+	sav.close();
+}
+
+/**
+ * Saves a saved game's contents to a binary save.
+ * The brief info, the game and the battle each go in a chunk of
+ * their own. The battle's tiles, nodes, units and items are
+ * stored in binary chunks of their own instead of in the YAML.
+ * @param filename Full path of the file.
+ */
+void SavedGame::saveBinary(const std::string &filename) const
+{
+	SaveContainer sav;
+
+	YAML::Emitter head;
+	saveHeader(head);
+	sav.setChunk("HEAD", head.c_str());
+
+	YAML::Emitter game;
+	saveGame(game, false);
+	sav.setChunk("GAME", game.c_str());
+
+	if (_battleGame != 0)
+	{
+		YAML::Emitter battle;
+		_battleGame->save(battle, &sav);
+		sav.setChunk("BATL", battle.c_str());
+	}
+
+	sav.save(filename);
+}
+
+/**
+ * Returns a checksum of everything that goes in the save
+ * besides the battle, including the RNG, so two games
+ * can be compared without comparing their saves.
+ * @return FNV-1a hash of the game data.
+ */
+unsigned int SavedGame::getChecksum() const
+{
+	YAML::Emitter out;
+	saveGame(out, false);
+	Uint32 hash = 2166136261u;
+	for (const char *c = out.c_str(); *c != 0; ++c)
+	{
+		hash = (hash ^ (Uint8)*c) * 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * Saves the brief game info used in the saves list.
+ * @param out YAML emitter.
+ */
+void SavedGame::saveHeader(YAML::Emitter &out) const
+{
 	out << YAML::BeginMap;
 	out << YAML::Key << "version" << YAML::Value << OPENXCOM_VERSION_SHORT;
 	out << YAML::Key << "time" << YAML::Value;
 	_time->save(out);
 	out << YAML::EndMap;
+}
 
-	// Saves the full game data to the save
-	out << YAML::BeginDoc;
+/**
+ * Saves the full game data.
+ * @param out YAML emitter.
+ * @param battle Include the battle in the game data.
+ */
+void SavedGame::saveGame(YAML::Emitter &out, bool battle) const
+{
 	out << YAML::BeginMap;
 	out << YAML::Key << "difficulty" << YAML::Value << _difficulty;
 	out << YAML::Key << "monthsPassed" << YAML::Value << _monthsPassed;
@@ -471,14 +615,47 @@ void SavedGame::save(const std::string &filename) const
 	out << YAML::EndSeq;
 	out << YAML::Key << "alienStrategy" << YAML::Value;
 	_alienStrategy->save(out);
-	if (_battleGame != 0)
+	if (battle && _battleGame != 0)
 	{
 		out << YAML::Key << "battleGame" << YAML::Value;
 		_battleGame->save(out);
 	}
 	out << YAML::EndMap;
-	sav << out.c_str();
-	sav.close();
+}
+
+/**
+ * Converts a save between the YAML and binary formats, by loading it
+ * and saving it again in the other format under the same name.
+ * The RNG is left as it was, even though loading a save changes it.
+ * @param filename Save filename.
+ * @param rule Ruleset for the saved game.
+ * @return True if the save was converted to the binary format, False if to YAML.
+ */
+bool SavedGame::convert(const std::string &filename, Ruleset *rule)
+{
+	std::string s = Options::getUserFolder() + filename + ".sav";
+	bool binary = !SaveContainer::isContainer(s);
+	RNG::Snapshot rng = RNG::snapshot();
+	try
+	{
+		SavedGame save;
+		save.load(filename, rule);
+		if (binary)
+		{
+			save.saveBinary(s);
+		}
+		else
+		{
+			save.saveYaml(s);
+		}
+	}
+	catch (...)
+	{
+		RNG::restore(rng);
+		throw;
+	}
+	RNG::restore(rng);
+	return binary;
 }
 
 /**
@@ -742,16 +919,33 @@ void SavedGame::setBattleGame(SavedBattleGame *battleGame)
 	_battleGame = battleGame;
 }
 
+/**
+ * Adds a research to the list of discovered research,
+ * and marks it and everything it unlocks in the research bitsets.
+ * @param r The discovered research.
+ */
+void SavedGame::addDiscovered(const RuleResearch *r)
+{
+	_discovered.push_back(r);
+	if (r == 0)
+		return;
+	setBit(_researched, r->getId());
+	_researchedNames.insert(r->getName());
+	for (std::vector<int>::const_iterator i = r->getUnlockIds().begin(); i != r->getUnlockIds().end(); ++i)
+	{
+		setBit(_unlocked, *i);
+	}
+}
+
 /**
  * Add a ResearchProject to the list of already discovered ResearchProject
  * @param r The newly found ResearchProject
 */
 void SavedGame::addFinishedResearch (const RuleResearch * r, const Ruleset * ruleset)
 {
-	std::vector<const RuleResearch *>::const_iterator itDiscovered = std::find(_discovered.begin (), _discovered.end (), r);
-	if(itDiscovered == _discovered.end())
+	if(!getBit(_researched, r->getId()))
 	{
-		_discovered.push_back(r);
+		addDiscovered(r);
 		removePoppedResearch(r);
 		addResearchScore(r->getPoints());
 	}
@@ -801,98 +995,80 @@ const std::vector<const RuleResearch *> & SavedGame::getDiscoveredResearch() con
 */
 void SavedGame::getAvailableResearchProjects (std::vector<RuleResearch *> & projects, const Ruleset * ruleset, Base * base) const
 {
-	const std::vector<const RuleResearch *> & discovered(getDiscoveredResearch());
-	std::vector<std::string> researchProjects = ruleset->getResearchList();
-	const std::vector<ResearchProject *> & baseResearchProjects = base->getResearch();
-	std::vector<const RuleResearch *> unlocked;
-	for(std::vector<const RuleResearch *>::const_iterator it = discovered.begin (); it != discovered.end (); ++it)
+	int count = ruleset->getResearchList().size();
+	for (int id = 0; id != count; ++id)
 	{
-		for(std::vector<std::string>::const_iterator itUnlocked = (*it)->getUnlocked ().begin (); itUnlocked != (*it)->getUnlocked ().end (); ++itUnlocked)
+		RuleResearch *research = ruleset->getResearch(id);
+		if (isProjectAvailable(research, ruleset, base))
 		{
-			unlocked.push_back(ruleset->getResearch(*itUnlocked));
+			projects.push_back(research);
 		}
 	}
-	for(std::vector<std::string>::const_iterator iter = researchProjects.begin (); iter != researchProjects.end (); ++iter)
+}
+
+/**
+   Check whether a RuleResearch can be started in a Base: it must be available,
+   not discovered yet (unless it's a live alien with more to tell), not already
+   in progress, and have its item and required research.
+   * @param research the RuleResearch to test.
+   * @param ruleset the Game Ruleset
+   * @param base a pointer to a Base
+   * @return true if the RuleResearch can be started
+*/
+bool SavedGame::isProjectAvailable(const RuleResearch *research, const Ruleset *ruleset, Base *base) const
+{
+	if (!isResearchAvailable(research, _unlocked, ruleset))
+	{
+		return false;
+	}
+
+	if (getBit(_researched, research->getId()))
 	{
-		RuleResearch *research = ruleset->getResearch(*iter);
-		if (!isResearchAvailable(research, unlocked, ruleset))
+		bool liveAlien = ruleset->getUnit(research->getName()) != 0;
+		if (!liveAlien)
 		{
-			continue;
+			return false;
 		}
-		std::vector<const RuleResearch *>::const_iterator itDiscovered = std::find(discovered.begin (), discovered.end (), research);
-		
-		bool liveAlien = ruleset->getUnit(research->getName()) != 0;
-
-		if (itDiscovered != discovered.end ())
+		bool cull = true;
+		for (std::vector<int>::const_iterator ohBoy = research->getGetOneFreeIds().begin(); ohBoy != research->getGetOneFreeIds().end(); ++ohBoy)
 		{
-			if (!liveAlien)
-			{
-				continue;
-			}
-			else
+			if (!getBit(_researched, *ohBoy))
 			{
-				bool cull = true;
-				if (research->getGetOneFree().size() != 0)
-				{
-					for (std::vector<std::string>::const_iterator ohBoy = research->getGetOneFree().begin(); ohBoy != research->getGetOneFree().end(); ++ohBoy)
-					{
-						std::vector<const RuleResearch *>::const_iterator more_iteration = std::find(discovered.begin (), discovered.end (), ruleset->getResearch(*ohBoy));
-						if (more_iteration == discovered.end ())
-						{
-							cull = false;
-							break;
-						}
-					}
-				}
-				std::vector<std::string>::const_iterator leaderCheck = std::find(research->getUnlocked().begin(), research->getUnlocked().end(), "STR_LEADER_PLUS");
-				std::vector<std::string>::const_iterator cmnderCheck = std::find(research->getUnlocked().begin(), research->getUnlocked().end(), "STR_CYDONIA_DEP");
-				
-				bool leader ( leaderCheck != research->getUnlocked().end());
-				bool cmnder ( cmnderCheck != research->getUnlocked().end());
-
-				if (leader)
-				{
-					std::vector<const RuleResearch*>::const_iterator found = std::find(discovered.begin(), discovered.end(), ruleset->getResearch("STR_LEADER_PLUS"));
-					if (found == discovered.end())
-						cull = false;
-				}
-
-				if (cmnder)
-				{
-					std::vector<const RuleResearch*>::const_iterator found = std::find(discovered.begin(), discovered.end(), ruleset->getResearch("STR_CYDONIA_DEP"));
-					if (found == discovered.end())
-						cull = false;
-				}
-
-				if (cull)
-					continue;
+				cull = false;
+				break;
 			}
 		}
+		bool leader = std::find(research->getUnlocked().begin(), research->getUnlocked().end(), "STR_LEADER_PLUS") != research->getUnlocked().end();
+		bool cmnder = std::find(research->getUnlocked().begin(), research->getUnlocked().end(), "STR_CYDONIA_DEP") != research->getUnlocked().end();
 
-		if (std::find_if (baseResearchProjects.begin(), baseResearchProjects.end (), findRuleResearch(research)) != baseResearchProjects.end ())
+		if (leader)
 		{
-			continue;
+			RuleResearch *found = ruleset->getResearch("STR_LEADER_PLUS");
+			if (found == 0 || !getBit(_researched, found->getId()))
+				cull = false;
 		}
-		if (research->needItem() && base->getItems()->getItem(research->getName ()) == 0)
+
+		if (cmnder)
 		{
-			continue;
+			RuleResearch *found = ruleset->getResearch("STR_CYDONIA_DEP");
+			if (found == 0 || !getBit(_researched, found->getId()))
+				cull = false;
 		}
-		if (research->getRequirements().size() != 0)
-		{
-			size_t tally(0);
-			for(size_t itreq = 0; itreq != research->getRequirements().size(); ++itreq)
-			{
-				itDiscovered = std::find(discovered.begin (), discovered.end (), ruleset->getResearch(research->getRequirements().at(itreq)));
-				if (itDiscovered != discovered.end ())
-				{
-					tally++;
-				}
-			}
-			if(tally != research->getRequirements().size())
-			continue;
-		}
-		projects.push_back (research);
+
+		if (cull)
+			return false;
 	}
+
+	const std::vector<ResearchProject *> & baseResearchProjects = base->getResearch();
+	if (std::find_if (baseResearchProjects.begin(), baseResearchProjects.end (), findRuleResearch(research)) != baseResearchProjects.end ())
+	{
+		return false;
+	}
+	if (research->needItem() && base->getItems()->getItem(research->getName ()) == 0)
+	{
+		return false;
+	}
+	return isResearched(research->getRequirementIds());
 }
 
 /**
@@ -911,7 +1087,7 @@ void SavedGame::getAvailableProductions (std::vector<RuleManufacture *> & produc
 		++iter)
 	{
 		RuleManufacture *m = ruleset->getManufacture(*iter);
-		if(!isResearched(m->getRequirements()))
+		if(!isResearched(m->getRequirementIds()))
 		{
 		 	continue;
 		}
@@ -931,51 +1107,59 @@ void SavedGame::getAvailableProductions (std::vector<RuleManufacture *> & produc
 */
 bool SavedGame::isResearchAvailable (RuleResearch * r, const std::vector<const RuleResearch *> & unlocked, const Ruleset * ruleset) const
 {
-	std::vector<std::string> deps = r->getDependencies();
-	const std::vector<const RuleResearch *> & discovered(getDiscoveredResearch());
-	bool liveAlien = ruleset->getUnit(r->getName()) != 0;
-	if(std::find(unlocked.begin (), unlocked.end (), r) != unlocked.end ())
+	std::vector<bool> unlockedSet;
+	for (std::vector<const RuleResearch *>::const_iterator i = unlocked.begin(); i != unlocked.end(); ++i)
+	{
+		if (*i)
+		{
+			setBit(unlockedSet, (*i)->getId());
+		}
+	}
+	return isResearchAvailable(r, unlockedSet, ruleset);
+}
+
+/**
+   Check whether a ResearchProject can be researched.
+   * @param r the RuleResearch to test.
+   * @param unlocked the set of currently unlocked research IDs
+   * @return true if the RuleResearch can be researched
+*/
+bool SavedGame::isResearchAvailable (const RuleResearch * r, const std::vector<bool> & unlocked, const Ruleset * ruleset) const
+{
+	if (getBit(unlocked, r->getId()))
 	{
 		return true;
 	}
-	else if (liveAlien)
-	{		
-		if (r->getGetOneFree().size() > 0)
+	else if (!r->getGetOneFreeIds().empty() && ruleset->getUnit(r->getName()) != 0)
+	{
+		for (std::vector<int>::const_iterator itFree = r->getGetOneFreeIds().begin(); itFree != r->getGetOneFreeIds().end(); ++itFree)
 		{
-			for (std::vector<std::string>::const_iterator itFree = r->getGetOneFree().begin(); itFree != r->getGetOneFree().end(); ++itFree)
+			if (!getBit(unlocked, *itFree))
 			{
-				if(std::find(unlocked.begin (), unlocked.end (), ruleset->getResearch(*itFree)) == unlocked.end ())
-				{
-					return true;
-				}
+				return true;
 			}
-			std::vector<std::string>::const_iterator leaderCheck = std::find(r->getUnlocked().begin(), r->getUnlocked().end(), "STR_LEADER_PLUS");
-			std::vector<std::string>::const_iterator cmnderCheck = std::find(r->getUnlocked().begin(), r->getUnlocked().end(), "STR_CYDONIA_DEP");
-				
-			bool leader ( leaderCheck != r->getUnlocked().end());
-			bool cmnder ( cmnderCheck != r->getUnlocked().end());
+		}
+		bool leader = std::find(r->getUnlocked().begin(), r->getUnlocked().end(), "STR_LEADER_PLUS") != r->getUnlocked().end();
+		bool cmnder = std::find(r->getUnlocked().begin(), r->getUnlocked().end(), "STR_CYDONIA_DEP") != r->getUnlocked().end();
 
-			if (leader)
-			{
-				std::vector<const RuleResearch*>::const_iterator found = std::find(discovered.begin(), discovered.end(), ruleset->getResearch("STR_LEADER_PLUS"));
-				if (found == discovered.end())
-					return true;
-			}
+		if (leader)
+		{
+			RuleResearch *found = ruleset->getResearch("STR_LEADER_PLUS");
+			if (found == 0 || !getBit(_researched, found->getId()))
+				return true;
+		}
 
-			if (cmnder)
-			{
-				std::vector<const RuleResearch*>::const_iterator found = std::find(discovered.begin(), discovered.end(), ruleset->getResearch("STR_CYDONIA_DEP"));
-				if (found == discovered.end())
-					return true;
-			}
+		if (cmnder)
+		{
+			RuleResearch *found = ruleset->getResearch("STR_CYDONIA_DEP");
+			if (found == 0 || !getBit(_researched, found->getId()))
+				return true;
 		}
 	}
 
-	for(std::vector<std::string>::const_iterator iter = deps.begin (); iter != deps.end (); ++ iter)
+	for (std::vector<int>::const_iterator iter = r->getDependencyIds().begin(); iter != r->getDependencyIds().end(); ++iter)
 	{
-		RuleResearch *research = ruleset->getResearch(*iter);
-		std::vector<const RuleResearch *>::const_iterator itDiscovered = std::find(discovered.begin (), discovered.end (), research);
-		if (itDiscovered == discovered.end ())
+		if (!getBit(_researched, *iter))
 		{
 			return false;
 		}
@@ -996,9 +1180,9 @@ void SavedGame::getDependableResearch (std::vector<RuleResearch *> & dependables
 	getDependableResearchBasic(dependables, research, ruleset, base);
 	for(std::vector<const RuleResearch *>::const_iterator iter = _discovered.begin (); iter != _discovered.end (); ++iter)
 	{
-		if((*iter)->getCost() == 0)
+		if(*iter && (*iter)->getCost() == 0)
 		{
-			if (std::find((*iter)->getDependencies().begin (), (*iter)->getDependencies().end (), research->getName()) != (*iter)->getDependencies().end ())
+			if (std::find((*iter)->getDependencyIds().begin (), (*iter)->getDependencyIds().end (), research->getId()) != (*iter)->getDependencyIds().end ())
 			{
 				getDependableResearchBasic(dependables, *iter, ruleset, base);
 			}
@@ -1008,6 +1192,7 @@ void SavedGame::getDependableResearch (std::vector<RuleResearch *> & dependables
 
 /**
    Get the list of newly available research projects once a ResearchProject has been completed. This function doesn't check for fake ResearchProject.
+   Only the research that depends on or unlocks the discovered one needs to be looked at.
    * @param dependables the list of RuleResearch which are now available.
    * @param research The RuleResearch which has just been discovered
    * @param ruleset the Game Ruleset
@@ -1015,17 +1200,15 @@ void SavedGame::getDependableResearch (std::vector<RuleResearch *> & dependables
 */
 void SavedGame::getDependableResearchBasic (std::vector<RuleResearch *> & dependables, const RuleResearch *research, const Ruleset * ruleset, Base * base) const
 {
-	std::vector<RuleResearch *> possibleProjects;
-	getAvailableResearchProjects(possibleProjects, ruleset, base);
-	for(std::vector<RuleResearch *>::iterator iter = possibleProjects.begin (); iter != possibleProjects.end (); ++iter)
+	for(std::vector<int>::const_iterator iter = research->getDependents().begin (); iter != research->getDependents().end (); ++iter)
 	{
-		if (std::find((*iter)->getDependencies().begin (), (*iter)->getDependencies().end (), research->getName()) != (*iter)->getDependencies().end ()
-			|| std::find((*iter)->getUnlocked().begin (), (*iter)->getUnlocked().end (), research->getName()) != (*iter)->getUnlocked().end ())
+		RuleResearch *dependent = ruleset->getResearch(*iter);
+		if (isProjectAvailable(dependent, ruleset, base))
 		{
-			dependables.push_back(*iter);
-			if ((*iter)->getCost() == 0)
+			dependables.push_back(dependent);
+			if (dependent->getCost() == 0)
 			{
-				getDependableResearchBasic(dependables, *iter, ruleset, base);
+				getDependableResearchBasic(dependables, dependent, ruleset, base);
 			}
 		}
 	}
@@ -1038,16 +1221,13 @@ void SavedGame::getDependableResearchBasic (std::vector<RuleResearch *> & depend
    * @param ruleset the Game Ruleset
    * @param base a pointer to a Base
 */
-void SavedGame::getDependableManufacture (std::vector<RuleManufacture *> & dependables, const RuleResearch *research, const Ruleset * ruleset, Base *) const
+void SavedGame::getDependableManufacture (std::vector<RuleManufacture *> & dependables, const RuleResearch *research, const Ruleset *, Base *) const
 {
-	const std::vector<std::string> &mans = ruleset->getManufactureList();
-	for(std::vector<std::string>::const_iterator iter = mans.begin (); iter != mans.end (); ++iter)
+	for(std::vector<RuleManufacture *>::const_iterator iter = research->getManufacture().begin (); iter != research->getManufacture().end (); ++iter)
 	{
-		RuleManufacture *m = ruleset->getManufacture(*iter);
-		const std::vector<std::string> &reqs = m->getRequirements();
-		if(isResearched(m->getRequirements()) && std::find(reqs.begin(), reqs.end(), research->getName()) != reqs.end())
+		if(isResearched((*iter)->getRequirementIds()))
 		{
-			dependables.push_back(m);
+			dependables.push_back(*iter);
 		}
 	}
 }
@@ -1061,40 +1241,43 @@ bool SavedGame::isResearched(const std::string &research) const
 {
 	if (research.empty() || _debug)
 		return true;
-	for (std::vector<const RuleResearch *>::const_iterator i = _discovered.begin(); i != _discovered.end(); ++i)
+	return _researchedNames.find(research) != _researchedNames.end();
+}
+
+/**
+ * Returns if a certain list of research has been completed.
+ * @param research List of research IDs.
+ * @return Whether it's researched or not.
+ */
+bool SavedGame::isResearched(const std::vector<std::string> &research) const
+{
+	if (research.empty() || _debug)
+		return true;
+	for (std::vector<std::string>::const_iterator i = research.begin(); i != research.end(); ++i)
 	{
-		if ((*i)->getName() == research)
-			return true;
+		if (_researchedNames.find(*i) == _researchedNames.end())
+			return false;
 	}
 
-	return false;
+	return true;
 }
 
 /**
  * Returns if a certain list of research has been completed.
- * @param research List of research IDs.
+ * @param research List of research IDs, as given by the ruleset.
  * @return Whether it's researched or not.
  */
-bool SavedGame::isResearched(const std::vector<std::string> &research) const
+bool SavedGame::isResearched(const std::vector<int> &research) const
 {
 	if (research.empty() || _debug)
 		return true;
-	std::vector<std::string> matches = research;
-	for (std::vector<const RuleResearch *>::const_iterator i = _discovered.begin(); i != _discovered.end(); ++i)
+	for (std::vector<int>::const_iterator i = research.begin(); i != research.end(); ++i)
 	{
-		for (std::vector<std::string>::iterator j = matches.begin(); j != matches.end(); ++j)
-		{
-			if ((*i)->getName() == *j)
-			{
-				j = matches.erase(j);
-				break;
-			}
-		}
-		if (matches.empty())
-			return true;
+		if (!getBit(_researched, *i))
+			return false;
 	}
 
-	return false;
+	return true;
 }
 
 /**
@@ -1323,12 +1506,26 @@ private:
 
 /**
  * Find the region containing this location.
+ * With a ruleset, only the regions near the location are checked.
  * @param lon The longtitude.
  * @param lat The latitude.
+ * @param ruleset The game rules, to look up the region by location.
  * @return Pointer to the region, or 0.
  */
-Region *SavedGame::locateRegion(double lon, double lat) const
+Region *SavedGame::locateRegion(double lon, double lat, const Ruleset *ruleset) const
 {
+	if (ruleset != NULL)
+	{
+		RuleRegion *rule = ruleset->locateRegion(lon, lat);
+		for (std::vector<Region*>::const_iterator i = _regions.begin(); rule != 0 && i != _regions.end(); ++i)
+		{
+			if ((*i)->getRules() == rule)
+			{
+				return *i;
+			}
+		}
+		return 0;
+	}
 	std::vector<Region *>::const_iterator found = std::find_if(_regions.begin(), _regions.end(), ContainsPoint(lon, lat));
 	if (found != _regions.end())
 	{
@@ -1340,11 +1537,44 @@ Region *SavedGame::locateRegion(double lon, double lat) const
 /**
  * Find the region containing this target.
  * @param target The target to locate.
+ * @param ruleset The game rules, to look up the region by location.
  * @return Pointer to the region, or 0.
  */
-Region *SavedGame::locateRegion(const Target &target) const
+Region *SavedGame::locateRegion(const Target &target, const Ruleset *ruleset) const
+{
+	return locateRegion(target.getLongitude(), target.getLatitude(), ruleset);
+}
+
+/**
+ * Find the country containing this location.
+ * With a ruleset, only the countries near the location are checked.
+ * @param lon The longtitude.
+ * @param lat The latitude.
+ * @param ruleset The game rules, to look up the country by location.
+ * @return Pointer to the country, or 0.
+ */
+Country *SavedGame::locateCountry(double lon, double lat, const Ruleset *ruleset) const
 {
-	return locateRegion(target.getLongitude(), target.getLatitude());
+	if (ruleset != NULL)
+	{
+		RuleCountry *rule = ruleset->locateCountry(lon, lat);
+		for (std::vector<Country*>::const_iterator i = _countries.begin(); rule != 0 && i != _countries.end(); ++i)
+		{
+			if ((*i)->getRules() == rule)
+			{
+				return *i;
+			}
+		}
+		return 0;
+	}
+	for (std::vector<Country*>::const_iterator i = _countries.begin(); i != _countries.end(); ++i)
+	{
+		if ((*i)->getRules()->insideCountry(lon, lat))
+		{
+			return *i;
+		}
+	}
+	return 0;
 }
 
 /*
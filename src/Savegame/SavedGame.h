@@ -20,8 +20,10 @@
 #define OPENXCOM_SAVEDGAME_H
 
 #include <map>
+#include <set>
 #include <vector>
 #include <string>
+#include <yaml-cpp/yaml.h>
 
 namespace OpenXcom
 {
@@ -75,6 +77,8 @@ private:
 	AlienStrategy *_alienStrategy;
 	SavedBattleGame *_battleGame;
 	std::vector<const RuleResearch *> _discovered;
+	std::vector<bool> _researched, _unlocked;
+	std::set<std::string> _researchedNames;
 	std::vector<AlienMission*> _activeMissions;
 	bool _debug, _warned, _detail, _radarLines;
 	int _monthsPassed;
@@ -84,6 +88,26 @@ private:
 	std::vector<const RuleResearch *> _poppedResearch;
 
 	void getDependableResearchBasic (std::vector<RuleResearch *> & dependables, const RuleResearch *research, const Ruleset * ruleset, Base * base) const;
+	/// Adds a research to the discovered research.
+	void addDiscovered(const RuleResearch *r);
+	/// Checks whether a research can be researched, with a set of unlocked research.
+	bool isResearchAvailable(const RuleResearch *r, const std::vector<bool> &unlocked, const Ruleset *ruleset) const;
+	/// Checks whether a research can be started in a base.
+	bool isProjectAvailable(const RuleResearch *r, const Ruleset *ruleset, Base *base) const;
+	/// Gets if a list of research IDs has been unlocked.
+	bool isResearched(const std::vector<int> &research) const;
+	/// Loads the brief save info.
+	void loadHeader(const YAML::Node &doc);
+	/// Loads the full save data, apart from the battle.
+	void loadGame(const YAML::Node &doc, Ruleset *rule);
+	/// Saves the brief save info.
+	void saveHeader(YAML::Emitter &out) const;
+	/// Saves the full save data.
+	void saveGame(YAML::Emitter &out, bool battle) const;
+	/// Saves a saved game to a YAML file.
+	void saveYaml(const std::string &filename) const;
+	/// Saves a saved game to a binary file.
+	void saveBinary(const std::string &filename) const;
 public:
 	/// Creates a new saved game.
 	SavedGame();
@@ -91,10 +115,14 @@ public:
 	~SavedGame();
 	/// Gets list of saves in the user directory.
 	static void getList(TextList *list, Language *lang);
-	/// Loads a saved game from YAML.
+	/// Loads a saved game from YAML or a binary save.
 	void load(const std::string &filename, Ruleset *rule);
-	/// Saves a saved game to YAML.
+	/// Saves a saved game to YAML or a binary save.
 	void save(const std::string &filename) const;
+	/// Converts a saved game between YAML and binary.
+	static bool convert(const std::string &filename, Ruleset *rule);
+	/// Gets a checksum of the whole game state.
+	unsigned int getChecksum() const;
 	/// Gets game difficulty.
 	GameDifficulty getDifficulty() const;
 	/// Sets game difficulty.
@@ -198,9 +226,11 @@ public:
 	/// Gets a mission matching region and type.
 	AlienMission *getAlienMission(const std::string &region, const std::string &type) const;
 	/// Locate a region containing a position.
-	Region *locateRegion(double lon, double lat) const;
+	Region *locateRegion(double lon, double lat, const Ruleset *ruleset = NULL) const;
 	/// Locate a region containing a Target.
-	Region *locateRegion(const Target &target) const;
+	Region *locateRegion(const Target &target, const Ruleset *ruleset = NULL) const;
+	/// Locate a country containing a position.
+	Country *locateCountry(double lon, double lat, const Ruleset *ruleset = NULL) const;
 	/// Return the month counter.
 	int getMonthsPassed() const;
 	/// Return the GraphRegionToggles.
@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "Tile.h"
+#include "TileStore.h"
 #include "../Ruleset/MapData.h"
 #include "../Ruleset/MapDataSet.h"
 #include "../Engine/SurfaceSet.h"
@@ -43,28 +44,31 @@ Tile::SerializationKey Tile::serializationKey =
  4 + 2*4 + 2*4 + 1 + 1 + 1 // total bytes to save one tile
 };
 
+unsigned int Tile::_sightChanges = 0;
+
 /**
 * constructor
 * @param pos Position.
+* @param store Fields of all the tiles of the map.
+* @param index Index of the tile in the map.
 */
-Tile::Tile(const Position& pos): _smoke(0), _fire(0), _explosive(0), _pos(pos), _unit(0), _animationOffset(0), _markerColor(0), _visible(false), _preview(-1), _TUMarker(0), _overlaps(0)
-{
+Tile::Tile(const Position& pos, TileStore *store, int index): _unit(0), _pos(pos), _explosive(0), _animationOffset(0), _markerColor(0), _preview(-1), _TUMarker(0), _overlaps(0), _shapeVersion(0),
+	closestSoldierDSqr(NOT_CALCULATED), meanSoldierDSqr(0), soldiersVisible(NOT_CALCULATED), closestAlienDSqr(0), totalExposure(0)
+{
+	_objects = store->getObjects() + index * TileStore::PARTS;
+	_mapDataID = store->getMapDataIDs() + index * TileStore::PARTS;
+	_mapDataSetID = store->getMapDataSetIDs() + index * TileStore::PARTS;
+	_light = store->getLight() + index * TileStore::LIGHTLAYERS;
+	_lastLight = store->getLastLight() + index * TileStore::LIGHTLAYERS;
+	_smoke = store->getSmoke() + index;
+	_fire = store->getFire() + index;
+	_visible = store->getVisible() + index;
+	_discovered = store->getDiscovered() + index * TileStore::DISCOVERY_PARTS;
+	_inventory = store->getInventories() + index;
 	for (int i = 0; i < 4; ++i)
 	{
-		_objects[i] = 0;
-		_mapDataID[i] = -1;
-		_mapDataSetID[i] = -1;
 		_currentFrame[i] = 0;
 	}
-	for (int layer = 0; layer < LIGHTLAYERS; layer++)
-	{
-		_light[layer] = 0;
-		_lastLight[layer] = -1;
-	}
-	for (int i = 0; i < 3; ++i)
-	{
-		_discovered[i] = false;
-	}
 }
 
 /**
@@ -72,7 +76,7 @@ Tile::Tile(const Position& pos): _smoke(0), _fire(0), _explosive(0), _pos(pos),
  */
 Tile::~Tile()
 {
-	_inventory.clear();
+	_inventory->clear();
 }
 
 /**
@@ -89,19 +93,19 @@ void Tile::load(const YAML::Node &node)
 	}
 	if(const YAML::Node *pName = node.FindValue("fire"))
 	{
-		*pName >> _fire;
+		*pName >> *_fire;
 	}
 	else
 	{
-		_fire = 0;
+		*_fire = 0;
 	}
 	if(const YAML::Node *pName = node.FindValue("smoke"))
 	{
-		*pName >> _smoke;
+		*pName >> *_smoke;
 	}
 	else
 	{
-		_smoke = 0;
+		*_smoke = 0;
 	}
 	if(const YAML::Node *pName = node.FindValue("discovered"))
 	{
@@ -117,6 +121,8 @@ void Tile::load(const YAML::Node &node)
 	{
 		_currentFrame[2] = 7;
 	}
+	++_shapeVersion;
+	++_sightChanges;
 }
 
 /**
@@ -134,8 +140,8 @@ void Tile::loadBinary(Uint8 *buffer, Tile::SerializationKey& serKey)
 	_mapDataSetID[2] = unserializeInt(&buffer, serKey._mapDataSetID);
 	_mapDataSetID[3] = unserializeInt(&buffer, serKey._mapDataSetID);
 
-	_smoke = unserializeInt(&buffer, serKey._smoke);
-	_fire = unserializeInt(&buffer, serKey._fire);
+	*_smoke = unserializeInt(&buffer, serKey._smoke);
+	*_fire = unserializeInt(&buffer, serKey._fire);
 
     Uint8 boolFields = unserializeInt(&buffer, serKey.boolFields);
 	_discovered[0] = (boolFields & 1) ? true : false;
@@ -143,6 +149,8 @@ void Tile::loadBinary(Uint8 *buffer, Tile::SerializationKey& serKey)
 	_discovered[2] = (boolFields & 4) ? true : false;
 	_currentFrame[1] = (boolFields & 8) ? 7 : 0;
 	_currentFrame[2] = (boolFields & 0x10) ? 7 : 0;
+	++_shapeVersion;
+	++_sightChanges;
 }
 
 
@@ -158,10 +166,10 @@ void Tile::save(YAML::Emitter &out) const
 	out << YAML::BeginSeq << _mapDataID[0] << _mapDataID[1] << _mapDataID[2] << _mapDataID[3] << YAML::EndSeq;
 	out << YAML::Key << "mapDataSetID" << YAML::Value << YAML::Flow;
 	out << YAML::BeginSeq << _mapDataSetID[0] << _mapDataSetID[1] << _mapDataSetID[2] << _mapDataSetID[3] << YAML::EndSeq;
-	if (_smoke)
-		out << YAML::Key << "smoke" << YAML::Value << _smoke;
-	if (_fire)
-		out << YAML::Key << "fire" << YAML::Value << _fire;
+	if (*_smoke)
+		out << YAML::Key << "smoke" << YAML::Value << *_smoke;
+	if (*_fire)
+		out << YAML::Key << "fire" << YAML::Value << *_fire;
 	if (_discovered[0] || _discovered[1] || _discovered[2])
 	{
 		out << YAML::Key << "discovered" << YAML::Value << YAML::Flow;
@@ -192,8 +200,8 @@ void Tile::saveBinary(Uint8** buffer) const
 	serializeInt(buffer, serializationKey._mapDataSetID, _mapDataSetID[2]);
 	serializeInt(buffer, serializationKey._mapDataSetID, _mapDataSetID[3]);
 
-	serializeInt(buffer, serializationKey._smoke, _smoke);
-	serializeInt(buffer, serializationKey._fire, _fire);
+	serializeInt(buffer, serializationKey._smoke, *_smoke);
+	serializeInt(buffer, serializationKey._fire, *_fire);
 
 	Uint8 boolFields = (_discovered[0]?1:0) + (_discovered[1]?2:0) + (_discovered[2]?4:0);
 	boolFields |= isUfoDoorOpen(1) ? 8 : 0; // west
@@ -226,6 +234,8 @@ void Tile::setMapData(MapData *dat, int mapDataID, int mapDataSetID, int part)
 	_objects[part] = dat;
 	_mapDataID[part] = mapDataID;
 	_mapDataSetID[part] = mapDataSetID;
+	++_shapeVersion;
+	++_sightChanges;
 }
 
 /**
@@ -245,7 +255,7 @@ void Tile::getMapData(int *mapDataID, int *mapDataSetID, int part) const
  */
 bool Tile::isVoid() const
 {
-	return _objects[0] == 0 && _objects[1] == 0 && _objects[2] == 0 && _objects[3] == 0 && _smoke == 0 && _inventory.size() == 0;
+	return _objects[0] == 0 && _objects[1] == 0 && _objects[2] == 0 && _objects[3] == 0 && *_smoke == 0 && _inventory->size() == 0;
 }
 
 /**
@@ -362,6 +372,8 @@ int Tile::openDoor(int part, BattleUnit *unit, bool debug)
 		if (unit && unit->getTimeUnits() < _objects[part]->getTUCost(unit->getArmor()->getMovementType()) && !debug)
 			return 4;
 		_currentFrame[part] = 1; // start opening door
+		++_shapeVersion;
+		++_sightChanges;
 		return 1;
 	}
 	if (_objects[part]->isUFODoor() && _currentFrame[part] != 7) // ufo door != part 7 - door is still opening
@@ -396,6 +408,8 @@ int Tile::closeUfoDoor()
 		{
 			_currentFrame[part] = 0;
 			retval = 1;
+			++_shapeVersion;
+			++_sightChanges;
 		}
 	}
 
@@ -466,7 +480,7 @@ int Tile::getShade() const
 {
 	int light = 0;
 
-	for (int layer = 0; layer < LIGHTLAYERS; layer++)
+	for (int layer = 0; layer < TileStore::LIGHTLAYERS; layer++)
 	{
 		if (_light[layer] > light)
 			light = _light[layer];
@@ -597,12 +611,13 @@ void Tile::ignite(int power)
 		}
 		if (power > RNG::generate(0, 100))
 		{
-			if (_fire == 0)
+			if (*_fire == 0)
 			{
-				_smoke = 15 - std::max(1, std::min((getFlammability() / 10), 12));
+				*_smoke = 15 - std::max(1, std::min((getFlammability() / 10), 12));
 				_overlaps = 1;
-				_fire = getFuel() + 1;
+				*_fire = getFuel() + 1;
 				_animationOffset = RNG::generate(0,3);
+				++_sightChanges;
 			}
 		}
 	}
@@ -679,7 +694,8 @@ BattleUnit *Tile::getUnit() const
  */
 void Tile::setFire(int fire)
 {
-	_fire = fire;
+	*_fire = fire;
+	++_sightChanges;
 	_animationOffset = RNG::generate(0,3);
 }
 
@@ -689,7 +705,7 @@ void Tile::setFire(int fire)
  */
 int Tile::getFire() const
 {
-	return _fire;
+	return *_fire;
 }
 
 /**
@@ -698,18 +714,19 @@ int Tile::getFire() const
  */
 void Tile::addSmoke(int smoke)
 {
-	if (_fire == 0)
+	if (*_fire == 0)
 	{
 		if (_overlaps == 0)
 		{
-			_smoke = std::max(1, std::min(_smoke + smoke, 15));
+			*_smoke = std::max(1, std::min(*_smoke + smoke, 15));
 		}
 		else
 		{
-			_smoke += smoke;
+			*_smoke += smoke;
 		}
 		_animationOffset = RNG::generate(0,3);
 		addOverlap();
+		++_sightChanges;
 	}
 }
 
@@ -719,7 +736,8 @@ void Tile::addSmoke(int smoke)
  */
 void Tile::setSmoke(int smoke)
 {
-	_smoke = smoke;
+	*_smoke = smoke;
+	++_sightChanges;
 	_animationOffset = RNG::generate(0,3);
 }
 
@@ -730,7 +748,7 @@ void Tile::setSmoke(int smoke)
  */
 int Tile::getSmoke() const
 {
-	return _smoke;
+	return *_smoke;
 }
 
 /**
@@ -751,7 +769,7 @@ int Tile::getAnimationOffset() const
 void Tile::addItem(BattleItem *item, RuleInventory *ground)
 {
 	item->setSlot(ground);
-	_inventory.push_back(item);
+	_inventory->push_back(item);
 	item->setTile(this);
 }
 
@@ -761,11 +779,11 @@ void Tile::addItem(BattleItem *item, RuleInventory *ground)
  */
 void Tile::removeItem(BattleItem *item)
 {
-	for (std::vector<BattleItem*>::iterator i = _inventory.begin(); i != _inventory.end(); ++i)
+	for (std::vector<BattleItem*>::iterator i = _inventory->begin(); i != _inventory->end(); ++i)
 	{
 		if ((*i) == item)
 		{
-			_inventory.erase(i);
+			_inventory->erase(i);
 			break;
 		}
 	}
@@ -780,7 +798,7 @@ int Tile::getTopItemSprite()
 {
 	int biggestWeight = -1;
 	int biggestItem = -1;
-	for (std::vector<BattleItem*>::iterator i = _inventory.begin(); i != _inventory.end(); ++i)
+	for (std::vector<BattleItem*>::iterator i = _inventory->begin(); i != _inventory->end(); ++i)
 	{
 		if ((*i)->getRules()->getWeight() > biggestWeight)
 		{
@@ -799,23 +817,24 @@ int Tile::getTopItemSprite()
 void Tile::prepareNewTurn()
 {
 	// we've recieved new smoke in this turn, but we're not on fire, average out the smoke.
-	if ( _overlaps != 0 && _smoke != 0 && _fire == 0)
+	if ( _overlaps != 0 && *_smoke != 0 && *_fire == 0)
 	{
-		_smoke = std::max(0, std::min((_smoke / _overlaps)- 1, 15));
+		*_smoke = std::max(0, std::min((*_smoke / _overlaps)- 1, 15));
+		++_sightChanges;
 	}
 	// if we still have smoke/fire
-	if (_smoke)
+	if (*_smoke)
 	{
 		if (_unit && !_unit->isOut())
 		{
-			if (_fire)
+			if (*_fire)
 			{
 				// this is how we avoid hitting the same unit multiple times.
 				if (_unit->getArmor()->getSize() == 1 || !_unit->tookFireDamage())
 				{
 					_unit->toggleFireDamage();
 					// _smoke becomes our damage value
-					_unit->damage(Position(0, 0, 0), _smoke, DT_IN, true);
+					_unit->damage(Position(0, 0, 0), *_smoke, DT_IN, true);
 					// try to set the unit on fire.
 					if ( RNG::generate(0, 100) < 40 * _unit->getArmor()->getDamageModifier(DT_IN))
 					{
@@ -836,7 +855,7 @@ void Tile::prepareNewTurn()
 					// try to knock this guy out.
 					if (_unit->getArmor()->getDamageModifier(DT_SMOKE) > 0.0 && _unit->getArmor()->getSize() == 1)
 					{
-						_unit->damage(Position(0,0,0), (_smoke / 4) + 1, DT_SMOKE, true);
+						_unit->damage(Position(0,0,0), (*_smoke / 4) + 1, DT_SMOKE, true);
 					}
 				}
 			}
@@ -851,7 +870,7 @@ void Tile::prepareNewTurn()
  */
 std::vector<BattleItem *> *Tile::getInventory()
 {
-	return &_inventory;
+	return _inventory;
 }
 
 
@@ -878,7 +897,7 @@ int Tile::getMarkerColor()
  */
 void Tile::setVisible(int visibility)
 {
-	_visible += visibility;
+	*_visible += visibility;
 }
 
 /**
@@ -886,7 +905,7 @@ void Tile::setVisible(int visibility)
  */
 int Tile::getVisible()
 {
-	return _visible;
+	return *_visible;
 }
 
 /**
@@ -929,6 +948,28 @@ int Tile::getOverlaps() const
 	return _overlaps;
 }
 
+/**
+ * Gets a counter that changes whenever the objects of the tile
+ * change or a ufo door opens or closes, so anything cached about
+ * the solid shape of the tile knows to work it out again.
+ * @return Shape version.
+ */
+unsigned int Tile::getShapeVersion() const
+{
+	return _shapeVersion;
+}
+
+/**
+ * Gets a counter that changes whenever any tile changes shape
+ * or its smoke or fire changes, so anything cached about lines
+ * of sight across the map knows to work them out again.
+ * @return Number of changes so far.
+ */
+unsigned int Tile::getSightChanges()
+{
+	return _sightChanges;
+}
+
 /*
  * increment the overlap value on this tile.
  */
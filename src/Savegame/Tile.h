@@ -35,6 +35,7 @@ class MapData;
 class BattleUnit;
 class BattleItem;
 class RuleInventory;
+class TileStore;
 
 /**
  * Basic element of which a battle map is build.
@@ -55,39 +56,41 @@ public:
 		Uint32 totalBytes; // per structure, including any data not mentioned here and accounting for all array members!
 	} serializationKey;
 
-    // scratch variables for AI, regarding how many soldiers are visible from a square and how close is the closest one:
-	int closestSoldierDSqr;
-	Position closestSoldierPos;
-	int meanSoldierDSqr;
-	int soldiersVisible;
-	int closestAlienDSqr;
-	int totalExposure;
-
 	static const int NOT_CALCULATED = -1;
 
 protected:
-	static const int LIGHTLAYERS = 3;
-	MapData *_objects[4];
-	int _mapDataID[4];
-	int _mapDataSetID[4];
-	int _currentFrame[4];
-	bool _discovered[3];
-	int _light[LIGHTLAYERS], _lastLight[LIGHTLAYERS];
-	int _smoke;
-	int _fire;
-	int _explosive;
-	Position _pos;
+	// the fields whole map passes look at live in the map's TileStore
+	MapData **_objects;
+	int *_mapDataID;
+	int *_mapDataSetID;
+	int *_light, *_lastLight;
+	int *_smoke;
+	int *_fire;
+	int *_visible;
+	bool *_discovered;
+	std::vector<BattleItem *> *_inventory;
 	BattleUnit *_unit;
-	std::vector<BattleItem *> _inventory;
+	Position _pos;
+	int _explosive;
+	int _currentFrame[4];
 	int _animationOffset;
 	int _markerColor;
-	int _visible;
 	int _preview;
 	int _TUMarker;
 	int _overlaps;
+	unsigned int _shapeVersion;
+	static unsigned int _sightChanges;
 public:
+    // scratch variables for AI, regarding how many soldiers are visible from a square and how close is the closest one:
+	int closestSoldierDSqr;
+	Position closestSoldierPos;
+	int meanSoldierDSqr;
+	int soldiersVisible;
+	int closestAlienDSqr;
+	int totalExposure;
+
 	/// Creates a tile.
-	Tile(const Position& pos);
+	Tile(const Position& pos, TileStore *store, int index);
 	/// Cleans up a tile.
 	~Tile();
 	/// Load the tile from yaml
@@ -198,6 +201,10 @@ public:
 	int getOverlaps() const;
 	/// increment the overlap value on this tile.
 	void addOverlap();
+	/// Gets a counter that changes whenever the solid shape of the tile does.
+	unsigned int getShapeVersion() const;
+	/// Gets the number of changes to any tile that affect lines of sight.
+	static unsigned int getSightChanges();
 };
 
 }
@@ -0,0 +1,171 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "TileStore.h"
+#include <algorithm>
+
+namespace OpenXcom
+{
+
+/**
+ * Creates the fields for all the tiles of a map,
+ * set up like a blank tile's.
+ * @param size Number of tiles.
+ */
+TileStore::TileStore(int size) : _size(size)
+{
+	_objects = new MapData*[_size * PARTS];
+	_mapDataID = new int[_size * PARTS];
+	_mapDataSetID = new int[_size * PARTS];
+	_light = new int[_size * LIGHTLAYERS];
+	_lastLight = new int[_size * LIGHTLAYERS];
+	_smoke = new int[_size];
+	_fire = new int[_size];
+	_visible = new int[_size];
+	_discovered = new bool[_size * DISCOVERY_PARTS];
+	_inventories = new std::vector<BattleItem*>[_size];
+
+	std::fill(_objects, _objects + _size * PARTS, (MapData*)0);
+	std::fill(_mapDataID, _mapDataID + _size * PARTS, -1);
+	std::fill(_mapDataSetID, _mapDataSetID + _size * PARTS, -1);
+	std::fill(_light, _light + _size * LIGHTLAYERS, 0);
+	std::fill(_lastLight, _lastLight + _size * LIGHTLAYERS, -1);
+	std::fill(_smoke, _smoke + _size, 0);
+	std::fill(_fire, _fire + _size, 0);
+	std::fill(_visible, _visible + _size, 0);
+	std::fill(_discovered, _discovered + _size * DISCOVERY_PARTS, false);
+}
+
+/**
+ * Deletes the fields.
+ */
+TileStore::~TileStore()
+{
+	delete[] _objects;
+	delete[] _mapDataID;
+	delete[] _mapDataSetID;
+	delete[] _light;
+	delete[] _lastLight;
+	delete[] _smoke;
+	delete[] _fire;
+	delete[] _visible;
+	delete[] _discovered;
+	delete[] _inventories;
+}
+
+/**
+ * Returns the number of tiles the fields are for.
+ * @return Number of tiles.
+ */
+int TileStore::getSize() const
+{
+	return _size;
+}
+
+/**
+ * Returns the map data of each part of every tile.
+ * @return Array of PARTS pointers per tile.
+ */
+MapData **TileStore::getObjects() const
+{
+	return _objects;
+}
+
+/**
+ * Returns the map data IDs of each part of every tile.
+ * @return Array of PARTS IDs per tile.
+ */
+int *TileStore::getMapDataIDs() const
+{
+	return _mapDataID;
+}
+
+/**
+ * Returns the map data set IDs of each part of every tile.
+ * @return Array of PARTS IDs per tile.
+ */
+int *TileStore::getMapDataSetIDs() const
+{
+	return _mapDataSetID;
+}
+
+/**
+ * Returns the light of each layer of every tile.
+ * @return Array of LIGHTLAYERS amounts per tile.
+ */
+int *TileStore::getLight() const
+{
+	return _light;
+}
+
+/**
+ * Returns the light each layer of every tile
+ * had before it was last reset.
+ * @return Array of LIGHTLAYERS amounts per tile.
+ */
+int *TileStore::getLastLight() const
+{
+	return _lastLight;
+}
+
+/**
+ * Returns the turns of smoke left on every tile.
+ * @return Array of one amount per tile.
+ */
+int *TileStore::getSmoke() const
+{
+	return _smoke;
+}
+
+/**
+ * Returns the turns of fire left on every tile.
+ * @return Array of one amount per tile.
+ */
+int *TileStore::getFire() const
+{
+	return _fire;
+}
+
+/**
+ * Returns the visibility of every tile.
+ * @return Array of one flag per tile.
+ */
+int *TileStore::getVisible() const
+{
+	return _visible;
+}
+
+/**
+ * Returns the fog of war state of each part of every tile.
+ * @return Array of DISCOVERY_PARTS flags per tile.
+ */
+bool *TileStore::getDiscovered() const
+{
+	return _discovered;
+}
+
+/**
+ * Returns the items lying on every tile.
+ * @return Array of one list per tile.
+ */
+std::vector<BattleItem*> *TileStore::getInventories() const
+{
+	return _inventories;
+}
+
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_TILESTORE_H
+#define OPENXCOM_TILESTORE_H
+
+#include <vector>
+
+namespace OpenXcom
+{
+
+class MapData;
+class BattleItem;
+
+/**
+ * Holds the fields of every tile of a battle map that whole map
+ * passes go through, each field in a dense array of its own indexed
+ * like the tiles. Every tile points into these arrays for its own
+ * fields, and the passes can walk an array without touching the
+ * tiles. Inventories are kept in a side table, apart from the tiles.
+ */
+class TileStore
+{
+public:
+	static const int PARTS = 4;
+	static const int LIGHTLAYERS = 3;
+	static const int DISCOVERY_PARTS = 3;
+private:
+	int _size;
+	MapData **_objects;
+	int *_mapDataID, *_mapDataSetID;
+	int *_light, *_lastLight;
+	int *_smoke, *_fire, *_visible;
+	bool *_discovered;
+	std::vector<BattleItem*> *_inventories;
+public:
+	/// Creates the fields for a number of tiles.
+	TileStore(int size);
+	/// Cleans up the fields.
+	~TileStore();
+	/// Gets the number of tiles.
+	int getSize() const;
+	/// Gets the map data of every tile, PARTS per tile.
+	MapData **getObjects() const;
+	/// Gets the map data IDs of every tile, PARTS per tile.
+	int *getMapDataIDs() const;
+	/// Gets the map data set IDs of every tile, PARTS per tile.
+	int *getMapDataSetIDs() const;
+	/// Gets the light of every tile, LIGHTLAYERS per tile.
+	int *getLight() const;
+	/// Gets the previous light of every tile, LIGHTLAYERS per tile.
+	int *getLastLight() const;
+	/// Gets the smoke of every tile.
+	int *getSmoke() const;
+	/// Gets the fire of every tile.
+	int *getFire() const;
+	/// Gets the visibility of every tile.
+	int *getVisible() const;
+	/// Gets the discovery of every tile, DISCOVERY_PARTS per tile.
+	bool *getDiscovered() const;
+	/// Gets the inventory of every tile.
+	std::vector<BattleItem*> *getInventories() const;
+};
+
+}
+
+#endif
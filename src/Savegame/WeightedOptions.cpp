@@ -18,6 +18,7 @@
  */
 #include <assert.h>
 #include "WeightedOptions.h"
+#include "../Ruleset/RulesetCache.h"
 #include "../Engine/RNG.h"
 
 namespace OpenXcom
@@ -107,4 +108,22 @@ void WeightedOptions::save(YAML::Emitter &out) const
 	out << YAML::EndMap;
 }
 
+/**
+ * Replace our list with data from the ruleset cache.
+ * @param in Ruleset cache.
+ */
+void WeightedOptions::loadCache(CacheReader &in)
+{
+	in >> _choices >> _totalWeight;
+}
+
+/**
+ * Store our list in the ruleset cache.
+ * @param out Ruleset cache.
+ */
+void WeightedOptions::saveCache(CacheWriter &out) const
+{
+	out << _choices << _totalWeight;
+}
+
 }
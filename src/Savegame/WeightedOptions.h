@@ -27,6 +27,9 @@
 namespace OpenXcom
 {
 
+class CacheReader;
+class CacheWriter;
+
 /**
  * Holds pairs of relative weights and IDs.
  * It is used to store options and make a random choice between them.
@@ -48,6 +51,10 @@ public:
 	void load(const YAML::Node &node);
 	/// Store our list in YAML.
 	void save(YAML::Emitter &out) const;
+	/// Replace our list with data from the ruleset cache.
+	void loadCache(CacheReader &in);
+	/// Store our list in the ruleset cache.
+	void saveCache(CacheWriter &out) const;
 private:
 	std::map<std::string, unsigned> _choices; //!< Options and weights
 	unsigned _totalWeight; //!< The total weight of all options.
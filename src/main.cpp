@@ -18,11 +18,15 @@
  */
 #include <exception>
 #include <sstream>
+#include <SDL.h>
 #include "version.h"
 #include "Engine/Logger.h"
 #include "Engine/CrossPlatform.h"
 #include "Engine/Game.h"
 #include "Engine/Options.h"
+#include "Engine/Exception.h"
+#include "Engine/DataPack.h"
+#include "Ruleset/Ruleset.h"
 #include "Menu/StartState.h"
 
 /** @mainpage
@@ -55,6 +59,27 @@ int main(int argc, char** args)
 #endif
 		if (!Options::init(argc, args))
 			return EXIT_SUCCESS;
+		if (!Options::getPackFile().empty())
+		{
+			DataPack::build(Options::getPackFile());
+			return EXIT_SUCCESS;
+		}
+		if (!Options::getCacheMode().empty())
+		{
+			std::string mode = Options::getCacheMode();
+			if (mode != "build" && mode != "verify")
+			{
+				throw Exception("Unknown ruleset cache action: " + mode);
+			}
+			bool ok = Ruleset::buildCache(Options::getUserFolder() + "ruleset.cache", Options::getRulesets(), mode == "verify");
+			return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+		if (!Options::getConvertSave().empty() || !Options::getSimulateSave().empty() || !Options::getSimulateBattle().empty() || Options::getBenchmarkGlobe() > 0)
+		{
+			// no window or sound needed to run the geoscape
+			SDL_putenv(const_cast<char*>("SDL_VIDEODRIVER=dummy"));
+			SDL_putenv(const_cast<char*>("SDL_AUDIODRIVER=dummy"));
+		}
 		std::stringstream title;
 		title << "OpenXcom " << OPENXCOM_VERSION_SHORT << OPENXCOM_VERSION_GIT;
 		game = new Game(title.str());
@@ -73,6 +98,7 @@ int main(int argc, char** args)
 
 	// Comment this for faster exit.
 	delete game;
+	DataPack::close();
 	// Uncomment to check memory leaks in VS
 	//_CrtDumpMemoryLeaks();
 	return EXIT_SUCCESS;